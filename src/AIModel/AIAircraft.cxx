@@ -12,6 +12,7 @@
 #include <Main/util.hxx>
 #include <Scenery/scenery.hxx>
 #include <Traffic/Schedule.hxx>
+#include <Traffic/TrafficMgr.hxx>
 
 #include <simgear/io/iostreams/sgstream.hxx>
 #include <simgear/structure/exception.hxx>
@@ -165,6 +166,14 @@ void FGAIAircraft::unbind()
 {
     FGAIBase::unbind();
     clearATCController();
+
+    // let the schedule move on now, rather than at its next periodic check
+    if (trafficRef) {
+        auto tmgr = globals->get_subsystem<FGTrafficManager>();
+        if (tmgr) {
+            tmgr->requeueSchedule(trafficRef);
+        }
+    }
 }
 
 void FGAIAircraft::setPerformance(const std::string& acType, const std::string& acClass)
@@ -1360,9 +1369,9 @@ void FGAIAircraft::updateVerticalSpeedTarget(double dt)
         // find target vertical speed
         if (use_perf_vs) {
             if (altitude_ft < tgt_altitude_ft) {
-                tgt_vs = std::min(tgt_altitude_ft - altitude_ft, _performance->climbRate());
+                tgt_vs = std::min(tgt_altitude_ft - altitude_ft, _performance->climbRateAt(altitude_ft));
             } else {
-                tgt_vs = std::max(tgt_altitude_ft - altitude_ft, -_performance->descentRate());
+                tgt_vs = std::max(tgt_altitude_ft - altitude_ft, -_performance->descentRateAt(altitude_ft));
             }
         } else if (fp->getCurrentWaypoint()) {
             double vert_dist_ft = fp->getCurrentWaypoint()->getCrossat() - altitude_ft;
@@ -1527,19 +1536,18 @@ bool FGAIAircraft::reachedEndOfCruise(double& distance)
         }
 
         double dist = fp->getDistanceToGo(pos.getLatitudeDeg(), pos.getLongitudeDeg(), curr);
-        double descentSpeed = (getPerformance()->vDescent() * SG_NM_TO_METER) / 3600.0;   // convert from kts to meter/s
-        double descentRate = (getPerformance()->descentRate() * SG_FEET_TO_METER) / 60.0; // convert from feet/min to meter/s
 
-        double verticalDistance = ((altitude_ft - 2000.0) - trafficRef->getArrivalAirport()->getElevation()) * SG_FEET_TO_METER;
-        double descentTimeNeeded = verticalDistance / descentRate;
-        double distanceCoveredByDescent = descentSpeed * descentTimeNeeded;
+        // descent down to 2000ft above the arrival airport, with the rates
+        // and speeds of the performance profile
+        double bottomOfDescentFt = trafficRef->getArrivalAirport()->getElevation() + 2000.0;
+        double distanceCoveredByDescent = getPerformance()->descentDistanceM(altitude_ft) -
+                                          getPerformance()->descentDistanceM(bottomOfDescentFt);
 
         if (tracked) {
             SG_LOG(SG_AI, SG_BULK, "Checking for end of cruise stage for :" << trafficRef->getCallSign());
-            SG_LOG(SG_AI, SG_BULK, "Descent rate      : " << descentRate);
-            SG_LOG(SG_AI, SG_BULK, "Descent speed     : " << descentSpeed);
-            SG_LOG(SG_AI, SG_BULK, "VerticalDistance  : " << verticalDistance << ". Altitude : " << altitude_ft << ". Elevation " << trafficRef->getArrivalAirport()->getElevation());
-            SG_LOG(SG_AI, SG_BULK, "DecentTimeNeeded  : " << descentTimeNeeded);
+            SG_LOG(SG_AI, SG_BULK, "Descent rate      : " << getPerformance()->descentRateAt(altitude_ft));
+            SG_LOG(SG_AI, SG_BULK, "Descent speed     : " << getPerformance()->descentSpeedAt(altitude_ft));
+            SG_LOG(SG_AI, SG_BULK, "Altitude : " << altitude_ft << ". Elevation " << trafficRef->getArrivalAirport()->getElevation());
             SG_LOG(SG_AI, SG_BULK, "DistanceCovered   : " << distanceCoveredByDescent);
         }
 
@@ -136,6 +136,7 @@ void FGAIBallistic::reinit() {
     _impact_speed = 0;
 
     invisible = false;
+    _haveOldCartPos = false;
 
     _elapsed_time += (sg_random() * 100);
 
@@ -913,12 +914,24 @@ void FGAIBallistic::Run(double dt) {
         setHdg(_azimuth, dt, coeff);
     }
 
-    // Do impacts and collisions
-    if (_report_impact && !_impact_reported)
-        handle_impact();
-
-    if (_report_collision && !_collision_reported)
-        handle_collision();
+    // Do impacts and collisions. Testing only the current position lets
+    // fast objects pass through terrain and targets between two frames, so
+    // the segment since the last frame is swept instead.
+    if (needsImpactCheck() || needsCollisionCheck()) {
+        const SGVec3d cartPos = SGVec3d::fromGeod(pos);
+        if (_haveOldCartPos) {
+            manager->queueSweep(this, _oldcartPos, cartPos);
+        } else {
+            // nothing to sweep yet in the first frame
+            if (needsImpactCheck())
+                handle_impact();
+
+            if (needsCollisionCheck())
+                handle_collision();
+        }
+        _oldcartPos = cartPos;
+        _haveOldCartPos = true;
+    }
 
     // Set destruction flag if altitude less than sea level -1000
     if (altitude_ft < -1000.0 && life != -1)
@@ -976,6 +989,37 @@ void FGAIBallistic::handle_collision()
     }
 }
 
+void FGAIBallistic::handleSweepHit(const SGVec3d& hit, const FGAIBase* object)
+{
+    // report the exact point of the hit, not where the object got to
+    pos = SGGeod::fromCart(hit);
+    _oldcartPos = hit;
+
+    if (object) {
+        report_impact(pos.getElevationM(), object);
+        _collision_reported = true;
+    } else {
+        // look up the material and elevation at the hit point, as the
+        // point test does, so the report and listeners see them
+        if (!getHtAGL(pos.getElevationM() + 100)) {
+            _elevation_m = pos.getElevationM();
+            _ht_agl_ft = 0.0;
+        }
+
+        SG_LOG(SG_AI, SG_DEBUG, "AIBallistic: terrain impact " << _name << " material " << _mat_name);
+        _impact_reported = true;
+        handleEndOfLife(_elevation_m);
+    }
+}
+
+void FGAIBallistic::handleSweepMiss()
+{
+    // the point test is still needed for the AGL and material properties,
+    // and for objects which are below the terrain without crossing it
+    if (needsImpactCheck())
+        handle_impact();
+}
+
 void FGAIBallistic::report_impact(double elevation, const FGAIBase *object)
 {
     _impact_lat    = pos.getLatitudeDeg();
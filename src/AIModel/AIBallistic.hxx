@@ -35,6 +35,15 @@ public:
 
     void Run(double dt);
 
+    // Continuous impact and collision detection: Run() hands the segment
+    // travelled in this frame to FGAIManager::queueSweep, which tests all
+    // of them after the AI update and reports back here.
+    bool needsImpactCheck() const { return _report_impact && !_impact_reported; }
+    bool needsCollisionCheck() const { return _report_collision && !_collision_reported; }
+    double getFuseRangeFt() const { return _fuse_range; }
+    void handleSweepHit(const SGVec3d& hit, const FGAIBase* object);
+    void handleSweepMiss();
+
     void setAzimuth(double az);
     void setElevation(double el);
     void setAzimuthRandomError(double error);
@@ -211,5 +220,6 @@ private:
     double _load_offset = 0.0;
 
     SGVec3d _oldcartoffsetPos;
-    SGVec3d _oldcartPos;
+    SGVec3d _oldcartPos;            // start of the segment for the next sweep
+    bool _haveOldCartPos = false;
 };
@@ -21,6 +21,7 @@
 #include <simgear/debug/ErrorReportingCallback.hxx>
 #include <simgear/debug/logstream.hxx>
 #include <simgear/misc/sg_path.hxx>
+#include <simgear/misc/strutils.hxx>
 #include <simgear/props/props.hxx>
 #include <simgear/scene/model/modellib.hxx>
 #include <simgear/scene/util/SGNodeMasks.hxx>
@@ -35,7 +36,9 @@
 
 #include "AIFlightPlan.hxx"
 #include "AIBase.hxx"
+#include "AIElevationCache.hxx"
 #include "AIManager.hxx"
+#include "AIModelLoader.hxx"
 
 static std::string default_model = "Models/Geometry/glider.ac";
 const double FGAIBase::e = 2.71828183;
@@ -231,6 +234,18 @@ FGAIBase::removeModel()
     }
 }
 
+void FGAIBase::attachModelToScene()
+{
+    auto scenery = globals->get_scenery();
+    if (scenery && aip.getSceneGraph()) {
+        // a request replaced in the loader may attach the object again
+        auto branch = scenery->get_models_branch();
+        if (!branch->containsNode(aip.getSceneGraph())) {
+            branch->addChild(aip.getSceneGraph());
+        }
+    }
+}
+
 void FGAIBase::setScenarioPath(const std::string& scenarioPath)
 {
     _scenarioPath = scenarioPath;
@@ -686,10 +701,14 @@ bool FGAIBase::init(ModelSearchOrder searchOrder)
         aip.init( _model.get() );
         aip.setVisible(true);
         invisible = false;
-        
-        auto scenery = globals->get_scenery();
-        if (scenery) {
-            scenery->get_models_branch()->addChild(aip.getSceneGraph());
+
+        // the manager decides when the pager gets to load the model,
+        // nearest first; stand-alone objects are attached right away
+        auto loader = manager ? manager->getModelLoader() : nullptr;
+        if (loader) {
+            loader->enqueue(this, simgear::strutils::join(model_list, ";"));
+        } else {
+            attachModelToScene();
         }
         _initialized = true;
 
@@ -924,6 +943,13 @@ SGVec3d FGAIBase::getCartPos() const {
 
 bool FGAIBase::getGroundElevationM(const SGGeod& pos, double& elev,
                                    const simgear::BVHMaterial** material) const {
+    // AI models aren't part of the terrain branch, so lookups of different
+    // objects at the same spot can share the manager's cached results
+    FGAIElevationCache* cache = manager ? manager->getElevationCache() : nullptr;
+    if (cache) {
+        return cache->getElevationM(pos, elev, material);
+    }
+
     return globals->get_scenery()->get_elevation_m(pos, elev, material,
                                                    _model.get());
 }
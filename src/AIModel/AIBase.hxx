@@ -85,6 +85,9 @@ public:
     void updateLOD();
     void updateInterior();
 
+    /// add the model to the scene graph, see FGAIModelLoader
+    void attachModelToScene();
+
     void setManager(FGAIManager* mgr, SGPropertyNode* p);
 
     void setPath(const char* model);
@@ -121,6 +124,17 @@ public:
     void setDie(bool die);
     bool isValid() const;
 
+    /**
+     * @brief simulation level of detail, managed by FGAIManager::update.
+     * Distant objects are updated in a lower tier, less often, with the
+     * time accumulated since their last update.
+     */
+    struct SimLOD {
+        int tier = 0;
+        double pendingDt = 0.0;
+    };
+    SimLOD& simLOD() { return _simLOD; }
+
     void setCollisionData(bool i, double lat, double lon, double elev);
     void setImpactData(bool d);
     void setImpactLat(double lat);
@@ -295,6 +309,7 @@ protected:
 private:
     int _refID;
     object_type _otype;
+    SimLOD _simLOD;
     bool _initialized = false;
     osg::ref_ptr<osg::LOD> _model;
     osg::ref_ptr<osg::PagedLOD> _low_res;
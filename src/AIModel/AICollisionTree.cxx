@@ -0,0 +1,197 @@
+/*
+ * SPDX-FileName: AICollisionTree.cxx
+ * SPDX-FileComment: bounding volume hierarchy over AI objects for projectile sweeps
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <config.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <simgear/constants.h>
+
+#include "AIBase.hxx"
+#include "AICollisionTree.hxx"
+
+namespace {
+
+const int MAX_LEAF_SIZE = 4;
+
+// slab test of the segment start + t * dir, 0 <= t <= tMax, against the box
+bool segmentHitsBox(const SGVec3d& start, const SGVec3d& dir, double tMax,
+                    const SGVec3d& boxMin, const SGVec3d& boxMax)
+{
+    double tNear = 0.0;
+    double tFar = tMax;
+    for (int axis = 0; axis < 3; ++axis) {
+        if (std::fabs(dir[axis]) < 1e-12) {
+            if ((start[axis] < boxMin[axis]) || (start[axis] > boxMax[axis])) {
+                return false;
+            }
+            continue;
+        }
+
+        double t1 = (boxMin[axis] - start[axis]) / dir[axis];
+        double t2 = (boxMax[axis] - start[axis]) / dir[axis];
+        if (t1 > t2) {
+            std::swap(t1, t2);
+        }
+        tNear = std::max(tNear, t1);
+        tFar = std::min(tFar, t2);
+        if (tNear > tFar) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // of anonymous namespace
+
+void FGAICollisionTree::clear()
+{
+    _entries.clear();
+    _nodes.clear();
+}
+
+void FGAICollisionTree::build(const std::vector<SGSharedPtr<FGAIBase>>& objects)
+{
+    clear();
+
+    for (const auto& object : objects) {
+        const auto type = object->getType();
+        if (object->getDie() || (type == FGAIBase::object_type::otBallistic) ||
+            (type == FGAIBase::object_type::otStorm) || (type == FGAIBase::object_type::otThermal)) {
+            continue;
+        }
+
+        Entry e;
+        e.object = object.get();
+        e.centre = object->getCartPos();
+        e.radiusM = object->getCollisionLength() * SG_FEET_TO_METER;
+        e.heightM = object->getCollisionHeight() * SG_FEET_TO_METER;
+        e.altitudeM = object->_getAltitude() * SG_FEET_TO_METER;
+        _entries.push_back(e);
+    }
+
+    if (!_entries.empty()) {
+        _nodes.reserve(2 * _entries.size() / MAX_LEAF_SIZE + 1);
+        buildNode(0, static_cast<int>(_entries.size()));
+    }
+}
+
+int FGAICollisionTree::buildNode(int first, int count)
+{
+    Node node;
+    node.min = SGVec3d(std::numeric_limits<double>::max(), std::numeric_limits<double>::max(),
+                       std::numeric_limits<double>::max());
+    node.max = -node.min;
+    for (int i = first; i < first + count; ++i) {
+        const SGVec3d r(_entries[i].radiusM, _entries[i].radiusM, _entries[i].radiusM);
+        node.min = min(node.min, _entries[i].centre - r);
+        node.max = max(node.max, _entries[i].centre + r);
+    }
+    node.first = first;
+    node.count = count;
+    node.left = node.right = -1;
+
+    const int index = static_cast<int>(_nodes.size());
+    _nodes.push_back(node);
+    if (count <= MAX_LEAF_SIZE) {
+        return index;
+    }
+
+    // split at the median of the longest axis
+    const SGVec3d extent = node.max - node.min;
+    int axis = 0;
+    if (extent[1] > extent[axis]) axis = 1;
+    if (extent[2] > extent[axis]) axis = 2;
+
+    const int half = count / 2;
+    std::nth_element(_entries.begin() + first, _entries.begin() + first + half,
+                     _entries.begin() + first + count,
+                     [axis](const Entry& a, const Entry& b) { return a.centre[axis] < b.centre[axis]; });
+
+    const int left = buildNode(first, half);
+    const int right = buildNode(first + half, count - half);
+    _nodes[index].first = -1;
+    _nodes[index].left = left;
+    _nodes[index].right = right;
+    return index;
+}
+
+const FGAIBase* FGAICollisionTree::intersect(const SGVec3d& start, const SGVec3d& end,
+                                             double fuseRangeFt, double& t) const
+{
+    if (_nodes.empty()) {
+        return nullptr;
+    }
+
+    const FGAIBase* best = nullptr;
+    double bestT = std::numeric_limits<double>::max();
+    intersectNode(0, start, end, fuseRangeFt * SG_FEET_TO_METER, bestT, best);
+    if (best) {
+        t = bestT;
+    }
+    return best;
+}
+
+void FGAICollisionTree::intersectNode(int index, const SGVec3d& start, const SGVec3d& end,
+                                      double fuseM, double& bestT, const FGAIBase*& best) const
+{
+    const Node& node = _nodes[index];
+    const SGVec3d dir = end - start;
+    const SGVec3d fuse(fuseM, fuseM, fuseM);
+    if (!segmentHitsBox(start, dir, std::min(1.0, bestT), node.min - fuse, node.max + fuse)) {
+        return;
+    }
+
+    if (node.first < 0) {
+        intersectNode(node.left, start, end, fuseM, bestT, best);
+        intersectNode(node.right, start, end, fuseM, bestT, best);
+        return;
+    }
+
+    const double len2 = dot(dir, dir);
+    for (int i = node.first; i < node.first + node.count; ++i) {
+        const Entry& e = _entries[i];
+        const double r = e.radiusM + fuseM;
+
+        // closest approach of the segment to the centre
+        double tClosest = 0.0;
+        if (len2 > 0.0) {
+            tClosest = SGMiscd::clip(dot(e.centre - start, dir) / len2, 0.0, 1.0);
+        }
+        const double d2 = distSqr(start + tClosest * dir, e.centre);
+        if (d2 >= r * r) {
+            continue;
+        }
+
+        // where the segment enters the sphere
+        double tEnter = tClosest;
+        if (len2 > 0.0) {
+            tEnter = std::max(0.0, tClosest - std::sqrt((r * r - d2) / len2));
+        }
+        if (tEnter >= bestT) {
+            continue;
+        }
+
+        // height limit as in FGAIManager::calcCollision, checked where the
+        // segment enters and where it is closest
+        const double heightLimit = e.heightM + fuseM;
+        double tHit = -1.0;
+        for (double candidate : {tEnter, tClosest}) {
+            const SGGeod p = SGGeod::fromCart(start + candidate * dir);
+            if (std::fabs(p.getElevationM() - e.altitudeM) <= heightLimit) {
+                tHit = candidate;
+                break;
+            }
+        }
+
+        if ((tHit >= 0.0) && (tHit < bestT)) {
+            bestT = tHit;
+            best = e.object;
+        }
+    }
+}
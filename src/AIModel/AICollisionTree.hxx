@@ -0,0 +1,68 @@
+/*
+ * SPDX-FileName: AICollisionTree.hxx
+ * SPDX-FileComment: bounding volume hierarchy over AI objects for projectile sweeps
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <simgear/math/SGMath.hxx>
+#include <simgear/structure/SGSharedPtr.hxx>
+
+class FGAIBase;
+
+/**
+ * Bounding volume hierarchy over the AI objects a projectile can collide
+ * with, rebuilt by FGAIManager once per frame when there are projectiles
+ * to test. Each object is a sphere of its collision length around its
+ * position, nodes are axis aligned boxes in earth centred coordinates.
+ *
+ * intersect() finds the first object hit by the segment a projectile
+ * travelled in the last frame, with the same height and length limits
+ * (plus fuse range) as FGAIManager::calcCollision.
+ */
+class FGAICollisionTree
+{
+public:
+    void clear();
+
+    /// objects of types which can't be hit are skipped
+    void build(const std::vector<SGSharedPtr<FGAIBase>>& objects);
+
+    /**
+     * @param fuseRangeFt added to the collision size of every object
+     * @param t on success, the fraction of the segment up to the hit
+     * @return the object hit first, or nullptr
+     */
+    const FGAIBase* intersect(const SGVec3d& start, const SGVec3d& end,
+                              double fuseRangeFt, double& t) const;
+
+    size_t size() const { return _entries.size(); }
+
+private:
+    struct Entry {
+        const FGAIBase* object;
+        SGVec3d centre;
+        double radiusM;
+        double heightM;
+        double altitudeM;
+    };
+
+    struct Node {
+        SGVec3d min;
+        SGVec3d max;
+        int first;      ///< leaves: range in _entries, inner nodes: first = -1
+        int count;
+        int left;
+        int right;
+    };
+
+    int buildNode(int first, int count);
+    void intersectNode(int index, const SGVec3d& start, const SGVec3d& end,
+                       double fuseM, double& bestT, const FGAIBase*& best) const;
+
+    std::vector<Entry> _entries;
+    std::vector<Node> _nodes;
+};
@@ -0,0 +1,213 @@
+/*
+ * SPDX-FileName: AIElevationCache.cxx
+ * SPDX-FileComment: shared ground elevation lookups for AI objects
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <config.h>
+
+#include <cmath>
+
+#include <simgear/constants.h>
+
+#include <Main/globals.hxx>
+#include <Scenery/scenery.hxx>
+
+#include "AIElevationCache.hxx"
+
+namespace {
+
+const double DEFAULT_CELL_SIZE_M = 4.0;
+// cells are square in degrees, so they get narrower towards the poles
+const double METERS_PER_DEGREE = 111120.0;
+const double PROBE_START_M = 10000.0;
+
+// valid entries are re-resolved after this time, the tile may have been
+// replaced by a different LOD in the meantime
+const double REFRESH_INTERVAL_S = 60.0;
+// cells without scenery are retried this often
+const double RETRY_INTERVAL_S = 2.0;
+// cells nobody asked for in this time are dropped
+const double EXPIRY_S = 120.0;
+const size_t MAX_RESOLVE_PER_FRAME = 200;
+
+bool sceneryElevation(const SGGeod& pos, double& elev, const simgear::BVHMaterial** material)
+{
+    FGScenery* scenery = globals->get_scenery();
+    return scenery && scenery->get_elevation_m(pos, elev, material, nullptr);
+}
+
+} // of anonymous namespace
+
+FGAIElevationCache::FGAIElevationCache(Resolver resolver) :
+    _resolver(resolver ? resolver : Resolver(sceneryElevation)),
+    _cellDeg(DEFAULT_CELL_SIZE_M / METERS_PER_DEGREE)
+{
+}
+
+FGAIElevationCache::~FGAIElevationCache() = default;
+
+void FGAIElevationCache::bind(SGPropertyNode* node)
+{
+    _node = node;
+    _enabledNode = node->getNode("enabled", true);
+    if (!_enabledNode->hasValue()) {
+        _enabledNode->setBoolValue(true);
+    }
+
+    const double cellSizeM = node->getDoubleValue("cell-size-m", DEFAULT_CELL_SIZE_M);
+    if (cellSizeM > 0.0) {
+        _cellDeg = cellSizeM / METERS_PER_DEGREE;
+        clear();
+    }
+
+    _lookupsNode = node->getNode("lookups", true);
+    _hitsNode = node->getNode("hits", true);
+    _missesNode = node->getNode("misses", true);
+    _bypassedNode = node->getNode("bypassed", true);
+    _hitRateNode = node->getNode("hit-rate", true);
+    _entriesNode = node->getNode("entries", true);
+    _queuedNode = node->getNode("queued", true);
+    _batchNode = node->getNode("batch-resolved", true);
+}
+
+void FGAIElevationCache::unbind()
+{
+    _node.clear();
+    _enabledNode.clear();
+    _lookupsNode.clear();
+    _hitsNode.clear();
+    _missesNode.clear();
+    _bypassedNode.clear();
+    _hitRateNode.clear();
+    _entriesNode.clear();
+    _queuedNode.clear();
+    _batchNode.clear();
+}
+
+uint64_t FGAIElevationCache::cellKey(const SGGeod& pos) const
+{
+    const uint64_t lat = static_cast<uint32_t>(std::floor((pos.getLatitudeDeg() + 90.0) / _cellDeg));
+    const uint64_t lon = static_cast<uint32_t>(std::floor((pos.getLongitudeDeg() + 180.0) / _cellDeg));
+    return (lat << 32) | lon;
+}
+
+SGGeod FGAIElevationCache::cellCentre(uint64_t key) const
+{
+    const double lat = ((key >> 32) + 0.5) * _cellDeg - 90.0;
+    const double lon = ((key & 0xffffffffu) + 0.5) * _cellDeg - 180.0;
+    return SGGeod::fromDegM(lon, lat, PROBE_START_M);
+}
+
+bool FGAIElevationCache::resolve(uint64_t key, Cell& cell)
+{
+    const simgear::BVHMaterial* material = nullptr;
+    double elev = 0.0;
+    cell.valid = _resolver(cellCentre(key), elev, &material);
+    cell.resolvedAt = _now;
+    if (cell.valid) {
+        cell.elevationM = elev;
+        cell.material = material;
+    }
+    return cell.valid;
+}
+
+bool FGAIElevationCache::getElevationM(const SGGeod& pos, double& elev,
+                                       const simgear::BVHMaterial** material)
+{
+    if (_enabledNode && !_enabledNode->getBoolValue()) {
+        ++_bypassed;
+        return _resolver(pos, elev, material);
+    }
+
+    ++_lookups;
+    const uint64_t key = cellKey(pos);
+    auto it = _cells.find(key);
+    if (it == _cells.end()) {
+        ++_misses;
+        it = _cells.emplace(key, Cell()).first;
+        resolve(key, it->second);
+    } else {
+        ++_hits;
+    }
+
+    Cell& cell = it->second;
+    cell.lastUsed = _now;
+
+    // the cached answer is only the same as a probe from pos if that
+    // starts above the ground; anything else (e.g. a ballistic object
+    // checking from just above itself) goes to the scenery directly
+    if (cell.valid && (pos.getElevationM() <= cell.elevationM)) {
+        ++_bypassed;
+        return _resolver(pos, elev, material);
+    }
+
+    const double age = _now - cell.resolvedAt;
+    if (!cell.queued && (age >= (cell.valid ? REFRESH_INTERVAL_S : RETRY_INTERVAL_S))) {
+        cell.queued = true;
+        _queue.push_back(key);
+    }
+
+    if (!cell.valid) {
+        return false;
+    }
+
+    elev = cell.elevationM;
+    if (material) {
+        *material = cell.material.get();
+    }
+    return true;
+}
+
+void FGAIElevationCache::update(double dt)
+{
+    _now += dt;
+
+    size_t resolved = 0;
+    size_t i = 0;
+    for (; (i < _queue.size()) && (resolved < MAX_RESOLVE_PER_FRAME); ++i) {
+        auto it = _cells.find(_queue[i]);
+        if (it == _cells.end()) {
+            continue;
+        }
+        it->second.queued = false;
+        resolve(it->first, it->second);
+        ++resolved;
+    }
+    _queue.erase(_queue.begin(), _queue.begin() + i);
+    _batchResolved += resolved;
+
+    // expire once per simulated second, not every frame
+    if (std::floor(_now) != std::floor(_now - dt)) {
+        for (auto it = _cells.begin(); it != _cells.end();) {
+            if (!it->second.queued && (_now - it->second.lastUsed > EXPIRY_S)) {
+                it = _cells.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    if (_node) {
+        _lookupsNode->setLongValue(static_cast<long>(_lookups));
+        _hitsNode->setLongValue(static_cast<long>(_hits));
+        _missesNode->setLongValue(static_cast<long>(_misses));
+        _bypassedNode->setLongValue(static_cast<long>(_bypassed));
+        _hitRateNode->setDoubleValue(hitRate());
+        _entriesNode->setIntValue(static_cast<int>(_cells.size()));
+        _queuedNode->setIntValue(static_cast<int>(_queue.size()));
+        _batchNode->setLongValue(static_cast<long>(_batchResolved));
+    }
+}
+
+void FGAIElevationCache::clear()
+{
+    _cells.clear();
+    _queue.clear();
+    _lookups = _hits = _misses = _bypassed = _batchResolved = 0;
+}
+
+double FGAIElevationCache::hitRate() const
+{
+    return _lookups ? static_cast<double>(_hits) / _lookups : 0.0;
+}
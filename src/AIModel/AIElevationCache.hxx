@@ -0,0 +1,98 @@
+/*
+ * SPDX-FileName: AIElevationCache.hxx
+ * SPDX-FileComment: shared ground elevation lookups for AI objects
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include <simgear/bvh/BVHMaterial.hxx>
+#include <simgear/math/SGGeod.hxx>
+#include <simgear/props/props.hxx>
+#include <simgear/structure/SGSharedPtr.hxx>
+
+/**
+ * Ground elevation service for all AI objects, owned by FGAIManager.
+ *
+ * Requests are quantized to small lat/lon cells; every cell remembers the
+ * terrain elevation and material found at its centre, so ground vehicles,
+ * ships, escorts and thermals at (nearly) the same spot share a single
+ * scenery intersection. A request for an unknown cell is resolved right
+ * away, because callers need an answer in the same frame. Entries which
+ * got old, and cells where the scenery wasn't loaded yet, are queued
+ * instead and re-resolved together in update(), once per frame, with the
+ * previous answer served in the meantime.
+ *
+ * Statistics are published below /sim/ai/elevation-cache.
+ */
+class FGAIElevationCache
+{
+public:
+    using Resolver = std::function<bool(const SGGeod&, double&, const simgear::BVHMaterial**)>;
+
+    /// @param resolver scenery query; defaults to FGScenery::get_elevation_m
+    explicit FGAIElevationCache(Resolver resolver = Resolver());
+    ~FGAIElevationCache();
+
+    void bind(SGPropertyNode* node);
+    void unbind();
+
+    /**
+     * Same contract as FGScenery::get_elevation_m: pos is the start of a
+     * vertical probe, its elevation must be above the terrain.
+     */
+    bool getElevationM(const SGGeod& pos, double& elev,
+                       const simgear::BVHMaterial** material);
+
+    /// resolve the queued cells and drop unused ones, once per frame
+    void update(double dt);
+
+    void clear();
+
+    size_t size() const { return _cells.size(); }
+    double hitRate() const;
+
+private:
+    struct Cell {
+        double elevationM = 0.0;
+        SGSharedPtr<const simgear::BVHMaterial> material;
+        double resolvedAt = 0.0;
+        double lastUsed = 0.0;
+        bool valid = false;
+        bool queued = false;
+    };
+
+    uint64_t cellKey(const SGGeod& pos) const;
+    SGGeod cellCentre(uint64_t key) const;
+    bool resolve(uint64_t key, Cell& cell);
+
+    Resolver _resolver;
+    std::unordered_map<uint64_t, Cell> _cells;
+    std::vector<uint64_t> _queue;
+
+    double _cellDeg;
+    double _now = 0.0;
+
+    // statistics since the last clear()
+    uint64_t _lookups = 0;
+    uint64_t _hits = 0;
+    uint64_t _misses = 0;
+    uint64_t _bypassed = 0;
+    uint64_t _batchResolved = 0;
+
+    SGPropertyNode_ptr _node;
+    SGPropertyNode_ptr _enabledNode;
+    SGPropertyNode_ptr _lookupsNode;
+    SGPropertyNode_ptr _hitsNode;
+    SGPropertyNode_ptr _missesNode;
+    SGPropertyNode_ptr _bypassedNode;
+    SGPropertyNode_ptr _hitRateNode;
+    SGPropertyNode_ptr _entriesNode;
+    SGPropertyNode_ptr _queuedNode;
+    SGPropertyNode_ptr _batchNode;
+};
@@ -175,7 +175,7 @@ bool FGAIEscort::getGroundElev(SGGeod inpos) {
     double height_m ;
 
     const simgear::BVHMaterial* mat = 0;
-    if (globals->get_scenery()->get_elevation_m(SGGeod::fromGeodM(inpos, 3000), height_m, &mat, 0)){
+    if (getGroundElevationM(SGGeod::fromGeodM(inpos, 3000), height_m, &mat)){
         const SGMaterial* material = dynamic_cast<const SGMaterial*>(mat);
         _ht_agl_ft = inpos.getElevationFt() - height_m * SG_METER_TO_FEET;
 
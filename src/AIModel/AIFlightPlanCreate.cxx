@@ -693,7 +693,7 @@ bool FGAIFlightPlan::createClimb(FGAIAircraft* ac, bool firstFlight,
                                  double speed, double alt,
                                  const string& fltType)
 {
-    double vClimb = ac->getPerformance()->vClimb();
+    const PerformanceData* perf = ac->getPerformance();
 
     if (firstFlight) {
         const string& rwyClass = getRunwayClassFromTrafficType(fltType);
@@ -723,24 +723,25 @@ bool FGAIFlightPlan::createClimb(FGAIAircraft* ac, bool firstFlight,
 
         if (fabs(headingDiffRunway) < 10) {
             SGGeod climb1 = SGGeodesy::direct(cur, course, 10 * SG_NM_TO_METER);
-            FGAIWaypoint* wpt = createInAir(ac, "10000ft climb", climb1, 10000, vClimb);
+            FGAIWaypoint* wpt = createInAir(ac, "10000ft climb", climb1, 10000, perf->climbSpeedAt(10000));
             pushBackWaypoint(wpt);
 
             SGGeod climb2 = SGGeodesy::direct(cur, course, 20 * SG_NM_TO_METER);
-            wpt = createInAir(ac, "18000ft climb", climb2, 18000, vClimb);
+            wpt = createInAir(ac, "18000ft climb", climb2, 18000, perf->climbSpeedAt(18000));
             pushBackWaypoint(wpt);
         } else {
-            double initialTurnRadius = getTurnRadius(vClimb, true);
+            double vClimb5000 = perf->climbSpeedAt(5000);
+            double initialTurnRadius = perf->turnRadius(vClimb5000);
             SGGeod climb1 = SGGeodesy::direct(cur, runway->headingDeg(), 5 * SG_NM_TO_METER);
-            FGAIWaypoint* wpt = createInAir(ac, "5000ft climb", climb1, 5000, vClimb);
+            FGAIWaypoint* wpt = createInAir(ac, "5000ft climb", climb1, 5000, vClimb5000);
             pushBackWaypoint(wpt);
             int rightAngle = headingDiffRunway > 0 ? 90 : -90;
             int firstTurnIncrement = headingDiffRunway > 0 ? 2 : -2;
 
             SGGeod firstTurnCenter = SGGeodesy::direct(climb1, ac->getTrueHeadingDeg() + rightAngle, initialTurnRadius);
-            createArc(ac, firstTurnCenter, ac->_getHeading() - rightAngle, course - rightAngle, firstTurnIncrement, initialTurnRadius, 5000, 100, vClimb, "climb-out%03d");
+            createArc(ac, firstTurnCenter, ac->_getHeading() - rightAngle, course - rightAngle, firstTurnIncrement, initialTurnRadius, 5000, 100, vClimb5000, "climb-out%03d");
             SGGeod climb2 = SGGeodesy::direct(cur, course, 20 * SG_NM_TO_METER);
-            wpt = createInAir(ac, "18000ft climb", waypoints.back()->getPos(), 18000, vClimb);
+            wpt = createInAir(ac, "18000ft climb", waypoints.back()->getPos(), 18000, perf->climbSpeedAt(18000));
             pushBackWaypoint(wpt);
         }
     }
@@ -791,7 +792,7 @@ bool FGAIFlightPlan::createDescent(FGAIAircraft* ac,
 
     // depending on entry we differ approach (teardrop/direct/parallel)
 
-    double initialTurnRadius = getTurnRadius(vDescent, true);
+    double initialTurnRadius = ac->getPerformance()->turnRadius(vDescent);
     //double finalTurnRadius = getTurnRadius(vApproach, true);
 
     // get length of the downwind leg for the intended runway
@@ -966,7 +967,7 @@ bool FGAIFlightPlan::createHold(FGAIAircraft* ac,
     const string& rwyClass = getRunwayClassFromTrafficType(fltType);
     double vDescent = ac->getPerformance()->vDescent();
     // double vApproach = ac->getPerformance()->vApproach();
-    double initialTurnRadius = getTurnRadius(vDescent, true);
+    double initialTurnRadius = ac->getPerformance()->turnRadius(vDescent);
     double dHeading = ac->getTrueHeadingDeg();
     apt->getDynamics()->getActiveRunway(rwyClass, 2, activeRunway,
                                         dHeading);
@@ -0,0 +1,126 @@
+/*
+ * SPDX-FileName: AIFlightPlanQueue.cxx
+ * SPDX-FileComment: deferred flight plan generation for spawning AI traffic
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <config.h>
+
+#include <algorithm>
+
+#include <simgear/debug/logstream.hxx>
+
+#include "AIAircraft.hxx"
+#include "AIFlightPlan.hxx"
+#include "AIFlightPlanQueue.hxx"
+
+namespace {
+
+const double DEFAULT_BUDGET_MS = 4.0;
+// weight of the latest job in the running mean
+const double MEAN_WEIGHT = 0.1;
+
+} // of anonymous namespace
+
+FGAIFlightPlanQueue::FGAIFlightPlanQueue() : _budgetMs(DEFAULT_BUDGET_MS)
+{
+}
+
+FGAIFlightPlanQueue::~FGAIFlightPlanQueue() = default;
+
+void FGAIFlightPlanQueue::bind(SGPropertyNode* node)
+{
+    _node = node;
+    _budgetNode = node->getNode("budget-ms", true);
+    if (!_budgetNode->hasValue()) {
+        _budgetNode->setDoubleValue(DEFAULT_BUDGET_MS);
+    }
+
+    _depthNode = node->getNode("depth", true);
+    _builtNode = node->getNode("built", true);
+    _droppedNode = node->getNode("dropped", true);
+    _latencyNode = node->getNode("latency-ms", true);
+    _meanLatencyNode = node->getNode("mean-latency-ms", true);
+    _maxLatencyNode = node->getNode("max-latency-ms", true);
+    _buildTimeNode = node->getNode("build-time-ms", true);
+}
+
+void FGAIFlightPlanQueue::unbind()
+{
+    _node.clear();
+    _budgetNode.clear();
+    _depthNode.clear();
+    _builtNode.clear();
+    _droppedNode.clear();
+    _latencyNode.clear();
+    _meanLatencyNode.clear();
+    _maxLatencyNode.clear();
+    _buildTimeNode.clear();
+}
+
+void FGAIFlightPlanQueue::push(FGAIAircraft* aircraft, Builder builder, Completion done)
+{
+    Job job;
+    job.aircraft = aircraft;
+    job.builder = std::move(builder);
+    job.done = std::move(done);
+    job.queued.stamp();
+    _jobs.push_back(std::move(job));
+}
+
+void FGAIFlightPlanQueue::update()
+{
+    if (_budgetNode) {
+        _budgetMs = _budgetNode->getDoubleValue();
+    }
+
+    SGTimeStamp frameStart;
+    frameStart.stamp();
+
+    bool first = true;
+    while (!_jobs.empty() && (first || ((frameStart.elapsedUSec() / 1000.0) < _budgetMs))) {
+        // the completion may queue further jobs, so take this one out first
+        Job job = std::move(_jobs.front());
+        _jobs.pop_front();
+
+        if (job.aircraft->getDie()) {
+            ++_dropped;
+            continue;
+        }
+
+        first = false;
+        SGTimeStamp buildStart;
+        buildStart.stamp();
+        std::unique_ptr<FGAIFlightPlan> plan = job.builder();
+        _lastBuildMs = buildStart.elapsedUSec() / 1000.0;
+
+        _lastLatencyMs = job.queued.elapsedUSec() / 1000.0;
+        _meanLatencyMs = (_built == 0) ? _lastLatencyMs :
+                                         (1.0 - MEAN_WEIGHT) * _meanLatencyMs + MEAN_WEIGHT * _lastLatencyMs;
+        _maxLatencyMs = std::max(_maxLatencyMs, _lastLatencyMs);
+        ++_built;
+
+        SG_LOG(SG_AI, SG_DEBUG, "AI flight plan for " << job.aircraft->getCallSign() << " built in "
+                                << _lastBuildMs << "msec, " << _lastLatencyMs << "msec after it was queued");
+        job.done(std::move(plan));
+    }
+
+    if (_node) {
+        _depthNode->setIntValue(static_cast<int>(_jobs.size()));
+        _builtNode->setLongValue(static_cast<long>(_built));
+        _droppedNode->setLongValue(static_cast<long>(_dropped));
+        _latencyNode->setDoubleValue(_lastLatencyMs);
+        _meanLatencyNode->setDoubleValue(_meanLatencyMs);
+        _maxLatencyNode->setDoubleValue(_maxLatencyMs);
+        _buildTimeNode->setDoubleValue(_lastBuildMs);
+    }
+}
+
+void FGAIFlightPlanQueue::clear()
+{
+    for (auto& job : _jobs) {
+        job.aircraft->setDie(true);
+        ++_dropped;
+    }
+    _jobs.clear();
+}
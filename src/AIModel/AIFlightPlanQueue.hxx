@@ -0,0 +1,91 @@
+/*
+ * SPDX-FileName: AIFlightPlanQueue.hxx
+ * SPDX-FileComment: deferred flight plan generation for spawning AI traffic
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <memory>
+
+#include <simgear/props/props.hxx>
+#include <simgear/structure/SGSharedPtr.hxx>
+#include <simgear/timing/timestamp.hxx>
+
+class FGAIAircraft;
+class FGAIFlightPlan;
+
+/**
+ * Job queue for the flight plans of AI aircraft which are about to be
+ * spawned, owned by FGAIManager.
+ *
+ * Creating a plan means taxi route searches in the groundnet, runway and
+ * parking allocation and SID/STAR lookups; when the traffic manager
+ * activates a wave of departures, doing all of that at once causes a
+ * visible hitch. Instead, the caller queues a builder for each aircraft
+ * and the queue runs as many builders per frame as fit into a time budget
+ * (at least one, so the queue always drains). The aircraft is only
+ * attached by the completion callback, once its plan exists.
+ *
+ * Builders should capture what they need by value when they are queued:
+ * they run in a later frame.
+ *
+ * Jobs of aircraft which died while waiting are dropped without calling
+ * either function.
+ *
+ * Statistics are published below /sim/ai/flightplan-queue.
+ */
+class FGAIFlightPlanQueue
+{
+public:
+    using Builder = std::function<std::unique_ptr<FGAIFlightPlan>()>;
+    using Completion = std::function<void(std::unique_ptr<FGAIFlightPlan>)>;
+
+    FGAIFlightPlanQueue();
+    ~FGAIFlightPlanQueue();
+
+    void bind(SGPropertyNode* node);
+    void unbind();
+
+    void push(FGAIAircraft* aircraft, Builder builder, Completion done);
+
+    /// run the queued jobs which fit into this frame's budget
+    void update();
+
+    /**
+     * drop all pending jobs, marking their aircraft as dead: whoever queued
+     * them (the traffic schedules) then knows they will never be attached
+     */
+    void clear();
+
+    size_t size() const { return _jobs.size(); }
+
+private:
+    struct Job {
+        SGSharedPtr<FGAIAircraft> aircraft;
+        Builder builder;
+        Completion done;
+        SGTimeStamp queued;
+    };
+    std::deque<Job> _jobs;
+
+    double _budgetMs;
+    unsigned long _built = 0;
+    unsigned long _dropped = 0;
+    double _lastLatencyMs = 0.0;
+    double _meanLatencyMs = 0.0;
+    double _maxLatencyMs = 0.0;
+    double _lastBuildMs = 0.0;
+
+    SGPropertyNode_ptr _node;
+    SGPropertyNode_ptr _budgetNode;
+    SGPropertyNode_ptr _depthNode;
+    SGPropertyNode_ptr _builtNode;
+    SGPropertyNode_ptr _droppedNode;
+    SGPropertyNode_ptr _latencyNode;
+    SGPropertyNode_ptr _meanLatencyNode;
+    SGPropertyNode_ptr _maxLatencyNode;
+    SGPropertyNode_ptr _buildTimeNode;
+};
@@ -222,14 +222,14 @@ bool FGAIGroundVehicle::getPitch() {
         double elev_front = 0;
         double elev_rear = 0;
 
-        if (globals->get_scenery()->get_elevation_m(SGGeod::fromGeodM(geodFront, 3000),
-            elev_front, NULL, 0)){
+        if (getGroundElevationM(SGGeod::fromGeodM(geodFront, 3000),
+            elev_front, nullptr)){
                 front_elev_m = elev_front + _z_offset_m;
         } else
             return false;
 
-        if (globals->get_scenery()->get_elevation_m(SGGeod::fromGeodM(geodRear, 3000),
-            elev_rear, NULL, 0)){
+        if (getGroundElevationM(SGGeod::fromGeodM(geodRear, 3000),
+            elev_rear, nullptr)){
                 rear_elev_m = elev_rear;
         } else
             return false;
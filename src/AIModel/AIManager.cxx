@@ -21,11 +21,15 @@
 #include <Main/fg_props.hxx>
 #include <Main/globals.hxx>
 #include <Main/sentryIntegration.hxx>
+#include <Scenery/scenery.hxx>
 #include <Scripting/NasalSys.hxx>
 
 #include "AIAircraft.hxx"
 #include "AIBallistic.hxx"
 #include "AICarrier.hxx"
+#include "AIElevationCache.hxx"
+#include "AIFlightPlanQueue.hxx"
+#include "AIModelLoader.hxx"
 #include "AIEscort.hxx"
 #include "AIGroundVehicle.hxx"
 #include "AIManager.hxx"
@@ -40,6 +44,20 @@
 
 static bool static_haveRegisteredScenarios = false;
 
+namespace {
+
+// defaults for the simulation LOD, see FGAIManager::updateDue
+const double LOD_NEAR_RANGE_NM = 10.0;
+const double LOD_FAR_RANGE_NM = 40.0;
+const double LOD_HYSTERESIS_NM = 1.0;
+const double LOD_MEDIUM_INTERVAL_SEC = 0.25;
+const double LOD_FAR_INTERVAL_SEC = 1.0;
+// objects of this size (ft) use the ranges as they are; larger ones look
+// bigger on screen and keep their detail further out
+const double LOD_REFERENCE_SIZE_FT = 100.0;
+
+} // of anonymous namespace
+
 class FGAIManager::Scenario
 {
 public:
@@ -137,6 +155,33 @@ void FGAIManager::init()
     _environmentVisiblity = fgGetNode("/environment/visibility-m");
     _groundSpeedKts_node = fgGetNode("/velocities/groundspeed-kt", true);
 
+    _elevationCache.reset(new FGAIElevationCache);
+    _elevationCache->bind(fgGetNode("/sim/ai/elevation-cache", true));
+
+    _flightPlanQueue.reset(new FGAIFlightPlanQueue);
+    _flightPlanQueue->bind(fgGetNode("/sim/ai/flightplan-queue", true));
+
+    _modelLoader.reset(new FGAIModelLoader);
+    _modelLoader->bind(fgGetNode("/sim/ai/model-loader", true));
+
+    _updateLODNode = fgGetNode("/sim/ai/update-lod", true);
+    auto initLOD = [this](const char* name, double value) {
+        SGPropertyNode* n = _updateLODNode->getNode(name, true);
+        if (!n->hasValue()) {
+            n->setDoubleValue(value);
+        }
+    };
+    // off unless asked for: the reduced rates change how distant traffic
+    // and scenario objects behave
+    if (!_updateLODNode->hasChild("enabled")) {
+        _updateLODNode->setBoolValue("enabled", false);
+    }
+    initLOD("near-range-nm", LOD_NEAR_RANGE_NM);
+    initLOD("far-range-nm", LOD_FAR_RANGE_NM);
+    initLOD("hysteresis-nm", LOD_HYSTERESIS_NM);
+    initLOD("medium-interval-sec", LOD_MEDIUM_INTERVAL_SEC);
+    initLOD("far-interval-sec", LOD_FAR_INTERVAL_SEC);
+
     // Create an (invisible) AIAircraft representation of the current
     // users's aircraft, that mimicks the user aircraft's behavior.
 
@@ -305,8 +350,28 @@ void FGAIManager::shutdown()
     }
 
     ai_list.clear();
+    _updateLODNode.clear();
+    _sweeps.clear();
+    _collisionTree.clear();
     _environmentVisiblity.clear();
 
+    if (_elevationCache) {
+        _elevationCache->unbind();
+        _elevationCache.reset();
+    }
+
+    if (_flightPlanQueue) {
+        // the schedules of aircraft still waiting for their plan let go of them
+        _flightPlanQueue->clear();
+        _flightPlanQueue->unbind();
+        _flightPlanQueue.reset();
+    }
+
+    if (_modelLoader) {
+        _modelLoader->unbind();
+        _modelLoader.reset();
+    }
+
     if (_userAircraft) {
         _userAircraft->setDie(true);
         // we can't unbind() but we do need to clear these
@@ -341,6 +406,10 @@ void FGAIManager::removeDeadItem(FGAIBase* base)
     props->setBoolValue("valid", false);
     base->unbind();
 
+    if (_modelLoader) {
+        _modelLoader->release(base);
+    }
+
     // for backward compatibility reset properties, so that aircraft,
     // which don't know the <valid> property, keep working
     // TODO: remove after a while
@@ -376,15 +445,34 @@ void FGAIManager::update(double dt)
 
     ai_list.erase(ai_list.begin(), firstAlive);
 
+    // build the plans of waiting aircraft; completed ones get attached,
+    // so this has to happen before iterating the list
+    if (_flightPlanQueue) {
+        _flightPlanQueue->update();
+    }
+
+    // after the queue, so freshly attached aircraft can be admitted
+    if (_modelLoader) {
+        _modelLoader->update(dt, globals->get_view_position_cart());
+    }
+
+    readUpdateLODConfig();
+    const SGVec3d userCart = globals->get_aircraft_position_cart();
+
     // every remaining item is alive. update them in turn, but guard for
     // exceptions, so a single misbehaving AI object doesn't bring down the
     // entire subsystem.
     for (FGAIBase* base : ai_list) {
         try {
+            double updateDt = dt;
+            if (!updateDue(base, userCart, dt, updateDt)) {
+                continue;
+            }
+
             if (base->isa(FGAIBase::object_type::otThermal)) {
-                processThermal(dt, static_cast<FGAIThermal*>(base));
+                processThermal(updateDt, static_cast<FGAIThermal*>(base));
             } else {
-                base->update(dt);
+                base->update(updateDt);
             }
         } catch (sg_exception& e) {
             SG_LOG(SG_AI, SG_WARN, "caught exception updating AI model:" << base->_getName() << ", which will be killed."
@@ -394,9 +482,158 @@ void FGAIManager::update(double dt)
         }
     }                                            // of live AI objects iteration
 
+    processSweeps();
+    publishUpdateLODStats();
+
+    // refresh the elevations the AI objects asked for this frame
+    if (_elevationCache) {
+        _elevationCache->update(dt);
+    }
+
     thermal_lift_node->setDoubleValue(strength); // for thermals
 }
 
+void FGAIManager::readUpdateLODConfig()
+{
+    for (int& count : _lodCount) {
+        count = 0;
+    }
+
+    if (!_updateLODNode) {
+        _updateLODEnabled = false;
+        return;
+    }
+
+    _updateLODEnabled = _updateLODNode->getBoolValue("enabled");
+    _lodNearRangeNm = _updateLODNode->getDoubleValue("near-range-nm");
+    _lodFarRangeNm = std::max(_lodNearRangeNm, _updateLODNode->getDoubleValue("far-range-nm"));
+    _lodHysteresisNm = _updateLODNode->getDoubleValue("hysteresis-nm");
+    _lodInterval[LOD_NEAR] = 0.0;
+    _lodInterval[LOD_MEDIUM] = _updateLODNode->getDoubleValue("medium-interval-sec");
+    _lodInterval[LOD_FAR] = _updateLODNode->getDoubleValue("far-interval-sec");
+    _lodInterval[LOD_EXEMPT] = 0.0;
+}
+
+void FGAIManager::publishUpdateLODStats()
+{
+    if (!_updateLODNode) {
+        return;
+    }
+
+    _updateLODNode->setIntValue("near-count", _lodCount[LOD_NEAR]);
+    _updateLODNode->setIntValue("medium-count", _lodCount[LOD_MEDIUM]);
+    _updateLODNode->setIntValue("far-count", _lodCount[LOD_FAR]);
+    _updateLODNode->setIntValue("exempt-count", _lodCount[LOD_EXEMPT]);
+    _updateLODNode->setLongValue("updates", static_cast<long>(_lodUpdates));
+    _updateLODNode->setLongValue("skipped", static_cast<long>(_lodSkipped));
+}
+
+bool FGAIManager::updateDue(FGAIBase* base, const SGVec3d& userCart, double dt, double& updateDt)
+{
+    FGAIBase::SimLOD& lod = base->simLOD();
+
+    // objects which interact with the user, or whose state comes from
+    // elsewhere, always run every frame
+    const auto type = base->getType();
+    const bool exempt = !_updateLODEnabled || (type == FGAIBase::object_type::otBallistic) ||
+                        (type == FGAIBase::object_type::otCarrier) ||
+                        (type == FGAIBase::object_type::otMultiplayer) ||
+                        (type == FGAIBase::object_type::otThermal) ||
+                        (type == FGAIBase::object_type::otStorm);
+    if (exempt) {
+        updateDt = dt + lod.pendingDt;
+        lod.pendingDt = 0.0;
+        lod.tier = LOD_NEAR;
+        ++_lodCount[LOD_EXEMPT];
+        ++_lodUpdates;
+        return true;
+    }
+
+    // distance scaled by the size of the object, i.e. by its size on screen
+    const double size = SGMiscd::clip(base->getCollisionLength() / LOD_REFERENCE_SIZE_FT, 0.5, 4.0);
+    const double rangeNm = dist(userCart, base->getCartPos()) * SG_METER_TO_NM / size;
+
+    // move by one tier at a time, and only once past the hysteresis band
+    int tier = lod.tier;
+    const double bounds[] = {_lodNearRangeNm, _lodFarRangeNm};
+    if ((tier < LOD_FAR) && (rangeNm > bounds[tier] + _lodHysteresisNm)) {
+        ++tier;
+    } else if ((tier > LOD_NEAR) && (rangeNm < bounds[tier - 1] - _lodHysteresisNm)) {
+        --tier;
+    }
+
+    lod.pendingDt += dt;
+    const bool promoted = tier < lod.tier;
+    lod.tier = tier;
+    ++_lodCount[tier];
+
+    if (!promoted && (lod.pendingDt < _lodInterval[tier])) {
+        ++_lodSkipped;
+        return false;
+    }
+
+    updateDt = lod.pendingDt;
+    lod.pendingDt = 0.0;
+    ++_lodUpdates;
+    return true;
+}
+
+void FGAIManager::queueSweep(FGAIBallistic* ballistic, const SGVec3d& from, const SGVec3d& to)
+{
+    _sweeps.push_back({ballistic, from, to});
+}
+
+void FGAIManager::processSweeps()
+{
+    if (_sweeps.empty()) {
+        return;
+    }
+
+    // one tree for all projectiles of this frame, and only if one of them
+    // can actually hit something
+    const bool needTree = std::any_of(_sweeps.begin(), _sweeps.end(), [](const Sweep& s) {
+        return s.ballistic->needsCollisionCheck();
+    });
+    if (needTree) {
+        _collisionTree.build(ai_list);
+    }
+
+    FGScenery* scenery = globals->get_scenery();
+    for (const Sweep& s : _sweeps) {
+        FGAIBallistic* ballistic = s.ballistic.get();
+        if (ballistic->getDie()) {
+            continue;
+        }
+
+        const SGVec3d segment = s.to - s.from;
+        const double length = norm(segment);
+
+        const FGAIBase* object = nullptr;
+        double objectT = 2.0;
+        if (needTree && ballistic->needsCollisionCheck()) {
+            object = _collisionTree.intersect(s.from, s.to, ballistic->getFuseRangeFt(), objectT);
+        }
+
+        SGVec3d terrainHit;
+        double terrainT = 2.0;
+        if (scenery && ballistic->needsImpactCheck() && (length > 0.0) &&
+            scenery->get_cart_segment_intersection(s.from, s.to, terrainHit, nullptr)) {
+            terrainT = norm(terrainHit - s.from) / length;
+        }
+
+        if (object && (objectT <= terrainT)) {
+            ballistic->handleSweepHit(s.from + objectT * segment, object);
+        } else if (terrainT <= 1.0) {
+            ballistic->handleSweepHit(terrainHit, nullptr);
+        } else {
+            ballistic->handleSweepMiss();
+        }
+    }
+
+    _sweeps.clear();
+    _collisionTree.clear();
+}
+
 /** update LOD settings of all AI/MP models */
 void FGAIManager::updateLOD(SGPropertyNode* node)
 {
@@ -9,6 +9,8 @@
 
 #include <list>
 #include <map>
+#include <memory>
+#include <vector>
 
 #include <simgear/math/SGVec3.hxx>
 #include <simgear/misc/sg_path.hxx>
@@ -16,9 +18,15 @@
 #include <simgear/structure/SGSharedPtr.hxx>
 #include <simgear/structure/subsystem_mgr.hxx>
 
+#include "AICollisionTree.hxx"
+
 class FGAIBase;
+class FGAIBallistic;
 class FGAIThermal;
 class FGAIAircraft;
+class FGAIElevationCache;
+class FGAIFlightPlanQueue;
+class FGAIModelLoader;
 
 typedef SGSharedPtr<FGAIBase> FGAIBasePtr;
 
@@ -45,6 +53,14 @@ public:
 
     const FGAIBase* calcCollision(double alt, double lat, double lon, double fuse_range);
 
+    /**
+     * @brief test the segment a ballistic object travelled in this frame
+     * against the terrain and the other AI objects. All queued segments are
+     * processed together after the AI objects were updated, and the result
+     * is reported via FGAIBallistic::handleSweepHit / handleSweepMiss.
+     */
+    void queueSweep(FGAIBallistic* ballistic, const SGVec3d& from, const SGVec3d& to);
+
     inline double get_user_heading() const { return user_heading; }
     inline double get_user_pitch() const { return user_pitch; }
     inline double get_user_speed() const { return user_speed; }
@@ -104,6 +120,30 @@ public:
         return _radarRangeM;
     }
 
+    /**
+     * @brief shared ground elevation lookups, see FGAIBase::getGroundElevationM
+     */
+    FGAIElevationCache* getElevationCache() const
+    {
+        return _elevationCache.get();
+    }
+
+    /**
+     * @brief deferred flight plan generation for aircraft about to spawn
+     */
+    FGAIFlightPlanQueue* getFlightPlanQueue() const
+    {
+        return _flightPlanQueue.get();
+    }
+
+    /**
+     * @brief distance ordered admission of models into the scene graph
+     */
+    FGAIModelLoader* getModelLoader() const
+    {
+        return _modelLoader.get();
+    }
+
 private:
     // FGSubmodelMgr is a friend for access to the AI_list
     friend class FGSubmodelMgr;
@@ -154,6 +194,32 @@ private:
     double strength = 0.0;
     void processThermal(double dt, FGAIThermal* thermal);
 
+    // simulation LOD: which objects get updated in this frame
+    enum { LOD_NEAR = 0, LOD_MEDIUM, LOD_FAR, LOD_EXEMPT, LOD_TIERS };
+    bool updateDue(FGAIBase* base, const SGVec3d& userCart, double dt, double& updateDt);
+    void readUpdateLODConfig();
+    void publishUpdateLODStats();
+
+    SGPropertyNode_ptr _updateLODNode;
+    bool _updateLODEnabled = false;
+    double _lodNearRangeNm = 0.0;
+    double _lodFarRangeNm = 0.0;
+    double _lodHysteresisNm = 0.0;
+    double _lodInterval[LOD_TIERS] = {};
+    int _lodCount[LOD_TIERS] = {};
+    unsigned long _lodUpdates = 0;
+    unsigned long _lodSkipped = 0;
+
+    // swept impact and collision tests of ballistic objects
+    struct Sweep {
+        SGSharedPtr<FGAIBallistic> ballistic;
+        SGVec3d from;
+        SGVec3d to;
+    };
+    std::vector<Sweep> _sweeps;
+    FGAICollisionTree _collisionTree;
+    void processSweeps();
+
     SGPropertyChangeCallback<FGAIManager> cb_ai_bare;
     SGPropertyChangeCallback<FGAIManager> cb_ai_detailed;
     SGPropertyChangeCallback<FGAIManager> cb_interior;
@@ -169,4 +235,8 @@ private:
     bool _radarEnabled = true,
          _radarDebugMode = false;
     double _radarRangeM = 0.0;
+
+    std::unique_ptr<FGAIElevationCache> _elevationCache;
+    std::unique_ptr<FGAIFlightPlanQueue> _flightPlanQueue;
+    std::unique_ptr<FGAIModelLoader> _modelLoader;
 };
@@ -0,0 +1,270 @@
+/*
+ * SPDX-FileName: AIModelLoader.cxx
+ * SPDX-FileComment: distance ordered, concurrency limited model loading for AI objects
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <config.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include <osg/LOD>
+
+#include <simgear/debug/logstream.hxx>
+
+#include <Main/fg_props.hxx>
+
+#include "AIBase.hxx"
+#include "AIModelLoader.hxx"
+
+namespace {
+
+const int DEFAULT_MAX_CONCURRENT = 4;
+// a model which isn't in by then gives up its slot
+const double DEFAULT_TIMEOUT_S = 10.0;
+
+/**
+ * whether the LOD of an object selects any child at a distance from the
+ * viewer: the pager only loads the paged children it reaches. Pixel size
+ * ranges are estimated from the bounding radius and the current view.
+ */
+bool withinLODRange(const osg::LOD* lod, double distanceM)
+{
+    if (!lod) {
+        return false;
+    }
+
+    double range = distanceM;
+    if (lod->getRangeMode() == osg::LOD::PIXEL_SIZE_ON_SCREEN) {
+        const double fovDeg = fgGetDouble("/sim/current-view/field-of-view", 55.0);
+        const double heightPx = fgGetDouble("/sim/startup/ysize", 768.0);
+        const double halfFov = std::max(0.01, 0.5 * fovDeg * SG_DEGREES_TO_RADIANS);
+        range = (lod->getRadius() * heightPx) / (std::max(1.0, distanceM) * 2.0 * tan(halfFov));
+    }
+
+    for (unsigned int i = 0; i < lod->getNumRanges(); ++i) {
+        if ((range >= lod->getMinRange(i)) && (range < lod->getMaxRange(i))) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+} // of anonymous namespace
+
+FGAIModelLoader::FGAIModelLoader() : _maxConcurrent(DEFAULT_MAX_CONCURRENT),
+                                     _timeoutS(DEFAULT_TIMEOUT_S)
+{
+}
+
+FGAIModelLoader::~FGAIModelLoader() = default;
+
+void FGAIModelLoader::bind(SGPropertyNode* node)
+{
+    _node = node;
+    _enabledNode = node->getNode("enabled", true);
+    if (!_enabledNode->hasValue()) {
+        _enabledNode->setBoolValue(true);
+    }
+    _maxConcurrentNode = node->getNode("max-concurrent", true);
+    if (!_maxConcurrentNode->hasValue()) {
+        _maxConcurrentNode->setIntValue(DEFAULT_MAX_CONCURRENT);
+    }
+    _timeoutNode = node->getNode("timeout-sec", true);
+    if (!_timeoutNode->hasValue()) {
+        _timeoutNode->setDoubleValue(DEFAULT_TIMEOUT_S);
+    }
+
+    _pendingNode = node->getNode("pending", true);
+    _loadingNode = node->getNode("loading", true);
+    _cachedPathsNode = node->getNode("cached-paths", true);
+    _admittedNode = node->getNode("admitted", true);
+    _cacheHitsNode = node->getNode("cache-hits", true);
+    _timeoutsNode = node->getNode("timeouts", true);
+}
+
+void FGAIModelLoader::unbind()
+{
+    _node.clear();
+    _enabledNode.clear();
+    _maxConcurrentNode.clear();
+    _timeoutNode.clear();
+    _pendingNode.clear();
+    _loadingNode.clear();
+    _cachedPathsNode.clear();
+    _admittedNode.clear();
+    _cacheHitsNode.clear();
+    _timeoutsNode.clear();
+}
+
+void FGAIModelLoader::enqueue(FGAIBase* object, const std::string& path)
+{
+    auto known = _paths.find(object);
+    if (known != _paths.end()) {
+        if (known->second == path) {
+            // already queued or attached
+            return;
+        }
+
+        // a new model for the object replaces the earlier request
+        release(object);
+    }
+
+    _paths[object] = path;
+    Model& model = _models[path];
+    ++model.users;
+
+    Request request;
+    request.object = object;
+    request.path = path;
+    if (_enabledNode && !_enabledNode->getBoolValue()) {
+        admit(request, model, false);
+        return;
+    }
+    _pending.push_back(std::move(request));
+}
+
+void FGAIModelLoader::release(FGAIBase* object)
+{
+    auto it = _paths.find(object);
+    if (it == _paths.end()) {
+        return;
+    }
+
+    const std::string path = it->second;
+    _paths.erase(it);
+
+    _pending.erase(std::remove_if(_pending.begin(), _pending.end(),
+                                  [object](const Request& r) { return r.object.get() == object; }),
+                   _pending.end());
+
+    auto model = _models.find(path);
+    if (model == _models.end()) {
+        return;
+    }
+
+    auto loading = std::find_if(_loading.begin(), _loading.end(),
+                                [object](const Loading& l) { return l.object.get() == object; });
+    if (loading != _loading.end()) {
+        // the prototype went away before it was in; copies attached
+        // meanwhile carry on loading by themselves
+        _loading.erase(loading);
+    }
+
+    if (--model->second.users <= 0) {
+        _models.erase(model);
+    }
+}
+
+void FGAIModelLoader::admit(Request& request, Model& model, bool prototype)
+{
+    request.object->attachModelToScene();
+    ++_admitted;
+
+    if (!prototype) {
+        return;
+    }
+
+    Loading loading;
+    loading.object = request.object;
+    loading.path = request.path;
+    loading.started = _now;
+    _loading.push_back(std::move(loading));
+    model.attached = true;
+}
+
+void FGAIModelLoader::update(double dt, const SGVec3d& viewCart)
+{
+    _now += dt;
+    if (_maxConcurrentNode) {
+        _maxConcurrent = std::max(1, _maxConcurrentNode->getIntValue());
+        _timeoutS = _timeoutNode->getDoubleValue();
+    }
+
+    // free the slots of models which are in, which the pager won't load
+    // because they are outside their LOD range, or which take too long
+    for (auto it = _loading.begin(); it != _loading.end();) {
+        auto model = _models.find(it->path);
+        const bool loaded = it->object->modelLoaded();
+        const bool inRange = withinLODRange(it->object->getSceneBranch(),
+                                            dist(it->object->getCartPos(), viewCart));
+        const bool timedOut = (_now - it->started) > _timeoutS;
+        if (!loaded && inRange && !timedOut) {
+            ++it;
+            continue;
+        }
+
+        if (model != _models.end()) {
+            model->second.loaded = loaded;
+        }
+        if (timedOut && !loaded && inRange) {
+            ++_timeouts;
+            SG_LOG(SG_AI, SG_DEBUG, "AIModelLoader: timed out loading " << it->path);
+        }
+        it = _loading.erase(it);
+    }
+
+    const bool enabled = !_enabledNode || _enabledNode->getBoolValue();
+    for (auto& request : _pending) {
+        request.distanceM = dist(request.object->getCartPos(), viewCart);
+    }
+    std::stable_sort(_pending.begin(), _pending.end(),
+                     [](const Request& a, const Request& b) { return a.distanceM < b.distanceM; });
+
+    for (auto it = _pending.begin(); it != _pending.end();) {
+        // dead objects are released by FGAIManager::removeDeadItem
+        if (it->object->getDie()) {
+            ++it;
+            continue;
+        }
+
+        Model& model = _models[it->path];
+        if (!enabled) {
+            admit(*it, model, false);
+        } else if (model.attached) {
+            // the prototype's request is under way or done, copies share it
+            if (model.loaded) {
+                ++_cacheHits;
+            }
+            admit(*it, model, false);
+        } else if (static_cast<int>(_loading.size()) < _maxConcurrent) {
+            admit(*it, model, true);
+        } else {
+            ++it;
+            continue;
+        }
+        it = _pending.erase(it);
+    }
+
+    if (_node) {
+        _pendingNode->setIntValue(static_cast<int>(_pending.size()));
+        _loadingNode->setIntValue(static_cast<int>(_loading.size()));
+        _cachedPathsNode->setIntValue(static_cast<int>(_models.size()));
+        _admittedNode->setLongValue(static_cast<long>(_admitted));
+        _cacheHitsNode->setLongValue(static_cast<long>(_cacheHits));
+        _timeoutsNode->setLongValue(static_cast<long>(_timeouts));
+    }
+}
+
+void FGAIModelLoader::clear()
+{
+    _pending.clear();
+    _loading.clear();
+    _models.clear();
+    _paths.clear();
+    _now = 0.0;
+}
+
+bool FGAIModelLoader::isPending(const FGAIBase* object) const
+{
+    return std::any_of(_pending.begin(), _pending.end(),
+                       [object](const Request& r) { return r.object.get() == object; });
+}
+
+int FGAIModelLoader::users(const std::string& path) const
+{
+    auto it = _models.find(path);
+    return (it == _models.end()) ? 0 : it->second.users;
+}
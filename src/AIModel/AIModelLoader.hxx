@@ -0,0 +1,117 @@
+/*
+ * SPDX-FileName: AIModelLoader.hxx
+ * SPDX-FileComment: distance ordered, concurrency limited model loading for AI objects
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <simgear/math/SGMath.hxx>
+#include <simgear/props/props.hxx>
+#include <simgear/structure/SGSharedPtr.hxx>
+
+class FGAIBase;
+
+/**
+ * Admission queue between FGAIBase::init and the scene graph, owned by
+ * FGAIManager.
+ *
+ * Adding an AI or multiplayer object to the scene graph is what makes the
+ * database pager load its model; when a scenario, a wave of traffic or a
+ * busy multiplayer session adds many objects at once, the pager requests
+ * for all of them compete and close aircraft can stay invisible behind
+ * distant ones. Instead, objects are queued here and attached nearest to
+ * the viewer first, with at most max-concurrent models in flight.
+ *
+ * Models are tracked per resolved path with the number of live objects
+ * using them. The first object of a path is the prototype and takes a
+ * loading slot. Further objects of the same path are attached as soon as
+ * the prototype is, without using a slot: the pager and the model registry
+ * cache share the geometry and textures, and each copy only needs its own
+ * (cheap) instance with its own animation bindings.
+ *
+ * A loading slot is freed when the model has been loaded, when the object
+ * is outside the range of its LOD (the pager doesn't load what the LOD
+ * doesn't select, so a distant prototype would otherwise hold its slot),
+ * or after a timeout, so that a broken model doesn't block the queue.
+ *
+ * Statistics are published below /sim/ai/model-loader.
+ */
+class FGAIModelLoader
+{
+public:
+    FGAIModelLoader();
+    ~FGAIModelLoader();
+
+    void bind(SGPropertyNode* node);
+    void unbind();
+
+    /// queue the model of object, or attach it directly if disabled. Queueing
+    /// the same path again does nothing, another path replaces the request.
+    void enqueue(FGAIBase* object, const std::string& path);
+
+    /// called when object is removed, drops its reference to the path
+    void release(FGAIBase* object);
+
+    /// attach the queued objects which may be loaded now
+    void update(double dt, const SGVec3d& viewCart);
+
+    /// drop all queued objects and the model table
+    void clear();
+
+    bool isPending(const FGAIBase* object) const;
+    size_t pending() const { return _pending.size(); }
+    size_t loading() const { return _loading.size(); }
+    size_t cachedPaths() const { return _models.size(); }
+
+    /// number of live objects using path
+    int users(const std::string& path) const;
+
+private:
+    struct Model {
+        int users = 0;
+        bool loaded = false;
+        bool attached = false; ///< the prototype has been attached
+    };
+
+    struct Request {
+        SGSharedPtr<FGAIBase> object;
+        std::string path;
+        double distanceM = 0.0;
+    };
+
+    struct Loading {
+        SGSharedPtr<FGAIBase> object;
+        std::string path;
+        double started = 0.0;
+    };
+
+    void admit(Request& request, Model& model, bool prototype);
+
+    std::vector<Request> _pending;
+    std::vector<Loading> _loading;
+    std::map<std::string, Model> _models;
+    std::map<const FGAIBase*, std::string> _paths;
+
+    double _now = 0.0;
+    int _maxConcurrent;
+    double _timeoutS;
+    unsigned long _admitted = 0;
+    unsigned long _cacheHits = 0;
+    unsigned long _timeouts = 0;
+
+    SGPropertyNode_ptr _node;
+    SGPropertyNode_ptr _enabledNode;
+    SGPropertyNode_ptr _maxConcurrentNode;
+    SGPropertyNode_ptr _timeoutNode;
+    SGPropertyNode_ptr _pendingNode;
+    SGPropertyNode_ptr _loadingNode;
+    SGPropertyNode_ptr _cachedPathsNode;
+    SGPropertyNode_ptr _admittedNode;
+    SGPropertyNode_ptr _cacheHitsNode;
+    SGPropertyNode_ptr _timeoutsNode;
+};
@@ -1061,8 +1061,7 @@ void FGAIShip::setWPPos()
 
     if (curr->getOn_ground()) {
         double elevation_m = 0;
-        if (globals->get_scenery()->get_elevation_m(
-                SGGeod::fromGeodM(wppos, 3000), elevation_m, NULL, 0)) {
+        if (getGroundElevationM(SGGeod::fromGeodM(wppos, 3000), elevation_m, nullptr)) {
             wppos.setElevationM(elevation_m);
         }
     } else {
@@ -0,0 +1,398 @@
+/*
+ * SPDX-FileName: SubmodelParticles.cxx
+ * SPDX-FileComment: pooled lightweight ballistic submodels
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include <osg/PagedLOD>
+
+#include <simgear/constants.h>
+#include <simgear/debug/logstream.hxx>
+#include <simgear/math/sg_random.hxx>
+#include <simgear/scene/model/modellib.hxx>
+#include <simgear/scene/util/OsgMath.hxx>
+#include <simgear/scene/util/SGNodeMasks.hxx>
+
+#include <Environment/atmosphere.hxx>
+#include <Environment/gravity.hxx>
+#include <Main/globals.hxx>
+#include <Scenery/scenery.hxx>
+
+#include "AIElevationCache.hxx"
+#include "AIManager.hxx"
+#include "SubmodelParticles.hxx"
+
+using simgear::SGModelLib;
+
+namespace {
+
+// rounds are promoted once they could reach the ground or a target within
+// this time, so the FGAIBallistic has a few frames to find the hit itself
+const double PROMOTION_LOOKAHEAD_S = 0.5;
+const double PROMOTION_MARGIN_FT = 50.0;
+
+// same filter constant as FGAIBallistic for aero-stabilised submodels
+const double STABILISATION_COEFF = 0.9;
+
+double normalizeHeading(double hdg)
+{
+    hdg = std::fmod(hdg, 360.0);
+    return (hdg < 0.0) ? hdg + 360.0 : hdg;
+}
+
+} // of anonymous namespace
+
+FGSubmodelParticles::FGSubmodelParticles() = default;
+
+FGSubmodelParticles::~FGSubmodelParticles()
+{
+    clear();
+}
+
+void FGSubmodelParticles::bind(SGPropertyNode* node)
+{
+    _node = node;
+    _maxCountNode = node->getNode("max-count", true);
+    if (!_maxCountNode->hasValue()) {
+        _maxCountNode->setIntValue(static_cast<int>(_maxCount));
+    }
+    _activeNode = node->getNode("active", true);
+    _spawnedNode = node->getNode("spawned", true);
+    _promotedNode = node->getNode("promoted", true);
+}
+
+void FGSubmodelParticles::unbind()
+{
+    _node.clear();
+    _maxCountNode.clear();
+    _activeNode.clear();
+    _spawnedNode.clear();
+    _promotedNode.clear();
+}
+
+int FGSubmodelParticles::addType(const Type& type)
+{
+    TypeData data;
+    data.type = type;
+    data.group = new osg::Group;
+    data.group->setName("submodel particles: " + type.model);
+    data.group->setNodeMask(~SG_NODEMASK_TERRAIN_BIT);
+
+    // one model for all rounds of this type, loaded in the background
+    osg::ref_ptr<osg::PagedLOD> model = SGModelLib::loadPagedModel(type.model, globals->get_props());
+    if (model.valid()) {
+        model->setRangeMode(osg::LOD::DISTANCE_FROM_EYE_POINT);
+        model->setRange(0, 0, FLT_MAX);
+        data.model = model;
+    } else {
+        SG_LOG(SG_AI, SG_WARN, "Submodels: could not load particle model " << type.model);
+    }
+
+    FGScenery* scenery = globals->get_scenery();
+    if (scenery && scenery->get_models_branch()) {
+        scenery->get_models_branch()->addChild(data.group.get());
+    }
+
+    _types.push_back(data);
+    return static_cast<int>(_types.size()) - 1;
+}
+
+bool FGSubmodelParticles::spawn(int type, const State& state)
+{
+    if (_maxCountNode) {
+        _maxCount = static_cast<size_t>(std::max(0, _maxCountNode->getIntValue()));
+    }
+    if ((type < 0) || (type >= static_cast<int>(_types.size())) || (_type.size() >= _maxCount)) {
+        return false;
+    }
+
+    const TypeData& t = _types[type];
+    const double el = state.elevationDeg * SG_DEGREES_TO_RADIANS;
+    const double az = state.azimuthDeg * SG_DEGREES_TO_RADIANS;
+    const double hs = std::cos(el) * state.speedFps;
+
+    _type.push_back(type);
+    _lat.push_back(state.pos.getLatitudeDeg());
+    _lon.push_back(state.pos.getLongitudeDeg());
+    _altFt.push_back(state.pos.getElevationFt());
+    _vn.push_back(std::cos(az) * hs);
+    _ve.push_back(std::sin(az) * hs);
+    _vd.push_back(-std::sin(el) * state.speedFps);
+    _hdg.push_back(state.hdgDeg);
+    _pitch.push_back(state.pitchDeg);
+    _roll.push_back(t.type.noRoll ? 0.0 : state.rollDeg);
+    _mass.push_back(state.mass);
+    _cd.push_back(state.cd);
+    _buoyancy.push_back(t.type.buoyancy);
+    _windFactor.push_back(t.type.wind ? 1.0 : 0.0);
+    _life.push_back(state.life);
+    _age.push_back(state.age);
+
+    osg::ref_ptr<osg::MatrixTransform> xform;
+    if (_freeTransforms.empty()) {
+        xform = new osg::MatrixTransform;
+        xform->setDataVariance(osg::Object::DYNAMIC);
+    } else {
+        xform = _freeTransforms.back();
+        _freeTransforms.pop_back();
+    }
+    if (t.model.valid()) {
+        xform->addChild(t.model.get());
+    }
+    t.group->addChild(xform.get());
+    _transform.push_back(xform);
+
+    place(_type.size() - 1);
+    ++_spawned;
+    return true;
+}
+
+void FGSubmodelParticles::update(double dt, FGAIManager* manager,
+                                 std::vector<std::pair<int, State>>& promote)
+{
+    const size_t n = _type.size();
+    if ((n > 0) && (dt > 0.0)) {
+        _speed.resize(n);
+        _dead.assign(n, 0);
+
+        double windNorth = 0.0, windEast = 0.0;
+        if (manager) {
+            windNorth = manager->get_wind_from_north();
+            windEast = manager->get_wind_from_east();
+        }
+
+        // gravity hardly changes over the area the rounds fly in
+        const double gravity = SG_METER_TO_FEET * Environment::Gravity::instance()->getGravity(
+            SGGeod::fromDegFt(_lon[0], _lat[0], _altFt[0]));
+
+        // life time and drag; this needs the atmosphere at each round
+        for (size_t i = 0; i < n; ++i) {
+            _age[i] += dt;
+            if ((_life[i] != -1) && (_age[i] > _life[i])) {
+                _dead[i] = 1;
+            }
+
+            const Type& type = _types[_type[i]].type;
+            if (type.random) {
+                // keep the new Cd within +- 10% of the current Cd
+                const double cd = type.cd * (1 - type.cdRandomness + 2 * type.cdRandomness * sg_random());
+                _cd[i] = SGMiscd::clip(cd, _cd[i] * 0.9, _cd[i] * 1.1);
+            }
+
+            const double speed = std::sqrt(_vn[i] * _vn[i] + _ve[i] * _ve[i] + _vd[i] * _vd[i]);
+            const double mach = FGAtmo::machFromKnotsAtAltitudeFt(speed / SG_KT_TO_FPS, _altFt[i]);
+            const double rho = FGAtmo::densityAtAltitudeFt(_altFt[i]) / SG_SLUGFT3_TO_KGPM3;
+
+            // Cd adjusted by Mach number, as in FGAIBallistic::Run
+            double cdm;
+            if (mach < 0.7)
+                cdm = 0.0125 * mach + _cd[i];
+            else if (mach < 1.2)
+                cdm = 0.3742 * mach * mach - 0.252 * mach + 0.0021 + _cd[i];
+            else
+                cdm = 0.2965 * std::pow(mach, -1.1506) + _cd[i];
+
+            const double drag = cdm * 0.5 * rho * speed * speed * type.dragArea / _mass[i] * dt;
+            _speed[i] = (speed > drag) ? (speed - drag) / speed : 0.0;
+        }
+
+        // velocities and positions: plain arithmetic over the arrays
+        for (size_t i = 0; i < n; ++i) {
+            _vn[i] *= _speed[i];
+            _ve[i] *= _speed[i];
+            _vd[i] = _vd[i] * _speed[i] + (gravity - _buoyancy[i]) * dt;
+        }
+
+        for (size_t i = 0; i < n; ++i) {
+            const double cosLat = std::cos(_lat[i] * SG_DEGREES_TO_RADIANS);
+            const double ftPerDegLat = 366468.96 - 3717.12 * cosLat;
+            const double ftPerDegLon = 365228.16 * cosLat;
+            _lat[i] += (_vn[i] - windNorth * _windFactor[i]) / ftPerDegLat * dt;
+            _lon[i] += (_ve[i] - windEast * _windFactor[i]) / ftPerDegLon * dt;
+            _altFt[i] -= _vd[i] * dt;
+        }
+
+        const double c = dt / (STABILISATION_COEFF + dt);
+        for (size_t i = 0; i < n; ++i) {
+            if ((_altFt[i] < -1000.0) && (_life[i] != -1)) {
+                _dead[i] = 1;
+            }
+
+            const Type& type = _types[_type[i]].type;
+            if (type.aeroStabilised) {
+                const double hs = std::sqrt(_vn[i] * _vn[i] + _ve[i] * _ve[i]);
+                const double elevation = std::atan2(-_vd[i], hs) * SG_RADIANS_TO_DEGREES;
+                const double azimuth = std::atan2(_ve[i], _vn[i]) * SG_RADIANS_TO_DEGREES;
+
+                // turn the short way round
+                double diff = normalizeHeading(azimuth - _hdg[i]);
+                if (diff > 180.0) {
+                    diff -= 360.0;
+                }
+                _hdg[i] = normalizeHeading(_hdg[i] + diff * c);
+                _pitch[i] = elevation * c + _pitch[i] * (1 - c);
+            }
+
+            if (!_dead[i] && (type.impact || type.collision) && needsPromotion(i, manager)) {
+                promote.emplace_back(_type[i], state(i));
+                _dead[i] = 1;
+                ++_promoted;
+            }
+        }
+
+        // remove from the back, so swapping in the last round is safe
+        for (size_t i = n; i-- > 0;) {
+            if (_dead[i]) {
+                remove(i);
+            } else {
+                place(i);
+            }
+        }
+    }
+
+    if (_node) {
+        _activeNode->setIntValue(static_cast<int>(_type.size()));
+        _spawnedNode->setLongValue(static_cast<long>(_spawned));
+        _promotedNode->setLongValue(static_cast<long>(_promoted));
+    }
+}
+
+bool FGSubmodelParticles::needsPromotion(size_t i, FGAIManager* manager) const
+{
+    if (!manager) {
+        return false;
+    }
+
+    const Type& type = _types[_type[i]].type;
+    const double speed = std::sqrt(_vn[i] * _vn[i] + _ve[i] * _ve[i] + _vd[i] * _vd[i]);
+    const double lookaheadFt = speed * PROMOTION_LOOKAHEAD_S + PROMOTION_MARGIN_FT;
+
+    if (type.impact) {
+        // probe from just above the round, like FGAIBallistic::handle_impact
+        const SGGeod probe = SGGeod::fromDegM(_lon[i], _lat[i], _altFt[i] * SG_FEET_TO_METER + 100);
+        double elevationM = 0.0;
+        FGAIElevationCache* cache = manager->getElevationCache();
+        bool found;
+        if (cache) {
+            found = cache->getElevationM(probe, elevationM, nullptr);
+        } else {
+            FGScenery* scenery = globals->get_scenery();
+            found = scenery && scenery->get_elevation_m(probe, elevationM, nullptr);
+        }
+        if (found && (_altFt[i] - elevationM * SG_METER_TO_FEET < lookaheadFt)) {
+            return true;
+        }
+    }
+
+    if (type.collision) {
+        if (manager->calcCollision(_altFt[i], _lat[i], _lon[i], type.fuseRange + lookaheadFt)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+FGSubmodelParticles::State FGSubmodelParticles::state(size_t i) const
+{
+    State s;
+    s.pos = SGGeod::fromDegFt(_lon[i], _lat[i], _altFt[i]);
+    const double hs = std::sqrt(_vn[i] * _vn[i] + _ve[i] * _ve[i]);
+    s.speedFps = std::sqrt(hs * hs + _vd[i] * _vd[i]);
+    s.elevationDeg = std::atan2(-_vd[i], hs) * SG_RADIANS_TO_DEGREES;
+    s.azimuthDeg = normalizeHeading(std::atan2(_ve[i], _vn[i]) * SG_RADIANS_TO_DEGREES);
+    s.hdgDeg = _hdg[i];
+    s.pitchDeg = _pitch[i];
+    s.rollDeg = _roll[i];
+    s.mass = _mass[i];
+    s.cd = _cd[i];
+    s.life = _life[i];
+    s.age = _age[i];
+    return s;
+}
+
+void FGSubmodelParticles::place(size_t i)
+{
+    // same orientation convention as SGModelPlacement
+    const SGGeod pos = SGGeod::fromDegFt(_lon[i], _lat[i], _altFt[i]);
+    SGQuatd orient = SGQuatd::fromLonLat(pos);
+    orient *= SGQuatd::fromYawPitchRollDeg(_hdg[i], _pitch[i], _roll[i]);
+    orient *= SGQuatd::fromRealImag(0, SGVec3d(0, 1, 0));
+
+    _transform[i]->setMatrix(osg::Matrix::rotate(toOsg(orient)) *
+                             osg::Matrix::translate(toOsg(SGVec3d::fromGeod(pos))));
+}
+
+void FGSubmodelParticles::remove(size_t i)
+{
+    osg::ref_ptr<osg::MatrixTransform> xform = _transform[i];
+    _types[_type[i]].group->removeChild(xform.get());
+    xform->removeChildren(0, xform->getNumChildren());
+    _freeTransforms.push_back(xform);
+
+    const size_t last = _type.size() - 1;
+    if (i != last) {
+        _type[i] = _type[last];
+        _lat[i] = _lat[last];
+        _lon[i] = _lon[last];
+        _altFt[i] = _altFt[last];
+        _vn[i] = _vn[last];
+        _ve[i] = _ve[last];
+        _vd[i] = _vd[last];
+        _hdg[i] = _hdg[last];
+        _pitch[i] = _pitch[last];
+        _roll[i] = _roll[last];
+        _mass[i] = _mass[last];
+        _cd[i] = _cd[last];
+        _buoyancy[i] = _buoyancy[last];
+        _windFactor[i] = _windFactor[last];
+        _life[i] = _life[last];
+        _age[i] = _age[last];
+        _transform[i] = _transform[last];
+        _dead[i] = _dead[last];
+    }
+
+    _type.pop_back();
+    _lat.pop_back();
+    _lon.pop_back();
+    _altFt.pop_back();
+    _vn.pop_back();
+    _ve.pop_back();
+    _vd.pop_back();
+    _hdg.pop_back();
+    _pitch.pop_back();
+    _roll.pop_back();
+    _mass.pop_back();
+    _cd.pop_back();
+    _buoyancy.pop_back();
+    _windFactor.pop_back();
+    _life.pop_back();
+    _age.pop_back();
+    _transform.pop_back();
+    _dead.pop_back();
+}
+
+void FGSubmodelParticles::clear()
+{
+    _dead.resize(_type.size());
+    while (!_type.empty()) {
+        remove(_type.size() - 1);
+    }
+
+    FGScenery* scenery = globals ? globals->get_scenery() : nullptr;
+    if (scenery && scenery->get_models_branch()) {
+        for (auto& t : _types) {
+            scenery->get_models_branch()->removeChild(t.group.get());
+        }
+    }
+    _types.clear();
+    _freeTransforms.clear();
+}
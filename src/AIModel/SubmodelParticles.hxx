@@ -0,0 +1,139 @@
+/*
+ * SPDX-FileName: SubmodelParticles.hxx
+ * SPDX-FileComment: pooled lightweight ballistic submodels
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <osg/Group>
+#include <osg/MatrixTransform>
+#include <osg/Node>
+#include <osg/ref_ptr>
+
+#include <simgear/math/SGMath.hxx>
+#include <simgear/props/props.hxx>
+
+class FGAIManager;
+
+/**
+ * Submodels marked <lightweight> (tracer rounds, flares, chaff, ...) don't
+ * become FGAIBallistic objects with their own property subtree and model
+ * when released. Their state is kept here in parallel arrays, one entry
+ * per round, and all of them are integrated in one pass per frame with
+ * the same drag, gravity, buoyancy and wind model as FGAIBallistic::Run.
+ *
+ * All rounds of a type share one model node below a per-type group; each
+ * round only owns a transform, which is recycled when it dies.
+ *
+ * Rounds of types which report impacts or collisions are handed back to
+ * FGSubmodelMgr for promotion to a full FGAIBallistic as soon as they get
+ * close to the ground or to another AI object.
+ */
+class FGSubmodelParticles
+{
+public:
+    struct Type {
+        std::string model;
+        double cd = 0.193;
+        double cdRandomness = 0.0;
+        double dragArea = 0.034;
+        double buoyancy = 0.0;
+        double fuseRange = 0.0;
+        bool random = false;
+        bool wind = false;
+        bool aeroStabilised = true;
+        bool noRoll = false;
+        bool impact = false;
+        bool collision = false;
+    };
+
+    /// state of a single round, as passed in at release and out on promotion
+    struct State {
+        SGGeod pos;
+        double azimuthDeg = 0.0;    ///< direction of the velocity
+        double elevationDeg = 0.0;
+        double speedFps = 0.0;
+        double hdgDeg = 0.0;        ///< orientation of the model
+        double pitchDeg = 0.0;
+        double rollDeg = 0.0;
+        double mass = 0.0;          ///< slugs
+        double cd = 0.0;
+        double life = 0.0;          ///< seconds, -1 for immortal
+        double age = 0.0;
+    };
+
+    FGSubmodelParticles();
+    ~FGSubmodelParticles();
+
+    void bind(SGPropertyNode* node);
+    void unbind();
+
+    int addType(const Type& type);
+
+    /// false if the pool is full, the caller then falls back to FGAIBallistic
+    bool spawn(int type, const State& state);
+
+    /**
+     * Integrate all rounds and remove the dead ones. Rounds which need a
+     * full FGAIBallistic are removed as well and returned in promote.
+     */
+    void update(double dt, FGAIManager* manager,
+                std::vector<std::pair<int, State>>& promote);
+
+    /// remove all rounds and types
+    void clear();
+
+    size_t size() const { return _type.size(); }
+
+private:
+    void remove(size_t i);
+    bool needsPromotion(size_t i, FGAIManager* manager) const;
+    State state(size_t i) const;
+    void place(size_t i);
+
+    struct TypeData {
+        Type type;
+        osg::ref_ptr<osg::Node> model;
+        osg::ref_ptr<osg::Group> group;
+    };
+    std::vector<TypeData> _types;
+
+    // one entry per live round; velocities are north/east/down in fps
+    std::vector<int> _type;
+    std::vector<double> _lat;
+    std::vector<double> _lon;
+    std::vector<double> _altFt;
+    std::vector<double> _vn;
+    std::vector<double> _ve;
+    std::vector<double> _vd;
+    std::vector<double> _hdg;
+    std::vector<double> _pitch;
+    std::vector<double> _roll;
+    std::vector<double> _mass;
+    std::vector<double> _cd;
+    std::vector<double> _buoyancy;
+    std::vector<double> _windFactor;    ///< 1 if the type drifts with the wind
+    std::vector<double> _life;
+    std::vector<double> _age;
+    std::vector<osg::ref_ptr<osg::MatrixTransform>> _transform;
+
+    // scratch arrays for the integration pass
+    std::vector<double> _speed;
+    std::vector<unsigned char> _dead;
+
+    std::vector<osg::ref_ptr<osg::MatrixTransform>> _freeTransforms;
+
+    size_t _maxCount = 2000;
+    unsigned long _spawned = 0;
+    unsigned long _promoted = 0;
+
+    SGPropertyNode_ptr _node;
+    SGPropertyNode_ptr _maxCountNode;
+    SGPropertyNode_ptr _activeNode;
+    SGPropertyNode_ptr _spawnedNode;
+    SGPropertyNode_ptr _promotedNode;
+};
@@ -3,6 +3,11 @@
 
 
 
+#include <algorithm>
+#include <cmath>
+
+#include <simgear/constants.h>
+#include <simgear/math/SGMisc.hxx>
 #include <simgear/props/props.hxx>
 
 #include "AIAircraft.hxx"
@@ -15,6 +20,35 @@
 // to the AIAircraft.
 #define BRAKE_SETTING 1.6
 
+namespace {
+
+// speed limit below 10000ft
+const double SPEED_LIMIT_ALTITUDE_FT = 10000.0;
+const double SPEED_LIMIT_KTS = 250.0;
+
+// bank angle flight plan turns are planned with
+const double PLANNED_BANK_DEG = 25.0;
+// FGAIFlightPlan::getTurnRadius estimate for PLANNED_BANK_DEG
+const double TURN_RADIUS_FACTOR = 0.1911;
+
+double defaultCeiling(double vCruise)
+{
+    if (vCruise >= 350.0) return 45000.0;
+    if (vCruise >= 250.0) return 30000.0;
+    if (vCruise >= 150.0) return 20000.0;
+    return 12000.0;
+}
+
+template <size_t N>
+double interpolate(const std::array<double, N>& table, double x, double step)
+{
+    const double f = SGMiscd::clip(x / step, 0.0, static_cast<double>(N - 1));
+    const size_t i = std::min(static_cast<size_t>(f), N - 2);
+    return table[i] + (f - i) * (table[i + 1] - table[i]);
+}
+
+} // of anonymous namespace
+
 
 PerformanceData* PerformanceData::getDefaultData()
 {
@@ -41,6 +75,8 @@ PerformanceData::PerformanceData() : _acceleration(4.0),
 {
     _rollrate = 9.0; // degrees per second
     _maxbank = 30.0; // passenger friendly bank angle
+    _ceiling = defaultCeiling(_vCruise);
+    buildTables();
 }
 
 PerformanceData::PerformanceData(const PerformanceData* clone) : _acceleration(clone->_acceleration),
@@ -62,6 +98,8 @@ PerformanceData::PerformanceData(const PerformanceData* clone) : _acceleration(c
 {
     _rollrate = clone->_rollrate;
     _maxbank = clone->_maxbank;
+    _ceiling = clone->_ceiling;
+    buildTables();
 }
 
 // helper to try various names of a property, in order.
@@ -100,6 +138,85 @@ void PerformanceData::initFromProps(SGPropertyNode* db_node)
     _wingSpan = db_node->getDoubleValue("geometry/wing/span-ft", _wingSpan);
     _wingChord = db_node->getDoubleValue("geometry/wing/chord-ft", _wingChord);
     _weight = db_node->getDoubleValue("geometry/weight-lbs", _weight);
+    _ceiling = db_node->getDoubleValue("ceiling-ft", defaultCeiling(_vCruise));
+
+    buildTables();
+}
+
+void PerformanceData::buildTables()
+{
+    for (size_t i = 0; i < TABLE_ALT_SAMPLES; ++i) {
+        const double alt = i * TABLE_ALT_STEP_FT;
+
+        // climb performance falls off to half the sea level rate at the ceiling
+        _climbRateTable[i] = _climbRate * (1.0 - 0.5 * std::min(1.0, alt / std::max(_ceiling, 1.0)));
+
+        // descents are shallower below 10000ft, down to 60% at sea level
+        _descentRateTable[i] = _descentRate * (0.6 + 0.4 * std::min(1.0, alt / SPEED_LIMIT_ALTITUDE_FT));
+
+        // speed limit below 10000ft, blended in over the next 1000ft
+        const double blend = SGMiscd::clip((alt - SPEED_LIMIT_ALTITUDE_FT) / TABLE_ALT_STEP_FT, 0.0, 1.0);
+        const double limitedClimb = std::min(SPEED_LIMIT_KTS, _vClimb);
+        const double limitedDescent = std::min(SPEED_LIMIT_KTS, _vDescent);
+        _climbSpeedTable[i] = limitedClimb + blend * (_vClimb - limitedClimb);
+        _descentSpeedTable[i] = limitedDescent + blend * (_vDescent - limitedDescent);
+
+        // integrate the descent from sea level upwards
+        if (i == 0) {
+            _descentDistanceTable[i] = 0.0;
+        } else {
+            const double rate = 0.5 * (_descentRateTable[i - 1] + _descentRateTable[i]);
+            const double speed = 0.5 * (_descentSpeedTable[i - 1] + _descentSpeedTable[i]);
+            const double minutes = TABLE_ALT_STEP_FT / std::max(rate, 1.0);
+            _descentDistanceTable[i] = _descentDistanceTable[i - 1] +
+                                       speed * SG_NM_TO_METER * minutes / 60.0;
+        }
+    }
+
+    // scale the flight plan estimate by the bank angle this type can fly
+    const double bank = std::min(PLANNED_BANK_DEG, _maxbank);
+    const double bankFactor = std::tan(PLANNED_BANK_DEG * SGD_DEGREES_TO_RADIANS) /
+                              std::tan(bank * SGD_DEGREES_TO_RADIANS);
+    for (size_t i = 0; i < TABLE_SPEED_SAMPLES; ++i) {
+        const double speed = i * TABLE_SPEED_STEP_KTS;
+        _turnRadiusTable[i] = TURN_RADIUS_FACTOR * speed * speed * bankFactor;
+    }
+}
+
+double PerformanceData::climbRateAt(double altitudeFt) const
+{
+    return interpolate(_climbRateTable, altitudeFt, TABLE_ALT_STEP_FT);
+}
+
+double PerformanceData::descentRateAt(double altitudeFt) const
+{
+    return interpolate(_descentRateTable, altitudeFt, TABLE_ALT_STEP_FT);
+}
+
+double PerformanceData::climbSpeedAt(double altitudeFt) const
+{
+    return interpolate(_climbSpeedTable, altitudeFt, TABLE_ALT_STEP_FT);
+}
+
+double PerformanceData::descentSpeedAt(double altitudeFt) const
+{
+    return interpolate(_descentSpeedTable, altitudeFt, TABLE_ALT_STEP_FT);
+}
+
+double PerformanceData::descentDistanceM(double altitudeFt) const
+{
+    return interpolate(_descentDistanceTable, altitudeFt, TABLE_ALT_STEP_FT);
+}
+
+double PerformanceData::turnRadius(double speedKts) const
+{
+    const double maxSpeed = (TABLE_SPEED_SAMPLES - 1) * TABLE_SPEED_STEP_KTS;
+    if (std::fabs(speedKts) > maxSpeed) {
+        // beyond the table, the radius still grows with the square of the speed
+        const double r = _turnRadiusTable[TABLE_SPEED_SAMPLES - 1];
+        return r * (speedKts * speedKts) / (maxSpeed * maxSpeed);
+    }
+    return interpolate(_turnRadiusTable, std::fabs(speedKts), TABLE_SPEED_STEP_KTS);
 }
 
 double PerformanceData::actualSpeed(const FGAIAircraft* ac, double tgt_speed, double dt, bool maxBrakes)
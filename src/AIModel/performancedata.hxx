@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+
 class FGAIAircraft;
 class SGPropertyNode;
 
@@ -48,6 +50,21 @@ public:
 
     double decelerationOnGround() const;
 
+    // Profiles interpolated from the tables built by buildTables(), for the
+    // AI controllers and the flight plan generator.
+    double climbRateAt(double altitudeFt) const;    ///< fpm
+    double descentRateAt(double altitudeFt) const;  ///< fpm
+    double climbSpeedAt(double altitudeFt) const;   ///< kts
+    double descentSpeedAt(double altitudeFt) const; ///< kts
+
+    /// ground distance in meters covered in a descent from altitudeFt to
+    /// sea level; the difference of two values gives any partial descent
+    double descentDistanceM(double altitudeFt) const;
+
+    /// radius of a turn at the planned bank angle, in the same units as
+    /// FGAIFlightPlan::getTurnRadius
+    double turnRadius(double speedKts) const;
+
     /**
      @brief Last-resort fallback performance data. This is to avoid special-casing
      logic in the AIAircraft code, by ensuring we always have a valid _performance pointer.
@@ -55,6 +72,25 @@ public:
     static PerformanceData* getDefaultData();
 
 private:
+    /**
+     * Fill the profile tables from the scalar values. Called whenever
+     * those change, i.e. once per type when the PerformanceDB is loaded.
+     */
+    void buildTables();
+
+    static constexpr double TABLE_ALT_STEP_FT = 1000.0;
+    static constexpr size_t TABLE_ALT_SAMPLES = 51; // 0 - 50000ft
+    static constexpr double TABLE_SPEED_STEP_KTS = 10.0;
+    static constexpr size_t TABLE_SPEED_SAMPLES = 61; // 0 - 600kts
+
+    typedef std::array<double, TABLE_ALT_SAMPLES> AltitudeTable;
+    AltitudeTable _climbRateTable;
+    AltitudeTable _descentRateTable;
+    AltitudeTable _climbSpeedTable;
+    AltitudeTable _descentSpeedTable;
+    AltitudeTable _descentDistanceTable;
+    std::array<double, TABLE_SPEED_SAMPLES> _turnRadiusTable;
+
     double _acceleration{0.0};
     double _deceleration{0.0};
     double _brakeDeceleration{0.0};
@@ -71,6 +107,7 @@ private:
 
     double _rollrate{0.0};
     double _maxbank{0.0};
+    double _ceiling{0.0};
 
     // Data for aerodynamic wake computation
     double _wingSpan{0.0};
@@ -11,6 +11,7 @@
 #include <algorithm>
 
 #include <simgear/math/sg_geodesy.hxx>
+#include <simgear/math/sg_random.hxx>
 #include <simgear/misc/sg_path.hxx>
 #include <simgear/props/props_io.hxx>
 #include <simgear/structure/exception.hxx>
@@ -100,16 +101,22 @@ void FGSubmodelMgr::postinit()
 
 void FGSubmodelMgr::shutdown()
 {
+    _particles.clear();
+    _particleSubmodels.clear();
+
     std::for_each(submodels.begin(), submodels.end(), [](submodel* sm) { delete sm; });
     submodels.clear();
 }
 
 void FGSubmodelMgr::bind()
 {
+    _particles.bind(fgGetNode("/sim/submodels/particles", true));
 }
 
 void FGSubmodelMgr::unbind()
 {
+    _particles.unbind();
+
     submodel_iterator = submodels.begin();
     while (submodel_iterator != submodels.end()) {
         (*submodel_iterator)->prop->untie("count");
@@ -211,6 +218,12 @@ void FGSubmodelMgr::update(double dt)
             sm->first_time = true; // reset first-time flag
         }
     }
+
+    _promotions.clear();
+    _particles.update(dt, aiManager(), _promotions);
+    for (const auto& p : _promotions) {
+        promoteParticle(_particleSubmodels[p.first], p.second);
+    }
 }
 
 bool FGSubmodelMgr::release(submodel* sm, double dt)
@@ -237,26 +250,46 @@ bool FGSubmodelMgr::release(submodel* sm, double dt)
     // Calculate submodel's initial conditions in world-coordinates
     transform(sm);
 
-    FGAIBallistic* ballist = new FGAIBallistic;
-    ballist->setPath(sm->model.c_str());
-    ballist->setName(sm->name);
-    ballist->setSlaved(sm->slaved);
-    ballist->setRandom(sm->random);
-    ballist->setLifeRandomness(sm->life_randomness->get_value());
+    if (sm->count > 0)
+        sm->count--;
+
+    // lightweight rounds go into the particle pool unless that is full
+    if (releaseParticle(sm))
+        return true;
+
+    FGAIBallistic* ballist = makeBallistic(sm);
     ballist->setLatitude(offsetpos.getLatitudeDeg());
     ballist->setLongitude(offsetpos.getLongitudeDeg());
     ballist->setAltitude(offsetpos.getElevationFt());
-    ballist->setAzimuthRandomError(sm->azimuth_error->get_value());
     ballist->setAzimuth(IC.azimuth);
-    ballist->setElevationRandomError(sm->elevation_error->get_value());
     ballist->setElevation(IC.elevation);
     ballist->setRoll(IC.roll);
     ballist->setSpeed(IC.speed / SG_KT_TO_FPS);
     ballist->setWind_from_east(IC.wind_from_east);
     ballist->setWind_from_north(IC.wind_from_north);
     ballist->setMass(IC.mass);
-    ballist->setDragArea(sm->drag_area);
     ballist->setLife(sm->life);
+    ballist->setXoffset(_x_offset);
+    ballist->setYoffset(_y_offset);
+    ballist->setZoffset(_z_offset);
+
+    aiManager()->attach(ballist);
+    return true;
+}
+
+// An FGAIBallistic with everything set which doesn't depend on the state
+// at release.
+FGAIBallistic* FGSubmodelMgr::makeBallistic(submodel* sm)
+{
+    FGAIBallistic* ballist = new FGAIBallistic;
+    ballist->setPath(sm->model.c_str());
+    ballist->setName(sm->name);
+    ballist->setSlaved(sm->slaved);
+    ballist->setRandom(sm->random);
+    ballist->setLifeRandomness(sm->life_randomness->get_value());
+    ballist->setAzimuthRandomError(sm->azimuth_error->get_value());
+    ballist->setElevationRandomError(sm->elevation_error->get_value());
+    ballist->setDragArea(sm->drag_area);
     ballist->setBuoyancy(sm->buoyancy);
     ballist->setWind(sm->wind);
     ballist->setCdRandomness(sm->cd_randomness->get_value());
@@ -273,20 +306,64 @@ bool FGSubmodelMgr::release(submodel* sm, double dt)
     ballist->setForceStabilisation(sm->force_stabilised);
     ballist->setExternalForce(sm->ext_force);
     ballist->setForcePath(sm->force_path);
-    ballist->setXoffset(_x_offset);
-    ballist->setYoffset(_y_offset);
-    ballist->setZoffset(_z_offset);
     ballist->setPitchoffset(sm->pitch_offset->get_value());
     ballist->setYawoffset(sm->yaw_offset->get_value());
     ballist->setParentNodes(_selected_ac);
     ballist->setContentsNode(sm->contents_node);
     ballist->setWeight(sm->weight);
+    return ballist;
+}
 
-    aiManager()->attach(ballist);
+bool FGSubmodelMgr::releaseParticle(submodel* sm)
+{
+    // 'slaved' is tied and may have been switched on since loading
+    if (sm->particle_type < 0 || sm->slaved)
+        return false;
 
-    if (sm->count > 0)
-        sm->count--;
-    return true;
+    // the same randomisation as the FGAIBallistic setters
+    FGSubmodelParticles::State state;
+    state.pos = offsetpos;
+    state.azimuthDeg = IC.azimuth;
+    state.elevationDeg = IC.elevation;
+    state.life = sm->life;
+    if (sm->random) {
+        const double az_error = sm->azimuth_error->get_value();
+        const double el_error = sm->elevation_error->get_value();
+        const double life_randomness = sm->life_randomness->get_value();
+        state.azimuthDeg += -az_error + 2 * az_error * sg_random();
+        state.elevationDeg += -el_error + 2 * el_error * sg_random();
+        if (sm->life != -1)
+            state.life = sm->life * life_randomness + (sm->life * (1 - life_randomness) * sg_random());
+    }
+    state.hdgDeg = state.azimuthDeg;
+    state.pitchDeg = state.elevationDeg;
+    state.rollDeg = IC.roll;
+    state.speedFps = IC.speed;
+    state.mass = IC.mass;
+    state.cd = sm->cd;
+
+    return _particles.spawn(sm->particle_type, state);
+}
+
+// Hand a round which is about to hit something over to a full FGAIBallistic,
+// which does the impact and collision reporting.
+void FGSubmodelMgr::promoteParticle(submodel* sm, const FGSubmodelParticles::State& state)
+{
+    FGAIBallistic* ballist = makeBallistic(sm);
+    // the randomisation was done at release
+    ballist->setRandom(false);
+    ballist->setLatitude(state.pos.getLatitudeDeg());
+    ballist->setLongitude(state.pos.getLongitudeDeg());
+    ballist->setAltitude(state.pos.getElevationFt());
+    ballist->setAzimuth(state.azimuthDeg);
+    ballist->setElevation(state.elevationDeg);
+    ballist->setRoll(state.rollDeg);
+    ballist->setSpeed(state.speedFps / SG_KT_TO_FPS);
+    ballist->setMass(state.mass);
+    ballist->setCd(state.cd);
+    ballist->setLife((state.life == -1) ? -1 : std::max(0.0, state.life - state.age));
+
+    aiManager()->attach(ballist);
 }
 
 void FGSubmodelMgr::load()
@@ -510,6 +587,8 @@ void FGSubmodelMgr::setData(int id, const string& path, bool serviceable, const
         sm->ext_force = entry_node->getBoolValue("external-force", false);
         sm->force_path = entry_node->getStringValue("force-path", "");
         sm->random = entry_node->getBoolValue("random", false);
+        sm->lightweight = entry_node->getBoolValue("lightweight", false);
+        sm->particle_type = -1;
 
         SGPropertyNode_ptr prop_root = fgGetNode("/", true);
         SGPropertyNode n;
@@ -603,6 +682,31 @@ void FGSubmodelMgr::setData(int id, const string& path, bool serviceable, const
         if (sm->speed_node != 0)
             sm->speed = sm->speed_node->getDoubleValue();
 
+        if (sm->lightweight) {
+            // rounds in the pool have no property tree and no parent link
+            if (sm->slaved || sm->ext_force || sm->force_stabilised || sm->expiry || !sm->submodel.empty()) {
+                SG_LOG(SG_AI, SG_DEV_WARN, "Submodels: " << sm->name
+                       << " can't be lightweight: slaved, external-force, force-stabilised,"
+                          " expiry and submodel-path need a full ballistic object");
+            } else {
+                FGSubmodelParticles::Type type;
+                type.model = sm->model;
+                type.cd = sm->cd;
+                type.cdRandomness = sm->cd_randomness->get_value();
+                type.dragArea = sm->drag_area;
+                type.buoyancy = sm->buoyancy;
+                type.fuseRange = sm->fuse_range;
+                type.random = sm->random;
+                type.wind = sm->wind;
+                type.aeroStabilised = sm->aero_stabilised;
+                type.noRoll = sm->no_roll;
+                type.impact = sm->impact;
+                type.collision = sm->collision;
+                sm->particle_type = _particles.addType(type);
+                _particleSubmodels.push_back(sm);
+            }
+        }
+
         sm->timer = sm->delay;
         sm->id = id;
         sm->first_time = false;
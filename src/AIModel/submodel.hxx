@@ -14,6 +14,9 @@
 
 #include <simgear/misc/inputvalue.hxx>
 
+#include "SubmodelParticles.hxx"
+
+class FGAIBallistic;
 class FGAIBase;
 class FGAIManager;
 
@@ -70,6 +73,8 @@ public:
         bool force_stabilised;
         bool ext_force;
         std::string force_path;
+        bool lightweight;   // released into the particle pool
+        int particle_type;  // index in the particle pool, -1 if not pooled
     } submodel;
 
     typedef struct {
@@ -177,9 +182,16 @@ private:
     void transform(submodel*);
     void setParentNode(int parent_id);
     bool release(submodel*, double dt);
+    FGAIBallistic* makeBallistic(submodel* sm);
+    bool releaseParticle(submodel* sm);
+    void promoteParticle(submodel* sm, const FGSubmodelParticles::State& state);
 
     int _count{0};
 
+    FGSubmodelParticles _particles;
+    submodel_vector_type _particleSubmodels;    // by particle type
+    std::vector<std::pair<int, FGSubmodelParticles::State>> _promotions;
+
     SGGeod userpos;
     SGGeod offsetpos;
 
@@ -37,6 +37,7 @@
 #include <signal.h>
 
 #include <ATC/ATCController.hxx>
+#include <ATC/GroundNetworkMesh.hxx>
 #include <ATC/atc_mgr.hxx>
 #include <ATC/trafficcontrol.hxx>
 
@@ -402,11 +403,7 @@ void FGATCController::signOff(int id)
         return;
     }
     SG_LOG(SG_ATC, SG_DEBUG, i->getCallsign() << " (" << i->getId() << ") signing off from " << getName() << "(" << getFrequency() << ")");
-    int oldSize = activeTraffic.size();
-    activeTraffic.erase(i);
-    if ((oldSize - activeTraffic.size()) != 1) {
-        SG_LOG(SG_ATC, SG_WARN, i->getCallsign() << " not removed ");
-    }
+    eraseActiveTraffic(i);
 }
 
 bool FGATCController::hasInstruction(int id)
@@ -471,13 +468,15 @@ string FGATCController::genTransponderCode(const string& fltRules)
 
 void FGATCController::eraseDeadTraffic()
 {
-    auto it = std::remove_if(activeTraffic.begin(), activeTraffic.end(), [](const FGTrafficRecord& traffic) {
-        if (traffic.isDead()) {
-            SG_LOG(SG_ATC, SG_DEBUG, "Remove dead " << traffic.getId() << " " << traffic.isDead());
+    TrafficVectorIterator i = activeTraffic.begin();
+    while (i != activeTraffic.end()) {
+        if (i->isDead()) {
+            SG_LOG(SG_ATC, SG_DEBUG, "Remove dead " << i->getId() << " " << i->isDead());
+            i = eraseActiveTraffic(i);
+        } else {
+            ++i;
         }
-        return traffic.isDead();
-    });
-    activeTraffic.erase(it, activeTraffic.end());
+    }
 }
 
 /*
@@ -487,8 +486,52 @@ void FGATCController::eraseDeadTraffic()
 */
 TrafficVectorIterator FGATCController::searchActiveTraffic(int id)
 {
-    return std::find_if(activeTraffic.begin(), activeTraffic.end(),
-                        [id](const FGTrafficRecord& rec) { return rec.getId() == id; });
+    auto it = activeTrafficIndex.find(id);
+    if (it == activeTrafficIndex.end()) {
+        return activeTraffic.end();
+    }
+    return it->second;
+}
+
+TrafficVectorIterator FGATCController::addActiveTraffic(const FGTrafficRecord& rec, bool atFront)
+{
+    TrafficVectorIterator i;
+    if (atFront) {
+        activeTraffic.push_front(rec);
+        i = activeTraffic.begin();
+    } else {
+        i = activeTraffic.insert(activeTraffic.end(), rec);
+    }
+
+    if (!activeTrafficIndex.emplace(rec.getId(), i).second) {
+        SG_LOG(SG_ATC, SG_DEV_WARN, getName() << ": duplicate traffic record for id " << rec.getId());
+        activeTrafficIndex[rec.getId()] = i;
+    }
+    trafficGrid.invalidate();
+    return i;
+}
+
+TrafficVectorIterator FGATCController::eraseActiveTraffic(TrafficVectorIterator i)
+{
+    auto it = activeTrafficIndex.find(i->getId());
+    if ((it != activeTrafficIndex.end()) && (it->second == i)) {
+        activeTrafficIndex.erase(it);
+    }
+    trafficGrid.invalidate();
+    return activeTraffic.erase(i);
+}
+
+void FGATCController::findNearbyTraffic(const SGGeod& pos, double rangeM,
+                                        std::vector<TrafficVectorIterator>& result)
+{
+    trafficGrid.update(activeTraffic, globals->get_sim_time_sec());
+    trafficGrid.query(pos, rangeM, result);
+}
+
+double FGATCController::getMaxTrafficRadius()
+{
+    trafficGrid.update(activeTraffic, globals->get_sim_time_sec());
+    return trafficGrid.getMaxRadius();
 }
 
 void FGATCController::clearTrafficControllers()
@@ -497,3 +540,38 @@ void FGATCController::clearTrafficControllers()
         traffic.clearATCController();
     }
 }
+
+void FGATCController::renderTrafficSegments(bool visible, int activeMargin)
+{
+    if (!parent) {
+        return;
+    }
+
+    if (!visible) {
+        if (FGGroundNetworkMesh* mesh = parent->getGroundNetworkMesh(false)) {
+            mesh->setVisible(false);
+        }
+        return;
+    }
+
+    // one mesh per airport, shared by its controllers; only the controller
+    // of the user aircraft renders, and it sets the state of every segment
+    FGGroundNetworkMesh* groundNetMesh = parent->getGroundNetworkMesh();
+    if (!groundNetMesh) {
+        return;
+    }
+
+    time_t now = globals->get_time_params()->get_cur_time();
+    groundNetMesh->beginUpdate();
+    for (auto& rec : activeTraffic) {
+        if ((activeMargin >= 0) && !rec.isActive(activeMargin)) {
+            continue;
+        }
+        groundNetMesh->showSegment(rec.getCurrentPosition(), now);
+        for (int k : rec.getIntentions()) {
+            groundNetMesh->showSegment(k, now);
+        }
+    }
+    groundNetMesh->commit();
+    groundNetMesh->setVisible(true);
+}
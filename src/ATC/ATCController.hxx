@@ -22,6 +22,10 @@
 
 #include <Airports/airports_fwd.hxx>
 
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
 #include <osg/Geode>
 #include <osg/Geometry>
 #include <osg/MatrixTransform>
@@ -87,6 +91,9 @@ protected:
     bool available;
     time_t lastTransmission;
     TrafficVector activeTraffic;
+    // id -> record; list iterators stay valid until the record is erased
+    std::unordered_map<int, TrafficVectorIterator> activeTrafficIndex;
+    FGTrafficGrid trafficGrid;
 
     double dt_count;
     osg::Group* group;
@@ -97,7 +104,16 @@ protected:
     bool isUserAircraft(FGAIAircraft*);
     void clearTrafficControllers();
     TrafficVectorIterator searchActiveTraffic(int id);
+    /** Adds a record, which must not exist yet, keeping the index up to date. */
+    TrafficVectorIterator addActiveTraffic(const FGTrafficRecord& rec, bool atFront = false);
+    TrafficVectorIterator eraseActiveTraffic(TrafficVectorIterator i);
     void eraseDeadTraffic();
+    /**
+     * Groundnet debug view: highlight the current and intended taxi
+     * segments of the active traffic, or only of records which are active
+     * within activeMargin seconds if that is not negative.
+     */
+    void renderTrafficSegments(bool visible, int activeMargin = -1);
     /**Returns the frequency to be used. */
     virtual int getFrequency() = 0;
 public:
@@ -161,6 +177,13 @@ public:
     TrafficVector &getActiveTraffic() {
         return activeTraffic;
     };
+    /**
+     * Append the records which may be within rangeM of pos, using the
+     * spatial grid. Callers still have to check the actual distance.
+     */
+    void findNearbyTraffic(const SGGeod& pos, double rangeM,
+                           std::vector<TrafficVectorIterator>& result);
+    double getMaxTrafficRadius();
 
     double getDt() {
         return dt_count;
@@ -99,7 +99,7 @@ void FGApproachController::announcePosition(int id,
         rec.setCallsign(ref->getCallSign());
         rec.setAircraft(ref);
         rec.setPlannedArrivalTime(intendedRoute->getArrivalTime());
-        activeTraffic.push_back(rec);
+        addActiveTraffic(rec);
     } else {
         i->setPositionAndHeading(lat, lon, heading, speed, alt);
         i->setPlannedArrivalTime(intendedRoute->getArrivalTime());
@@ -119,11 +119,7 @@ void FGGroundController::announcePosition(int id,
         rec.setCallsign(aircraft->getCallSign());
         rec.setAircraft(aircraft);
         // add to the front of the list of activeTraffic if the aircraft is already taxiing
-        if (leg == 2) {
-            activeTraffic.push_front(rec);
-        } else {
-            activeTraffic.push_back(rec);
-        }
+        addActiveTraffic(rec, leg == 2);
     } else {
         i->setPositionAndIntentions(currentPosition, intendedRoute);
         i->setPositionAndHeading(lat, lon, heading, speed, alt);
@@ -253,8 +249,15 @@ void FGGroundController::checkSpeedAdjustment(int id, double lat,
         closest = current;
         closestOnNetwork = current;
 
-        for (TrafficVectorIterator iter = activeTraffic.begin();
-                iter != activeTraffic.end(); ++iter) {
+        // Only aircraft within the distance at which we would react can
+        // matter, so look at the neighbouring grid cells instead of all traffic
+        const double maxOtherRadius = std::max(getMaxTrafficRadius(),
+                                               towerController->getMaxTrafficRadius());
+        const double searchRange = 2 * ((1.1 * current->getRadius()) + (1.1 * maxOtherRadius));
+        std::vector<TrafficVectorIterator> nearby;
+        findNearbyTraffic(curr, searchRange, nearby);
+
+        for (TrafficVectorIterator iter : nearby) {
             if (iter == current) {
                 continue;
             }
@@ -274,9 +277,9 @@ void FGGroundController::checkSpeedAdjustment(int id, double lat,
 
         // Next check with the tower controller
         if (towerController->hasActiveTraffic()) {
-            for (TrafficVectorIterator iter =
-                        towerController->getActiveTraffic().begin();
-                    iter != towerController->getActiveTraffic().end(); ++iter) {
+            nearby.clear();
+            towerController->findNearbyTraffic(curr, searchRange, nearby);
+            for (TrafficVectorIterator iter : nearby) {
                 if( current->getId() == iter->getId()) {
                     continue;
                 }
@@ -378,18 +381,10 @@ void FGGroundController::checkHoldPosition(int id, double lat,
 {
     FGGroundNetwork* network = parent->parent()->groundNetwork();
     TrafficVectorIterator current;
-    TrafficVectorIterator i = activeTraffic.begin();
-    if (activeTraffic.size()) {
-        //while ((i->getId() != id) && i != activeTraffic.end())
-        while (i != activeTraffic.end()) {
-            if (i->getId() == id) {
-                break;
-            }
-            i++;
-        }
-    } else {
+    if (activeTraffic.empty()) {
         return;
     }
+    TrafficVectorIterator i = FGATCController::searchActiveTraffic(id);
 
     time_t now = globals->get_time_params()->get_cur_time();
     if (i == activeTraffic.end() || (activeTraffic.size() == 0)) {
@@ -527,18 +522,11 @@ bool FGGroundController::checkForCircularWaits(int id)
     SG_LOG(SG_ATC, SG_DEBUG, "Performing circular check for " << id);
     int target = 0;
     TrafficVectorIterator current, other;
-    TrafficVectorIterator i = activeTraffic.begin();
     int trafficSize = activeTraffic.size();
-    if (trafficSize) {
-        while (i != activeTraffic.end()) {
-            if (i->getId() == id) {
-                break;
-            }
-            i++;
-        }
-    } else {
+    if (!trafficSize) {
         return false;
     }
+    TrafficVectorIterator i = FGATCController::searchActiveTraffic(id);
 
     if (i == activeTraffic.end()) {
         SG_LOG(SG_GENERAL, SG_ALERT,
@@ -557,17 +545,7 @@ bool FGGroundController::checkForCircularWaits(int id)
 
     while ((target > 0) && (target != id) && counter++ < trafficSize) {
         //printed = true;
-        TrafficVectorIterator iter = activeTraffic.begin();
-        if (trafficSize) {
-            while (iter != activeTraffic.end()) {
-                if (iter->getId() == target) {
-                    break;
-                }
-                ++iter;
-            }
-        } else {
-            return false;
-        }
+        TrafficVectorIterator iter = FGATCController::searchActiveTraffic(target);
 
         if (iter == activeTraffic.end()) {
             SG_LOG(SG_ATC, SG_DEBUG, "[Waiting for traffic at Runway: DONE] ");
@@ -598,209 +576,10 @@ bool FGGroundController::checkForCircularWaits(int id)
     }
 }
 
-// Note that this function is copied from simgear. for maintanance purposes, it's probabtl better to make a general function out of that.
-static void WorldCoordinate(osg::Matrix& obj_pos, double lat,
-                            double lon, double elev, double hdg, double slope)
-{
-    SGGeod geod = SGGeod::fromDegM(lon, lat, elev);
-    obj_pos = makeZUpFrame(geod);
-    // hdg is not a compass heading, but a counter-clockwise rotation
-    // around the Z axis
-    obj_pos.preMult(osg::Matrix::rotate(hdg * SGD_DEGREES_TO_RADIANS,
-                                        0.0, 0.0, 1.0));
-    obj_pos.preMult(osg::Matrix::rotate(slope * SGD_DEGREES_TO_RADIANS,
-                                        0.0, 1.0, 0.0));
-}
-
 /** Draw visible taxi routes */
 void FGGroundController::render(bool visible)
 {
-    SGMaterialLib *matlib = globals->get_matlib();
-    FGGroundNetwork* network = parent->parent()->groundNetwork();
-
-    if (group) {
-        //int nr = ;
-        globals->get_scenery()->get_scene_graph()->removeChild(group);
-        //while (group->getNumChildren()) {
-        //   SG_LOG(SG_ATC, SG_DEBUG, "Number of children: " << group->getNumChildren());
-        //simgear::EffectGeode* geode = (simgear::EffectGeode*) group->getChild(0);
-        //osg::MatrixTransform *obj_trans = (osg::MatrixTransform*) group->getChild(0);
-        //geode->releaseGLObjects();
-        //group->removeChild(geode);
-        //delete geode;
-        group = 0;
-    }
-    if (visible) {
-        group = new osg::Group;
-        FGScenery * local_scenery = globals->get_scenery();
-        // double elevation_meters = 0.0;
-//        double elevation_feet = 0.0;
-        time_t now = globals->get_time_params()->get_cur_time();
-
-        //for ( FGTaxiSegmentVectorIterator i = segments.begin(); i != segments.end(); i++) {
-        //double dx = 0;
-
-        for   (TrafficVectorIterator i = activeTraffic.begin(); i != activeTraffic.end(); i++) {
-            // Handle start point i.e. the segment that is connected to the aircraft itself on the starting end
-            // and to the the first "real" taxi segment on the other end.
-            const int pos = i->getCurrentPosition();
-            if (pos > 0) {
-                FGTaxiSegment* segment = network->findSegment(pos);
-                SGGeod start = i->getPos();
-                SGGeod end  (segment->getEnd()->geod());
-
-                double length = SGGeodesy::distanceM(start, end);
-                //heading = SGGeodesy::headingDeg(start->geod(), end->geod());
-
-                double az2, heading; //, distanceM;
-                SGGeodesy::inverse(start, end, heading, az2, length);
-                double coveredDistance = length * 0.5;
-                SGGeod center;
-                SGGeodesy::direct(start, heading, coveredDistance, center, az2);
-                SG_LOG(SG_ATC, SG_BULK, "Active Aircraft : Centerpoint = (" << center.getLatitudeDeg() << ", " << center.getLongitudeDeg() << "). Heading = " << heading);
-                ///////////////////////////////////////////////////////////////////////////////
-                // Make a helper function out of this
-                osg::Matrix obj_pos;
-                osg::MatrixTransform *obj_trans = new osg::MatrixTransform;
-                obj_trans->setDataVariance(osg::Object::STATIC);
-                // Experimental: Calculate slope here, based on length, and the individual elevations
-                double elevationStart;
-                if (isUserAircraft((i)->getAircraft())) {
-                    elevationStart = fgGetDouble("/position/ground-elev-m");
-                } else {
-                    elevationStart = ((i)->getAircraft()->_getAltitude());
-                }
-                double elevationEnd   = segment->getEnd()->getElevationM();
-                SG_LOG(SG_ATC, SG_DEBUG, "Using elevation " << elevationEnd);
-
-                if ((elevationEnd == 0) || (elevationEnd = parent->getElevation())) {
-                    SGGeod center2 = end;
-                    center2.setElevationM(SG_MAX_ELEVATION_M);
-                    if (local_scenery->get_elevation_m( center2, elevationEnd, NULL )) {
-//                        elevation_feet = elevationEnd * SG_METER_TO_FEET + 0.5;
-                        //elevation_meters += 0.5;
-                    }
-                    else {
-                        elevationEnd = parent->getElevation();
-                    }
-                    segment->getEnd()->setElevation(elevationEnd);
-                }
-                double elevationMean  = (elevationStart + elevationEnd) / 2.0;
-                double elevDiff       = elevationEnd - elevationStart;
-
-                double slope = atan2(elevDiff, length) * SGD_RADIANS_TO_DEGREES;
-
-                SG_LOG(SG_ATC, SG_DEBUG, "1. Using mean elevation : " << elevationMean << " and " << slope);
-
-                WorldCoordinate( obj_pos, center.getLatitudeDeg(), center.getLongitudeDeg(), elevationMean+ 0.5, -(heading), slope );
-
-                obj_trans->setMatrix( obj_pos );
-                //osg::Vec3 center(0, 0, 0)
-
-                float width = length /2.0;
-                osg::Vec3 corner(-width, 0, 0.25f);
-                osg::Vec3 widthVec(2*width + 1, 0, 0);
-                osg::Vec3 heightVec(0, 1, 0);
-                osg::Geometry* geometry;
-                geometry = osg::createTexturedQuadGeometry(corner, widthVec, heightVec);
-                simgear::EffectGeode* geode = new simgear::EffectGeode;
-                geode->setName("test");
-                geode->addDrawable(geometry);
-                //osg::Node *custom_obj;
-                SGMaterial *mat;
-                if (segment->hasBlock(now)) {
-                    mat = matlib->find("UnidirectionalTaperRed", center);
-                } else {
-                    mat = matlib->find("UnidirectionalTaperGreen", center);
-                }
-                if (mat)
-                    geode->setEffect(mat->get_effect());
-                obj_trans->addChild(geode);
-                // wire as much of the scene graph together as we can
-                //->addChild( obj_trans );
-                group->addChild( obj_trans );
-                /////////////////////////////////////////////////////////////////////
-            } else {
-                SG_LOG(SG_ATC, SG_INFO, "BIG FAT WARNING: current position is here : " << pos);
-            }
-            // Next: Draw the other taxi segments.
-            for (intVecIterator j = (i)->getIntentions().begin(); j != (i)->getIntentions().end(); j++) {
-                osg::Matrix obj_pos;
-                const int k = (*j);
-                if (k > 0) {
-                    osg::MatrixTransform *obj_trans = new osg::MatrixTransform;
-                    obj_trans->setDataVariance(osg::Object::STATIC);
-                    FGTaxiSegment* segmentK = network->findSegment(k);
-                    // Experimental: Calculate slope here, based on length, and the individual elevations
-                    double elevationStart = segmentK->getStart()->getElevationM();
-                    double elevationEnd   = segmentK->getEnd  ()->getElevationM();
-                    if ((elevationStart == 0)  || (elevationStart == parent->getElevation())) {
-                        SGGeod center2 = segmentK->getStart()->geod();
-                        center2.setElevationM(SG_MAX_ELEVATION_M);
-                        if (local_scenery->get_elevation_m( center2, elevationStart, NULL )) {
-//                            elevation_feet = elevationStart * SG_METER_TO_FEET + 0.5;
-                            //elevation_meters += 0.5;
-                        }
-                        else {
-                            elevationStart = parent->getElevation();
-                        }
-                        segmentK->getStart()->setElevation(elevationStart);
-                    }
-                    if ((elevationEnd == 0) || (elevationEnd == parent->getElevation())) {
-                        SGGeod center2 = segmentK->getEnd()->geod();
-                        center2.setElevationM(SG_MAX_ELEVATION_M);
-                        if (local_scenery->get_elevation_m( center2, elevationEnd, NULL )) {
-//                            elevation_feet = elevationEnd * SG_METER_TO_FEET + 0.5;
-                            //elevation_meters += 0.5;
-                        }
-                        else {
-                            elevationEnd = parent->getElevation();
-                        }
-                        segmentK->getEnd()->setElevation(elevationEnd);
-                    }
-
-                    double elevationMean  = (elevationStart + elevationEnd) / 2.0;
-                    double elevDiff       = elevationEnd - elevationStart;
-                    double length         = segmentK->getLength();
-                    double slope = atan2(elevDiff, length) * SGD_RADIANS_TO_DEGREES;
-
-                    SG_LOG(SG_ATC, SG_DEBUG, "2. Using mean elevation : " << elevationMean << " and " << slope);
-
-                    SGGeod segCenter = segmentK->getCenter();
-                    WorldCoordinate( obj_pos, segCenter.getLatitudeDeg(), segCenter.getLongitudeDeg(),
-                                     elevationMean+ 0.5, -(segmentK->getHeading()), slope );
-
-                    obj_trans->setMatrix( obj_pos );
-                    //osg::Vec3 center(0, 0, 0)
-
-                    float width = segmentK->getLength() /2.0;
-                    osg::Vec3 corner(-width, 0, 0.25f);
-                    osg::Vec3 widthVec(2*width + 1, 0, 0);
-                    osg::Vec3 heightVec(0, 1, 0);
-                    osg::Geometry* geometry;
-                    geometry = osg::createTexturedQuadGeometry(corner, widthVec, heightVec);
-                    simgear::EffectGeode* geode = new simgear::EffectGeode;
-                    geode->setName("test");
-                    geode->addDrawable(geometry);
-                    //osg::Node *custom_obj;
-                    SGMaterial *mat;
-                    if (segmentK->hasBlock(now)) {
-                        mat = matlib->find("UnidirectionalTaperRed", segCenter);
-                    } else {
-                        mat = matlib->find("UnidirectionalTaperGreen", segCenter);
-                    }
-                    if (mat)
-                        geode->setEffect(mat->get_effect());
-                    obj_trans->addChild(geode);
-                    // wire as much of the scene graph together as we can
-                    //->addChild( obj_trans );
-                    group->addChild( obj_trans );
-                }
-            }
-            //dx += 0.1;
-        }
-        globals->get_scenery()->get_scene_graph()->addChild(group);
-    }
+    renderTrafficSegments(visible);
 }
 
 string FGGroundController::getName() {
@@ -814,6 +593,19 @@ void FGGroundController::update(double dt)
     network->unblockAllSegments(now);
     int priority = 1;
 
+    // Segments whose opposite direction is currently occupied by taxiing
+    // traffic; departing aircraft must not push back onto those.
+    opposedSegments.clear();
+    for (const auto& rec : activeTraffic) {
+        int pos = rec.getCurrentPosition();
+        if (pos > 0) {
+            FGTaxiSegment *seg = network->findOppositeSegment(pos-1);
+            if (seg) {
+                opposedSegments.insert(seg->getIndex());
+            }
+        }
+    }
+
     TrafficVector& startupTraffic(parent->getStartupController()->getActiveTraffic());
     TrafficVectorIterator i;
 
@@ -862,21 +654,12 @@ void FGGroundController::updateStartupTraffic(TrafficVectorIterator i,
         return;
     }
 
-    // Check for all active aircraft whether it's current pos segment is
-    // an opposite of one of the departing aircraft's intentions
-    for (TrafficVectorIterator j = activeTraffic.begin(); j != activeTraffic.end(); j++) {
-        int pos = j->getCurrentPosition();
-        if (pos > 0) {
-            FGTaxiSegment *seg = network->findOppositeSegment(pos-1);
-            if (seg) {
-                int posReverse = seg->getIndex();
-                for (intVecIterator k = i->getIntentions().begin(); k != i->getIntentions().end(); k++) {
-                    if ((*k) == posReverse) {
-                        i->denyPushBack();
-                        network->findSegment(posReverse)->block(i->getId(), now, now);
-                    }
-                }
-            }
+    // Check whether any of the departing aircraft's intentions is the
+    // opposite of a segment an active aircraft is currently on
+    for (intVecIterator k = i->getIntentions().begin(); k != i->getIntentions().end(); k++) {
+        if (opposedSegments.count(*k)) {
+            i->denyPushBack();
+            network->findSegment(*k)->block(i->getId(), now, now);
         }
     }
     // if the current aircraft is still allowed to pushback, we can start reserving a route for if by blocking all the entry taxiways.
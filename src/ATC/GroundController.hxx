@@ -26,6 +26,7 @@
 #include <simgear/compiler.h>
 
 #include <string>
+#include <unordered_set>
 
 #include <ATC/trafficcontrol.hxx>
 #include <ATC/TowerController.hxx>
@@ -46,6 +47,8 @@ private:
     int version;
 
     FGTowerController *towerController;
+    // rebuilt every update(), see updateStartupTraffic()
+    std::unordered_set<int> opposedSegments;
     /**Returns the frequency to be used. */
     int getFrequency();
 
@@ -0,0 +1,275 @@
+// GroundNetworkMesh.cxx - persistent geometry for the ATC groundnet debug view
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include <config.h>
+
+#include "GroundNetworkMesh.hxx"
+
+#include <algorithm>
+
+#include <osg/Geode>
+#include <osg/PrimitiveSet>
+#include <osg/StateSet>
+
+#include <simgear/constants.h>
+#include <simgear/debug/logstream.hxx>
+#include <simgear/math/SGMath.hxx>
+#include <simgear/scene/util/OsgMath.hxx>
+
+#include <Airports/airport.hxx>
+#include <Airports/dynamics.hxx>
+#include <Airports/groundnetwork.hxx>
+#include <Main/globals.hxx>
+#include <Scenery/scenery.hxx>
+
+namespace {
+
+const float HALF_WIDTH_M = 0.5f;
+const float END_OVERLAP_M = 0.5f;
+const double HEIGHT_ABOVE_GROUND_M = 0.75;
+const int ELEVATION_RETRY_COMMITS = 100;
+
+const osg::Vec4 COLOR_HIDDEN(0.0f, 0.0f, 0.0f, 0.0f);
+const osg::Vec4 COLOR_FREE(0.0f, 1.0f, 0.0f, 0.8f);
+const osg::Vec4 COLOR_BLOCKED(1.0f, 0.0f, 0.0f, 0.8f);
+
+const osg::Vec4& colorForState(unsigned char state)
+{
+    switch (state) {
+    case FGGroundNetworkMesh::FREE:    return COLOR_FREE;
+    case FGGroundNetworkMesh::BLOCKED: return COLOR_BLOCKED;
+    default:
+        break;
+    }
+    return COLOR_HIDDEN;
+}
+
+} // of anonymous namespace
+
+FGGroundNetworkMesh::FGGroundNetworkMesh(FGGroundNetwork* network, FGAirportDynamics* dynamics) :
+    _network(network),
+    _dynamics(dynamics)
+{
+    build();
+}
+
+FGGroundNetworkMesh::~FGGroundNetworkMesh()
+{
+    setVisible(false);
+}
+
+double FGGroundNetworkMesh::nodeElevation(FGTaxiNode* node, bool& resolved)
+{
+    // same rules as the previous per-frame geometry: node elevations of 0
+    // or the airport elevation are placeholders, ask the scenery instead
+    double elevation = node->getElevationM();
+    const double airportElevation = _dynamics->getElevation();
+    if ((elevation != 0) && (elevation != airportElevation)) {
+        return elevation;
+    }
+
+    FGScenery* scenery = globals->get_scenery();
+    SGGeod probe = node->geod();
+    probe.setElevationM(SG_MAX_ELEVATION_M);
+    if (scenery && scenery->get_elevation_m(probe, elevation, nullptr)) {
+        node->setElevation(elevation);
+        return elevation;
+    }
+
+    resolved = false;
+    return airportElevation;
+}
+
+void FGGroundNetworkMesh::build()
+{
+    const SGGeod origin = _dynamics->parent()->geod();
+    const osg::Matrix frame = makeZUpFrame(origin);
+    _worldToLocal = osg::Matrix::inverse(frame);
+
+    const unsigned int count = _network->getNumSegments();
+    _vertices = new osg::Vec3Array(count * 4);
+    _colors = new osg::Vec4Array(count * 4, COLOR_HIDDEN);
+    _colors->setDataVariance(osg::Object::DYNAMIC);
+    _state.assign(count, HIDDEN);
+    _pending.assign(count, HIDDEN);
+
+    osg::ref_ptr<osg::DrawElementsUInt> triangles = new osg::DrawElementsUInt(GL_TRIANGLES);
+    triangles->reserve(count * 6);
+
+    for (unsigned int i = 0; i < count; ++i) {
+        FGTaxiSegment* segment = _network->findSegment(i + 1);
+        bool resolved = true;
+        const double startElev = nodeElevation(segment->getStart(), resolved);
+        const double endElev = nodeElevation(segment->getEnd(), resolved);
+        if (!resolved) {
+            _unresolved.push_back(i + 1);
+        }
+
+        SGGeod start = segment->getStart()->geod();
+        start.setElevationM(startElev + HEIGHT_ABOVE_GROUND_M);
+        SGGeod end = segment->getEnd()->geod();
+        end.setElevationM(endElev + HEIGHT_ABOVE_GROUND_M);
+
+        const osg::Vec3 s(toOsg(SGVec3d::fromGeod(start)) * _worldToLocal);
+        const osg::Vec3 e(toOsg(SGVec3d::fromGeod(end)) * _worldToLocal);
+        osg::Vec3 dir(e.x() - s.x(), e.y() - s.y(), 0.0f);
+        if (dir.normalize() < 1e-3f) {
+            dir.set(1.0f, 0.0f, 0.0f);
+        }
+        const osg::Vec3 side(-dir.y() * HALF_WIDTH_M, dir.x() * HALF_WIDTH_M, 0.0f);
+        const osg::Vec3 overlap(dir * END_OVERLAP_M);
+
+        const unsigned int v = i * 4;
+        (*_vertices)[v + 0] = s - overlap + side;
+        (*_vertices)[v + 1] = s - overlap - side;
+        (*_vertices)[v + 2] = e + overlap - side;
+        (*_vertices)[v + 3] = e + overlap + side;
+
+        triangles->push_back(v + 0);
+        triangles->push_back(v + 1);
+        triangles->push_back(v + 2);
+        triangles->push_back(v + 0);
+        triangles->push_back(v + 2);
+        triangles->push_back(v + 3);
+    }
+
+    _geometry = new osg::Geometry;
+    _geometry->setDataVariance(osg::Object::DYNAMIC);
+    _geometry->setUseDisplayList(false);
+    _geometry->setUseVertexBufferObjects(true);
+    _geometry->setVertexArray(_vertices.get());
+    _geometry->setColorArray(_colors.get(), osg::Array::BIND_PER_VERTEX);
+    _geometry->addPrimitiveSet(triangles.get());
+
+    osg::Geode* geode = new osg::Geode;
+    geode->setName("groundnet-debug");
+    geode->addDrawable(_geometry.get());
+
+    osg::StateSet* ss = geode->getOrCreateStateSet();
+    ss->setMode(GL_LIGHTING, osg::StateAttribute::OFF);
+    ss->setMode(GL_BLEND, osg::StateAttribute::ON);
+    ss->setRenderingHint(osg::StateSet::TRANSPARENT_BIN);
+
+    _transform = new osg::MatrixTransform(frame);
+    _transform->addChild(geode);
+
+    SG_LOG(SG_ATC, SG_DEBUG, "Built groundnet mesh for " << _dynamics->parent()->ident()
+           << " with " << count << " segments, " << _unresolved.size() << " without elevation");
+}
+
+void FGGroundNetworkMesh::retryElevations()
+{
+    const osg::Matrix localToWorld = _transform->getMatrix();
+    std::vector<int> stillUnresolved;
+    bool changed = false;
+    for (int index : _unresolved) {
+        FGTaxiSegment* segment = _network->findSegment(index);
+        bool resolved = true;
+        const double startElev = nodeElevation(segment->getStart(), resolved);
+        const double endElev = nodeElevation(segment->getEnd(), resolved);
+        if (!resolved) {
+            stillUnresolved.push_back(index);
+            continue;
+        }
+
+        // only the heights change, the quad keeps its shape
+        const unsigned int v = (index - 1) * 4;
+        const double elev[4] = {startElev, startElev, endElev, endElev};
+        for (int k = 0; k < 4; ++k) {
+            const osg::Vec3d world = osg::Vec3d((*_vertices)[v + k]) * localToWorld;
+            SGGeod geod = SGGeod::fromCart(toSG(world));
+            geod.setElevationM(elev[k] + HEIGHT_ABOVE_GROUND_M);
+            (*_vertices)[v + k] = toOsg(SGVec3d::fromGeod(geod)) * _worldToLocal;
+        }
+        changed = true;
+    }
+
+    _unresolved.swap(stillUnresolved);
+    if (changed) {
+        _vertices->dirty();
+        _geometry->dirtyBound();
+    }
+}
+
+void FGGroundNetworkMesh::beginUpdate()
+{
+    std::fill(_pending.begin(), _pending.end(), HIDDEN);
+}
+
+void FGGroundNetworkMesh::setState(int index, SegmentState state)
+{
+    if ((index < 1) || (index > static_cast<int>(_pending.size()))) {
+        return;
+    }
+    _pending[index - 1] = state;
+}
+
+void FGGroundNetworkMesh::showSegment(int index, time_t now)
+{
+    FGTaxiSegment* segment = _network->findSegment(index);
+    if (!segment) {
+        return;
+    }
+    setState(index, segment->hasBlock(now) ? BLOCKED : FREE);
+}
+
+int FGGroundNetworkMesh::commit()
+{
+    int changed = 0;
+    for (size_t i = 0; i < _pending.size(); ++i) {
+        if (_pending[i] == _state[i]) {
+            continue;
+        }
+
+        _state[i] = _pending[i];
+        const osg::Vec4& color = colorForState(_state[i]);
+        for (size_t k = i * 4; k < i * 4 + 4; ++k) {
+            (*_colors)[k] = color;
+        }
+        ++changed;
+    }
+
+    if (changed) {
+        _colors->dirty();
+    }
+
+    if (!_unresolved.empty() && (++_commitsSinceRetry >= ELEVATION_RETRY_COMMITS)) {
+        _commitsSinceRetry = 0;
+        retryElevations();
+    }
+
+    return changed;
+}
+
+void FGGroundNetworkMesh::setVisible(bool visible)
+{
+    if (visible == _visible) {
+        return;
+    }
+
+    FGScenery* scenery = globals->get_scenery();
+    if (!scenery || !scenery->get_scene_graph()) {
+        _visible = false;
+        return;
+    }
+
+    if (visible) {
+        scenery->get_scene_graph()->addChild(_transform.get());
+    } else {
+        scenery->get_scene_graph()->removeChild(_transform.get());
+    }
+    _visible = visible;
+}
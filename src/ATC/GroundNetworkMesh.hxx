@@ -0,0 +1,94 @@
+// GroundNetworkMesh.hxx - persistent geometry for the ATC groundnet debug view
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifndef ATC_GROUND_NETWORK_MESH_HXX
+#define ATC_GROUND_NETWORK_MESH_HXX
+
+#include <ctime>
+#include <vector>
+
+#include <osg/Array>
+#include <osg/Geometry>
+#include <osg/MatrixTransform>
+#include <osg/ref_ptr>
+
+#include <Airports/airports_fwd.hxx>
+
+/**
+ * All taxiway segments of one ground network as a single vertex buffer,
+ * one quad per segment. Owned by the FGAirportDynamics of the airport, so
+ * all of its controllers draw into the same mesh. The vertices are computed once; the controllers'
+ * render() only assigns a state per segment, and the colour array is
+ * touched for the segments whose state actually changed.
+ *
+ * Usage per frame: beginUpdate(), setState() or showSegment() for every
+ * segment which should be shown, commit().
+ */
+class FGGroundNetworkMesh
+{
+public:
+    enum SegmentState {
+        HIDDEN = 0,
+        FREE,
+        BLOCKED
+    };
+
+    FGGroundNetworkMesh(FGGroundNetwork* network, FGAirportDynamics* dynamics);
+    ~FGGroundNetworkMesh();
+
+    void beginUpdate();
+
+    /// @param index segment index as used by FGGroundNetwork::findSegment()
+    void setState(int index, SegmentState state);
+
+    /// show a segment as FREE or BLOCKED depending on its blocks at now
+    void showSegment(int index, time_t now);
+
+    /// upload the changed colours, returns the number of changed segments
+    int commit();
+
+    /// add to or remove from the scene graph
+    void setVisible(bool visible);
+
+    /// number of segments in the mesh
+    size_t size() const
+    { return _state.size(); }
+
+private:
+    void build();
+    double nodeElevation(FGTaxiNode* node, bool& resolved);
+    void retryElevations();
+
+    FGGroundNetwork* _network;
+    FGAirportDynamics* _dynamics;
+
+    osg::ref_ptr<osg::MatrixTransform> _transform;
+    osg::ref_ptr<osg::Geometry> _geometry;
+    osg::ref_ptr<osg::Vec3Array> _vertices;
+    osg::ref_ptr<osg::Vec4Array> _colors;
+    osg::Matrix _worldToLocal;
+
+    std::vector<unsigned char> _state;      ///< what the colour array shows
+    std::vector<unsigned char> _pending;    ///< collected since beginUpdate()
+
+    // segments whose node elevations weren't available from the scenery
+    // yet; their vertices are corrected once the tiles are loaded
+    std::vector<int> _unresolved;
+    int _commitsSinceRetry = 0;
+    bool _visible = false;
+};
+
+#endif // ATC_GROUND_NETWORK_MESH_HXX
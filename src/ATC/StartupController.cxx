@@ -97,7 +97,7 @@ void FGStartupController::announcePosition(int id,
         rec.setCallsign(ref->getCallSign());
         rec.setAircraft(ref);
         rec.setHoldPosition(true);
-        activeTraffic.push_back(rec);
+        addActiveTraffic(rec);
     } else {
         i->setPositionAndIntentions(currentPosition, intendedRoute);
         i->setPositionAndHeading(lat, lon, heading, speed, alt);
@@ -191,216 +191,10 @@ void FGStartupController::updateAircraftInformation(int id, SGGeod geod, double
     }
 }
 
-// Note that this function is copied from simgear. for maintenance purposes, it's probably better to make a general function out of that.
-static void WorldCoordinate(osg::Matrix& obj_pos, double lat,
-                            double lon, double elev, double hdg, double slope)
-{
-    SGGeod geod = SGGeod::fromDegM(lon, lat, elev);
-    obj_pos = makeZUpFrame(geod);
-    // hdg is not a compass heading, but a counter-clockwise rotation
-    // around the Z axis
-    obj_pos.preMult(osg::Matrix::rotate(hdg * SGD_DEGREES_TO_RADIANS,
-                                        0.0, 0.0, 1.0));
-    obj_pos.preMult(osg::Matrix::rotate(slope * SGD_DEGREES_TO_RADIANS,
-                                        0.0, 1.0, 0.0));
-}
-
-
 void FGStartupController::render(bool visible)
 {
-    SGMaterialLib *matlib = globals->get_matlib();
-    if (group) {
-        //int nr = ;
-        globals->get_scenery()->get_scene_graph()->removeChild(group);
-        //while (group->getNumChildren()) {
-        // SG_LOG(SG_ATC, SG_BULK, "Number of children: " << group->getNumChildren());
-        //simgear::EffectGeode* geode = (simgear::EffectGeode*) group->getChild(0);
-        //osg::MatrixTransform *obj_trans = (osg::MatrixTransform*) group->getChild(0);
-        //geode->releaseGLObjects();
-        //group->removeChild(geode);
-        //delete geode;
-        group = 0;
-    }
-    if (visible) {
-        SG_LOG(SG_ATC, SG_BULK, "Rendering startup controller");
-        group = new osg::Group;
-        FGScenery * local_scenery = globals->get_scenery();
-        //double elevation_meters = 0.0;
-        //double elevation_feet = 0.0;
-
-        FGGroundNetwork* groundNet = parent->parent()->groundNetwork();
-
-        //for ( FGTaxiSegmentVectorIterator i = segments.begin(); i != segments.end(); i++) {
-        double dx = 0;
-        time_t now = globals->get_time_params()->get_cur_time();
-
-        for   (TrafficVectorIterator i = activeTraffic.begin(); i != activeTraffic.end(); ++i) {
-            if (i->isActive(300)) {
-                // Handle start point
-                int pos = i->getCurrentPosition();
-                SG_LOG(SG_ATC, SG_BULK, "rendering for " << i->getAircraft()->getCallSign() << "pos = " << pos);
-                if (pos > 0) {
-                    FGTaxiSegment *segment = groundNet->findSegment(pos);
-                    SGGeod start = i->getPos();
-                    SGGeod end  (segment->getEnd()->geod());
-
-                    double length = SGGeodesy::distanceM(start, end);
-                    //heading = SGGeodesy::headingDeg(start->geod(), end->geod());
-
-                    double az2, heading; //, distanceM;
-                    SGGeodesy::inverse(start, end, heading, az2, length);
-                    double coveredDistance = length * 0.5;
-                    SGGeod center;
-                    SGGeodesy::direct(start, heading, coveredDistance, center, az2);
-                    SG_LOG(SG_ATC, SG_BULK, "Active Aircraft : Centerpoint = (" << center.getLatitudeDeg() << ", " << center.getLongitudeDeg() << "). Heading = " << heading);
-                    ///////////////////////////////////////////////////////////////////////////////
-                    // Make a helper function out of this
-                    osg::Matrix obj_pos;
-                    osg::MatrixTransform *obj_trans = new osg::MatrixTransform;
-                    obj_trans->setDataVariance(osg::Object::STATIC);
-                    // Experimental: Calculate slope here, based on length, and the individual elevations
-                    double elevationStart;
-                    if (isUserAircraft((i)->getAircraft())) {
-                        elevationStart = fgGetDouble("/position/ground-elev-m");
-                    } else {
-                        elevationStart = ((i)->getAircraft()->_getAltitude() * SG_FEET_TO_METER);
-                    }
-                    double elevationEnd   = segment->getEnd()->getElevationM();
-                    if ((elevationEnd == 0) || (elevationEnd == parent->getElevation())) {
-                        SGGeod center2 = end;
-                        center2.setElevationM(SG_MAX_ELEVATION_M);
-                        if (local_scenery->get_elevation_m( center2, elevationEnd, NULL )) {
-                            //elevation_feet = elevationEnd * SG_METER_TO_FEET + 0.5;
-                            //elevation_meters += 0.5;
-                        }
-                        else {
-                            elevationEnd = parent->getElevation();
-                        }
-                        segment->getEnd()->setElevation(elevationEnd);
-                    }
-
-                    double elevationMean  = (elevationStart + elevationEnd) / 2.0;
-                    double elevDiff       = elevationEnd - elevationStart;
-
-                    double slope = atan2(elevDiff, length) * SGD_RADIANS_TO_DEGREES;
-
-                    SG_LOG(SG_ATC, SG_BULK, "1. Using mean elevation : " << elevationMean << " and " << slope);
-
-                    WorldCoordinate( obj_pos, center.getLatitudeDeg(), center.getLongitudeDeg(), elevationMean + 0.5 + dx, -(heading), slope );
-                    ;
-
-                    obj_trans->setMatrix( obj_pos );
-                    //osg::Vec3 center(0, 0, 0)
-
-                    float width = length /2.0;
-                    osg::Vec3 corner(-width, 0, 0.25f);
-                    osg::Vec3 widthVec(2*width + 1, 0, 0);
-                    osg::Vec3 heightVec(0, 1, 0);
-                    osg::Geometry* geometry;
-                    geometry = osg::createTexturedQuadGeometry(corner, widthVec, heightVec);
-                    simgear::EffectGeode* geode = new simgear::EffectGeode;
-                    geode->setName("test");
-                    geode->addDrawable(geometry);
-                    //osg::Node *custom_obj;
-                    SGMaterial *mat;
-                    if (segment->hasBlock(now)) {
-                        mat = matlib->find("UnidirectionalTaperRed", center);
-                    } else {
-                        mat = matlib->find("UnidirectionalTaperGreen", center);
-                    }
-                    if (mat)
-                        geode->setEffect(mat->get_effect());
-                    obj_trans->addChild(geode);
-                    // wire as much of the scene graph together as we can
-                    //->addChild( obj_trans );
-                    group->addChild( obj_trans );
-                    /////////////////////////////////////////////////////////////////////
-                } else {
-                    SG_LOG(SG_ATC, SG_DEBUG, "BIG FAT WARNING: current position is here : " << pos);
-                }
-                for (intVecIterator j = (i)->getIntentions().begin(); j != (i)->getIntentions().end(); ++j) {
-                    osg::Matrix obj_pos;
-                    int k = (*j);
-                    if (k > 0) {
-                        SG_LOG(SG_ATC, SG_BULK, "rendering for " << i->getAircraft()->getCallSign() << "intention = " << k);
-                        osg::MatrixTransform *obj_trans = new osg::MatrixTransform;
-                        obj_trans->setDataVariance(osg::Object::STATIC);
-                        FGTaxiSegment *segment  = groundNet->findSegment(k);
-
-                        double elevationStart = segment->getStart()->getElevationM();
-                        double elevationEnd   = segment->getEnd  ()->getElevationM();
-                        if ((elevationStart == 0) || (elevationStart == parent->getElevation())) {
-                            SGGeod center2 = segment->getStart()->geod();
-                            center2.setElevationM(SG_MAX_ELEVATION_M);
-                            if (local_scenery->get_elevation_m( center2, elevationStart, NULL )) {
-                                //elevation_feet = elevationStart * SG_METER_TO_FEET + 0.5;
-                                //elevation_meters += 0.5;
-                            }
-                            else {
-                                elevationStart = parent->getElevation();
-                            }
-                            segment->getStart()->setElevation(elevationStart);
-                        }
-                        if ((elevationEnd == 0) || (elevationEnd == parent->getElevation())) {
-                            SGGeod center2 = segment->getEnd()->geod();
-                            center2.setElevationM(SG_MAX_ELEVATION_M);
-                            if (local_scenery->get_elevation_m( center2, elevationEnd, NULL )) {
-                                //elevation_feet = elevationEnd * SG_METER_TO_FEET + 0.5;
-                                //elevation_meters += 0.5;
-                            }
-                            else {
-                                elevationEnd = parent->getElevation();
-                            }
-                            segment->getEnd()->setElevation(elevationEnd);
-                        }
-
-                        double elevationMean  = (elevationStart + elevationEnd) / 2.0;
-                        double elevDiff       = elevationEnd - elevationStart;
-                        double length         = segment->getLength();
-                        double slope = atan2(elevDiff, length) * SGD_RADIANS_TO_DEGREES;
-
-                        SG_LOG(SG_ATC, SG_BULK, "2. Using mean elevation : " << elevationMean << " and " << slope);
-
-                        SGGeod segCenter(segment->getCenter());
-                        WorldCoordinate( obj_pos, segCenter.getLatitudeDeg(),
-                                        segCenter.getLongitudeDeg(), elevationMean + 0.5 + dx, -(segment->getHeading()), slope );
-
-                        //WorldCoordinate( obj_pos, segment->getLatitude(), segment->getLongitude(), parent->getElevation()+8+dx, -(segment->getHeading()) );
-
-                        obj_trans->setMatrix( obj_pos );
-                        //osg::Vec3 center(0, 0, 0)
-
-                        float width = segment->getLength() /2.0;
-                        osg::Vec3 corner(-width, 0, 0.25f);
-                        osg::Vec3 widthVec(2*width + 1, 0, 0);
-                        osg::Vec3 heightVec(0, 1, 0);
-                        osg::Geometry* geometry;
-                        geometry = osg::createTexturedQuadGeometry(corner, widthVec, heightVec);
-                        simgear::EffectGeode* geode = new simgear::EffectGeode;
-                        geode->setName("test");
-                        geode->addDrawable(geometry);
-                        //osg::Node *custom_obj;
-                        SGMaterial *mat;
-                        if (segment->hasBlock(now)) {
-                            mat = matlib->find("UnidirectionalTaperRed", segCenter);
-                        } else {
-                            mat = matlib->find("UnidirectionalTaperGreen", segCenter);
-                        }
-                        if (mat)
-                            geode->setEffect(mat->get_effect());
-                        obj_trans->addChild(geode);
-                        // wire as much of the scene graph together as we can
-                        //->addChild( obj_trans );
-                        group->addChild( obj_trans );
-                    } else {
-                        SG_LOG(SG_ATC, SG_DEBUG, "BIG FAT WARNING: k is here : " << pos);
-                    }
-                }
-                dx += 0.2;
-            }
-        }
-        globals->get_scenery()->get_scene_graph()->addChild(group);
-    }
+    // only show aircraft which are about to push back
+    renderTrafficSegments(visible, 300);
 }
 
 string FGStartupController::getName() {
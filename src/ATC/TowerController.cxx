@@ -99,7 +99,7 @@ void FGTowerController::announcePosition(int id,
         rec.setCallsign(ref->getCallSign());
         rec.setRadius(radius);
         rec.setAircraft(ref);
-        activeTraffic.push_back(rec);
+        addActiveTraffic(rec);
         // Don't just schedule the aircraft for the tower controller, also assign if to the correct active runway.
         ActiveRunwayVecIterator rwy = activeRunways.begin();
         if (! activeRunways.empty()) {
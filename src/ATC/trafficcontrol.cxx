@@ -23,8 +23,10 @@
 #include <config.h>
 
 #include <algorithm>
+#include <cmath>
 #include <cstdio>
 #include <random>
+#include <unordered_set>
 
 #include <osg/Geode>
 #include <osg/Geometry>
@@ -412,18 +414,21 @@ int FGTrafficRecord::crosses(FGGroundNetwork * net,
         }
     }
     if (! intentions.empty() && ! other.intentions.empty()) {
+        // collect the nodes the other route passes through once, instead
+        // of comparing every pair of segments
+        std::unordered_set<int> otherNodes;
+        for (j = other.intentions.begin(); j != other.intentions.end(); ++j) {
+            if ((*j) > 0) {
+                otherNodes.insert(net->findSegment(*j)->getEnd()->getIndex());
+            }
+        }
         for (i = intentions.begin(); i != intentions.end(); ++i) {
-            for (j = other.intentions.begin(); j != other.intentions.end(); ++j) {
-                SG_LOG(SG_ATC, SG_BULK, "finding segment " << *i << " and " << *j);
-                if (((*i) > 0) && ((*j) > 0)) {
-                    currentTargetNode =
-                        net->findSegment(*i)->getEnd()->getIndex();
-                    otherTargetNode =
-                        net->findSegment(*j)->getEnd()->getIndex();
-                    if (currentTargetNode == otherTargetNode) {
-                        SG_LOG(SG_ATC, SG_BULK, "Routes will cross at " << currentTargetNode);
-                        return currentTargetNode;
-                    }
+            if ((*i) > 0) {
+                currentTargetNode =
+                    net->findSegment(*i)->getEnd()->getIndex();
+                if (otherNodes.count(currentTargetNode)) {
+                    SG_LOG(SG_ATC, SG_BULK, "Routes will cross at " << currentTargetNode);
+                    return currentTargetNode;
                 }
             }
         }
@@ -580,3 +585,70 @@ bool FGATCInstruction::hasInstruction() const
     return (holdPattern || holdPosition || changeSpeed || changeHeading
             || changeAltitude || resolveCircularWait);
 }
+
+/***************************************************************************
+ * FGTrafficGrid
+ **************************************************************************/
+
+namespace {
+// large enough that a query for the usual separation distances only
+// needs to look at the neighbouring cells
+const double TRAFFIC_GRID_CELL_M = 250.0;
+const double METERS_PER_DEGREE = SG_NM_TO_METER * 60.0;
+}
+
+int FGTrafficGrid::latCell(double lat) const
+{
+    return static_cast<int>(std::floor(lat * METERS_PER_DEGREE / TRAFFIC_GRID_CELL_M));
+}
+
+int FGTrafficGrid::lonCell(double lon) const
+{
+    return static_cast<int>(std::floor(lon * METERS_PER_DEGREE * lonScale / TRAFFIC_GRID_CELL_M));
+}
+
+void FGTrafficGrid::update(TrafficVector& traffic, double simTime)
+{
+    if (!dirty && (builtAt == simTime)) {
+        return;
+    }
+
+    cells.clear();
+    maxRadius = 0.0;
+    dirty = false;
+    builtAt = simTime;
+    if (traffic.empty()) {
+        return;
+    }
+
+    // all traffic of a controller is at or near one airport, so a single
+    // longitude scale is good enough
+    const double refLat = traffic.front().getPos().getLatitudeRad();
+    lonScale = std::max(0.01, std::cos(refLat));
+
+    for (TrafficVectorIterator i = traffic.begin(); i != traffic.end(); ++i) {
+        const SGGeod pos = i->getPos();
+        cells[key(latCell(pos.getLatitudeDeg()), lonCell(pos.getLongitudeDeg()))].push_back(i);
+        maxRadius = std::max(maxRadius, i->getRadius());
+    }
+}
+
+void FGTrafficGrid::query(const SGGeod& pos, double rangeM,
+                          std::vector<TrafficVectorIterator>& result) const
+{
+    if (cells.empty()) {
+        return;
+    }
+
+    const int span = static_cast<int>(std::ceil(rangeM / TRAFFIC_GRID_CELL_M)) + 1;
+    const int lat0 = latCell(pos.getLatitudeDeg());
+    const int lon0 = lonCell(pos.getLongitudeDeg());
+    for (int dlat = -span; dlat <= span; ++dlat) {
+        for (int dlon = -span; dlon <= span; ++dlon) {
+            auto it = cells.find(key(lat0 + dlat, lon0 + dlon));
+            if (it != cells.end()) {
+                result.insert(result.end(), it->second.begin(), it->second.end());
+            }
+        }
+    }
+}
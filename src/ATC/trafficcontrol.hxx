@@ -23,6 +23,10 @@
 
 #include <Airports/airports_fwd.hxx>
 
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+
 #include <osg/Geode>
 #include <osg/Geometry>
 #include <osg/MatrixTransform>
@@ -345,6 +349,47 @@ public:
     int getPriority() const { return priority; };
 };
 
+/***********************************************************************
+ * FGTrafficGrid
+ * Coarse spatial bucketing of the traffic records of one controller, so
+ * that proximity checks only look at aircraft in the neighbouring cells
+ * instead of at all active traffic. The grid is rebuilt lazily, at most
+ * once per frame or after records were added or removed; queries add a
+ * cell of margin to cover movement since the last rebuild.
+ **********************************************************************/
+class FGTrafficGrid
+{
+public:
+    void invalidate() {
+        dirty = true;
+    };
+
+    /** Rebuild from traffic unless this was already done at simTime. */
+    void update(TrafficVector& traffic, double simTime);
+
+    /** Append all records which may be within rangeM of pos. */
+    void query(const SGGeod& pos, double rangeM,
+               std::vector<TrafficVectorIterator>& result) const;
+
+    /** Largest radius of the records, as of the last rebuild. */
+    double getMaxRadius() const {
+        return maxRadius;
+    };
+
+private:
+    int latCell(double lat) const;
+    int lonCell(double lon) const;
+    static int64_t key(int latIdx, int lonIdx) {
+        return (static_cast<int64_t>(latIdx) << 32) ^ static_cast<uint32_t>(lonIdx);
+    };
+
+    std::unordered_map<int64_t, std::vector<TrafficVectorIterator> > cells;
+    double builtAt = -1.0;
+    bool dirty = true;
+    double lonScale = 1.0;      ///< cos(latitude) of the traffic, fixed per rebuild
+    double maxRadius = 0.0;
+};
+
 /***********************************************************************
  * Active runway, a utility class to keep track of which aircraft has
  * clearance for a given runway.
@@ -23,9 +23,55 @@
 #include <simgear/constants.h>
 
 #include <Main/fg_props.hxx>
+#include <Main/globals.hxx>
 
 using namespace flightgear;
 
+namespace {
+
+class PerformanceDataListener : public SGPropertyChangeListener
+{
+public:
+    unsigned int serial()
+    {
+        // attach on first use, and again to a new property tree (tests)
+        SGPropertyNode* root = globals->get_props();
+        if (root != _root) {
+            if (_node) {
+                _node->removeChangeListener(this);
+            }
+            _root = root;
+            _node = root->getNode("aircraft/performance", true);
+            _node->addChangeListener(this);
+            ++_serial;
+        }
+
+        return _serial;
+    }
+
+    void valueChanged(SGPropertyNode*) override
+    {
+        ++_serial;
+    }
+
+    void childAdded(SGPropertyNode*, SGPropertyNode*) override
+    {
+        ++_serial;
+    }
+
+    void childRemoved(SGPropertyNode*, SGPropertyNode*) override
+    {
+        ++_serial;
+    }
+
+private:
+    SGPropertyNode_ptr _root;
+    SGPropertyNode_ptr _node;
+    unsigned int _serial = 0;
+};
+
+} // of anonymous namespace
+
 double distanceForTimeAndSpeeds(double tSec, double v1, double v2)
 {
     return tSec * 0.5 * (v1 + v2);
@@ -43,6 +89,17 @@ AircraftPerformance::AircraftPerformance()
     }
 }
 
+unsigned int AircraftPerformance::dataSerial()
+{
+    static PerformanceDataListener listener;
+    return listener.serial();
+}
+
+bool AircraftPerformance::operator==(const AircraftPerformance& other) const
+{
+    return _perfData == other._perfData;
+}
+
 double AircraftPerformance::groundSpeedForAltitudeKnots(int altitudeFt) const
 {
     auto bracket = bracketForAltitude(altitudeFt);
@@ -340,6 +397,15 @@ double AircraftPerformance::groundSpeedForMach(int altitudeFt, double mach)
     return TAS;
 }
 
+bool AircraftPerformance::Bracket::operator==(const Bracket& other) const
+{
+    return (atOrBelowAltitudeFt == other.atOrBelowAltitudeFt) &&
+           (climbRateFPM == other.climbRateFPM) &&
+           (descentRateFPM == other.descentRateFPM) &&
+           (speedIASOrMach == other.speedIASOrMach) &&
+           (speedIsMach == other.speedIsMach);
+}
+
 int AircraftPerformance::Bracket::gsForAltitude(int altitude) const
 {
     double M = 0.0;
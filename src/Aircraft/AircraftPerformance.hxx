@@ -59,6 +59,20 @@ public:
     static double machForCAS(int altitudeFt, double cas);
     static double groundSpeedForMach(int altitudeFt, double mach);
 
+    /**
+     * Changes whenever anything below /aircraft/performance changes, so a
+     * user can keep its AircraftPerformance until then, instead of reading
+     * the properties again each time.
+     */
+    static unsigned int dataSerial();
+
+    /// same brackets, so any computed path would be the same
+    bool operator==(const AircraftPerformance& other) const;
+    bool operator!=(const AircraftPerformance& other) const
+    {
+        return !(*this == other);
+    }
+
 private:
     void readPerformanceData();
 
@@ -85,6 +99,8 @@ private:
         
         int gsForAltitude(int altitude) const;
 
+        bool operator==(const Bracket& other) const;
+
         double climbTime(int alt1, int alt2) const;
         double climbDistanceM(int alt1, int alt2) const;
         double descendTime(int alt1, int alt2) const;
@@ -30,6 +30,7 @@
 #include <Airports/xmlloader.hxx>
 #include <Airports/dynamics.hxx>
 #include <Airports/airportdynamicsmanager.hxx>
+#include <Airports/apt_loader.hxx>
 #include <Navaids/procedure.hxx>
 #include <Navaids/waypoint.hxx>
 #include <ATC/CommStation.hxx>
@@ -349,12 +350,14 @@ FGTaxiwayList FGAirport::getTaxiways() const
 //------------------------------------------------------------------------------
 unsigned int FGAirport::numPavements() const
 {
+  loadDetail();
   return mPavements.size();
 }
 
 //------------------------------------------------------------------------------
 FGPavementList FGAirport::getPavements() const
 {
+  loadDetail();
   return mPavements;
 }
 
@@ -366,12 +369,14 @@ void FGAirport::addPavement(FGPavementRef pavement)
 //------------------------------------------------------------------------------
 unsigned int FGAirport::numBoundary() const
 {
+  loadDetail();
   return mBoundary.size();
 }
 
 //------------------------------------------------------------------------------
 FGPavementList FGAirport::getBoundary() const
 {
+  loadDetail();
   return mBoundary;
 }
 
@@ -383,12 +388,14 @@ void FGAirport::addBoundary(FGPavementRef boundary)
 //------------------------------------------------------------------------------
 unsigned int FGAirport::numLineFeatures() const
 {
+  loadDetail();
   return mLineFeatures.size();
 }
 
 //------------------------------------------------------------------------------
 FGPavementList FGAirport::getLineFeatures() const
 {
+  loadDetail();
   return mLineFeatures;
 }
 
@@ -397,6 +404,15 @@ void FGAirport::addLineFeature(FGPavementRef linefeature)
   mLineFeatures.push_back(linefeature);
 }
 
+void FGAirport::setDetail(FGPavementList pavements, FGPavementList boundary,
+                          FGPavementList lineFeatures)
+{
+  mDetailLoaded = true;
+  mPavements = std::move(pavements);
+  mBoundary = std::move(boundary);
+  mLineFeatures = std::move(lineFeatures);
+}
+
 //------------------------------------------------------------------------------
 FGRunwayRef FGAirport::getActiveRunwayForUsage() const
 {
@@ -586,6 +602,42 @@ void FGAirport::loadProcedures() const
   RouteBase::loadAirportProcedures(path, const_cast<FGAirport*>(this));
 }
 
+void FGAirport::loadDetail() const
+{
+  if (mDetailLoaded) {
+    return;
+  }
+
+  mDetailLoaded = true;
+  SGPath aptDat;
+  int64_t offset = 0;
+  unsigned int lineNum = 0;
+  std::string rows;
+  if (!NavDataCache::instance()->airportDetail(guid(), aptDat, offset, lineNum, rows)) {
+    return; // no pavements, boundary or line features
+  }
+
+  APTLoader::AirportDetail detail;
+  try {
+    APTLoader loader;
+    if (!rows.empty()) {
+      // from a compressed apt.dat, the rows were kept by the cache
+      loader.parseAirportDetail(rows, aptDat, lineNum, detail);
+    } else if (!loader.readAirportDetail(aptDat, offset, lineNum, ident(), detail)) {
+      return;
+    }
+  } catch (sg_exception& e) {
+    SG_LOG(SG_GENERAL, SG_WARN, ident() << ": failed to read pavements from " << aptDat
+           << ": " << e.getFormattedMessage());
+    return;
+  }
+
+  // anything added before goes first
+  mPavements.insert(mPavements.end(), detail.pavements.begin(), detail.pavements.end());
+  mBoundary.insert(mBoundary.end(), detail.boundary.begin(), detail.boundary.end());
+  mLineFeatures.insert(mLineFeatures.end(), detail.lineFeatures.begin(), detail.lineFeatures.end());
+}
+
 void FGAirport::loadRunwayRenames() const
 {
     if (mRunwayRenamesLoaded) {
@@ -178,6 +178,13 @@ public:
     FGPavementList getLineFeatures() const;
     void addLineFeature(FGPavementRef linefeature);
 
+    /**
+     * Replace the pavements, boundary and line features, which are otherwise
+     * read from the airport's apt.dat file on first use.
+     */
+    void setDetail(FGPavementList pavements, FGPavementList boundary,
+                   FGPavementList lineFeatures);
+
     class AirportFilter : public Filter
     {
     public:
@@ -257,6 +264,10 @@ public:
     void addSTAR(flightgear::STAR* aStar);
     void addApproach(flightgear::Approach* aApp);
 
+    /// whether the SIDs, STARs and approaches have been read
+    bool proceduresLoaded() const
+    { return mProceduresLoaded; }
+
     unsigned int numSIDs() const;
     flightgear::SID* getSIDByIndex(unsigned int aIndex) const;
     flightgear::SID* findSIDWithIdent(const std::string& aIdent) const;
@@ -368,6 +379,7 @@ private:
     void loadTaxiways() const;
     void loadProcedures() const;
     void loadRunwayRenames() const;
+    void loadDetail() const;
 
     mutable bool mTowerDataLoaded;
     mutable bool mHasTower;
@@ -378,6 +390,7 @@ private:
     mutable bool mTaxiwaysLoaded;
     mutable bool mProceduresLoaded;
     mutable bool mRunwayRenamesLoaded = false;
+    mutable bool mDetailLoaded = false;
     bool mIsClosed;
     mutable bool mThresholdDataLoaded;
     bool mILSDataLoaded;
@@ -386,9 +399,9 @@ private:
 
     mutable PositionedIDVec mHelipads;
     mutable PositionedIDVec mTaxiways;
-    std::vector<FGPavementRef> mPavements;
-    std::vector<FGPavementRef> mBoundary;
-    std::vector<FGPavementRef> mLineFeatures;
+    mutable std::vector<FGPavementRef> mPavements;
+    mutable std::vector<FGPavementRef> mBoundary;
+    mutable std::vector<FGPavementRef> mLineFeatures;
 
     typedef SGSharedPtr<flightgear::SID> SIDRef;
     typedef SGSharedPtr<flightgear::STAR> STARRef;
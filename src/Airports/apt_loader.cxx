@@ -13,11 +13,13 @@
 #include <cerrno>
 #include <cstddef>  // std::size_t
 #include <ctype.h>  // isspace()
+#include <exception> // std::exception_ptr
 #include <iostream>
 #include <sstream>  // std::istringstream
 #include <stdlib.h> // atof(), atoi()
 #include <string.h> // memchr()
 #include <string>
+#include <thread>   // std::thread::hardware_concurrency()
 #include <utility>  // std::pair, std::move()
 #include <vector>
 
@@ -25,9 +27,11 @@
 #include <simgear/constants.h>
 #include <simgear/debug/logstream.hxx>
 #include <simgear/io/iostreams/sgstream.hxx>
+#include <simgear/io/iostreams/zlibstream.hxx>
 #include <simgear/misc/sg_path.hxx>
 #include <simgear/misc/strutils.hxx>
 #include <simgear/structure/exception.hxx>
+#include <simgear/threads/SGThread.hxx>
 
 #include <ATC/CommStation.hxx>
 #include <Navaids/NavDataCache.hxx>
@@ -68,13 +72,142 @@ APTLoader::APTLoader()
 
 APTLoader::~APTLoader() {}
 
+// Rows parsed into pavements, boundaries and line features, on first use
+static bool isDetailLine(const unsigned int code)
+{
+    return ((code >= 110) && (code <= 116)) || (code == 120) || (code == 130);
+}
+
+// The detail rows kept for compressed apt.dat files are most of the airport
+// definitions, and would grow the cache by about the uncompressed size of the
+// file. They are stored deflated, which costs about the compressed size.
+static std::string compressDetailRows(const std::string& rows)
+{
+    std::istringstream in(rows);
+    simgear::ZlibCompressorIStream compressor(in, SGPath(), Z_BEST_SPEED);
+    std::ostringstream out;
+    out << compressor.rdbuf();
+    return out.str();
+}
+
+static bool isCommLine(const int code)
+{
+    return ((code >= 50) && (code <= 56)) || ((code >= 1050) && (code <= 1056));
+}
+
+// Rows loadAirport() ignores: signs, lighting objects, windsocks, beacons,
+// startup locations, traffic flow and the taxi routing network
+static bool isIgnoredLine(const unsigned int code)
+{
+    return (code == 0) || (code == 15) || ((code >= 18) && (code <= 21)) ||
+           ((code >= 1000) && !isCommLine(code));
+}
+
+/**
+ * Scans one apt.dat file for APTLoader::queueAptDatFile()
+ */
+class APTLoader::ScanThread : public SGThread
+{
+public:
+    ScanThread(APTLoader* loader, const NavDataCache::SceneryLocation& sceneryLocation,
+               std::size_t totalSize) : _loader(loader),
+                                        _location(sceneryLocation),
+                                        _totalSize(totalSize)
+    {
+    }
+
+    ~ScanThread()
+    {
+        if (!_joined) {
+            join();
+        }
+    }
+
+    void run() override
+    {
+        try {
+            _airports = _loader->scanAptDatFile(_location, _totalSize);
+        } catch (...) {
+            _error = std::current_exception();
+        }
+    }
+
+    // wait for the scan, and rethrow what it failed with
+    AirportInfoList take()
+    {
+        join();
+        _joined = true;
+        if (_error) {
+            std::rethrow_exception(_error);
+        }
+
+        return std::move(_airports);
+    }
+
+private:
+    APTLoader* _loader;
+    const NavDataCache::SceneryLocation _location;
+    const std::size_t _totalSize;
+    AirportInfoList _airports;
+    std::exception_ptr _error;
+    bool _joined = false;
+};
+
 void APTLoader::readAptDatFile(const NavDataCache::SceneryLocation& sceneryLocation,
                                std::size_t bytesReadSoFar,
                                std::size_t totalSizeOfAllAptDatFiles)
+{
+    finishScans();
+    _bytesScanned = bytesReadSoFar;
+    mergeAirports(scanAptDatFile(sceneryLocation, totalSizeOfAllAptDatFiles));
+}
+
+void APTLoader::queueAptDatFile(const NavDataCache::SceneryLocation& sceneryLocation,
+                                std::size_t /* bytesReadSoFar */,
+                                std::size_t totalSizeOfAllAptDatFiles)
+{
+    const size_t maxScans = std::max(2u, std::thread::hardware_concurrency());
+    while (pendingScans.size() >= maxScans) {
+        mergeAirports(pendingScans.front()->take());
+        pendingScans.pop_front();
+    }
+
+    pendingScans.emplace_back(new ScanThread(this, sceneryLocation, totalSizeOfAllAptDatFiles));
+    pendingScans.back()->start();
+}
+
+void APTLoader::finishScans()
+{
+    while (!pendingScans.empty()) {
+        // pop first: if the scan failed, the others are still waited for
+        std::unique_ptr<ScanThread> scan = std::move(pendingScans.front());
+        pendingScans.pop_front();
+        mergeAirports(scan->take());
+    }
+}
+
+void APTLoader::mergeAirports(AirportInfoList&& airports)
+{
+    for (auto& a : airports) {
+        if (airportInfoMap.count(a.first)) {
+            SG_LOG(SG_GENERAL, SG_INFO,
+                   a.second.file << ":" << a.second.firstLineNum << ": skipping airport " << a.first << " (already defined earlier)");
+            continue;
+        }
+
+        airportInfoMap.emplace(std::move(a.first), std::move(a.second));
+    }
+}
+
+APTLoader::AirportInfoList
+APTLoader::scanAptDatFile(const NavDataCache::SceneryLocation& sceneryLocation,
+                          std::size_t totalSizeOfAllAptDatFiles)
 {
     const SGPath aptdb_file = sceneryLocation.datPath;
     string apt_dat = aptdb_file.utf8Str(); // full path to the file being parsed
     sg_gzifstream in(aptdb_file, std::ios_base::in | std::ios_base::binary, true);
+    // compressed files can't be seeked later on, see readAirportDetail()
+    const bool keepDetailRows = !canSeekAptDat(aptdb_file);
 
     if (!in.is_open()) {
         const std::string errMsg = simgear::strutils::error_string(errno);
@@ -85,24 +218,34 @@ void APTLoader::readAptDatFile(const NavDataCache::SceneryLocation& sceneryLocat
     }
 
     string line;
+    AirportInfoList airports;
 
     unsigned int rowCode = 0; // terminology used in the apt.dat format spec
     unsigned int line_num = 0;
-    // "airport identifier": terminology used in the apt.dat format spec. It is
-    // often an ICAO code, but not always.
-    string currentAirportId;
-    // Boolean used to make sure we don't try to load the same airport several
-    // times. Defaults to true only to ensure we don't add garbage to
-    // 'airportInfoMap' under the key "" (empty airport identifier) in case the
-    // apt.dat file doesn't have a start-of-airport row code (1, 16 or 17) after
-    // its header---which would be invalid, anyway.
-    bool skipAirport = true;
+    // offset of the next line, in uncompressed bytes
+    int64_t offset = 0;
+    // bytes of the file added to '_bytesScanned' so far
+    std::size_t bytesReported = 0;
+    // The airport being read, or nullptr if there is none. Starts as nullptr to
+    // ensure we don't add garbage in case the apt.dat file doesn't have a
+    // start-of-airport row code (1, 16 or 17) after its header---which would be
+    // invalid, anyway.
+    RawAirportInfo* currentAirport = nullptr;
+    // detail rows of 'currentAirport', compressed when it is complete
+    string detailRows;
+    auto finishDetailRows = [&]() {
+        if (currentAirport && !detailRows.empty()) {
+            currentAirport->detailRows = compressDetailRows(detailRows);
+        }
+        detailRows.clear();
+    };
 
     // Read the apt.dat header (two lines)
     while (line_num < 2 && std::getline(in, line)) {
         // 'line' may end with an \r character (tested on Linux, only \n was
         // stripped: std::getline() only discards the _native_ line terminator)
         line_num++;
+        offset += line.size() + 1;
 
         if (line_num == 1) {
             std::string stripped_line = simgear::strutils::strip(line);
@@ -135,13 +278,18 @@ void APTLoader::readAptDatFile(const NavDataCache::SceneryLocation& sceneryLocat
     while (std::getline(in, line)) {
         // 'line' may end with an \r character, see above
         line_num++;
+        const int64_t lineOffset = offset;
+        offset += line.size() + 1;
 
         if (isBlankOrCommentLine(line))
             continue;
 
         if ((line_num % 100) == 0) {
             // every 100 lines
-            unsigned int percent = ((bytesReadSoFar + in.approxOffset()) * 100) / totalSizeOfAllAptDatFiles;
+            const std::size_t bytesRead = in.approxOffset();
+            const std::size_t allBytesRead = (_bytesScanned += bytesRead - bytesReported);
+            bytesReported = bytesRead;
+            unsigned int percent = (allBytesRead * 100) / totalSizeOfAllAptDatFiles;
             cache->setRebuildPhaseProgress(
                 NavDataCache::REBUILD_READING_APT_DAT_FILES, percent);
         }
@@ -152,52 +300,58 @@ void APTLoader::readAptDatFile(const NavDataCache::SceneryLocation& sceneryLocat
         if (rowCode == 1 /* Airport */ ||
             rowCode == 16 /* Seaplane base */ ||
             rowCode == 17 /* Heliport */) {
+            finishDetailRows();
             vector<string> tokens(simgear::strutils::split(line));
             if (tokens.size() < 6) {
                 SG_LOG(SG_GENERAL, SG_WARN,
                        apt_dat << ":" << line_num << ": invalid airport header "
                                                      "(at least 6 fields are required)");
-                skipAirport = true; // discard everything until the next airport header
+                currentAirport = nullptr; // discard everything until the next airport header
                 continue;
             }
 
-            currentAirportId = tokens[4]; // often an ICAO, but not always
-            // Check if the airport is already in 'airportInfoMap'; get the
-            // existing entry, if any, otherwise insert a new one.
-            std::pair<AirportInfoMapType::iterator, bool>
-                insertRetval = airportInfoMap.insert(
-                    AirportInfoMapType::value_type(currentAirportId, RawAirportInfo()));
-            skipAirport = !insertRetval.second;
-
-            if (skipAirport) {
-                SG_LOG(SG_GENERAL, SG_INFO,
-                       apt_dat << ":" << line_num << ": skipping airport " << currentAirportId << " (already defined earlier)");
-            } else {
-                // We haven't seen this airport yet in any apt.dat file
-                RawAirportInfo& airportInfo = insertRetval.first->second;
-                airportInfo.file = aptdb_file;
-                airportInfo.sceneryPath = sceneryLocation.sceneryPath;
-                airportInfo.rowCode = rowCode;
-                airportInfo.firstLineNum = line_num;
-                airportInfo.firstLineTokens = std::move(tokens);
-            }
+            // tokens[4] is the airport identifier, often an ICAO but not always
+            airports.emplace_back(tokens[4], RawAirportInfo());
+            currentAirport = &airports.back().second;
+            currentAirport->file = aptdb_file;
+            currentAirport->sceneryPath = sceneryLocation.sceneryPath;
+            currentAirport->rowCode = rowCode;
+            currentAirport->firstLineNum = line_num;
+            currentAirport->offset = lineOffset;
+            currentAirport->hasDetail = false;
+            currentAirport->detailLineNum = 0;
+            currentAirport->firstLineTokens = std::move(tokens);
         } else if (rowCode == 99) {
             SG_LOG(SG_GENERAL, SG_DEBUG,
                    apt_dat << ":" << line_num << ": code 99 found "
                                                  "(normally at end of file)");
-        } else if (!skipAirport) {
-            // Line belonging to an already started, and not skipped airport entry;
-            // just append it.
-            airportInfoMap[currentAirportId].otherLines.emplace_back(
-                line_num, rowCode, line);
+        } else if (!currentAirport || isIgnoredLine(rowCode)) {
+            // nothing to keep
+        } else if (isDetailLine(rowCode)) {
+            currentAirport->hasDetail = true;
+            if (keepDetailRows) {
+                if (detailRows.empty()) {
+                    currentAirport->detailLineNum = line_num;
+                }
+                detailRows.append(line).push_back('\n');
+            }
+        } else {
+            // Line belonging to an already started airport entry; just
+            // append it.
+            currentAirport->otherLines.emplace_back(line_num, rowCode, line);
         }
     } // of file reading loop
 
     throwExceptionIfStreamError(in, aptdb_file);
+    finishDetailRows();
+    _bytesScanned += in.approxOffset() - bytesReported;
+    return airports;
 }
 
 void APTLoader::loadAirports()
 {
+    finishScans();
+
     AirportInfoMapType::size_type nbLoadedAirports = 0;
     AirportInfoMapType::size_type nbAirports = airportInfoMap.size();
 
@@ -238,11 +392,6 @@ const FGAirport* APTLoader::loadAirportFromFile(const std::string& id, const Nav
     return loadAirport(sceneryLocation.datPath, id, &rawInfo, true);
 }
 
-static bool isCommLine(const int code)
-{
-    return ((code >= 50) && (code <= 56)) || ((code >= 1050) && (code <= 1056));
-}
-
 const FGAirport* APTLoader::loadAirport(const SGPath& aptDatFile, const std::string& airportID, RawAirportInfo* airport_info, bool createFGAirport)
 {
     // The first line for this airport was already split over whitespace, but
@@ -252,7 +401,6 @@ const FGAirport* APTLoader::loadAirport(const SGPath& aptDatFile, const std::str
     const LinesList& lines = airport_info->otherLines;
 
     const string aptDat = aptDatFile.utf8Str();
-    NodeBlock current_block = None;
 
     // Loop over the second and subsequent lines
     for (LinesList::const_iterator linesIt = lines.begin();
@@ -290,36 +438,6 @@ const FGAirport* APTLoader::loadAirport(const SGPath& aptDatFile, const std::str
         } else if (isCommLine(rowCode)) {
             parseCommLine(aptDat, linesIt->number, rowCode,
                           simgear::strutils::split(linesIt->str));
-        } else if (rowCode == 110) {
-            current_block = Pavement;
-            parsePavementLine850(simgear::strutils::split(linesIt->str, 0, 4));
-        } else if (rowCode >= 111 && rowCode <= 116) {
-            switch (current_block) {
-            case Pavement:
-                parseNodeLine850(&pavements, aptDat, linesIt->number, rowCode,
-                                 simgear::strutils::split(linesIt->str));
-                break;
-            case AirportBoundary:
-                parseNodeLine850(&airport_boundary, aptDat, linesIt->number, rowCode,
-                                 simgear::strutils::split(linesIt->str));
-                break;
-            case LinearFeature:
-                parseNodeLine850(&linear_feature, aptDat, linesIt->number, rowCode,
-                                 simgear::strutils::split(linesIt->str));
-                break;
-            default:
-            case None:
-                std::ostringstream oss;
-                string cleanedLine = cleanLine(linesIt->str);
-                oss << aptDat << ":" << linesIt->number << ": unexpected row code " << rowCode;
-                SG_LOG(SG_GENERAL, SG_ALERT, oss.str() << " (" << cleanedLine << ")");
-                throw sg_format_exception(oss.str(), cleanedLine);
-                break;
-            }
-        } else if (rowCode == 120) {
-            current_block = LinearFeature;
-        } else if (rowCode == 130) {
-            current_block = AirportBoundary;
         } else if (rowCode >= 1000) {
             // airport traffic flow (ignore)
         } else {
@@ -330,30 +448,38 @@ const FGAirport* APTLoader::loadAirport(const SGPath& aptDatFile, const std::str
         }
     } // of loop over the second and subsequent apt.dat lines for the airport
 
+    if (airport_info->hasDetail && !createFGAirport && currentAirportPosID) {
+        if (airport_info->detailRows.empty()) {
+            cache->setAirportDetail(currentAirportPosID, aptDatFile,
+                                    airport_info->offset, airport_info->firstLineNum);
+        } else {
+            cache->setAirportDetail(currentAirportPosID, aptDatFile, 0,
+                                    airport_info->detailLineNum, airport_info->detailRows);
+        }
+    }
+
     finishAirport(aptDat);
 
     if (createFGAirport) {
         FGAirportRef airport = FGAirport::findByIdent(airportID);
 
-        std::for_each(
-            pavements.begin(),
-            pavements.end(),
-            [airport](FGPavementRef p) { airport->addPavement(p); });
-
-        std::for_each(
-            airport_boundary.begin(),
-            airport_boundary.end(),
-            [airport](FGPavementRef p) { airport->addBoundary(p); });
-
-        std::for_each(
-            linear_feature.begin(),
-            linear_feature.end(),
-            [airport](FGPavementRef p) { airport->addLineFeature(p); });
-
-        pavements.clear();
-        airport_boundary.clear();
-        linear_feature.clear();
+        AirportDetail detail;
+        bool haveDetail = false;
+        if (airport && airport_info->hasDetail) {
+            if (airport_info->detailRows.empty()) {
+                haveDetail = readAirportDetail(aptDatFile, airport_info->offset,
+                                               airport_info->firstLineNum, airportID, detail);
+            } else {
+                parseAirportDetail(airport_info->detailRows, aptDatFile,
+                                   airport_info->detailLineNum, detail);
+                haveDetail = true;
+            }
+        }
 
+        if (haveDetail) {
+            airport->setDetail(std::move(detail.pavements), std::move(detail.boundary),
+                               std::move(detail.lineFeatures));
+        }
 
         return airport;
 
@@ -363,6 +489,117 @@ const FGAirport* APTLoader::loadAirport(const SGPath& aptDatFile, const std::str
     }
 }
 
+bool APTLoader::canSeekAptDat(const SGPath& aptDat)
+{
+    return !simgear::strutils::ends_with(aptDat.utf8Str(), ".gz");
+}
+
+bool APTLoader::readAirportDetail(const SGPath& aptDatFile, int64_t offset, unsigned int lineNum,
+                                  const std::string& airportId, AirportDetail& detail)
+{
+    const string aptDat = aptDatFile.utf8Str();
+    if (!canSeekAptDat(aptDatFile)) {
+        // skipping through a compressed file is far too slow on first use
+        SG_LOG(SG_GENERAL, SG_WARN, aptDat << " is compressed, can't read the pavements of " << airportId);
+        return false;
+    }
+
+    sg_ifstream in(aptDatFile, std::ios_base::in | std::ios_base::binary);
+    if (!in.is_open()) {
+        SG_LOG(SG_GENERAL, SG_WARN, "Cannot open file '" << aptDat << "' for the pavements of " << airportId);
+        return false;
+    }
+
+    in.seekg(offset);
+    string line;
+    vector<string> header;
+    if (in && std::getline(in, line)) {
+        header = simgear::strutils::split(line, 0, 5);
+    }
+
+    if ((header.size() < 5) || (header[4] != airportId)) {
+        // the cache is rebuilt when the file changes, so this is unexpected
+        SG_LOG(SG_GENERAL, SG_WARN,
+               aptDat << ":" << lineNum << ": expected the definition of " << airportId);
+        return false;
+    }
+
+    parseDetailLines(in, aptDat, lineNum, detail);
+    return true;
+}
+
+void APTLoader::parseAirportDetail(const std::string& rows, const SGPath& aptDatFile,
+                                   unsigned int lineNum, AirportDetail& detail)
+{
+    std::istringstream compressed(rows);
+    simgear::ZlibDecompressorIStream in(compressed, aptDatFile);
+    parseDetailLines(in, aptDatFile.utf8Str(), lineNum - 1, detail);
+}
+
+void APTLoader::parseDetailLines(std::istream& in, const std::string& aptDat,
+                                 unsigned int lineNum, AirportDetail& detail)
+{
+    pavement_ident.clear();
+    pavements.clear();
+    airport_boundary.clear();
+    linear_feature.clear();
+    NodeBlock current_block = None;
+
+    string line;
+    while (std::getline(in, line)) {
+        // 'line' may end with an '\r' character, see readAptDatFile()
+        lineNum++;
+
+        if (isBlankOrCommentLine(line))
+            continue;
+
+        const unsigned int rowCode = atoi(line.c_str());
+        if (rowCode == 1 || rowCode == 16 || rowCode == 17 || rowCode == 99) {
+            break; // the next airport, or the end of the file
+        }
+
+        if (rowCode == 110) {
+            current_block = Pavement;
+            parsePavementLine850(simgear::strutils::split(line, 0, 4));
+        } else if (rowCode >= 111 && rowCode <= 116) {
+            switch (current_block) {
+            case Pavement:
+                parseNodeLine850(&pavements, aptDat, lineNum, rowCode,
+                                 simgear::strutils::split(line));
+                break;
+            case AirportBoundary:
+                parseNodeLine850(&airport_boundary, aptDat, lineNum, rowCode,
+                                 simgear::strutils::split(line));
+                break;
+            case LinearFeature:
+                parseNodeLine850(&linear_feature, aptDat, lineNum, rowCode,
+                                 simgear::strutils::split(line));
+                break;
+            default:
+            case None:
+                std::ostringstream oss;
+                string cleanedLine = cleanLine(line);
+                oss << aptDat << ":" << lineNum << ": unexpected row code " << rowCode;
+                SG_LOG(SG_GENERAL, SG_ALERT, oss.str() << " (" << cleanedLine << ")");
+                throw sg_format_exception(oss.str(), cleanedLine);
+                break;
+            }
+        } else if (rowCode == 120) {
+            current_block = LinearFeature;
+        } else if (rowCode == 130) {
+            current_block = AirportBoundary;
+        }
+    } // of loop over the lines of the airport
+
+    throwExceptionIfStreamError(in, SGPath::fromUtf8(aptDat));
+
+    detail.pavements.swap(pavements);
+    detail.boundary.swap(airport_boundary);
+    detail.lineFeatures.swap(linear_feature);
+    pavements.clear();
+    airport_boundary.clear();
+    linear_feature.clear();
+}
 
 // Tell whether an apt.dat line is blank or a comment line
 bool APTLoader::isBlankOrCommentLine(const std::string& line)
@@ -388,7 +625,7 @@ std::string APTLoader::cleanLine(const std::string& line)
     return res;
 }
 
-void APTLoader::throwExceptionIfStreamError(const sg_gzifstream& input_stream,
+void APTLoader::throwExceptionIfStreamError(const std::istream& input_stream,
                                             const SGPath& path)
 {
     if (input_stream.bad()) {
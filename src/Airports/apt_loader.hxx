@@ -7,6 +7,10 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -34,21 +38,58 @@ public:
     APTLoader();
     virtual ~APTLoader();
 
+    // Pavements, boundary and line features of an airport
+    struct AirportDetail {
+        FGPavementList pavements;
+        FGPavementList boundary;
+        FGPavementList lineFeatures;
+    };
+
     // Read the specified apt.dat file into 'airportInfoMap'.
     // 'bytesReadSoFar' and 'totalSizeOfAllAptDatFiles' are used for progress
     // information.
     void readAptDatFile(const NavDataCache::SceneryLocation& sceneryLocation,
                         std::size_t bytesReadSoFar,
                         std::size_t totalSizeOfAllAptDatFiles);
+    // As readAptDatFile(), but the file is read by a thread of its own while
+    // the next ones are queued. Files are merged into 'airportInfoMap' in the
+    // order they were queued, so the first definition of an airport still
+    // wins. 'bytesReadSoFar' is unused, progress is summed over all files.
+    void queueAptDatFile(const NavDataCache::SceneryLocation& sceneryLocation,
+                         std::size_t bytesReadSoFar,
+                         std::size_t totalSizeOfAllAptDatFiles);
+    // Wait for the files queued with queueAptDatFile() and merge them. Also
+    // done by loadAirports().
+    void finishScans();
     // Read all airports gathered in 'airportInfoMap' and load them into the
     // navdata cache (even in case of overlapping apt.dat files,
-    // 'airportInfoMap' has only one entry per airport).
+    // 'airportInfoMap' has only one entry per airport). Pavements, boundaries
+    // and line features aren't parsed: the cache records where they start in
+    // plain files, or their rows for compressed ones, and FGAirport parses them
+    // with readAirportDetail() or parseAirportDetail() on first use.
     void loadAirports();
 
     // Load a specific airport defined in aptdb_file, and return a "rich" view
     // of the airport including taxiways, pavement and line features.
     const FGAirport* loadAirportFromFile(const std::string& id, const NavDataCache::SceneryLocation& sceneryLocation);
 
+    // Parse the pavements, boundary and line features of the airport whose
+    // definition starts 'offset' bytes into the plain apt.dat file 'aptDat',
+    // at line 'lineNum'. Returns false if the file can't be read, is
+    // compressed, or no longer has the airport at that offset.
+    bool readAirportDetail(const SGPath& aptDat, int64_t offset, unsigned int lineNum,
+                           const std::string& airportId, AirportDetail& detail);
+
+    // As readAirportDetail(), from the deflated detail rows of the airport
+    // kept when scanning a compressed apt.dat file, which can't be seeked.
+    // 'lineNum' is the line of the first row, for messages.
+    void parseAirportDetail(const std::string& rows, const SGPath& aptDat,
+                            unsigned int lineNum, AirportDetail& detail);
+
+    // Whether the detail of the airports of 'aptDat' is read from the file
+    // with readAirportDetail(); if not, the scan keeps the rows.
+    static bool canSeekAptDat(const SGPath& aptDat);
+
 private:
     struct Line {
         Line(unsigned int number_, unsigned int rowCode_, const std::string& str_)
@@ -70,14 +111,28 @@ private:
         unsigned int rowCode;
         // Line number in the apt.dat file where the airport definition starts
         unsigned int firstLineNum;
+        // Offset of the first line of the airport definition, in uncompressed
+        // bytes from the start of the file
+        int64_t offset;
+        // Whether the definition has pavement, boundary or line feature rows.
+        // These are left out of 'otherLines', see readAirportDetail().
+        bool hasDetail;
+        // For compressed files, the pavement, boundary and line feature rows,
+        // each ending with a newline, deflated as a whole, and the line number
+        // of the first one
+        std::string detailRows;
+        unsigned int detailLineNum;
         // The whitespace-separated strings comprising the first line of the airport
         // definition
         std::vector<std::string> firstLineTokens;
-        // Subsequent lines of the airport definition (one element per line)
+        // Subsequent lines of the airport definition needed to build its cache
+        // entry: runways, helipads, the tower and the comm stations
         LinesList otherLines;
     };
 
     typedef std::unordered_map<std::string, RawAirportInfo> AirportInfoMapType;
+    // Airports of one apt.dat file, in file order
+    typedef std::vector<std::pair<std::string, RawAirportInfo>> AirportInfoList;
     typedef SGSharedPtr<FGPavement> FGPavementPtr;
     typedef std::vector<FGPavementPtr> NodeList;
 
@@ -86,12 +141,26 @@ private:
 
     const FGAirport* loadAirport(const SGPath& aptDat, const std::string& airportID, RawAirportInfo* airport_info, bool createFGAirport = false);
 
+    class ScanThread;
+
+    // First pass over an apt.dat file: the airport headers, their offsets and
+    // the lines loadAirport() needs. Only touches '_bytesScanned' and the
+    // rebuild progress, so several files can be scanned at once.
+    AirportInfoList scanAptDatFile(const NavDataCache::SceneryLocation& sceneryLocation,
+                                   std::size_t totalSizeOfAllAptDatFiles);
+    // Add airports not yet in 'airportInfoMap'
+    void mergeAirports(AirportInfoList&& airports);
+
     // Tell whether an apt.dat line is blank or a comment line
     bool isBlankOrCommentLine(const std::string& line);
     // Return a copy of 'line' with trailing '\r' char(s) removed
     std::string cleanLine(const std::string& line);
-    void throwExceptionIfStreamError(const sg_gzifstream& input_stream,
+    void throwExceptionIfStreamError(const std::istream& input_stream,
                                      const SGPath& path);
+    // Parse detail rows from 'in' up to the next airport; 'lineNum' is the
+    // number of the line before the first one
+    void parseDetailLines(std::istream& in, const std::string& aptDat,
+                          unsigned int lineNum, AirportDetail& detail);
     void parseAirportLine(unsigned int rowCode,
                           const std::vector<std::string>& token,
                           const SGPath& sceneryPath);
@@ -118,6 +187,8 @@ private:
 
     std::vector<std::string> token;
     AirportInfoMapType airportInfoMap;
+    std::deque<std::unique_ptr<ScanThread>> pendingScans;
+    std::atomic<std::size_t> _bytesScanned{0};
     double rwy_lat_accum{0.0};
     double rwy_lon_accum{0.0};
     double last_rwy_heading{0.0};
@@ -16,6 +16,7 @@
 
 #include <AIModel/AIBase.hxx>
 #include <AIModel/AIManager.hxx>
+#include <ATC/GroundNetworkMesh.hxx>
 #include <Airports/groundnetwork.hxx>
 #include <Airports/runways.hxx>
 #include <Environment/environment.hxx>
@@ -217,6 +218,17 @@ void FGAirportDynamics::init()
     groundController.init();
 }
 
+FGGroundNetworkMesh* FGAirportDynamics::getGroundNetworkMesh(bool create)
+{
+    if (!groundNetMesh && create) {
+        FGGroundNetwork* network = parent()->groundNetwork();
+        if (network && network->exists()) {
+            groundNetMesh.reset(new FGGroundNetworkMesh(network, this));
+        }
+    }
+    return groundNetMesh.get();
+}
+
 FGParking* FGAirportDynamics::innerGetAvailableParking(double radius, const std::string& flType,
                                                        const std::string& airline,
                                                        bool skipEmptyAirlineCode)
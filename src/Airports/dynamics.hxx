@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <memory>
 #include <set>
 
 #include <simgear/structure/SGWeakReferenced.hxx>
@@ -47,6 +48,8 @@ private:
     ParkingAssignmentPrivate* _sharedData;
 };
 
+class FGGroundNetworkMesh;
+
 class FGAirportDynamics : public SGWeakReferenced
 {
 private:
@@ -61,6 +64,7 @@ private:
     FGTowerController towerController;
     FGApproachController approachController;
     FGGroundController groundController;
+    std::unique_ptr<FGGroundNetworkMesh> groundNetMesh;
 
     time_t lastUpdate;
     std::string prevTrafficType;
@@ -159,6 +163,13 @@ public:
         return &approachController;
     };
 
+    /**
+     * The geometry of the ground network debug view. There is one per
+     * airport, shared by its controllers, built on first use if create is
+     * set. nullptr if the airport has no ground network.
+     */
+    FGGroundNetworkMesh* getGroundNetworkMesh(bool create = true);
+
     int getApproachFrequency(unsigned nr);
     int getGroundFrequency(unsigned leg);
     int getTowerFrequency(unsigned nr);
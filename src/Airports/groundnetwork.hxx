@@ -286,6 +286,8 @@ public:
     /** Find the taxiway segment best matching the heading*/
     FGTaxiSegment* findSegmentByHeading(const FGTaxiNode* from, const double heading) const;
     FGTaxiSegment* findSegment(unsigned int idx) const;
+    /** Segment indices run from 1 to getNumSegments(). */
+    unsigned int getNumSegments() const { return segments.size(); }
     /**
      * Find the segments connected to the node.
     */
@@ -520,11 +520,8 @@ void FGRouteMgr::update( double dt )
   }
   
   // use RoutePath to compute location of active WP
-  if (!_routePath) {
-    _routePath.reset(new RoutePath{_plan});
-  }
-
-  SGGeod wpPos = _routePath->positionForIndex(_plan->currentIndex());
+  const RoutePath& routePath = _plan->routePath();
+  SGGeod wpPos = routePath.positionForIndex(_plan->currentIndex());
   double courseDeg, az2, distanceM;
   SGGeodesy::inverse(currentPos, wpPos, courseDeg, az2, distanceM);
 
@@ -549,7 +546,7 @@ void FGRouteMgr::update( double dt )
   
   FlightPlan::Leg* nextLeg = _plan->nextLeg();
   if (nextLeg) {
-    wpPos = _routePath->positionForIndex(_plan->currentIndex() + 1);
+    wpPos = routePath.positionForIndex(_plan->currentIndex() + 1);
     SGGeodesy::inverse(currentPos, wpPos, courseDeg, az2, distanceM);
 
     wp1->setDoubleValue("dist", distanceM * SG_METER_TO_NM);
@@ -571,7 +568,6 @@ void FGRouteMgr::update( double dt )
 
 void FGRouteMgr::clearRoute()
 {
-  _routePath.reset();
   if (_plan) {
       _plan->clearLegs();
   }
@@ -656,7 +652,6 @@ void FGRouteMgr::waypointsChanged()
 // mirror internal route to the property system for inspection by other subsystems
 void FGRouteMgr::update_mirror()
 {
-    _routePath.reset(); // wipe this so we re-compute on next update()
   mirror->removeChildren("wp");
   auto gui = globals->get_subsystem<NewGUI>();
   FGDialog* rmDlg = gui ? gui->getDialog("route-manager") : NULL;
@@ -50,6 +50,10 @@ public:
     AIWakeGroup(void);
     void AddAI(FGAIAircraft* ai);
     SGVec3d getInducedVelocityAt(const SGVec3d& pt) const;
+    // Same as getInducedVelocityAt() for several points, visiting each wake
+    // once.
+    void getInducedVelocitiesAt(const std::vector<SGVec3d>& pts,
+                                std::vector<SGVec3d>& vi) const;
     // Garbage collection
     void gc(void);
 };
@@ -33,9 +33,6 @@
 #include <FDM/flight.hxx>
 #include "AIWakeGroup.hxx"
 #include "AIModel/AIAircraft.hxx"
-extern "C" {
-#include "../LaRCsim/ls_matrix.h"
-}
 
 AircraftMesh::AircraftMesh(double _span, double _chord, const std::string& name)
     : WakeMesh(_span, _chord, name)
@@ -66,22 +63,21 @@ SGVec3d AircraftMesh::GetForce(const AIWakeGroup& wg, const SGVec3d& vel,
     std::vector<double> rhs;
     rhs.resize(nelm, 0.0);
 
+    // Query the AI wakes for all the points at once.
+    wg.getInducedVelocitiesAt(collPt, viColl);
+    wg.getInducedVelocitiesAt(midPt, viMid);
+
     for (int i=0; i<nelm; ++i)
-        rhs[i] = dot(elements[i]->getNormal(),
-                     Te2b.transform(wg.getInducedVelocityAt(collPt[i])));
+        rhs[i] = dot(elements[i]->getNormal(), Te2b.transform(viColl[i]));
 
-    for (int i=1; i<=nelm; ++i) {
-        Gamma[i][1] = 0.0;
-        for (int k=1; k<=nelm; ++k)
-            Gamma[i][1] += influenceMtx[i][k]*rhs[k-1];
-    }
+    solveGamma(rhs);
 
     SGVec3d f(0.,0.,0.);
     moment = SGVec3d::zeros();
 
     for (int i=0; i<nelm; ++i) {
         SGVec3d mp = elements[i]->getBoundVortexMidPoint();
-        SGVec3d v = Te2b.transform(wg.getInducedVelocityAt(midPt[i]));
+        SGVec3d v = Te2b.transform(viMid[i]);
         v += getInducedVelocityAt(mp);
 
         // The minus sign before vel to transform the aircraft velocity from the
@@ -41,6 +41,7 @@ private:
     friend class FGTestApi::PrivateAccessor::FDM::Accessor;
 
     std::vector<SGVec3d> collPt, midPt;
+    std::vector<SGVec3d> viColl, viMid; // induced velocities of the AI wakes
     SGQuatd Te2b;
     SGVec3d moment;
 };
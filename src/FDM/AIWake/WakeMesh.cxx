@@ -20,8 +20,11 @@
 //
 // $Id$
 
-#include <vector>
+#include <algorithm>
 #include <cmath>
+#include <map>
+#include <utility>
+#include <vector>
 
 #include <simgear/structure/SGSharedPtr.hxx>
 #include <simgear/math/SGVec3.hxx>
@@ -32,44 +35,236 @@ extern "C" {
 #include "../LaRCsim/ls_matrix.h"
 }
 
-WakeMesh::WakeMesh(double _span, double _chord, const std::string& aircraft_name)
-    : nelm(10), span(_span), chord(_chord)
+// Beyond this distance from the wake (in spans), the mesh is replaced by a
+// single horseshoe vortex.
+static const double FAR_FIELD_SPANS = 5.0;
+
+// The influence matrix only depends on the geometry of the mesh. It is LU
+// factorized once and shared by all the meshes with the same span and chord,
+// i.e. by all the AI aircraft of the same type.
+class WakeGeometry : public SGReferenced {
+public:
+    WakeGeometry(double span, double chord, int nelm);
+
+    static SGSharedPtr<WakeGeometry> get(double span, double chord, int nelm);
+
+    // Solve the system in place.
+    void solve(double* x) const;
+
+    // Induced velocity of the elements with the circulations gamma at p.
+    SGVec3d inducedVelocity(const double* gamma, const SGVec3d& p) const;
+
+    std::vector<AeroElement_ptr> elements;
+    bool valid;
+
+    // LU factors with partial pivoting, row major.
+    std::vector<double> lu;
+    std::vector<int> pivot;
+
+    // End points of the bound vortices, structure of arrays.
+    std::vector<double> x1, y1, z1, x2, y2, z2;
+
+    // Horseshoe vortex equivalent to the mesh in the far field, and the
+    // contribution of each element circulation to its circulation.
+    AeroElement_ptr farField;
+    std::vector<double> farWeight;
+
+private:
+    typedef std::map<std::pair<double, double>, SGSharedPtr<WakeGeometry> > Cache;
+    static Cache cache;
+};
+
+WakeGeometry::Cache WakeGeometry::cache;
+
+SGSharedPtr<WakeGeometry> WakeGeometry::get(double span, double chord, int nelm)
+{
+    // Drop the geometries which are no longer used by any mesh.
+    for (auto it = cache.begin(); it != cache.end();) {
+        if (SGReferenced::count(it->second.get()) == 1)
+            it = cache.erase(it);
+        else
+            ++it;
+    }
+
+    SGSharedPtr<WakeGeometry>& geom = cache[std::make_pair(span, chord)];
+    if (!geom || (static_cast<int>(geom->elements.size()) != nelm))
+        geom = new WakeGeometry(span, chord, nelm);
+
+    return geom;
+}
+
+WakeGeometry::WakeGeometry(double span, double chord, int nelm)
+    : valid(true)
 {
-    double y1 = -0.5*span;
+    double yLeft = -0.5*span;
     double ds = span / nelm;
 
     for(int i=0; i<nelm; i++) {
-        double y2 = y1 + ds;
-        elements.push_back(new AeroElement(SGVec3d(-chord, y1, 0.),
-                                           SGVec3d(0., y1, 0.),
-                                           SGVec3d(0., y2, 0.),
-                                           SGVec3d(-chord, y2, 0.)));
-        y1 = y2;
+        double yRight = yLeft + ds;
+        elements.push_back(new AeroElement(SGVec3d(-chord, yLeft, 0.),
+                                           SGVec3d(0., yLeft, 0.),
+                                           SGVec3d(0., yRight, 0.),
+                                           SGVec3d(-chord, yRight, 0.)));
+        yLeft = yRight;
     }
 
-    influenceMtx = nr_matrix(1, nelm, 1, nelm);
-    Gamma = nr_matrix(1, nelm, 1, 1);
+    for (const auto& elm : elements) {
+        SGVec3d p1 = elm->getBoundVortexMidPoint() - 0.5*elm->getBoundVortex();
+        SGVec3d p2 = p1 + elm->getBoundVortex();
+        x1.push_back(p1[0]);
+        y1.push_back(p1[1]);
+        z1.push_back(p1[2]);
+        x2.push_back(p2[0]);
+        y2.push_back(p2[1]);
+        z2.push_back(p2[2]);
+    }
+
+    lu.resize(nelm*nelm);
+    pivot.resize(nelm);
 
     for (int i=0; i < nelm; ++i) {
         SGVec3d normal = elements[i]->getNormal();
         SGVec3d collPt = elements[i]->getCollocationPoint();
 
         for (int j=0; j < nelm; ++j)
-            influenceMtx[i+1][j+1] = dot(elements[j]->getInducedVelocity(collPt),
-                                         normal);
+            lu[i*nelm+j] = dot(elements[j]->getInducedVelocity(collPt), normal);
     }
 
-    // Compute the inverse matrix with the Gauss-Jordan algorithm
-    int ret = nr_gaussj(influenceMtx, nelm, nullptr, 0);
-    if (ret) {
-        // Something went wrong with the matrix inversion.
+    // Doolittle LU factorization with partial pivoting
+    for (int k=0; k < nelm && valid; ++k) {
+        int p = k;
+        for (int i=k+1; i < nelm; ++i) {
+            if (fabs(lu[i*nelm+k]) > fabs(lu[p*nelm+k]))
+                p = i;
+        }
+        pivot[k] = p;
+
+        if (fabs(lu[p*nelm+k]) < 1E-12) {
+            valid = false;
+            break;
+        }
 
-        // 1. Nullify the influence matrix to disable the current aircraft wake.
-        for (int i=0; i < nelm; ++i) {
+        if (p != k) {
             for (int j=0; j < nelm; ++j)
-                influenceMtx[i+1][j+1] = 0.0;
+                std::swap(lu[k*nelm+j], lu[p*nelm+j]);
+        }
+
+        for (int i=k+1; i < nelm; ++i) {
+            double f = lu[i*nelm+k] / lu[k*nelm+k];
+            lu[i*nelm+k] = f;
+            for (int j=k+1; j < nelm; ++j)
+                lu[i*nelm+j] -= f*lu[k*nelm+j];
+        }
+    }
+
+    // The trailing vortices of two neighbouring elements partly cancel out.
+    // The equivalent horseshoe vortex has the same lift and its trailing
+    // vortices at the centroid of the remaining trailing vorticity; both
+    // are linear in the element circulations for a given circulation
+    // distribution shape, which is fixed by the geometry, so the weights
+    // are computed from the distribution for a unit free stream.
+    if (valid) {
+        std::vector<double> unit(nelm, -1.0);
+        solve(unit.data());
+
+        double strength = 0.0, moment = 0.0;
+        for (int j=0; j <= nelm; ++j) {
+            double g = (j < nelm ? unit[j] : 0.0) - (j > 0 ? unit[j-1] : 0.0);
+            double y = (j < nelm) ? y1[j] : y2[nelm-1];
+            strength += fabs(g);
+            moment += fabs(g*y);
         }
-        // 2. Report the issue in the log.
+
+        double halfSpan = (strength > 0.0) ? moment / strength : 0.5*span;
+        farField = new AeroElement(SGVec3d(-chord, -halfSpan, 0.),
+                                   SGVec3d(0., -halfSpan, 0.),
+                                   SGVec3d(0., halfSpan, 0.),
+                                   SGVec3d(-chord, halfSpan, 0.));
+        farWeight.assign(nelm, ds / (2.0*halfSpan));
+    }
+}
+
+void WakeGeometry::solve(double* x) const
+{
+    const int n = static_cast<int>(pivot.size());
+
+    for (int k=0; k < n; ++k)
+        std::swap(x[k], x[pivot[k]]);
+
+    for (int i=1; i < n; ++i) {
+        double s = x[i];
+        for (int j=0; j < i; ++j)
+            s -= lu[i*n+j]*x[j];
+        x[i] = s;
+    }
+
+    for (int i=n-1; i >= 0; --i) {
+        double s = x[i];
+        for (int j=i+1; j < n; ++j)
+            s -= lu[i*n+j]*x[j];
+        x[i] = s / lu[i*n+i];
+    }
+}
+
+// Same as the sum of AeroElement::getInducedVelocity() weighted by gamma, as
+// one loop over the arrays of the vortex ends that the compiler can
+// vectorize.
+SGVec3d WakeGeometry::inducedVelocity(const double* gamma, const SGVec3d& p) const
+{
+    const int n = static_cast<int>(x1.size());
+    const double px = p[0], py = p[1], pz = p[2];
+    const double k4pi = 1.0 / (4.0*M_PI);
+    double vx = 0.0, vy = 0.0, vz = 0.0;
+
+    for (int i=0; i < n; ++i) {
+        // relative positions to both ends of the bound vortex
+        double ax = px - x1[i], ay = py - y1[i], az = pz - z1[i];
+        double bx = px - x2[i], by = py - y2[i], bz = pz - z2[i];
+        double a2 = ax*ax + ay*ay + az*az;
+        double b2 = bx*bx + by*by + bz*bz;
+        double a = sqrt(a2), b = sqrt(b2);
+
+        // semi-infinite trailing vortices along -x, from both ends
+        double da = a2 + ax*a;
+        double db = b2 + bx*b;
+        double ka = (fabs(da) < 1E-6) ? 0.0 : gamma[i] * k4pi / da;
+        double kb = (fabs(db) < 1E-6) ? 0.0 : gamma[i] * k4pi / db;
+        vy += -az*ka + bz*kb;
+        vz += ay*ka - by*kb;
+
+        // bound vortex
+        double cx = ay*bz - az*by;
+        double cy = az*bx - ax*bz;
+        double cz = ax*by - ay*bx;
+        double c2 = cx*cx + cy*cy + cz*cz;
+        bool singular = (c2 < 1E-6) || (a2 < 1E-6) || (b2 < 1E-6);
+        double rx = x2[i] - x1[i], ry = y2[i] - y1[i], rz = z2[i] - z1[i];
+        double ia = singular ? 0.0 : 1.0 / a;
+        double ib = singular ? 0.0 : 1.0 / b;
+        double kc = singular ? 0.0 :
+            gamma[i] * (rx*(ax*ia - bx*ib) + ry*(ay*ia - by*ib)
+                        + rz*(az*ia - bz*ib)) * k4pi / c2;
+        vx += cx*kc;
+        vy += cy*kc;
+        vz += cz*kc;
+    }
+
+    return SGVec3d(vx, vy, vz);
+}
+
+WakeMesh::WakeMesh(double _span, double _chord, const std::string& aircraft_name)
+    : nelm(10), span(_span), chord(_chord), farGamma(0.0)
+{
+    geometry = WakeGeometry::get(span, chord, nelm);
+    elements = geometry->elements;
+
+    Gamma = nr_matrix(1, nelm, 1, 1);
+    for (int i=1; i<=nelm; ++i)
+        Gamma[i][1] = 0.0;
+
+    if (!geometry->valid) {
+        // Something went wrong with the matrix factorization: the circulations
+        // remain zero, which disables the current aircraft wake.
         SG_LOG(SG_FLIGHT, SG_WARN,
                 "Failed to build wake mesh. " << aircraft_name << " ( span:"
                 << _span << ", chord:" << _chord << ") wake will be ignored.");
@@ -78,18 +273,34 @@ WakeMesh::WakeMesh(double _span, double _chord, const std::string& aircraft_name
 
 WakeMesh::~WakeMesh()
 {
-    nr_free_matrix(influenceMtx, 1, nelm, 1, nelm);
     nr_free_matrix(Gamma, 1, nelm, 1, 1);
 }
 
-double WakeMesh::computeAoA(double vel, double rho, double weight)
+void WakeMesh::solveGamma(const std::vector<double>& rhs)
 {
-    for (int i=1; i<=nelm; ++i) {
-        Gamma[i][1] = 0.0;
-        for (int k=1; k<=nelm; ++k)
-            Gamma[i][1] -= influenceMtx[i][k];
-        Gamma[i][1] *= vel;
+    farGamma = 0.0;
+
+    if (!geometry->valid) {
+        for (int i=1; i<=nelm; ++i)
+            Gamma[i][1] = 0.0;
+        return;
+    }
+
+    std::vector<double> x(rhs);
+    geometry->solve(x.data());
+
+    for (int i=0; i<nelm; ++i) {
+        Gamma[i+1][1] = x[i];
+        farGamma += geometry->farWeight[i]*x[i];
     }
+}
+
+double WakeMesh::computeAoA(double vel, double rho, double weight)
+{
+    if (!geometry->valid)
+        return 0.0;
+
+    solveGamma(std::vector<double>(nelm, -vel));
 
     // Compute the lift only. Velocities in the z direction are discarded
     // because they only produce drag. This include the vertical component
@@ -105,16 +316,25 @@ double WakeMesh::computeAoA(double vel, double rho, double weight)
 
     for (int i=1; i<=nelm; ++i)
         Gamma[i][1] *= sinAlpha;
+    farGamma *= sinAlpha;
 
     return asin(sinAlpha);
 }
 
 SGVec3d WakeMesh::getInducedVelocityAt(const SGVec3d& at) const
 {
-    SGVec3d v(0., 0., 0.);
+    if (!geometry->valid)
+        return SGVec3d::zeros();
 
-    for (int i=0; i<nelm; ++i)
-        v += Gamma[i+1][1] * elements[i]->getInducedVelocity(at);
+    // Distance to the wake: the trailing vortices extend to infinity behind
+    // the wing.
+    double d2 = at[1]*at[1] + at[2]*at[2];
+    if (at[0] > 0.0)
+        d2 += at[0]*at[0];
+
+    if (d2 > FAR_FIELD_SPANS*FAR_FIELD_SPANS*span*span)
+        return farGamma * geometry->farField->getInducedVelocity(at);
 
-    return v;
+    // nr_matrix allocates the rows contiguously
+    return geometry->inducedVelocity(&Gamma[1][1], at);
 }
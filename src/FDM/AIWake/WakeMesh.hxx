@@ -24,11 +24,13 @@
 #define _FG_WAKEMESH_HXX
 
 #include <string>
+#include <vector>
 
 #include "AeroElement.hxx"
 
 namespace FGTestApi { namespace PrivateAccessor { namespace FDM { class Accessor; } } }
 
+class WakeGeometry;
 
 class WakeMesh : public SGReferenced {
 public:
@@ -40,10 +42,20 @@ public:
 protected:
     friend class FGTestApi::PrivateAccessor::FDM::Accessor;
 
+    // Solve the influence matrix system for the circulations Gamma, using the
+    // factorization shared by all the meshes of the same geometry.
+    void solveGamma(const std::vector<double>& rhs);
+
     int nelm;
     double span, chord;
     std::vector<AeroElement_ptr> elements;
-    double **influenceMtx, **Gamma;
+    double **Gamma;
+
+    SGSharedPtr<WakeGeometry> geometry;
+
+    // Circulation of the single horseshoe vortex which replaces the mesh far
+    // from the wake. Updated with Gamma.
+    double farGamma;
 };
 
 typedef SGSharedPtr<WakeMesh> WakeMesh_ptr;
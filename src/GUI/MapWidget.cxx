@@ -896,7 +896,7 @@ void MapWidget::paintRoute()
     return;
   }
 
-  RoutePath path(_route->flightPlan());
+  const RoutePath& path = _route->flightPlan()->routePath();
 
 // first pass, draw the actual lines
   glLineWidth(2.0);
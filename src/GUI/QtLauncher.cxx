@@ -267,7 +267,7 @@ private:
         if (!path.exists())
             return; // silently fail for now
 
-        flightgear::SHPParser::parsePolyLines(path, aType, m_parsedLines, areClosed);
+        flightgear::SHPParser::loadPolyLines(path, aType, m_parsedLines, areClosed);
     }
 
     flightgear::PolyLineList m_parsedLines;
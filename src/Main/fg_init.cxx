@@ -905,6 +905,17 @@ fgInitNav ()
         }
     }
 
+    // identical installations can share a memory mapped export of the
+    // cache, see NavDataSnapshot
+    const std::string snapshot = fgGetString("/sim/navdb/snapshot");
+    if (!snapshot.empty()) {
+        const SGPath snapshotPath = SGPath::fromUtf8(snapshot);
+        if (fgGetBool("/sim/navdb/write-snapshot", false)) {
+            cache->writeSnapshot(snapshotPath);
+        }
+        cache->openSnapshot(snapshotPath);
+    }
+
   FGTACANList *channellist = new FGTACANList;
   globals->set_channellist( channellist );
   
@@ -0,0 +1,195 @@
+/*
+ * SPDX-FileName: BinaryCacheFile.cxx
+ * SPDX-FileComment: framing shared by the binary cache files
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#include "BinaryCacheFile.hxx"
+
+#include <atomic>
+#include <cstring>
+#include <sstream>
+
+#include <simgear/compiler.h>
+
+#if defined(SG_WINDOWS)
+#  include <process.h> // _getpid()
+#else
+#  include <unistd.h>
+#endif
+
+#include <simgear/debug/logstream.hxx>
+#include <simgear/io/iostreams/sgstream.hxx>
+#include <simgear/misc/sg_dir.hxx>
+
+namespace {
+
+const uint32_t ENDIAN_MARKER = 0x01020304;
+
+// unique across processes sharing FG_HOME and writers within one process
+std::string uniqueTmpSuffix()
+{
+    static std::atomic<unsigned int> counter{0};
+#if defined(SG_WINDOWS)
+    const int pid = _getpid();
+#else
+    const int pid = getpid();
+#endif
+    return ".tmp." + std::to_string(pid) + "." + std::to_string(counter++);
+}
+
+} // of anonymous namespace
+
+namespace flightgear {
+
+void BinaryCacheHeader::init(const char* aMagic, uint32_t aVersion)
+{
+    memcpy(magic, aMagic, sizeof(magic));
+    version = aVersion;
+    endianMarker = ENDIAN_MARKER;
+}
+
+bool BinaryCacheHeader::matches(const char* aMagic, uint32_t aVersion) const
+{
+    return !memcmp(magic, aMagic, sizeof(magic)) && (version == aVersion) &&
+           (endianMarker == ENDIAN_MARKER);
+}
+
+uint64_t binaryCacheAlign(uint64_t pos)
+{
+    return (pos + 7) & ~uint64_t(7);
+}
+
+bool binaryCacheSectionFits(uint64_t length, uint64_t pos, uint64_t count, uint64_t recordSize)
+{
+    return (pos % 8 == 0) && (pos <= length) && (count <= (length - pos) / recordSize);
+}
+
+bool readBinaryCacheFile(const SGPath& path, std::string& data)
+{
+    if (!path.exists()) {
+        return false;
+    }
+
+    sg_ifstream f(path, std::ios::in | std::ios::binary);
+    if (!f.is_open()) {
+        return false;
+    }
+
+    std::ostringstream buf;
+    buf << f.rdbuf();
+    data = buf.str();
+    return true;
+}
+
+BinaryCacheReader::BinaryCacheReader(const std::string& data) : _data(data)
+{
+}
+
+bool BinaryCacheReader::get(void* out, size_t len)
+{
+    if (len > remaining()) {
+        return false;
+    }
+
+    memcpy(out, _data.data() + _pos, len);
+    _pos += len;
+    return true;
+}
+
+bool BinaryCacheReader::getString(std::string& out, size_t len)
+{
+    if (len > remaining()) {
+        return false;
+    }
+
+    out.assign(_data, _pos, len);
+    _pos += len;
+    return true;
+}
+
+BinaryCacheWriter::BinaryCacheWriter(const SGPath& path) : _path(path)
+{
+    SGPath dir = _path.dirPath();
+    if (!dir.exists()) {
+        simgear::Dir(dir).create(0755);
+    }
+
+    _tmpPath = _path;
+    _tmpPath.concat(uniqueTmpSuffix());
+    _stream.reset(new sg_ofstream(_tmpPath, std::ios::out | std::ios::binary | std::ios::trunc));
+    if (!_stream->is_open()) {
+        SG_LOG(SG_IO, SG_WARN, "unable to write cache file " << _tmpPath);
+        _stream.reset();
+    }
+}
+
+BinaryCacheWriter::~BinaryCacheWriter()
+{
+    if (_stream) {
+        // never committed
+        discard();
+    }
+}
+
+bool BinaryCacheWriter::isOpen() const
+{
+    return _stream != nullptr;
+}
+
+sg_ofstream& BinaryCacheWriter::stream()
+{
+    return *_stream;
+}
+
+void BinaryCacheWriter::write(const void* data, size_t len)
+{
+    _stream->write(reinterpret_cast<const char*>(data), len);
+}
+
+void BinaryCacheWriter::padTo(uint64_t pos)
+{
+    static const char zeros[8] = {0};
+    const uint64_t current = static_cast<uint64_t>(_stream->tellp());
+    if (pos > current) {
+        _stream->write(zeros, pos - current);
+    }
+}
+
+bool BinaryCacheWriter::commit()
+{
+    if (!_stream) {
+        return false;
+    }
+
+    _stream->close();
+    const bool ok = !_stream->fail();
+    _stream.reset();
+    if (!ok) {
+        SG_LOG(SG_IO, SG_WARN, "error writing cache file " << _tmpPath);
+        _tmpPath.remove();
+        return false;
+    }
+
+    if (_path.exists()) {
+        _path.remove();
+    }
+
+    if (!_tmpPath.rename(_path)) {
+        SG_LOG(SG_IO, SG_WARN, "unable to rename " << _tmpPath << " to " << _path);
+        _tmpPath.remove();
+        return false;
+    }
+
+    return true;
+}
+
+void BinaryCacheWriter::discard()
+{
+    _stream.reset();
+    _tmpPath.remove();
+}
+
+} // of namespace flightgear
@@ -0,0 +1,120 @@
+/*
+ * SPDX-FileName: BinaryCacheFile.hxx
+ * SPDX-FileComment: framing shared by the binary cache files
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <simgear/misc/sg_path.hxx>
+
+class sg_ofstream;
+
+namespace flightgear {
+
+/**
+ * The leading fields of every binary cache file. The magic names the kind
+ * of cache, the version its layout, and the endian marker the byte order
+ * of the machine which wrote it. Any mismatch means the file is ignored
+ * and rebuilt.
+ */
+struct BinaryCacheHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t endianMarker;
+
+    void init(const char* aMagic, uint32_t aVersion);
+    bool matches(const char* aMagic, uint32_t aVersion) const;
+};
+
+/**
+ * Round up to the 8-byte boundary each section of a mapped cache file
+ * starts on, so its records can be used in place.
+ */
+uint64_t binaryCacheAlign(uint64_t pos);
+
+/**
+ * Check a section of count records starts on an 8-byte boundary and lies
+ * within a file of the given length. Counts and positions read from a
+ * damaged file can be anything, so this must pass before touching a record.
+ */
+bool binaryCacheSectionFits(uint64_t length, uint64_t pos, uint64_t count, uint64_t recordSize);
+
+/**
+ * Read a whole cache file into memory. Returns false if the file is
+ * missing or can't be read.
+ */
+bool readBinaryCacheFile(const SGPath& path, std::string& data);
+
+/**
+ * Reads the fields of a cache file held in memory, failing rather than
+ * reading past the end of a short file.
+ */
+class BinaryCacheReader
+{
+public:
+    explicit BinaryCacheReader(const std::string& data);
+
+    bool get(void* out, size_t len);
+    bool getString(std::string& out, size_t len);
+
+    size_t size() const
+    { return _data.size(); }
+
+    size_t remaining() const
+    { return _data.size() - _pos; }
+
+private:
+    const std::string& _data;
+    size_t _pos = 0;
+};
+
+/**
+ * Writes a cache file to a temporary file beside it, which commit()
+ * renames into place, so another instance never reads a partially written
+ * file. The temporary name is unique to the process and writer, so
+ * instances sharing FG_HOME never write into the same file. It is removed
+ * if the writer is destroyed without committing.
+ */
+class BinaryCacheWriter
+{
+public:
+    explicit BinaryCacheWriter(const SGPath& path);
+    ~BinaryCacheWriter();
+
+    bool isOpen() const;
+
+    sg_ofstream& stream();
+
+    void write(const void* data, size_t len);
+
+    /**
+     * Write zeros up to pos, which is normally a section start computed
+     * with binaryCacheAlign().
+     */
+    void padTo(uint64_t pos);
+
+    /**
+     * Close the temporary file and replace the cache file with it. Returns
+     * false, leaving no temporary file behind, if any write failed.
+     */
+    bool commit();
+
+    const SGPath& path() const
+    { return _path; }
+
+private:
+    void discard();
+
+    SGPath _path;
+    SGPath _tmpPath;
+    std::unique_ptr<sg_ofstream> _stream;
+};
+
+} // of namespace flightgear
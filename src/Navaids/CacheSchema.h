@@ -1,6 +1,6 @@
 #pragma once
 
-const int SCHEMA_VERSION = 25;
+const int SCHEMA_VERSION = 29;
 
 #define SCHEMA_SQL                                                                              \
     "CREATE TABLE properties (key VARCHAR, value VARCHAR);"                                     \
@@ -15,7 +15,12 @@ const int SCHEMA_VERSION = 25;
     "CREATE INDEX pos_name ON positioned(name collate nocase);"                                 \
     "CREATE INDEX pos_apt_type ON positioned(airport, type);"                                   \
                                                                                                 \
+    "CREATE TABLE name_word (word VARCHAR, positioned INT64);"                                  \
+    "CREATE INDEX name_word_word ON name_word(word);"                                           \
+                                                                                                \
     "CREATE TABLE airport (scenery_path VARCHAR, has_metar BOOL);"                              \
+    "CREATE TABLE airport_detail (dat_file VARCHAR, dat_offset INT64, dat_line INT,"            \
+    "dat_rows BLOB);"                                                                           \
     "CREATE TABLE comm (freq_khz INT,range_nm INT);"                                            \
     "CREATE INDEX comm_freq ON comm(freq_khz);"                                                 \
                                                                                                 \
@@ -45,6 +45,7 @@
 #include <Navaids/procedure.hxx>
 #include <Navaids/waypoint.hxx>
 #include <Navaids/routePath.hxx>
+#include <Navaids/ProcedureCache.hxx>
 #include <Navaids/airways.hxx>
 #include <Autopilot/route_mgr.hxx>
 #include <Aircraft/AircraftPerformance.hxx>
@@ -456,6 +457,12 @@ void FlightPlan::finish()
     return;
   }
   
+  // procedures prefetched on activation which were never picked
+  auto procedures = ProcedureCache::instance();
+  procedures->discardPrefetch(_departure.get());
+  procedures->discardPrefetch(_destination.get());
+  procedures->discardPrefetch(_alternate.get());
+
   lockDelegates();
   _currentIndex = -1;
   _currentWaypointChanged = true;
@@ -1527,6 +1534,12 @@ void FlightPlan::activate()
     }
   }
   
+  // read the procedures which may be picked later on in the background
+  auto procedures = ProcedureCache::instance();
+  procedures->prefetch(_departure.get());
+  procedures->prefetch(_destination.get());
+  procedures->prefetch(_alternate.get());
+
   lockDelegates();
   
   _currentIndex = 0;
@@ -1712,6 +1725,10 @@ bool FlightPlan::Leg::setHoldCount(int count)
   void FlightPlan::Leg::markWaypointDirty()
   {
     auto fp = owner();
+    if (fp->_routePath) {
+      fp->_routePath->invalidate(_waypt);
+    }
+
     fp->lockDelegates();
     fp->_waypointsChanged = true;
     fp->unlockDelegates();
@@ -1756,7 +1773,7 @@ void FlightPlan::rebuildLegData()
 {
   _totalDistance = 0.0;
   double totalDistanceIncludingMissed = 0.0;
-  RoutePath path(this);
+  const RoutePath& path = routePath();
   
   for (unsigned int l=0; l<_legs.size(); ++l) {
     _legs[l]->_courseDeg = path.trackForIndex(l);
@@ -1774,15 +1791,25 @@ void FlightPlan::rebuildLegData()
   
 }
   
+const RoutePath& FlightPlan::routePath() const
+{
+    if (!_routePath) {
+        _routePath.reset(new RoutePath(this));
+    } else {
+        _routePath->update(this);
+    }
+    return *_routePath;
+}
+
 SGGeod FlightPlan::pointAlongRoute(int aIndex, double aOffsetNm) const
 {
-    RoutePath rp(this);
+    const RoutePath& rp = routePath();
     return rp.positionForDistanceFrom(aIndex, aOffsetNm * SG_NM_TO_METER);
 }
 
 SGGeod FlightPlan::pointAlongRouteNorm(int aIndex, double aOffsetNorm) const
 {
-    RoutePath rp(this);
+    const RoutePath& rp = routePath();
     if (fabs(aOffsetNorm) > 1.0) {
         SG_LOG(SG_AUTOPILOT, SG_ALERT, "FlightPlan::pointAlongRouteNorm: called with invalid arg:" << aOffsetNorm);
         return rp.positionForIndex(aIndex);
@@ -1817,9 +1844,26 @@ void FlightPlan::lockDelegates()
   }
 }
 
+void FlightPlan::beginBatchEdit()
+{
+  lockDelegates();
+}
+
+void FlightPlan::commitBatchEdit()
+{
+  if (_delegateLock == 0) {
+    SG_LOG(SG_NAVAID, SG_DEV_WARN, "FlightPlan::commitBatchEdit: no batch edit in progress");
+    return;
+  }
+
+  unlockDelegates();
+}
+
 void FlightPlan::unlockDelegates()
 {
   assert(_delegateLock > 0);
+  // every edit is bracketed by lockDelegates() and unlockDelegates()
+  ++_revision;
   if (_delegateLock > 1) {
     --_delegateLock;
     return;
@@ -25,10 +25,13 @@
 #define FG_FLIGHTPLAN_HXX
 
 #include <functional>
+#include <memory>
 
 #include <Navaids/route.hxx>
 #include <Airports/airport.hxx>
 
+class RoutePath;
+
 namespace flightgear
 {
 
@@ -439,6 +442,29 @@ public:
     
     using LegVisitor = std::function<void(Leg*)>;
     void forEachLeg(const LegVisitor& lv);
+
+    /**
+     * The turn geometry of the legs. It is kept between edits and updated
+     * incrementally, so only the legs around an insert, delete or
+     * replacement are recomputed. Valid until the next edit.
+     */
+    const RoutePath& routePath() const;
+
+    /**
+     * Changes after every edit, so users of the legs can tell cheaply
+     * whether they need to look at them again.
+     */
+    unsigned int revision() const
+    { return _revision; }
+
+    /**
+     * Group several edits: leg data is recomputed, and delegates told about
+     * the changes, once when the outermost batch is committed instead of
+     * after every insert or delete. Batches nest; every beginBatchEdit()
+     * must be matched by a commitBatchEdit().
+     */
+    void beginBatchEdit();
+    void commitBatchEdit();
 private:
     FlightPlan(bool isRoute);
 
@@ -452,6 +478,7 @@ private:
   void notifyCleared();
     
   unsigned int _delegateLock = 0;
+  unsigned int _revision = 0;
   bool _arrivalChanged = false,
     _departureChanged = false,
     _waypointsChanged = false,
@@ -509,6 +536,8 @@ private:
     double _totalDistance;
     void rebuildLegData();
 
+    mutable std::unique_ptr<RoutePath> _routePath;
+
     using LegVec = std::vector<LegRef>;
     LegVec _legs;
 
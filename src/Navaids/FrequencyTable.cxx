@@ -0,0 +1,102 @@
+/*
+ * SPDX-FileName: FrequencyTable.cxx
+ * SPDX-FileComment: in-memory frequency lookup of navaids and comm stations
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#include "FrequencyTable.hxx"
+
+#include <algorithm>
+
+namespace flightgear {
+
+void FrequencyTable::clear()
+{
+    _stations.clear();
+    _indexOfGuid.clear();
+    _built = false;
+}
+
+void FrequencyTable::add(const Station& s)
+{
+    _stations.push_back(s);
+}
+
+void FrequencyTable::finish()
+{
+    // stable, so stations on one frequency stay in the order they were added
+    std::stable_sort(_stations.begin(), _stations.end(),
+                     [](const Station& a, const Station& b) { return a.freq < b.freq; });
+
+    _indexOfGuid.clear();
+    _indexOfGuid.reserve(_stations.size());
+    for (size_t i = 0; i < _stations.size(); ++i) {
+        _indexOfGuid[_stations[i].guid] = i;
+    }
+    _built = true;
+}
+
+std::pair<FrequencyTable::StationIterator, FrequencyTable::StationIterator>
+FrequencyTable::range(int freq) const
+{
+    auto first = std::lower_bound(_stations.begin(), _stations.end(), freq,
+                                  [](const Station& s, int f) { return s.freq < f; });
+    auto last = std::upper_bound(first, _stations.end(), freq,
+                                 [](int f, const Station& s) { return f < s.freq; });
+    return std::make_pair(first, last);
+}
+
+PositionedIDVec FrequencyTable::findByFreq(int freq, FGPositioned::Type minType,
+                                           FGPositioned::Type maxType,
+                                           const SGVec3d& pos, double maxRangeM) const
+{
+    const double maxD2 = (maxRangeM < 0.0) ? -1.0 : maxRangeM * maxRangeM;
+
+    std::vector<std::pair<double, PositionedID>> candidates;
+    auto r = range(freq);
+    for (auto it = r.first; it != r.second; ++it) {
+        if ((it->type < minType) || (it->type > maxType)) {
+            continue;
+        }
+
+        const double d2 = distSqr(it->cart, pos);
+        if ((maxD2 >= 0.0) && (d2 > maxD2)) {
+            continue;
+        }
+        candidates.emplace_back(d2, it->guid);
+    }
+
+    std::sort(candidates.begin(), candidates.end());
+
+    PositionedIDVec result;
+    result.reserve(candidates.size());
+    for (const auto& c : candidates) {
+        result.push_back(c.second);
+    }
+    return result;
+}
+
+PositionedIDVec FrequencyTable::findByFreq(int freq, FGPositioned::Type minType,
+                                           FGPositioned::Type maxType) const
+{
+    PositionedIDVec result;
+    auto r = range(freq);
+    for (auto it = r.first; it != r.second; ++it) {
+        if ((it->type >= minType) && (it->type <= maxType)) {
+            result.push_back(it->guid);
+        }
+    }
+    return result;
+}
+
+void FrequencyTable::updatePosition(PositionedID guid, const SGVec3d& cart)
+{
+    auto it = _indexOfGuid.find(guid);
+    if (it != _indexOfGuid.end()) {
+        _stations[it->second].cart = cart;
+    }
+}
+
+} // of namespace flightgear
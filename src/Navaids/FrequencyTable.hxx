@@ -0,0 +1,73 @@
+/*
+ * SPDX-FileName: FrequencyTable.hxx
+ * SPDX-FileComment: in-memory frequency lookup of navaids and comm stations
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include <simgear/math/SGMath.hxx>
+
+#include <Navaids/positioned.hxx>
+
+namespace flightgear {
+
+/**
+ * All stations of one kind (navaids or comm stations) sorted by
+ * frequency, with their type and cartesian position. NavDataCache builds
+ * one for each kind from the database on first use, and answers the
+ * by-frequency queries of the radio instruments from it, instead of
+ * running a query which computes the distance of every candidate row in
+ * SQL.
+ *
+ * Frequencies are in the units of the database column they come from.
+ */
+class FrequencyTable
+{
+public:
+    struct Station {
+        int freq;
+        PositionedID guid;
+        FGPositioned::Type type;
+        SGVec3d cart;
+    };
+
+    void clear();
+
+    bool isBuilt() const
+    { return _built; }
+
+    /// add a station, at most once each; call finish() once all are added
+    void add(const Station& s);
+    void finish();
+
+    /**
+     * stations on freq of a type in [minType, maxType], nearest to pos
+     * first, optionally only those within maxRangeM
+     */
+    PositionedIDVec findByFreq(int freq, FGPositioned::Type minType, FGPositioned::Type maxType,
+                               const SGVec3d& pos, double maxRangeM = -1.0) const;
+
+    /// as above, in the order they were added
+    PositionedIDVec findByFreq(int freq, FGPositioned::Type minType, FGPositioned::Type maxType) const;
+
+    /// keep the position of a station which moved in sync, once finished
+    void updatePosition(PositionedID guid, const SGVec3d& cart);
+
+    size_t size() const
+    { return _stations.size(); }
+
+private:
+    typedef std::vector<Station>::const_iterator StationIterator;
+    std::pair<StationIterator, StationIterator> range(int freq) const;
+
+    std::vector<Station> _stations;
+    /// index of each station in _stations, for updatePosition()
+    std::unordered_map<PositionedID, size_t> _indexOfGuid;
+    bool _built = false;
+};
+
+} // of namespace flightgear
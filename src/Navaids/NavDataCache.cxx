@@ -10,13 +10,16 @@
 #include "NavDataCache.hxx"
 
 // std
+#include <algorithm>
 #include <cstddef>  // for std::size_t
 #include <map>
 #include <cstring>  // for memcoy
 #include <cassert>
+#include <cctype>
 #include <stdint.h> // for int64_t
 #include <sstream>  // for std::ostringstream
 #include <mutex>
+#include <set>
 #include <utility>
 #include <vector>
 
@@ -51,10 +54,15 @@
 #include <simgear/misc/strutils.hxx>
 #include <simgear/sg_inlines.h>
 #include <simgear/structure/exception.hxx>
+#include <simgear/threads/SGQueue.hxx>
 #include <simgear/threads/SGThread.hxx>
 
 #include "CacheSchema.h"
+#include "FrequencyTable.hxx"
+#include "NavDataSnapshot.hxx"
+#include "PositionedHotSet.hxx"
 #include "PositionedOctree.hxx"
+#include "SpatialQueryCache.hxx"
 #include "fix.hxx"
 #include "markerbeacon.hxx"
 #include "navrecord.hxx"
@@ -103,6 +111,75 @@ void sqlite_bind_temp_stdstring(sqlite3_stmt* stmt, int value, const std::string
 
 typedef sqlite3_stmt* sqlite3_stmt_ptr;
 
+// longest result list of a name search
+const size_t NAME_SEARCH_LIMIT = 500;
+
+// Words of a name or search term, as stored in the name_word table: runs
+// of letters and digits, upper-cased. Bytes of multi-byte UTF-8 sequences
+// count as letters, so accented names are indexed as whole words.
+string_list nameIndexWords(const std::string& s)
+{
+    string_list words;
+    std::string word;
+    for (unsigned char c : s) {
+        if (isalnum(c)) {
+            word.push_back(static_cast<char>(toupper(c)));
+        } else if ((c >= 0x80) && (c != 0xff)) {
+            word.push_back(static_cast<char>(c));
+        } else if (!word.empty()) {
+            words.push_back(word);
+            word.clear();
+        }
+    }
+
+    if (!word.empty()) {
+        words.push_back(word);
+    }
+    return words;
+}
+
+// the types the launcher and the airport dialog search by name
+bool isNameIndexed(FGPositioned::Type ty)
+{
+    return ((ty >= FGPositioned::AIRPORT) && (ty <= FGPositioned::SEAPORT)) ||
+           ((ty >= FGPositioned::FIX) && (ty <= FGPositioned::VOR)) ||
+           (ty == FGPositioned::DME) || (ty == FGPositioned::TACAN);
+}
+
+// Build a ranked search of positioned names: each word of the term has to
+// be the start of a word of the name; a single word may also be the start
+// of the ident. Exact ident matches come first, then ident prefixes, then
+// names starting with the term. The words consist only of letters, digits
+// and UTF-8 bytes, so they can be inlined as SQL literals.
+std::string nameSearchSQL(const std::string& columns, const std::string& term,
+                          const std::string& typeClause, size_t limit)
+{
+    const string_list words = nameIndexWords(term);
+    if (words.empty()) {
+        return {};
+    }
+
+    std::string matches;
+    for (const auto& w : words) {
+        std::string upperBound = w;
+        upperBound.back() = static_cast<char>(static_cast<unsigned char>(upperBound.back()) + 1);
+        if (!matches.empty()) {
+            matches += " INTERSECT ";
+        }
+        matches += "SELECT positioned FROM name_word WHERE word >= '" + w +
+                   "' AND word < '" + upperBound + "'";
+    }
+
+    const std::string& first = words.front();
+    if (words.size() == 1) {
+        matches += " UNION SELECT rowid FROM positioned WHERE ident LIKE '" + first + "%'";
+    }
+
+    return "SELECT " + columns + " FROM positioned WHERE rowid IN (" + matches + ") AND " +
+           typeClause + " ORDER BY (ident = '" + first + "') DESC, (ident LIKE '" + first +
+           "%') DESC, (name LIKE '" + first + "%') DESC, name LIMIT " + std::to_string(limit);
+}
+
 void f_distanceCartSqrFunction(sqlite3_context* ctx, int argc, sqlite3_value* argv[])
 {
   if (argc != 6) {
@@ -231,6 +308,196 @@ private:
 
 ////////////////////////////////////////////////////////////////////////////
 
+namespace {
+
+// leaves are queued again once the searches moved this far
+const double PREFETCH_RECENTRE_M = Octree::LEAF_SIZE * 0.5;
+const double DEFAULT_PREFETCH_RANGE_NM = 40.0;
+const double DEFAULT_PREFETCH_BUDGET_MB = 32.0;
+
+// positioned rows with the columns of their type's table, see readRecordRow
+#define RECORD_SELECT_SQL \
+    "SELECT positioned.rowid, positioned.type, positioned.ident, positioned.name, " \
+    "positioned.airport, positioned.lon, positioned.lat, positioned.elev_m, positioned.octree_node, " \
+    "airport.scenery_path, airport.has_metar, " \
+    "runway.heading, runway.length_ft, runway.width_m, runway.surface, " \
+    "runway.displaced_threshold, runway.stopway, runway.reciprocal, runway.ils, " \
+    "navaid.freq, navaid.range_nm, navaid.multiuse, navaid.runway, navaid.colocated, " \
+    "comm.freq_khz, comm.range_nm " \
+    "FROM positioned " \
+    "LEFT JOIN airport ON airport.rowid=positioned.rowid " \
+    "LEFT JOIN runway ON runway.rowid=positioned.rowid " \
+    "LEFT JOIN navaid ON navaid.rowid=positioned.rowid " \
+    "LEFT JOIN comm ON comm.rowid=positioned.rowid "
+
+// the members of a leaf, and every item of the airports in the leaf
+const char* PREFETCH_LEAF_SQL = RECORD_SELECT_SQL
+    "WHERE positioned.octree_node=?1 OR positioned.airport IN "
+    "(SELECT rowid FROM positioned WHERE octree_node=?1 AND type>=?2 AND type<=?3)";
+
+std::string columnString(sqlite3_stmt_ptr stmt, int col)
+{
+    const char* text = (const char*)sqlite3_column_text(stmt, col);
+    return text ? std::string{text} : std::string{};
+}
+
+void readRecordRow(sqlite3_stmt_ptr stmt, PositionedRecord& p)
+{
+    p.guid = sqlite3_column_int64(stmt, 0);
+    p.type = static_cast<FGPositioned::Type>(sqlite3_column_int(stmt, 1));
+    p.ident = columnString(stmt, 2);
+    p.name = columnString(stmt, 3);
+    p.airport = sqlite3_column_int64(stmt, 4);
+    p.pos = SGGeod::fromDegM(sqlite3_column_double(stmt, 5),
+                             sqlite3_column_double(stmt, 6),
+                             sqlite3_column_double(stmt, 7));
+    p.octreeNode = sqlite3_column_int64(stmt, 8);
+    p.sceneryPath = columnString(stmt, 9);
+    p.hasMetar = (sqlite3_column_int(stmt, 10) > 0);
+    p.heading = sqlite3_column_double(stmt, 11);
+    p.length = sqlite3_column_int(stmt, 12);
+    p.width = sqlite3_column_double(stmt, 13);
+    p.surface = sqlite3_column_int(stmt, 14);
+    p.displacedThreshold = sqlite3_column_double(stmt, 15);
+    p.stopway = sqlite3_column_double(stmt, 16);
+    p.reciprocal = sqlite3_column_int64(stmt, 17);
+    p.ils = sqlite3_column_int64(stmt, 18);
+    if ((p.type >= FGPositioned::FREQ_GROUND) && (p.type <= FGPositioned::FREQ_UNICOM)) {
+        p.freq = sqlite3_column_int(stmt, 24);
+        p.rangeNm = sqlite3_column_int(stmt, 25);
+    } else {
+        p.freq = sqlite3_column_int(stmt, 19);
+        p.rangeNm = sqlite3_column_int(stmt, 20);
+    }
+    p.multiuse = sqlite3_column_double(stmt, 21);
+    p.runway = sqlite3_column_int64(stmt, 22);
+    p.colocated = sqlite3_column_int64(stmt, 23);
+}
+
+} // of anonymous namespace
+
+/**
+ * Loads octree leaves for the hot set, with its own read-only connection
+ * to the cache so the queries don't block the main thread.
+ */
+class LeafPrefetchThread : public SGThread
+{
+public:
+  struct LoadedLeaf {
+      int64_t leaf;
+      unsigned int generation;
+      PositionedRecordVec records;
+  };
+
+  LeafPrefetchThread(const SGPath& path)
+  {
+      std::string pathUtf8 = path.utf8Str();
+      if (sqlite3_open_v2(pathUtf8.c_str(), &_db, SQLITE_OPEN_READONLY, NULL) == SQLITE_OK) {
+          sqlite3_prepare_v2(_db, PREFETCH_LEAF_SQL, -1, &_query, NULL);
+      }
+
+      if (!_query) {
+          SG_LOG(SG_NAVCACHE, SG_WARN, "NavCache: leaf prefetch disabled, couldn't prepare query");
+      }
+  }
+
+  ~LeafPrefetchThread()
+  {
+      _requests.push(Request{0, 0}); // leaf IDs start at one, 0 asks to exit
+      join();
+      sqlite3_finalize(_query);
+      sqlite3_close_v2(_db);
+  }
+
+  bool isValid() const
+  { return _query != nullptr; }
+
+  void request(int64_t leaf, unsigned int generation)
+  {
+      {
+          std::lock_guard<std::mutex> g(_lock);
+          ++_pending;
+      }
+      _requests.push(Request{leaf, generation});
+  }
+
+  std::vector<LoadedLeaf> takeResults()
+  {
+      std::lock_guard<std::mutex> g(_lock);
+      std::vector<LoadedLeaf> r;
+      r.swap(_results);
+      return r;
+  }
+
+  size_t pending() const
+  {
+      std::lock_guard<std::mutex> g(_lock);
+      return _pending;
+  }
+
+  virtual void run()
+  {
+      for (;;) {
+          Request r = _requests.pop();
+          if (r.leaf == 0) {
+              break;
+          }
+
+          LoadedLeaf loaded;
+          loaded.leaf = r.leaf;
+          loaded.generation = r.generation;
+          load(r.leaf, loaded.records);
+
+          std::lock_guard<std::mutex> g(_lock);
+          --_pending;
+          _results.push_back(std::move(loaded));
+      }
+  }
+
+private:
+  struct Request {
+      int64_t leaf;
+      unsigned int generation;
+  };
+
+  void load(int64_t leaf, PositionedRecordVec& records)
+  {
+      sqlite3_bind_int64(_query, 1, leaf);
+      sqlite3_bind_int(_query, 2, FGPositioned::AIRPORT);
+      sqlite3_bind_int(_query, 3, FGPositioned::SEAPORT);
+
+      for (;;) {
+          int err = sqlite3_step(_query);
+          if (err == SQLITE_DONE) {
+              break;
+          } else if (err == SQLITE_BUSY) {
+              // the main connection is writing, sleep a tiny amount
+              SGTimeStamp::sleepForMSec(1);
+              continue;
+          } else if (err != SQLITE_ROW) {
+              SG_LOG(SG_NAVCACHE, SG_ALERT, "Sqlite error:" << sqlite3_errmsg(_db) << " prefetching octree leaf");
+              records.clear(); // don't keep half a leaf
+              break;
+          }
+
+          PositionedRecord p;
+          readRecordRow(_query, p);
+          records.push_back(std::move(p));
+      }
+
+      sqlite3_reset(_query);
+  }
+
+  SGBlockingQueue<Request> _requests;
+  mutable std::mutex _lock;
+  std::vector<LoadedLeaf> _results;
+  size_t _pending = 0;
+  sqlite3* _db = nullptr;
+  sqlite3_stmt_ptr _query = nullptr;
+};
+
+////////////////////////////////////////////////////////////////////////////
+
 typedef std::map<PositionedID, FGPositionedRef> PositionedCache;
 
 class AirportTower : public FGPositioned
@@ -278,6 +545,7 @@ public:
 
   ~NavDataCachePrivate()
   {
+    prefetcher.reset();
     close();
   }
 
@@ -613,6 +881,9 @@ public:
                             "cart_x=?6, cart_y=?7, cart_z=?8 WHERE rowid=?1");
 
     insertAirport = prepare("INSERT INTO airport (rowid, scenery_path, has_metar) VALUES (?, ?, ?)");
+    insertAirportDetail = prepare("INSERT INTO airport_detail (rowid, dat_file, dat_offset, dat_line, dat_rows)"
+                                  " VALUES (?1, ?2, ?3, ?4, ?5)");
+    loadAirportDetail = prepare("SELECT dat_file, dat_offset, dat_line, dat_rows FROM airport_detail WHERE rowid=?1");
     insertNavaid = prepare("INSERT INTO navaid (rowid, freq, range_nm, multiuse, runway, colocated)"
                            " VALUES (?1, ?2, ?3, ?4, ?5, ?6)");
 
@@ -623,23 +894,24 @@ public:
                            " VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8)");
     runwayLengthFtQuery = prepare("SELECT length_ft FROM runway WHERE rowid=?1");
 
+    insertNameWord = prepare("INSERT INTO name_word (word, positioned) VALUES (?1, ?2)");
+    removeNameWord = prepare("DELETE FROM name_word WHERE word=?1 AND positioned=?2");
+    positionedNameQuery = prepare("SELECT name FROM positioned WHERE rowid=?1");
+
     removePositionedQuery = prepare("DELETE FROM positioned WHERE rowid=?1");
     removeTempPosQuery = prepare("DELETE FROM temp_positioned WHERE rowid=?1");
 
     // query statement
     findClosestWithIdent = prepare("SELECT guid FROM all_positioned WHERE ident=?1 " AND_TYPED " ORDER BY distanceCartSqr(cart_x, cart_y, cart_z, ?4, ?5, ?6)");
+    findTempWithIdent = prepare("SELECT rowid FROM temp_positioned WHERE ident=?1 " AND_TYPED);
 
-    findCommByFreq = prepare("SELECT positioned.rowid FROM positioned, comm WHERE "
-                             "positioned.rowid=comm.rowid AND freq_khz=?1 "
-                             AND_TYPED " ORDER BY distanceCartSqr(cart_x, cart_y, cart_z, ?4, ?5, ?6)");
+    loadNavFrequencies = prepare("SELECT navaid.freq, positioned.rowid, type, cart_x, cart_y, cart_z "
+                                 "FROM positioned, navaid WHERE positioned.rowid=navaid.rowid "
+                                 "ORDER BY positioned.rowid");
 
-    findNavsByFreq = prepare("SELECT positioned.rowid FROM positioned, navaid WHERE "
-                             "positioned.rowid=navaid.rowid "
-                             "AND navaid.freq=?1 " AND_TYPED
-                             " ORDER BY distanceCartSqr(cart_x, cart_y, cart_z, ?4, ?5, ?6)");
-
-    findNavsByFreqNoPos = prepare("SELECT positioned.rowid FROM positioned, navaid WHERE "
-                                  "positioned.rowid=navaid.rowid AND freq=?1 " AND_TYPED);
+    loadCommFrequencies = prepare("SELECT comm.freq_khz, positioned.rowid, type, cart_x, cart_y, cart_z "
+                                  "FROM positioned, comm WHERE positioned.rowid=comm.rowid "
+                                  "ORDER BY positioned.rowid");
 
     findNavaidForRunway = prepare("SELECT positioned.rowid FROM positioned, navaid WHERE "
                                   "positioned.rowid=navaid.rowid AND runway=?1 AND type=?2");
@@ -660,12 +932,6 @@ public:
 
     getOctreeLeafChildren = prepare("SELECT rowid, type FROM positioned WHERE octree_node=?1");
 
-    searchAirports = prepare("SELECT ident, name FROM positioned WHERE (name LIKE ?1 OR ident LIKE ?1) " AND_TYPED
-                             // prioritize entries with matching ICAO
-                             " ORDER BY (ident LIKE ?1) DESC");
-    sqlite3_bind_int(searchAirports, 2, FGPositioned::AIRPORT);
-    sqlite3_bind_int(searchAirports, 3, FGPositioned::SEAPORT);
-
     getAllAirports = prepare("SELECT ident, name FROM positioned WHERE type>=?1 AND type <=?2");
     sqlite3_bind_int(getAllAirports, 1, FGPositioned::AIRPORT);
     sqlite3_bind_int(getAllAirports, 2, FGPositioned::SEAPORT);
@@ -705,6 +971,12 @@ public:
     airwayEdgesFrom = prepare("SELECT airway, b FROM airway_edge WHERE network=?1 AND a=?2");
     airwayEdgesTo = prepare("SELECT airway, a FROM airway_edge WHERE network=?1 AND b=?2");
     airwayEdges = prepare("SELECT a, b FROM airway_edge WHERE airway=?1");
+    airwayNetworkEdges = prepare("SELECT e.airway, e.a, e.b, "
+                                 "pa.cart_x, pa.cart_y, pa.cart_z, pb.cart_x, pb.cart_y, pb.cart_z "
+                                 "FROM airway_edge e "
+                                 "LEFT JOIN positioned pa ON pa.rowid=e.a "
+                                 "LEFT JOIN positioned pb ON pb.rowid=e.b "
+                                 "WHERE e.network=?1");
   }
 
   void writeIntProperty(const string& key, int value)
@@ -722,110 +994,56 @@ public:
 
   FGPositioned* loadById(sqlite_int64 rowId, sqlite3_int64& aptId);
 
-  FGAirport* loadAirport(sqlite_int64 rowId,
-                         FGPositioned::Type ty,
-                         const string& id, const string& name, const SGGeod& pos)
+  FGPositioned* createPositioned(const PositionedRecord& r);
+
+  PathList snapshotSources() const;
+
+  void readAirport(PositionedRecord& r)
   {
-    sqlite3_bind_int64(loadAirportStmt, 1, rowId);
+    sqlite3_bind_int64(loadAirportStmt, 1, r.guid);
     execSelect1(loadAirportStmt);
-    SGPath sceneryPath{(char *) sqlite3_column_text(loadAirportStmt, 0)};
-    bool hasMetar = (sqlite3_column_int(loadAirportStmt, 1) > 0);
+    r.sceneryPath = (char *) sqlite3_column_text(loadAirportStmt, 0);
+    r.hasMetar = (sqlite3_column_int(loadAirportStmt, 1) > 0);
     reset(loadAirportStmt);
-
-    return new FGAirport(rowId, id, pos, name, hasMetar, ty,
-                         std::move(sceneryPath));
   }
 
-  FGRunwayBase* loadRunway(sqlite3_int64 rowId, FGPositioned::Type ty,
-                           const string& id, const SGGeod& pos, PositionedID apt)
+  void readRunway(PositionedRecord& r)
   {
-    sqlite3_bind_int(loadRunwayStmt, 1, rowId);
+    sqlite3_bind_int(loadRunwayStmt, 1, r.guid);
     execSelect1(loadRunwayStmt);
 
-    double heading = sqlite3_column_double(loadRunwayStmt, 0);
-    double lengthM = sqlite3_column_int(loadRunwayStmt, 1);
-    double widthM = sqlite3_column_double(loadRunwayStmt, 2);
-    int surface = sqlite3_column_int(loadRunwayStmt, 3);
-
-    if (ty == FGPositioned::TAXIWAY) {
-      reset(loadRunwayStmt);
-      return new FGTaxiway(rowId, id, pos, heading, lengthM, widthM, surface, apt);
-    } else if (ty == FGPositioned::HELIPAD) {
-        reset(loadRunwayStmt);
-        return new FGHelipad(rowId, apt, id, pos, heading, lengthM, widthM, surface);
-    } else {
-      double displacedThreshold = sqlite3_column_double(loadRunwayStmt, 4);
-      double stopway = sqlite3_column_double(loadRunwayStmt, 5);
-      PositionedID reciprocal = sqlite3_column_int64(loadRunwayStmt, 6);
-      PositionedID ils = sqlite3_column_int64(loadRunwayStmt, 7);
-      FGRunway* r = new FGRunway(rowId, apt, id, pos, heading, lengthM, widthM,
-                          displacedThreshold, stopway, surface);
-
-      if (reciprocal > 0) {
-        r->setReciprocalRunway(reciprocal);
-      }
-
-      if (ils > 0) {
-        r->setILS(ils);
-      }
-
-      reset(loadRunwayStmt);
-      return r;
-    }
+    r.heading = sqlite3_column_double(loadRunwayStmt, 0);
+    r.length = sqlite3_column_int(loadRunwayStmt, 1);
+    r.width = sqlite3_column_double(loadRunwayStmt, 2);
+    r.surface = sqlite3_column_int(loadRunwayStmt, 3);
+    r.displacedThreshold = sqlite3_column_double(loadRunwayStmt, 4);
+    r.stopway = sqlite3_column_double(loadRunwayStmt, 5);
+    r.reciprocal = sqlite3_column_int64(loadRunwayStmt, 6);
+    r.ils = sqlite3_column_int64(loadRunwayStmt, 7);
+    reset(loadRunwayStmt);
   }
 
-  CommStation* loadComm(sqlite3_int64 rowId, FGPositioned::Type ty,
-                        const string& id, const string& name,
-                        const SGGeod& pos,
-                        PositionedID airport)
+  void readComm(PositionedRecord& r)
   {
-      SG_UNUSED(id);
-
-      sqlite3_bind_int64(loadCommStation, 1, rowId);
+      sqlite3_bind_int64(loadCommStation, 1, r.guid);
       execSelect1(loadCommStation);
 
-      int range = sqlite3_column_int(loadCommStation, 0);
-      int freqKhz = sqlite3_column_int(loadCommStation, 1);
+      r.freq = sqlite3_column_int(loadCommStation, 0);
+      r.rangeNm = sqlite3_column_int(loadCommStation, 1);
       reset(loadCommStation);
-
-      CommStation* c = new CommStation(rowId, name, ty, pos, freqKhz, range);
-      c->setAirport(airport);
-      return c;
   }
 
-  FGPositioned* loadNav(sqlite3_int64 rowId,
-                       FGPositioned::Type ty, const string& id,
-                       const string& name, const SGGeod& pos)
+  void readNav(PositionedRecord& r)
   {
-    sqlite3_bind_int64(loadNavaid, 1, rowId);
+    sqlite3_bind_int64(loadNavaid, 1, r.guid);
     execSelect1(loadNavaid);
 
-    PositionedID runway = sqlite3_column_int64(loadNavaid, 3);
-    // marker beacons are light-weight
-    if ((ty == FGPositioned::OM) || (ty == FGPositioned::IM) ||
-        (ty == FGPositioned::MM))
-    {
-      reset(loadNavaid);
-      return new FGMarkerBeaconRecord(rowId, ty, runway, pos);
-    }
-
-    int rangeNm = sqlite3_column_int(loadNavaid, 0),
-    freq = sqlite3_column_int(loadNavaid, 1);
-    double mulituse = sqlite3_column_double(loadNavaid, 2);
-    PositionedID colocated = sqlite3_column_int64(loadNavaid, 4);
+    r.rangeNm = sqlite3_column_int(loadNavaid, 0);
+    r.freq = sqlite3_column_int(loadNavaid, 1);
+    r.multiuse = sqlite3_column_double(loadNavaid, 2);
+    r.runway = sqlite3_column_int64(loadNavaid, 3);
+    r.colocated = sqlite3_column_int64(loadNavaid, 4);
     reset(loadNavaid);
-
-    FGNavRecord* n =
-      (ty == FGPositioned::MOBILE_TACAN)
-      ? new FGMobileNavRecord
-            (rowId, ty, id, name, pos, freq, rangeNm, mulituse, runway)
-      : new FGNavRecord
-            (rowId, ty, id, name, pos, freq, rangeNm, mulituse, runway);
-
-    if (colocated)
-      n->setColocatedDME(colocated);
-
-    return n;
   }
 
   PositionedID insertPositioned(FGPositioned::Type ty, const string& ident,
@@ -835,6 +1053,8 @@ public:
       if (abandonCache)
           throw AbandonCacheException{};
 
+      persistentDataChanged();
+
       SGVec3d cartPos(SGVec3d::fromGeod(pos));
 
       sqlite3_bind_int(insertPositionedQuery, 1, ty);
@@ -858,9 +1078,23 @@ public:
     sqlite3_bind_double(insertPositionedQuery, 11, cartPos.z());
 
     PositionedID r = execInsert(insertPositionedQuery);
+    if (isNameIndexed(ty)) {
+        insertNameWords(r, name);
+    }
     return r;
   }
 
+  void insertNameWords(PositionedID guid, const string& name)
+  {
+      const string_list words = nameIndexWords(name);
+      const std::set<std::string> unique(words.begin(), words.end());
+      for (const auto& w : unique) {
+          sqlite_bind_stdstring(insertNameWord, 1, w);
+          sqlite3_bind_int64(insertNameWord, 2, guid);
+          execInsert(insertNameWord);
+      }
+  }
+
 
   PositionedID insertTemporaryPositioned(PositionedID guid, FGPositioned::Type ty, const string& ident,
                                          const string& name, const SGGeod& pos,
@@ -897,9 +1131,19 @@ public:
     string query = s;
     if (!exact) query += "%";
 
+    // with a snapshot, only temporary items are left to search in the database
+    std::vector<PositionedID> guids;
+    string source = "all_positioned";
+    if (snapshot && (column == "ident")) {
+      guids = snapshot->findByIdent(s, exact,
+                                    filter ? filter->minType() : FGPositioned::INVALID,
+                                    filter ? filter->maxType() : FGPositioned::LAST_TYPE);
+      source = "(SELECT rowid AS guid, type, ident FROM temp_positioned)";
+    }
+
   // build up SQL query text
     string matchTerm = exact ? "=?1" : " LIKE ?1";
-    string sql = "SELECT guid FROM all_positioned WHERE " + column + matchTerm;
+    string sql = "SELECT guid FROM " + source + " WHERE " + column + matchTerm;
     if (filter) {
       sql += " " AND_TYPED;
     }
@@ -917,7 +1161,6 @@ public:
       sqlite3_bind_int(stmt, 3, filter->maxType());
     }
 
-    std::vector<PositionedID> guids;
     // Run the prepared SQL statement
     while (stepSelect(stmt)) {
         guids.push_back(sqlite3_column_int64(stmt, 0));
@@ -938,6 +1181,111 @@ public:
     return result;
   }
 
+  FGPositionedRef findClosestWithIdentInSnapshot(const string& ident, const SGVec3d& cartPos,
+                                                 FGPositioned::Filter* filter)
+  {
+    std::vector<PositionedID> guids = snapshot->findByIdent(ident, true,
+                                                            filter ? filter->minType() : FGPositioned::INVALID,
+                                                            filter ? filter->maxType() : FGPositioned::LAST_TYPE);
+
+    // temporary items are only in the database
+    sqlite_bind_stdstring(findTempWithIdent, 1, ident);
+    sqlite3_bind_int(findTempWithIdent, 2, filter ? filter->minType() : FGPositioned::INVALID);
+    sqlite3_bind_int(findTempWithIdent, 3, filter ? filter->maxType() : FGPositioned::LAST_TYPE);
+    while (stepSelect(findTempWithIdent)) {
+      guids.push_back(sqlite3_column_int64(findTempWithIdent, 0));
+    }
+    reset(findTempWithIdent);
+
+    FGPositionedRef result;
+    double resultDistSqr = 0.0;
+    for (const auto guid : guids) {
+      FGPositionedRef pos = outer->loadById(guid);
+      if (!pos || (filter && !filter->pass(pos))) {
+        continue;
+      }
+
+      const double d2 = distSqr(pos->cart(), cartPos);
+      if (!result || (d2 < resultDistSqr)) {
+        result = pos;
+        resultDistSqr = d2;
+      }
+    }
+    return result;
+  }
+
+  void takePrefetchedLeaves()
+  {
+    if (!prefetcher) {
+      return;
+    }
+
+    for (auto& loaded : prefetcher->takeResults()) {
+      prefetchInFlight.erase(loaded.leaf);
+      if (loaded.generation == prefetchGeneration) {
+        hotSet.insertLeaf(loaded.leaf, std::move(loaded.records));
+      }
+    }
+  }
+
+  /// stop using the snapshot and the prefetched leaves, after the
+  /// database was written to
+  void persistentDataChanged()
+  {
+    SpatialQueryCache::instance()->clear();
+
+    if (snapshot) {
+      SG_LOG(SG_NAVCACHE, SG_INFO, "NavCache: navdata modified, no longer using the snapshot");
+      snapshot.reset();
+      navFrequencies.clear();
+      commFrequencies.clear();
+    }
+
+    clearHotSet();
+  }
+
+  /// forget the prefetched leaves
+  void clearHotSet()
+  {
+    if ((hotSet.leafCount() == 0) && prefetchInFlight.empty()) {
+      return;
+    }
+
+    hotSet.clear();
+    prefetchInFlight.clear();
+    havePrefetchCentre = false;
+    ++prefetchGeneration;
+  }
+
+  /// the table for query, loaded on first use
+  const FrequencyTable& frequencyTable(FrequencyTable& table, sqlite3_stmt_ptr query)
+  {
+    if (table.isBuilt()) {
+      return table;
+    }
+
+    if (snapshot) {
+      snapshot->fillFrequencyTable(query == loadCommFrequencies, table);
+      return table;
+    }
+
+    while (stepSelect(query)) {
+      FrequencyTable::Station s;
+      s.freq = sqlite3_column_int(query, 0);
+      s.guid = sqlite3_column_int64(query, 1);
+      s.type = static_cast<FGPositioned::Type>(sqlite3_column_int(query, 2));
+      s.cart = SGVec3d(sqlite3_column_double(query, 3),
+                       sqlite3_column_double(query, 4),
+                       sqlite3_column_double(query, 5));
+      table.add(s);
+    }
+    reset(query);
+    table.finish();
+
+    SG_LOG(SG_NAVCACHE, SG_DEBUG, "loaded frequency table with " << table.size() << " stations");
+    return table;
+  }
+
   PositionedIDVec selectIds(sqlite3_stmt_ptr query)
   {
     PositionedIDVec result;
@@ -968,14 +1316,37 @@ public:
     deferredOctreeUpdates.clear();
   }
 
-  void removePositioned(PositionedID rowid)
+  void removePositioned(PositionedID rowid, FGPositioned::Type ty)
   {
+      if ((rowid > 0) && isNameIndexed(ty)) {
+          removeNameWords(rowid);
+      }
+
       auto stmt = rowid < 0 ? removeTempPosQuery : removePositionedQuery;
       sqlite3_bind_int64(stmt, 1, rowid);
       execUpdate(stmt);
       reset(stmt);
   }
 
+  // Remove the words insertNameWords() added: otherwise they would match
+  // whatever is inserted next with the same rowid
+  void removeNameWords(PositionedID guid)
+  {
+      sqlite3_bind_int64(positionedNameQuery, 1, guid);
+      const string name = execSelect(positionedNameQuery) ? columnString(positionedNameQuery, 0)
+                                                          : string{};
+      reset(positionedNameQuery);
+
+      // by word, to use the word index
+      const string_list words = nameIndexWords(name);
+      const std::set<std::string> unique(words.begin(), words.end());
+      for (const auto& w : unique) {
+          sqlite_bind_stdstring(removeNameWord, 1, w);
+          sqlite3_bind_int64(removeNameWord, 2, guid);
+          execUpdate(removeNameWord);
+      }
+  }
+
   NavDataCache* outer;
   sqlite3* db;
   SGPath path;
@@ -991,6 +1362,7 @@ public:
     /// the cache drops its reference
     PositionedCache cache;
     unsigned int cacheHits, cacheMisses;
+    unsigned int prefetchHits = 0;
 
     /**
    * record the levels of open transaction objects we have
@@ -1011,19 +1383,21 @@ public:
 
     sqlite3_stmt_ptr insertPositionedQuery, insertAirport, insertTower, insertRunway,
         insertCommStation, insertNavaid;
+    sqlite3_stmt_ptr insertAirportDetail, loadAirportDetail;
     sqlite3_stmt_ptr insertTempPosQuery;
     sqlite3_stmt_ptr setAirportMetar, setRunwayReciprocal, setRunwayILS, setNavaidColocated,
         updatePosition, updateTempPos;
+    sqlite3_stmt_ptr insertNameWord, removeNameWord, positionedNameQuery;
     sqlite3_stmt_ptr removePositionedQuery, removeTempPosQuery;
 
     sqlite3_stmt_ptr findClosestWithIdent;
+    sqlite3_stmt_ptr findTempWithIdent;
     // octree (spatial index) related queries
     sqlite3_stmt_ptr getOctreeChildren, insertOctree, updateOctreeChildren,
         getOctreeLeafChildren;
 
-    sqlite3_stmt_ptr searchAirports, getAllAirports;
-    sqlite3_stmt_ptr findCommByFreq, findNavsByFreq,
-        findNavsByFreqNoPos, findNavaidForRunway;
+    sqlite3_stmt_ptr getAllAirports;
+    sqlite3_stmt_ptr loadNavFrequencies, loadCommFrequencies, findNavaidForRunway;
     sqlite3_stmt_ptr getAirportItems, getAirportItemByIdent;
     sqlite3_stmt_ptr findAirportRunway,
         findILS;
@@ -1033,7 +1407,7 @@ public:
     // airways
     sqlite3_stmt_ptr findAirway, findAirwayNet, insertAirwayEdge,
         isPosInAirway, airwayEdgesFrom, airwayEdgesTo,
-        insertAirway, airwayEdges;
+        insertAirway, airwayEdges, airwayNetworkEdges;
     sqlite3_stmt_ptr loadAirway;
 
     // since there's many permutations of ident/name queries, we create
@@ -1050,6 +1424,22 @@ public:
     // otherwise, NULL
     std::unique_ptr<RebuildThread> rebuilder;
 
+    // by-frequency lookups of the radios, see FrequencyTable
+    FrequencyTable navFrequencies, commFrequencies;
+
+    // octree leaves loaded ahead of the spatial searches
+    std::unique_ptr<LeafPrefetchThread> prefetcher;
+    PositionedHotSet hotSet;
+    std::set<int64_t> prefetchInFlight;
+    // results of requests from before the last clear are dropped
+    unsigned int prefetchGeneration = 0;
+    bool prefetchDisabled = false;
+    bool havePrefetchCentre = false;
+    SGVec3d prefetchCentre;
+
+    // read-only export of the persistent data, see NavDataSnapshot
+    std::unique_ptr<NavDataSnapshot> snapshot;
+
     // transient rowIDs (not actually present in the on-disk DB, only in our
     // in-memory cache / temporary table) start at this value and count down
     PositionedID nextTransientId = -1000;
@@ -1067,32 +1457,32 @@ FGPositioned* NavDataCache::NavDataCachePrivate::loadById(sqlite3_int64 rowid,
     execSelect1(loadPositioned);
 
     assert(rowid == sqlite3_column_int64(loadPositioned, 0));
-    FGPositioned::Type ty = (FGPositioned::Type)sqlite3_column_int(loadPositioned, 1);
-
-    PositionedID prowid = static_cast<PositionedID>(rowid);
-    string ident = (char*)sqlite3_column_text(loadPositioned, 2);
-    string name = (char*)sqlite3_column_text(loadPositioned, 3);
-    aptId = sqlite3_column_int64(loadPositioned, 4);
+    PositionedRecord r;
+    r.guid = static_cast<PositionedID>(rowid);
+    r.type = (FGPositioned::Type)sqlite3_column_int(loadPositioned, 1);
+    r.ident = (char*)sqlite3_column_text(loadPositioned, 2);
+    r.name = (char*)sqlite3_column_text(loadPositioned, 3);
+    r.airport = sqlite3_column_int64(loadPositioned, 4);
     double lon = sqlite3_column_double(loadPositioned, 5);
     double lat = sqlite3_column_double(loadPositioned, 6);
     double elev = sqlite3_column_double(loadPositioned, 7);
-    SGGeod pos = SGGeod::fromDegM(lon, lat, elev);
+    r.pos = SGGeod::fromDegM(lon, lat, elev);
+    aptId = r.airport;
 
     reset(loadPositioned);
 
-    switch (ty) {
+    switch (r.type) {
     case FGPositioned::AIRPORT:
     case FGPositioned::SEAPORT:
     case FGPositioned::HELIPORT:
-      return loadAirport(rowid, ty, ident, name, pos);
-
-    case FGPositioned::TOWER:
-      return new AirportTower(prowid, aptId, ident, pos);
+      readAirport(r);
+      break;
 
     case FGPositioned::RUNWAY:
     case FGPositioned::HELIPAD:
     case FGPositioned::TAXIWAY:
-      return loadRunway(rowid, ty, ident, pos, aptId);
+      readRunway(r);
+      break;
 
     case FGPositioned::LOC:
     case FGPositioned::VOR:
@@ -1105,10 +1495,91 @@ FGPositioned* NavDataCache::NavDataCachePrivate::loadById(sqlite3_int64 rowid,
     case FGPositioned::DME:
     case FGPositioned::TACAN:
     case FGPositioned::MOBILE_TACAN:
-      return loadNav(rowid, ty, ident, name, pos);
+      readNav(r);
+      break;
+
+    case FGPositioned::FREQ_GROUND:
+    case FGPositioned::FREQ_TOWER:
+    case FGPositioned::FREQ_ATIS:
+    case FGPositioned::FREQ_AWOS:
+    case FGPositioned::FREQ_APP_DEP:
+    case FGPositioned::FREQ_ENROUTE:
+    case FGPositioned::FREQ_CLEARANCE:
+    case FGPositioned::FREQ_UNICOM:
+      readComm(r);
+      break;
+
+    default:
+      break;
+    }
+
+    return createPositioned(r);
+}
+
+FGPositioned* NavDataCache::NavDataCachePrivate::createPositioned(const PositionedRecord& r)
+{
+    PositionedID prowid = r.guid;
+
+    switch (r.type) {
+    case FGPositioned::AIRPORT:
+    case FGPositioned::SEAPORT:
+    case FGPositioned::HELIPORT:
+      return new FGAirport(r.guid, r.ident, r.pos, r.name, r.hasMetar, r.type,
+                           SGPath{r.sceneryPath});
+
+    case FGPositioned::TOWER:
+      return new AirportTower(prowid, r.airport, r.ident, r.pos);
+
+    case FGPositioned::TAXIWAY:
+      return new FGTaxiway(r.guid, r.ident, r.pos, r.heading, r.length, r.width,
+                           r.surface, r.airport);
+
+    case FGPositioned::HELIPAD:
+      return new FGHelipad(r.guid, r.airport, r.ident, r.pos, r.heading, r.length,
+                           r.width, r.surface);
+
+    case FGPositioned::RUNWAY: {
+      FGRunway* rwy = new FGRunway(r.guid, r.airport, r.ident, r.pos, r.heading, r.length,
+                                   r.width, r.displacedThreshold, r.stopway, r.surface);
+      if (r.reciprocal > 0) {
+        rwy->setReciprocalRunway(r.reciprocal);
+      }
+
+      if (r.ils > 0) {
+        rwy->setILS(r.ils);
+      }
+      return rwy;
+    }
+
+    // marker beacons are light-weight
+    case FGPositioned::OM:
+    case FGPositioned::MM:
+    case FGPositioned::IM:
+      return new FGMarkerBeaconRecord(r.guid, r.type, r.runway, r.pos);
+
+    case FGPositioned::LOC:
+    case FGPositioned::VOR:
+    case FGPositioned::GS:
+    case FGPositioned::ILS:
+    case FGPositioned::NDB:
+    case FGPositioned::DME:
+    case FGPositioned::TACAN:
+    case FGPositioned::MOBILE_TACAN: {
+      FGNavRecord* n =
+        (r.type == FGPositioned::MOBILE_TACAN)
+        ? new FGMobileNavRecord
+              (r.guid, r.type, r.ident, r.name, r.pos, r.freq, r.rangeNm, r.multiuse, r.runway)
+        : new FGNavRecord
+              (r.guid, r.type, r.ident, r.name, r.pos, r.freq, r.rangeNm, r.multiuse, r.runway);
+
+      if (r.colocated)
+        n->setColocatedDME(r.colocated);
+
+      return n;
+    }
 
     case FGPositioned::FIX:
-      return new FGFix(rowid, ident, pos);
+      return new FGFix(r.guid, r.ident, r.pos);
 
     case FGPositioned::WAYPOINT:
     case FGPositioned::COUNTRY:
@@ -1116,7 +1587,7 @@ FGPositioned* NavDataCache::NavDataCachePrivate::loadById(sqlite3_int64 rowid,
     case FGPositioned::TOWN:
     case FGPositioned::VILLAGE:
     case FGPositioned::VISUAL_REPORTING_POINT: {
-        FGPositioned* wpt = new POI(rowid, ty, ident, pos, name);
+        FGPositioned* wpt = new POI(r.guid, r.type, r.ident, r.pos, r.name);
         return wpt;
     }
 
@@ -1127,8 +1598,12 @@ FGPositioned* NavDataCache::NavDataCachePrivate::loadById(sqlite3_int64 rowid,
     case FGPositioned::FREQ_APP_DEP:
     case FGPositioned::FREQ_ENROUTE:
     case FGPositioned::FREQ_CLEARANCE:
-    case FGPositioned::FREQ_UNICOM:
-      return loadComm(rowid, ty, ident, name, pos, aptId);
+    case FGPositioned::FREQ_UNICOM: {
+      // note the constructor takes the range before the frequency
+      CommStation* c = new CommStation(r.guid, r.name, r.type, r.pos, r.rangeNm, r.freq);
+      c->setAirport(r.airport);
+      return c;
+    }
 
     default:
       return NULL;
@@ -1418,6 +1893,7 @@ NavDataCache::~NavDataCache()
 // ensure we wip the airports cache too, or we'll get out
 // of sync during tests
   FGAirport::clearAirportsCache();
+  Airway::clearCache();
 
   static_instance = nullptr;
   d.reset();
@@ -1709,7 +2185,8 @@ void NavDataCache::setRebuildPhaseProgress(RebuildPhase ph, unsigned int percent
 
 void NavDataCache::loadDatFiles(
     DatFileType type,
-    std::function<void(const SceneryLocation&, std::size_t, std::size_t)> loader)
+    std::function<void(const SceneryLocation&, std::size_t, std::size_t)> loader,
+    std::function<void()> finish)
 {
   SGTimeStamp st;
   const string typeStr = datTypeStr[type];
@@ -1729,6 +2206,10 @@ void NavDataCache::loadDatFiles(
     stampCacheFile(scLoc.datPath); // this uses the realpath() of the file
   }
 
+  if (finish) {
+    finish();
+  }
+
   // Store the list of .dat files we have loaded
   writeOrderedStringListProperty(typeStr + ".dat files", datFiles,
                                  SGPath::pathListSep);
@@ -1745,6 +2226,7 @@ void NavDataCache::doRebuild()
     d->close(); // completely close the sqlite object
     d->path.remove(); // remove the file on disk
     d->init(); // start again from scratch
+    Airway::clearCache();
 
     // initialise the root octree node
     d->runSQL("INSERT INTO octree (rowid, children) VALUES (1, 0)");
@@ -1758,8 +2240,11 @@ void NavDataCache::doRebuild()
 
         using namespace std::placeholders;  // for _1, _2, _3...
 
+        // the files are scanned in parallel, and all merged before the
+        // phase is over
         loadDatFiles(DATFILETYPE_APT,
-                     std::bind(&APTLoader::readAptDatFile, &aptLoader, _1, _2, _3));
+                     std::bind(&APTLoader::queueAptDatFile, &aptLoader, _1, _2, _3),
+                     std::bind(&APTLoader::finishScans, &aptLoader));
 
         st.stamp();
         setRebuildPhaseProgress(REBUILD_UNKNOWN);
@@ -2077,7 +2562,20 @@ FGPositionedRef NavDataCache::loadById(PositionedID rowid)
   }
 
   sqlite3_int64 aptId;
-  FGPositionedRef pos = d->loadById(rowid, aptId);
+  FGPositionedRef pos;
+  const PositionedRecord* record = d->hotSet.find(rowid);
+  PositionedRecord snapshotRecord;
+  if (record) {
+    aptId = record->airport;
+    pos = d->createPositioned(*record);
+    d->prefetchHits++;
+  } else if (d->snapshot && d->snapshot->findRecord(rowid, snapshotRecord)) {
+    aptId = snapshotRecord.airport;
+    pos = d->createPositioned(snapshotRecord);
+  } else {
+    pos = d->loadById(rowid, aptId);
+  }
+
   if (rebuildInProgress) {
     // Do not cache and apply ILS adjustment while rebuilding the cache.
     // The adjustment process requires all ILS navaids to be present,
@@ -2117,6 +2615,9 @@ PositionedID NavDataCache::insertAirport(FGPositioned::Type ty, const string& id
 
 void NavDataCache::updatePosition(PositionedID item, const SGGeod &pos)
 {
+    // items moving in or out of a cached search area
+    SpatialQueryCache::instance()->clear();
+
     const bool isTemporary = (item < 0);
     SGVec3d cartPos(SGVec3d::fromGeod(pos));
     auto it = d->cache.find(item);
@@ -2146,6 +2647,7 @@ void NavDataCache::updatePosition(PositionedID item, const SGGeod &pos)
 
     if (it != d->cache.end()) {
         d->cache[item]->modifyPosition(pos);
+        updateFrequencyPosition(item, it->second->type(), cartPos);
     }
 
     auto stmt = isTemporary ? d->updateTempPos : d->updatePosition;
@@ -2165,6 +2667,9 @@ void NavDataCache::updatePosition(PositionedID item, const SGGeod &pos)
         // which was updated above.
         Octree::Leaf* octreeLeaf = Octree::globalPersistentOctree()->findLeafForPos(cartPos);
         sqlite3_bind_int64(stmt, 5, octreeLeaf->guid());
+
+        // the prefetched record would still have the old position
+        d->persistentDataChanged();
     }
 
     sqlite3_bind_double(stmt, 6, cartPos.x());
@@ -2271,6 +2776,7 @@ NavDataCache::insertNavaid(FGPositioned::Type ty, const string& ident,
   sqlite3_bind_double(d->insertNavaid, 4, multiuse);
   sqlite3_bind_int64(d->insertNavaid, 5, runway);
   sqlite3_bind_int64(d->insertNavaid, 6, 0);
+  d->navFrequencies.clear();
   return d->execInsert(d->insertNavaid);
 }
 
@@ -2296,6 +2802,7 @@ PositionedID NavDataCache::insertCommStation(FGPositioned::Type ty,
   sqlite3_bind_int64(d->insertCommStation, 1, rowId);
   sqlite3_bind_int(d->insertCommStation, 2, freq);
   sqlite3_bind_int(d->insertCommStation, 3, range);
+  d->commFrequencies.clear();
   return d->execInsert(d->insertCommStation);
 }
 
@@ -2321,7 +2828,7 @@ bool NavDataCache::removePOI(FGPositionedRef ref)
         octreeLeaf->removeChild(ref->guid());
     }
 
-    d->removePositioned(ref->guid());
+    d->removePositioned(ref->guid(), ref->type());
 
     auto it = d->cache.find(ref->guid());
     d->cache.erase(it);
@@ -2336,6 +2843,35 @@ void NavDataCache::setAirportMetar(const string& icao, bool hasMetar)
   d->execUpdate(d->setAirportMetar);
 }
 
+void NavDataCache::setAirportDetail(PositionedID airport, const SGPath& aptDat,
+                                    int64_t offset, unsigned int lineNum,
+                                    const string& rows)
+{
+  sqlite3_bind_int64(d->insertAirportDetail, 1, airport);
+  sqlite_bind_temp_stdstring(d->insertAirportDetail, 2, aptDat.utf8Str());
+  sqlite3_bind_int64(d->insertAirportDetail, 3, offset);
+  sqlite3_bind_int(d->insertAirportDetail, 4, lineNum);
+  sqlite3_bind_blob(d->insertAirportDetail, 5, rows.data(), rows.size(), SQLITE_STATIC);
+  d->execInsert(d->insertAirportDetail);
+}
+
+bool NavDataCache::airportDetail(PositionedID airport, SGPath& aptDat,
+                                 int64_t& offset, unsigned int& lineNum, string& rows)
+{
+  sqlite3_bind_int64(d->loadAirportDetail, 1, airport);
+  const bool found = d->execSelect(d->loadAirportDetail);
+  if (found) {
+    aptDat = SGPath::fromUtf8((char*) sqlite3_column_text(d->loadAirportDetail, 0));
+    offset = sqlite3_column_int64(d->loadAirportDetail, 1);
+    lineNum = sqlite3_column_int(d->loadAirportDetail, 2);
+    const char* data = (const char*)sqlite3_column_blob(d->loadAirportDetail, 3);
+    rows.assign(data ? data : "", sqlite3_column_bytes(d->loadAirportDetail, 3));
+  }
+
+  d->reset(d->loadAirportDetail);
+  return found;
+}
+
 //------------------------------------------------------------------------------
 FGPositionedList NavDataCache::findAllWithIdent( const string& s,
                                                  FGPositioned::Filter* filter,
@@ -2352,11 +2888,50 @@ FGPositionedList NavDataCache::findAllWithName( const string& s,
   return d->findAllByString(s, "name", filter, exact);
 }
 
+//------------------------------------------------------------------------------
+FGPositionedList NavDataCache::searchNames(const string& term,
+                                           FGPositioned::Filter* filter,
+                                           size_t limit)
+{
+  string types = "1";
+  if (filter) {
+    types = "(type >= " + std::to_string(filter->minType()) +
+            " AND type <= " + std::to_string(filter->maxType()) + ")";
+  }
+
+  FGPositionedList result;
+  const string sql = nameSearchSQL("rowid", term, types, limit ? limit : NAME_SEARCH_LIMIT);
+  sqlite3_stmt_ptr stmt = nullptr;
+  if (sql.empty() ||
+      (sqlite3_prepare_v2(d->db, sql.c_str(), sql.length(), &stmt, nullptr) != SQLITE_OK)) {
+    return result;
+  }
+
+  PositionedIDVec ids;
+  while (d->stepSelect(stmt)) {
+    ids.push_back(sqlite3_column_int64(stmt, 0));
+  }
+  // finalize before loading, loadById runs queries of its own
+  sqlite3_finalize(stmt);
+
+  for (auto id : ids) {
+    FGPositionedRef p = loadById(id);
+    if (p && (!filter || filter->pass(p))) {
+      result.push_back(p);
+    }
+  }
+  return result;
+}
+
 //------------------------------------------------------------------------------
 FGPositionedRef NavDataCache::findClosestWithIdent( const string& aIdent,
                                                     const SGGeod& aPos,
                                                     FGPositioned::Filter* aFilter )
 {
+  if (d->snapshot) {
+    return d->findClosestWithIdentInSnapshot(aIdent, SGVec3d::fromGeod(aPos), aFilter);
+  }
+
   sqlite_bind_stdstring(d->findClosestWithIdent, 1, aIdent);
   if (aFilter) {
     sqlite3_bind_int(d->findClosestWithIdent, 2, aFilter->minType());
@@ -2390,6 +2965,13 @@ FGPositionedRef NavDataCache::findClosestWithIdent( const string& aIdent,
 
 int NavDataCache::getOctreeBranchChildren(int64_t octreeNodeId)
 {
+    if (d->snapshot) {
+        const int children = d->snapshot->branchChildren(octreeNodeId);
+        if (children >= 0) {
+            return children;
+        }
+    }
+
     sqlite3_bind_int64(d->getOctreeChildren, 1, octreeNodeId);
     if (!d->execSelect(d->getOctreeChildren)) {
         // this can occur when in read-only mode: we don't add
@@ -2430,9 +3012,16 @@ void NavDataCache::defineOctreeNode(Octree::Branch* pr, Octree::Node* nd)
 TypedPositionedVec
 NavDataCache::getOctreeLeafChildren(int64_t octreeNodeId)
 {
-  sqlite3_bind_int64(d->getOctreeLeafChildren, 1, octreeNodeId);
-
   TypedPositionedVec r;
+  if (d->hotSet.leafChildren(octreeNodeId, r)) {
+    return r;
+  }
+
+  if (d->snapshot && d->snapshot->leafChildren(octreeNodeId, r)) {
+    return r;
+  }
+
+  sqlite3_bind_int64(d->getOctreeLeafChildren, 1, octreeNodeId);
   while (d->stepSelect(d->getOctreeLeafChildren)) {
     FGPositioned::Type ty = static_cast<FGPositioned::Type>
       (sqlite3_column_int(d->getOctreeLeafChildren, 1));
@@ -2444,6 +3033,192 @@ NavDataCache::getOctreeLeafChildren(int64_t octreeNodeId)
   return r;
 }
 
+void NavDataCache::prefetchAround(const SGVec3d& cartPos)
+{
+  // nothing to gain with a snapshot, everything is in memory already
+  if (!d || rebuildInProgress || d->prefetchDisabled || d->snapshot) {
+    return;
+  }
+
+  d->takePrefetchedLeaves();
+  if (d->havePrefetchCentre && (dist(cartPos, d->prefetchCentre) < PREFETCH_RECENTRE_M)) {
+    return;
+  }
+
+  if (!fgGetBool("/sim/navdb/prefetch/enabled", true)) {
+    return;
+  }
+
+  if (!d->prefetcher) {
+    d->prefetcher.reset(new LeafPrefetchThread(d->path));
+    if (!d->prefetcher->isValid()) {
+      d->prefetcher.reset();
+      d->prefetchDisabled = true;
+      return;
+    }
+    d->prefetcher->start();
+  }
+
+  const double budgetMb = fgGetDouble("/sim/navdb/prefetch/budget-mb", DEFAULT_PREFETCH_BUDGET_MB);
+  d->hotSet.setBudget(static_cast<size_t>(std::max(1.0, budgetMb) * 1024 * 1024));
+
+  d->havePrefetchCentre = true;
+  d->prefetchCentre = cartPos;
+  const double rangeM = fgGetDouble("/sim/navdb/prefetch/range-nm", DEFAULT_PREFETCH_RANGE_NM) * SG_NM_TO_METER;
+
+  std::vector<Octree::Leaf*> leaves;
+  Octree::globalPersistentOctree()->findLeavesWithinRange(cartPos, rangeM, leaves);
+
+  // nearest first, so those are ready first
+  std::sort(leaves.begin(), leaves.end(), [&cartPos](Octree::Leaf* a, Octree::Leaf* b) {
+    return a->distToNearest(cartPos) < b->distToNearest(cartPos);
+  });
+
+  for (auto leaf : leaves) {
+    const int64_t id = leaf->guid();
+    if (d->hotSet.hasLeaf(id) || d->prefetchInFlight.count(id)) {
+      continue;
+    }
+
+    d->prefetchInFlight.insert(id);
+    d->prefetcher->request(id, d->prefetchGeneration);
+  }
+}
+
+size_t NavDataCache::pendingPrefetchLeaves()
+{
+  d->takePrefetchedLeaves();
+  return d->prefetcher ? d->prefetcher->pending() : 0;
+}
+
+size_t NavDataCache::prefetchedLeaves() const
+{
+  return d->hotSet.leafCount();
+}
+
+unsigned int NavDataCache::prefetchHits() const
+{
+  return d->prefetchHits;
+}
+
+PathList NavDataCache::NavDataCachePrivate::snapshotSources() const
+{
+  // the files a rebuild reads: the same files give the same records, with
+  // the same rowids
+  PathList result;
+  auto addGroup = [this, &result](NavDataCache::DatFileType type) {
+    auto it = datFilesInfo.find(type);
+    if (it != datFilesInfo.end()) {
+      for (const auto& loc : it->second.paths) {
+        result.push_back(loc.datPath);
+      }
+    }
+  };
+
+  addGroup(DATFILETYPE_APT);
+  addGroup(DATFILETYPE_NAV);
+  addGroup(DATFILETYPE_FIX);
+  for (const auto& path : {metarDatPath, carrierDatPath, poiDatPath, airwayDatPath}) {
+    if (path.exists()) {
+      result.push_back(path);
+    }
+  }
+  return result;
+}
+
+bool NavDataCache::writeSnapshot(const SGPath& path)
+{
+  if (rebuildInProgress) {
+    return false;
+  }
+
+  SGTimeStamp st;
+  st.stamp();
+
+  NavDataSnapshot::Writer writer(path, d->snapshotSources());
+  if (!writer.begin()) {
+    return false;
+  }
+
+  sqlite3_stmt_ptr stmt = d->prepare(RECORD_SELECT_SQL "ORDER BY positioned.rowid");
+  while (d->stepSelect(stmt)) {
+    PositionedRecord r;
+    readRecordRow(stmt, r);
+    writer.addRecord(r);
+  }
+  d->finalize(stmt);
+
+  stmt = d->prepare("SELECT rowid, children FROM octree ORDER BY rowid");
+  while (d->stepSelect(stmt)) {
+    writer.addOctreeNode(sqlite3_column_int64(stmt, 0), sqlite3_column_int(stmt, 1));
+  }
+  d->finalize(stmt);
+
+  stmt = d->prepare("SELECT octree_node, rowid, type FROM positioned "
+                    "WHERE octree_node IS NOT NULL ORDER BY octree_node, rowid");
+  while (d->stepSelect(stmt)) {
+    writer.addLeafMember(sqlite3_column_int64(stmt, 0), sqlite3_column_int64(stmt, 1),
+                         static_cast<FGPositioned::Type>(sqlite3_column_int(stmt, 2)));
+  }
+  d->finalize(stmt);
+
+  for (bool comm : {false, true}) {
+    sqlite3_stmt_ptr query = comm ? d->loadCommFrequencies : d->loadNavFrequencies;
+    while (d->stepSelect(query)) {
+      FrequencyTable::Station s;
+      s.freq = sqlite3_column_int(query, 0);
+      s.guid = sqlite3_column_int64(query, 1);
+      s.type = static_cast<FGPositioned::Type>(sqlite3_column_int(query, 2));
+      s.cart = SGVec3d(sqlite3_column_double(query, 3),
+                       sqlite3_column_double(query, 4),
+                       sqlite3_column_double(query, 5));
+      writer.addStation(comm, s);
+    }
+    d->reset(query);
+  }
+
+  stmt = d->prepare("SELECT DISTINCT network FROM airway_edge ORDER BY network");
+  std::vector<int> networks;
+  while (d->stepSelect(stmt)) {
+    networks.push_back(sqlite3_column_int(stmt, 0));
+  }
+  d->finalize(stmt);
+
+  for (int network : networks) {
+    for (const auto& e : airwayNetworkEdges(network)) {
+      writer.addAirwayEdge(network, e);
+    }
+  }
+
+  const bool ok = writer.finish();
+  SG_LOG(SG_NAVCACHE, SG_INFO, "NavCache: writing the snapshot took " << st.elapsedMSec() << "msec");
+  return ok;
+}
+
+bool NavDataCache::openSnapshot(const SGPath& path)
+{
+  if (rebuildInProgress) {
+    return false;
+  }
+
+  d->snapshot = NavDataSnapshot::open(path, d->snapshotSources());
+  if (!d->snapshot) {
+    return false;
+  }
+
+  // everything below comes from the snapshot from now on
+  d->clearHotSet();
+  d->prefetcher.reset();
+  d->navFrequencies.clear();
+  d->commFrequencies.clear();
+  return true;
+}
+
+bool NavDataCache::hasSnapshot() const
+{
+  return d->snapshot != nullptr;
+}
+
 
 /**
  * A special purpose helper (used by FGAirport::searchNamesAndIdents) to
@@ -2452,32 +3227,38 @@ NavDataCache::getOctreeLeafChildren(int64_t octreeNodeId)
  */
 char** NavDataCache::searchAirportNamesAndIdents(const std::string& searchInput)
 {
-  sqlite3_stmt_ptr stmt;
+  sqlite3_stmt_ptr stmt = nullptr;
+  // the search statement depends on the words, so it's prepared here
+  // and finalized at the end, instead of being kept
+  sqlite3_stmt_ptr searchStmt = nullptr;
   unsigned int numMatches = 0, numAllocated = 16;
   string heliport("HELIPORT");
   bool heli_p = searchInput.substr(0, heliport.length()) == heliport;
   auto pos = searchInput.find(":");
   string aFilter((pos != string::npos) ? searchInput.substr(pos+1) : searchInput);
-  string searchTerm("%" + aFilter + "%");
 
   if (aFilter.empty() && !heli_p) {
     stmt = d->getAllAirports;
     numAllocated = 4096; // start much larger for all airports
   } else {
-    stmt = d->searchAirports;
-    sqlite_bind_stdstring(stmt, 1, searchTerm);
-    if (heli_p) {
-        sqlite3_bind_int(stmt, 2, FGPositioned::HELIPORT);
-        sqlite3_bind_int(stmt, 3, FGPositioned::HELIPORT);
+    const string types = heli_p ?
+        "type=" + std::to_string(FGPositioned::HELIPORT) :
+        "(type >= " + std::to_string(FGPositioned::AIRPORT) +
+        " AND type <= " + std::to_string(FGPositioned::SEAPORT) + ")";
+    string sql = nameSearchSQL("ident, name", aFilter, types, NAME_SEARCH_LIMIT);
+    if (sql.empty() && aFilter.empty()) {
+        // all heliports
+        sql = "SELECT ident, name FROM positioned WHERE " + types;
     }
-    else {
-        sqlite3_bind_int(stmt, 2, FGPositioned::AIRPORT);
-        sqlite3_bind_int(stmt, 3, FGPositioned::SEAPORT);
+
+    if (!sql.empty() &&
+        (sqlite3_prepare_v2(d->db, sql.c_str(), sql.length(), &searchStmt, nullptr) == SQLITE_OK)) {
+        stmt = searchStmt;
     }
   }
 
   char** result = (char**) malloc(sizeof(char*) * numAllocated);
-  while (d->stepSelect(stmt)) {
+  while (stmt && d->stepSelect(stmt)) {
     if ((numMatches + 1) >= numAllocated) {
       numAllocated <<= 1; // double in size!
     // reallocate results array
@@ -2515,7 +3296,11 @@ char** NavDataCache::searchAirportNamesAndIdents(const std::string& searchInput)
   }
 
   result[numMatches] = NULL; // end of list marker
-  d->reset(stmt);
+  if (searchStmt) {
+    sqlite3_finalize(searchStmt);
+  } else if (stmt) {
+    d->reset(stmt);
+  }
   return result;
 }
 
@@ -2533,73 +3318,63 @@ NavDataCache::findCommByFreq(int freqKhz, const SGGeod& aPos, FGPositioned::Filt
 PositionedIDVec
 NavDataCache::findCommsByFreq(int freqKhz, const SGGeod& aPos, FGPositioned::Filter* aFilter)
 {
-    PositionedIDVec matches;
-
-    sqlite3_bind_int(d->findCommByFreq, 1, freqKhz);
+    const FrequencyTable& table = d->frequencyTable(d->commFrequencies, d->loadCommFrequencies);
+    PositionedIDVec candidates;
     if (aFilter) {
-        sqlite3_bind_int(d->findCommByFreq, 2, aFilter->minType());
-        sqlite3_bind_int(d->findCommByFreq, 3, aFilter->maxType());
+        candidates = table.findByFreq(freqKhz, aFilter->minType(), aFilter->maxType(),
+                                      SGVec3d::fromGeod(aPos));
     } else { // full type range
-        sqlite3_bind_int(d->findCommByFreq, 2, FGPositioned::FREQ_GROUND);
-        sqlite3_bind_int(d->findCommByFreq, 3, FGPositioned::FREQ_UNICOM);
+        candidates = table.findByFreq(freqKhz, FGPositioned::FREQ_GROUND, FGPositioned::FREQ_UNICOM,
+                                      SGVec3d::fromGeod(aPos));
     }
 
-    SGVec3d cartPos(SGVec3d::fromGeod(aPos));
-    sqlite3_bind_double(d->findCommByFreq, 4, cartPos.x());
-    sqlite3_bind_double(d->findCommByFreq, 5, cartPos.y());
-    sqlite3_bind_double(d->findCommByFreq, 6, cartPos.z());
-    FGPositionedRef result;
+    if (!aFilter) {
+        return candidates;
+    }
 
-    while (d->execSelect(d->findCommByFreq)) {
-        const auto id = sqlite3_column_int64(d->findCommByFreq, 0);
-        if (aFilter) {
-            FGPositionedRef p = loadById(id);
-            if (aFilter && !aFilter->pass(p)) {
-                continue;
-            }
+    PositionedIDVec matches;
+    for (auto id : candidates) {
+        FGPositionedRef p = loadById(id);
+        if (aFilter->pass(p)) {
+            matches.push_back(id);
         }
-
-
-        matches.push_back(id);
     }
-
-    d->reset(d->findCommByFreq);
     return matches;
 }
 
+void NavDataCache::updateFrequencyPosition(PositionedID item, FGPositioned::Type ty,
+                                           const SGVec3d& cart)
+{
+  if ((ty >= FGPositioned::NDB) && (ty <= FGPositioned::MOBILE_TACAN)) {
+    d->navFrequencies.updatePosition(item, cart);
+  } else if ((ty >= FGPositioned::FREQ_GROUND) && (ty <= FGPositioned::FREQ_UNICOM)) {
+    d->commFrequencies.updatePosition(item, cart);
+  }
+}
+
 PositionedIDVec
 NavDataCache::findNavaidsByFreq(int freqKhz, const SGGeod& aPos, FGPositioned::Filter* aFilter)
 {
-  sqlite3_bind_int(d->findNavsByFreq, 1, freqKhz);
+  const FrequencyTable& table = d->frequencyTable(d->navFrequencies, d->loadNavFrequencies);
   if (aFilter) {
-    sqlite3_bind_int(d->findNavsByFreq, 2, aFilter->minType());
-    sqlite3_bind_int(d->findNavsByFreq, 3, aFilter->maxType());
-  } else { // full type range
-    sqlite3_bind_int(d->findNavsByFreq, 2, FGPositioned::NDB);
-    sqlite3_bind_int(d->findNavsByFreq, 3, FGPositioned::GS);
+    return table.findByFreq(freqKhz, aFilter->minType(), aFilter->maxType(),
+                            SGVec3d::fromGeod(aPos));
   }
 
-  SGVec3d cartPos(SGVec3d::fromGeod(aPos));
-  sqlite3_bind_double(d->findNavsByFreq, 4, cartPos.x());
-  sqlite3_bind_double(d->findNavsByFreq, 5, cartPos.y());
-  sqlite3_bind_double(d->findNavsByFreq, 6, cartPos.z());
-
-  return d->selectIds(d->findNavsByFreq);
+  // full type range
+  return table.findByFreq(freqKhz, FGPositioned::NDB, FGPositioned::GS, SGVec3d::fromGeod(aPos));
 }
 
 PositionedIDVec
 NavDataCache::findNavaidsByFreq(int freqKhz, FGPositioned::Filter* aFilter)
 {
-  sqlite3_bind_int(d->findNavsByFreqNoPos, 1, freqKhz);
+  const FrequencyTable& table = d->frequencyTable(d->navFrequencies, d->loadNavFrequencies);
   if (aFilter) {
-    sqlite3_bind_int(d->findNavsByFreqNoPos, 2, aFilter->minType());
-    sqlite3_bind_int(d->findNavsByFreqNoPos, 3, aFilter->maxType());
-  } else { // full type range
-    sqlite3_bind_int(d->findNavsByFreqNoPos, 2, FGPositioned::NDB);
-    sqlite3_bind_int(d->findNavsByFreqNoPos, 3, FGPositioned::GS);
+    return table.findByFreq(freqKhz, aFilter->minType(), aFilter->maxType());
   }
 
-  return d->selectIds(d->findNavsByFreqNoPos);
+  // full type range
+  return table.findByFreq(freqKhz, FGPositioned::NDB, FGPositioned::GS);
 }
 
 PositionedIDVec
@@ -2771,6 +3546,38 @@ AirwayEdgeVec NavDataCache::airwayEdgesFrom(int network, PositionedID pos)
   return result;
 }
 
+AirwayNetworkEdgeVec NavDataCache::airwayNetworkEdges(int network)
+{
+    if (d->snapshot) {
+        return d->snapshot->airwayNetworkEdges(network);
+    }
+
+    sqlite3_bind_int(d->airwayNetworkEdges, 1, network);
+
+    AirwayNetworkEdgeVec result;
+    while (d->stepSelect(d->airwayNetworkEdges)) {
+        AirwayNetworkEdge e;
+        e.airway = sqlite3_column_int(d->airwayNetworkEdges, 0);
+        e.from = sqlite3_column_int64(d->airwayNetworkEdges, 1);
+        e.to = sqlite3_column_int64(d->airwayNetworkEdges, 2);
+        // nodes created as temporary waypoints only exist in temp_positioned
+        e.haveCarts = (sqlite3_column_type(d->airwayNetworkEdges, 3) != SQLITE_NULL) &&
+                      (sqlite3_column_type(d->airwayNetworkEdges, 6) != SQLITE_NULL);
+        if (e.haveCarts) {
+            e.fromCart = SGVec3d(sqlite3_column_double(d->airwayNetworkEdges, 3),
+                                 sqlite3_column_double(d->airwayNetworkEdges, 4),
+                                 sqlite3_column_double(d->airwayNetworkEdges, 5));
+            e.toCart = SGVec3d(sqlite3_column_double(d->airwayNetworkEdges, 6),
+                               sqlite3_column_double(d->airwayNetworkEdges, 7),
+                               sqlite3_column_double(d->airwayNetworkEdges, 8));
+        }
+        result.push_back(e);
+    }
+
+    d->reset(d->airwayNetworkEdges);
+    return result;
+}
+
 AirwayRef NavDataCache::loadAirway(int airwayID)
 {
     sqlite3_bind_int(d->loadAirway, 1, airwayID);
@@ -2976,7 +3783,7 @@ public:
 
     virtual void run()
     {
-        while (!quit) {
+        while (query && !quit) {
             int err = sqlite3_step(query);
             if (err == SQLITE_DONE) {
                 break;
@@ -3013,18 +3820,22 @@ NavDataCache::ThreadedGUISearch::ThreadedGUISearch(const std::string& term, bool
     std::string pathUtf8 = p.utf8Str();
     sqlite3_open_v2(pathUtf8.c_str(), &d->db, openFlags, NULL);
 
-    std::string sql;
+    std::string types;
     if (onlyAirports) {
-        sql = "SELECT rowid FROM positioned WHERE name LIKE '%" + term
-                + "%' AND (type >= 1 AND type <= 3)";
+        types = "(type >= 1 AND type <= 3)";
     } else {
         // types are hard-coded here becuase this is only used by NavaidSearchModel
         // in ther launcher. We would ideally use a TypeFilter but that would
         // mean loading each positioned to filter them, which is inefficient.
-        sql = "SELECT rowid FROM positioned WHERE name LIKE '%" + term
-                + "%' AND ((type >= 1 AND type <= 3) OR ((type >= 9 AND type <= 11)) OR (type=18 AND name LIKE '% TACAN') ) ";
+        types = "((type >= 1 AND type <= 3) OR ((type >= 9 AND type <= 11)) OR (type=18 AND name LIKE '% TACAN') ) ";
+    }
+
+    const std::string sql = nameSearchSQL("rowid", term, types, NAME_SEARCH_LIMIT);
+    if (sql.empty() ||
+        (sqlite3_prepare_v2(d->db, sql.c_str(), sql.length(), &d->query, NULL) != SQLITE_OK)) {
+        // nothing to search for, run() completes immediately
+        d->query = nullptr;
     }
-    sqlite3_prepare_v2(d->db, sql.c_str(), sql.length(), &d->query, NULL);
 
     d->start();
 }
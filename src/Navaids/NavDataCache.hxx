@@ -32,6 +32,17 @@ typedef std::vector<TypedPositioned> TypedPositionedVec;
 typedef std::pair<int, PositionedID> AirwayEdge;
 typedef std::vector<AirwayEdge> AirwayEdgeVec;
 
+/// an edge of an airway network, with the positions of both ends
+struct AirwayNetworkEdge {
+    int airway;
+    PositionedID from;
+    PositionedID to;
+    bool haveCarts;         ///< false if an end isn't in the positioned table
+    SGVec3d fromCart;
+    SGVec3d toCart;
+};
+typedef std::vector<AirwayNetworkEdge> AirwayNetworkEdgeVec;
+
 namespace Octree {
 class Node;
 class Branch;
@@ -190,11 +201,30 @@ public:
     /// update the metar flag associated with an airport
     void setAirportMetar(const std::string& icao, bool hasMetar);
 
+    /**
+     * The pavements, boundaries and line features of an airport, parsed on
+     * first use (see FGAirport::getPavements()): for a plain apt.dat file
+     * where the definition of the airport starts, for a compressed one the
+     * rows themselves, deflated, starting at lineNum.
+     */
+    void setAirportDetail(PositionedID airport, const SGPath& aptDat,
+                          int64_t offset, unsigned int lineNum,
+                          const std::string& rows = {});
+    bool airportDetail(PositionedID airport, SGPath& aptDat,
+                       int64_t& offset, unsigned int& lineNum, std::string& rows);
+
     /**
    * Modify the position of an existing item.
    */
     void updatePosition(PositionedID item, const SGGeod& pos);
 
+    /**
+     * Keep the by-frequency lookups in sync with a station which moves
+     * without updatePosition(): a mobile navaid follows its carrier or
+     * tanker in memory only, on every access to its position.
+     */
+    void updateFrequencyPosition(PositionedID item, FGPositioned::Type ty, const SGVec3d& cart);
+
     FGPositionedList findAllWithIdent(const std::string& ident,
                                       FGPositioned::Filter* filter,
                                       bool exact);
@@ -202,6 +232,19 @@ public:
                                      FGPositioned::Filter* filter,
                                      bool exact);
 
+    /**
+     * Ranked search by name words and ident prefix, using the name index
+     * built with the cache: every word of the term has to be the start of
+     * a word of the name, a single word may also be the start of the
+     * ident. Exact and prefix ident matches are returned first. Only
+     * airports, fixes, VORs, NDBs, DMEs and TACANs are indexed by name.
+     *
+     * @param limit - the maximum number of results, 0 for the default
+     */
+    FGPositionedList searchNames(const std::string& term,
+                                 FGPositioned::Filter* filter,
+                                 size_t limit = 0);
+
     FGPositionedRef findClosestWithIdent(const std::string& aIdent,
                                          const SGGeod& aPos,
                                          FGPositioned::Filter* aFilter);
@@ -209,8 +252,8 @@ public:
 
     /**
    * Helper to implement the AirportSearch widget. Optimised text search of
-   * airport names and idents, returning a list suitable for passing directly
-   * to PLIB.
+   * airport names and idents (see searchNames), returning a list suitable
+   * for passing directly to PLIB.
    */
     char** searchAirportNamesAndIdents(const std::string& aFilter);
 
@@ -281,6 +324,47 @@ public:
    */
     TypedPositionedVec getOctreeLeafChildren(int64_t octreeNodeId);
 
+    /**
+     * Called by the spatial searches with their position. Queues the
+     * octree leaves within /sim/navdb/prefetch/range-nm of it for loading
+     * on a background thread, and takes in the leaves which have been
+     * loaded since the last call. Members of loaded leaves, and the items
+     * of their airports, are then created from memory by loadById and
+     * getOctreeLeafChildren.
+     */
+    void prefetchAround(const SGVec3d& cartPos);
+
+    /**
+     * number of leaves queued or being loaded by the prefetcher, after
+     * taking in those which are done
+     */
+    size_t pendingPrefetchLeaves();
+
+    /// number of leaves held in memory by the prefetcher
+    size_t prefetchedLeaves() const;
+
+    /// number of items loadById created from prefetched leaves
+    unsigned int prefetchHits() const;
+
+    /**
+     * Export the positioned records, octree, frequency tables and airway
+     * edges to a NavDataSnapshot file, for use by installations with the
+     * same navdata.
+     */
+    bool writeSnapshot(const SGPath& path);
+
+    /**
+     * Answer loadById, searches by ident, the octree, frequency and airway
+     * network queries from a snapshot written from the same dat files;
+     * searches by name and temporary items still use the database. The
+     * snapshot is checked against the dat files, not the database. Returns
+     * false, and keeps using the database, if the snapshot is missing or
+     * doesn't match.
+     */
+    bool openSnapshot(const SGPath& path);
+
+    bool hasSnapshot() const;
+
     // airways
     int findAirway(int network, const std::string& aName, bool create);
 
@@ -303,6 +387,13 @@ public:
    */
     AirwayEdgeVec airwayEdgesFrom(int network, PositionedID pos);
 
+    /**
+     * retrieve every edge of a network in one go, for building the
+     * in-memory routing graph. Edges are returned once, in the direction
+     * they were inserted.
+     */
+    AirwayNetworkEdgeVec airwayNetworkEdges(int network);
+
     AirwayRef loadAirway(int airwayID);
 
     /**
@@ -351,8 +442,11 @@ private:
 
     // A generic function for loading all navigation data files of the
     // specified type (apt/fix/nav etc.) using the passed type-specific loader.
+    // If the loader only queues the files, 'finish' waits for them before the
+    // phase is over.
     void loadDatFiles(DatFileType type,
-                      std::function<void(const SceneryLocation&, std::size_t, std::size_t)> loader);
+                      std::function<void(const SceneryLocation&, std::size_t, std::size_t)> loader,
+                      std::function<void()> finish = {});
 
     void doRebuild();
 
@@ -0,0 +1,657 @@
+/*
+ * SPDX-FileName: NavDataSnapshot.cxx
+ * SPDX-FileComment: memory mapped, read-only snapshot of the navdata cache
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#include "NavDataSnapshot.hxx"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+#include <simgear/debug/logstream.hxx>
+#include <simgear/io/iostreams/sgstream.hxx>
+#include <simgear/io/sg_file.hxx>
+#include <simgear/io/sg_mmap.hxx>
+
+#include "BinaryCacheFile.hxx"
+#include "CacheSchema.h"
+
+namespace {
+
+const char SNAPSHOT_MAGIC[8] = {'F', 'G', 'N', 'A', 'V', 'S', 'N', 'P'};
+const uint32_t SNAPSHOT_VERSION = 2;
+
+// All sections start on an 8-byte boundary and all records are a multiple
+// of 8 bytes, so the arrays can be used in place from the mapped file.
+struct SnapshotHeader
+{
+    flightgear::BinaryCacheHeader common;
+    uint32_t schemaVersion;     ///< of the cache the records were read from
+    uint32_t padding;
+    uint64_t numSources;
+    uint64_t numRecords;
+    uint64_t numNodes;
+    uint64_t numLeaves;
+    uint64_t numMembers;
+    uint64_t numNavStations;
+    uint64_t numCommStations;
+    uint64_t numAirwayEdges;
+    uint64_t numIdents;
+    uint64_t sourcesPos;        ///< in the order of the source list
+    uint64_t recordsPos;        ///< sorted by guid
+    uint64_t nodesPos;          ///< sorted by id
+    uint64_t leavesPos;         ///< sorted by id
+    uint64_t membersPos;
+    uint64_t navStationsPos;
+    uint64_t commStationsPos;
+    uint64_t airwayEdgesPos;
+    uint64_t identsPos;         ///< sorted by folded ident, then type
+    uint64_t stringDataPos;
+    uint64_t fileSize;
+};
+
+// the dat files the cache was built from, identified by their contents
+// so the snapshot can be checked without opening the cache
+struct SourceData
+{
+    uint64_t path, sha;         ///< offsets into the string data
+    int64_t size;
+    int64_t modTime;
+    uint32_t pathLen, shaLen;
+};
+
+struct RecordData
+{
+    int64_t guid;
+    int64_t airport;
+    int64_t octreeNode;
+    double lon, lat, elev;
+    uint64_t ident, name, sceneryPath; ///< offsets into the string data
+    double heading, length, width, displacedThreshold, stopway, multiuse;
+    int64_t reciprocal, ils, runway, colocated;
+    uint32_t identLen, nameLen, sceneryPathLen;
+    int32_t type;
+    int32_t surface, freq, rangeNm, hasMetar;
+};
+
+struct NodeData
+{
+    int64_t id;
+    int32_t children;
+    int32_t padding;
+};
+
+struct LeafData
+{
+    int64_t id;
+    uint64_t first;             ///< index into the members
+    uint64_t count;
+};
+
+struct MemberData
+{
+    int64_t guid;
+    int32_t type;
+    int32_t padding;
+};
+
+struct StationData
+{
+    int64_t guid;
+    double x, y, z;
+    int32_t freq;
+    int32_t type;
+};
+
+struct EdgeData
+{
+    int64_t from, to;
+    double fromCart[3];
+    double toCart[3];
+    int32_t network, airway, haveCarts, padding;
+};
+
+struct IdentData
+{
+    int64_t guid;
+    uint64_t ident;             ///< offset of the upper-cased ident
+    uint32_t identLen;
+    int32_t type;
+};
+
+// idents are compared without case, like the ident column of the cache
+std::string foldIdent(const std::string& ident)
+{
+    std::string result(ident);
+    std::transform(result.begin(), result.end(), result.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    return result;
+}
+
+bool sourceMatches(const SGPath& source, const std::string& path, const std::string& sha,
+                   int64_t size, int64_t modTime)
+{
+    if (!source.exists() || (static_cast<int64_t>(source.sizeInBytes()) != size)) {
+        return false;
+    }
+
+    // an unchanged file is trusted by its modification time, like the
+    // stat cache does; anything else has to have the same contents
+    if ((source.realpath().utf8Str() == path) && (static_cast<int64_t>(source.modTime()) == modTime)) {
+        return true;
+    }
+
+    SGFile f(source);
+    return f.computeHash() == sha;
+}
+
+} // of anonymous namespace
+
+namespace flightgear {
+
+class NavDataSnapshot::NavDataSnapshotPrivate
+{
+public:
+    std::string str(uint64_t offset, uint32_t len) const
+    {
+        if ((offset > stringDataLength) || (len > stringDataLength - offset)) {
+            return {};
+        }
+        return std::string(stringData + offset, len);
+    }
+
+    bool sourcesMatch(const PathList& expected) const
+    {
+        if (header->numSources != expected.size()) {
+            return false;
+        }
+
+        for (uint64_t i = 0; i < header->numSources; ++i) {
+            const SourceData& sd = sources[i];
+            if (!sourceMatches(expected[i], str(sd.path, sd.pathLen), str(sd.sha, sd.shaLen),
+                               sd.size, sd.modTime)) {
+                SG_LOG(SG_NAVCACHE, SG_INFO, "NavCache: snapshot source " << expected[i] << " differs");
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::unique_ptr<SGMMapFile> file;
+    const SnapshotHeader* header = nullptr;
+    const SourceData* sources = nullptr;
+    const RecordData* records = nullptr;
+    const NodeData* nodes = nullptr;
+    const LeafData* leaves = nullptr;
+    const MemberData* members = nullptr;
+    const StationData* navStations = nullptr;
+    const StationData* commStations = nullptr;
+    const EdgeData* airwayEdges = nullptr;
+    const IdentData* idents = nullptr;
+    const char* stringData = nullptr;
+    uint64_t stringDataLength = 0;
+};
+
+NavDataSnapshot::NavDataSnapshot() : d(new NavDataSnapshotPrivate)
+{
+}
+
+NavDataSnapshot::~NavDataSnapshot() = default;
+
+std::unique_ptr<NavDataSnapshot> NavDataSnapshot::open(const SGPath& path, const PathList& sources)
+{
+    if (!path.exists()) {
+        return {};
+    }
+
+    std::unique_ptr<SGMMapFile> file(new SGMMapFile(path));
+    if (!file->open(SG_IO_IN)) {
+        return {};
+    }
+
+    const char* base = file->get();
+    const uint64_t length = file->get_size();
+    if (!base || (length < sizeof(SnapshotHeader))) {
+        return {};
+    }
+
+    const SnapshotHeader* header = reinterpret_cast<const SnapshotHeader*>(base);
+    if (!header->common.matches(SNAPSHOT_MAGIC, SNAPSHOT_VERSION) ||
+        (header->schemaVersion != static_cast<uint32_t>(SCHEMA_VERSION)) ||
+        (header->fileSize != length))
+    {
+        SG_LOG(SG_NAVCACHE, SG_WARN, "NavCache: ignoring incompatible snapshot " << path);
+        return {};
+    }
+
+    // validate section bounds before touching any record
+    if (!binaryCacheSectionFits(length, header->sourcesPos, header->numSources, sizeof(SourceData)) ||
+        !binaryCacheSectionFits(length, header->recordsPos, header->numRecords, sizeof(RecordData)) ||
+        !binaryCacheSectionFits(length, header->nodesPos, header->numNodes, sizeof(NodeData)) ||
+        !binaryCacheSectionFits(length, header->leavesPos, header->numLeaves, sizeof(LeafData)) ||
+        !binaryCacheSectionFits(length, header->membersPos, header->numMembers, sizeof(MemberData)) ||
+        !binaryCacheSectionFits(length, header->navStationsPos, header->numNavStations, sizeof(StationData)) ||
+        !binaryCacheSectionFits(length, header->commStationsPos, header->numCommStations, sizeof(StationData)) ||
+        !binaryCacheSectionFits(length, header->airwayEdgesPos, header->numAirwayEdges, sizeof(EdgeData)) ||
+        !binaryCacheSectionFits(length, header->identsPos, header->numIdents, sizeof(IdentData)) ||
+        (header->stringDataPos > length))
+    {
+        SG_LOG(SG_NAVCACHE, SG_WARN, "NavCache: damaged snapshot " << path);
+        return {};
+    }
+
+    std::unique_ptr<NavDataSnapshot> snapshot(new NavDataSnapshot);
+    NavDataSnapshotPrivate* p = snapshot->d.get();
+    p->header = header;
+    p->sources = reinterpret_cast<const SourceData*>(base + header->sourcesPos);
+    p->records = reinterpret_cast<const RecordData*>(base + header->recordsPos);
+    p->nodes = reinterpret_cast<const NodeData*>(base + header->nodesPos);
+    p->leaves = reinterpret_cast<const LeafData*>(base + header->leavesPos);
+    p->members = reinterpret_cast<const MemberData*>(base + header->membersPos);
+    p->navStations = reinterpret_cast<const StationData*>(base + header->navStationsPos);
+    p->commStations = reinterpret_cast<const StationData*>(base + header->commStationsPos);
+    p->airwayEdges = reinterpret_cast<const EdgeData*>(base + header->airwayEdgesPos);
+    p->idents = reinterpret_cast<const IdentData*>(base + header->identsPos);
+    p->stringData = base + header->stringDataPos;
+    p->stringDataLength = length - header->stringDataPos;
+
+    if (!p->sourcesMatch(sources)) {
+        SG_LOG(SG_NAVCACHE, SG_WARN, "NavCache: snapshot " << path << " was written from different navdata");
+        return {};
+    }
+
+    p->file = std::move(file);
+
+    SG_LOG(SG_NAVCACHE, SG_INFO, "NavCache: using snapshot " << path << " with "
+           << header->numRecords << " records");
+    return snapshot;
+}
+
+bool NavDataSnapshot::findRecord(PositionedID guid, PositionedRecord& r) const
+{
+    const RecordData* end = d->records + d->header->numRecords;
+    const RecordData* it = std::lower_bound(d->records, end, guid,
+                                            [](const RecordData& rd, PositionedID g) { return rd.guid < g; });
+    if ((it == end) || (it->guid != guid)) {
+        return false;
+    }
+
+    r.guid = it->guid;
+    r.type = static_cast<FGPositioned::Type>(it->type);
+    r.ident = d->str(it->ident, it->identLen);
+    r.name = d->str(it->name, it->nameLen);
+    r.airport = it->airport;
+    r.pos = SGGeod::fromDegM(it->lon, it->lat, it->elev);
+    r.octreeNode = it->octreeNode;
+    r.sceneryPath = d->str(it->sceneryPath, it->sceneryPathLen);
+    r.hasMetar = (it->hasMetar != 0);
+    r.heading = it->heading;
+    r.length = it->length;
+    r.width = it->width;
+    r.displacedThreshold = it->displacedThreshold;
+    r.stopway = it->stopway;
+    r.surface = it->surface;
+    r.reciprocal = it->reciprocal;
+    r.ils = it->ils;
+    r.freq = it->freq;
+    r.rangeNm = it->rangeNm;
+    r.multiuse = it->multiuse;
+    r.runway = it->runway;
+    r.colocated = it->colocated;
+    return true;
+}
+
+bool NavDataSnapshot::leafChildren(int64_t leafId, TypedPositionedVec& children) const
+{
+    const LeafData* end = d->leaves + d->header->numLeaves;
+    const LeafData* it = std::lower_bound(d->leaves, end, leafId,
+                                          [](const LeafData& l, int64_t id) { return l.id < id; });
+    if ((it == end) || (it->id != leafId) || (it->first > d->header->numMembers) ||
+        (it->count > d->header->numMembers - it->first)) {
+        return false;
+    }
+
+    for (uint64_t i = it->first; i < it->first + it->count; ++i) {
+        const MemberData& m = d->members[i];
+        children.push_back(TypedPositioned(static_cast<FGPositioned::Type>(m.type), m.guid));
+    }
+    return true;
+}
+
+int NavDataSnapshot::branchChildren(int64_t nodeId) const
+{
+    const NodeData* end = d->nodes + d->header->numNodes;
+    const NodeData* it = std::lower_bound(d->nodes, end, nodeId,
+                                          [](const NodeData& n, int64_t id) { return n.id < id; });
+    if ((it == end) || (it->id != nodeId)) {
+        return -1;
+    }
+    return it->children;
+}
+
+void NavDataSnapshot::fillFrequencyTable(bool comm, FrequencyTable& table) const
+{
+    const StationData* stations = comm ? d->commStations : d->navStations;
+    const uint64_t count = comm ? d->header->numCommStations : d->header->numNavStations;
+    for (uint64_t i = 0; i < count; ++i) {
+        FrequencyTable::Station s;
+        s.freq = stations[i].freq;
+        s.guid = stations[i].guid;
+        s.type = static_cast<FGPositioned::Type>(stations[i].type);
+        s.cart = SGVec3d(stations[i].x, stations[i].y, stations[i].z);
+        table.add(s);
+    }
+    table.finish();
+}
+
+AirwayNetworkEdgeVec NavDataSnapshot::airwayNetworkEdges(int network) const
+{
+    AirwayNetworkEdgeVec result;
+    for (uint64_t i = 0; i < d->header->numAirwayEdges; ++i) {
+        const EdgeData& ed = d->airwayEdges[i];
+        if (ed.network != network) {
+            continue;
+        }
+
+        AirwayNetworkEdge e;
+        e.airway = ed.airway;
+        e.from = ed.from;
+        e.to = ed.to;
+        e.haveCarts = (ed.haveCarts != 0);
+        e.fromCart = SGVec3d(ed.fromCart[0], ed.fromCart[1], ed.fromCart[2]);
+        e.toCart = SGVec3d(ed.toCart[0], ed.toCart[1], ed.toCart[2]);
+        result.push_back(e);
+    }
+    return result;
+}
+
+PositionedIDVec NavDataSnapshot::findByIdent(const std::string& ident, bool exact,
+                                             int minType, int maxType) const
+{
+    const std::string key = foldIdent(ident);
+    const IdentData* end = d->idents + d->header->numIdents;
+    const IdentData* it = std::lower_bound(d->idents, end, key,
+                                           [this](const IdentData& id, const std::string& k) {
+                                               return d->str(id.ident, id.identLen) < k;
+                                           });
+
+    PositionedIDVec result;
+    for (; it != end; ++it) {
+        const std::string candidate = d->str(it->ident, it->identLen);
+        const bool matches = exact ? (candidate == key) : (candidate.compare(0, key.size(), key) == 0);
+        if (!matches) {
+            break;
+        }
+
+        if ((it->type >= minType) && (it->type <= maxType)) {
+            result.push_back(it->guid);
+        }
+    }
+    return result;
+}
+
+size_t NavDataSnapshot::recordCount() const
+{
+    return static_cast<size_t>(d->header->numRecords);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+class NavDataSnapshot::Writer::WriterPrivate
+{
+public:
+    uint64_t addString(const std::string& s, uint32_t& len)
+    {
+        len = static_cast<uint32_t>(s.size());
+        const uint64_t offset = stringData.size();
+        stringData.append(s);
+        return offset;
+    }
+
+    SGPath path;
+    PathList sources;
+    std::unique_ptr<BinaryCacheWriter> out;
+    uint64_t numRecords = 0;
+    PositionedID lastGuid = 0;
+    bool ordered = true;
+
+    std::vector<NodeData> nodes;
+    std::vector<LeafData> leaves;
+    std::vector<MemberData> members;
+    std::vector<StationData> navStations, commStations;
+    std::vector<EdgeData> airwayEdges;
+    std::vector<IdentData> idents;
+    std::string stringData;
+};
+
+NavDataSnapshot::Writer::Writer(const SGPath& path, const PathList& sources) : d(new WriterPrivate)
+{
+    d->path = path;
+    d->sources = sources;
+}
+
+NavDataSnapshot::Writer::~Writer() = default;
+
+bool NavDataSnapshot::Writer::begin()
+{
+    d->out.reset(new BinaryCacheWriter(d->path));
+    if (!d->out->isOpen()) {
+        d->out.reset();
+        return false;
+    }
+
+    // the header is written again once the sections are known
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    d->out->write(&header, sizeof(header));
+    d->out->padTo(binaryCacheAlign(sizeof(header)));
+    return true;
+}
+
+void NavDataSnapshot::Writer::addRecord(const PositionedRecord& r)
+{
+    if (!d->out) {
+        return;
+    }
+
+    if (d->numRecords && (r.guid <= d->lastGuid)) {
+        d->ordered = false;
+    }
+    d->lastGuid = r.guid;
+
+    RecordData rd;
+    memset(&rd, 0, sizeof(rd));
+    rd.guid = r.guid;
+    rd.airport = r.airport;
+    rd.octreeNode = r.octreeNode;
+    rd.lon = r.pos.getLongitudeDeg();
+    rd.lat = r.pos.getLatitudeDeg();
+    rd.elev = r.pos.getElevationM();
+    rd.ident = d->addString(r.ident, rd.identLen);
+    rd.name = d->addString(r.name, rd.nameLen);
+    rd.sceneryPath = d->addString(r.sceneryPath, rd.sceneryPathLen);
+    rd.heading = r.heading;
+    rd.length = r.length;
+    rd.width = r.width;
+    rd.displacedThreshold = r.displacedThreshold;
+    rd.stopway = r.stopway;
+    rd.multiuse = r.multiuse;
+    rd.reciprocal = r.reciprocal;
+    rd.ils = r.ils;
+    rd.runway = r.runway;
+    rd.colocated = r.colocated;
+    rd.type = r.type;
+    rd.surface = r.surface;
+    rd.freq = r.freq;
+    rd.rangeNm = r.rangeNm;
+    rd.hasMetar = r.hasMetar ? 1 : 0;
+
+    // most idents are upper case already and can share the string
+    IdentData id{r.guid, rd.ident, rd.identLen, rd.type};
+    const std::string folded = foldIdent(r.ident);
+    if (folded != r.ident) {
+        id.ident = d->addString(folded, id.identLen);
+    }
+    d->idents.push_back(id);
+
+    d->out->write(&rd, sizeof(rd));
+    ++d->numRecords;
+}
+
+void NavDataSnapshot::Writer::addOctreeNode(int64_t nodeId, int children)
+{
+    d->nodes.push_back(NodeData{nodeId, children, 0});
+}
+
+void NavDataSnapshot::Writer::addLeafMember(int64_t leafId, PositionedID guid, FGPositioned::Type ty)
+{
+    if (d->leaves.empty() || (d->leaves.back().id != leafId)) {
+        d->leaves.push_back(LeafData{leafId, static_cast<uint64_t>(d->members.size()), 0});
+    }
+
+    ++d->leaves.back().count;
+    d->members.push_back(MemberData{guid, static_cast<int32_t>(ty), 0});
+}
+
+void NavDataSnapshot::Writer::addStation(bool comm, const FrequencyTable::Station& s)
+{
+    StationData sd{s.guid, s.cart.x(), s.cart.y(), s.cart.z(), s.freq, static_cast<int32_t>(s.type)};
+    (comm ? d->commStations : d->navStations).push_back(sd);
+}
+
+void NavDataSnapshot::Writer::addAirwayEdge(int network, const AirwayNetworkEdge& e)
+{
+    EdgeData ed;
+    memset(&ed, 0, sizeof(ed));
+    ed.from = e.from;
+    ed.to = e.to;
+    for (int i = 0; i < 3; ++i) {
+        ed.fromCart[i] = e.fromCart[i];
+        ed.toCart[i] = e.toCart[i];
+    }
+    ed.network = network;
+    ed.airway = e.airway;
+    ed.haveCarts = e.haveCarts ? 1 : 0;
+    d->airwayEdges.push_back(ed);
+}
+
+bool NavDataSnapshot::Writer::finish()
+{
+    if (!d->out) {
+        return false;
+    }
+
+    auto lookupsSorted = [this]() {
+        auto byId = [](const auto& a, const auto& b) { return a.id < b.id; };
+        return std::is_sorted(d->nodes.begin(), d->nodes.end(), byId) &&
+               std::is_sorted(d->leaves.begin(), d->leaves.end(), byId);
+    };
+
+    if (!d->ordered || !lookupsSorted()) {
+        SG_LOG(SG_NAVCACHE, SG_WARN, "NavCache: snapshot data not in lookup order, not writing " << d->path);
+        d->out.reset();
+        return false;
+    }
+
+    std::vector<SourceData> sources;
+    for (const auto& source : d->sources) {
+        if (!source.exists()) {
+            SG_LOG(SG_NAVCACHE, SG_WARN, "NavCache: snapshot source " << source << " is missing, not writing " << d->path);
+            d->out.reset();
+            return false;
+        }
+
+        SourceData sd;
+        memset(&sd, 0, sizeof(sd));
+        SGFile sf(source);
+        sd.path = d->addString(source.realpath().utf8Str(), sd.pathLen);
+        sd.sha = d->addString(sf.computeHash(), sd.shaLen);
+        sd.size = static_cast<int64_t>(source.sizeInBytes());
+        sd.modTime = static_cast<int64_t>(source.modTime());
+        sources.push_back(sd);
+    }
+
+    const std::string& strings = d->stringData;
+    std::sort(d->idents.begin(), d->idents.end(), [&strings](const IdentData& a, const IdentData& b) {
+        const int c = strings.compare(a.ident, a.identLen, strings, b.ident, b.identLen);
+        if (c != 0) {
+            return c < 0;
+        }
+        return (a.type != b.type) ? (a.type < b.type) : (a.guid < b.guid);
+    });
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    header.common.init(SNAPSHOT_MAGIC, SNAPSHOT_VERSION);
+    header.schemaVersion = static_cast<uint32_t>(SCHEMA_VERSION);
+    header.numSources = sources.size();
+    header.numRecords = d->numRecords;
+    header.numNodes = d->nodes.size();
+    header.numLeaves = d->leaves.size();
+    header.numMembers = d->members.size();
+    header.numNavStations = d->navStations.size();
+    header.numCommStations = d->commStations.size();
+    header.numAirwayEdges = d->airwayEdges.size();
+    header.numIdents = d->idents.size();
+
+    uint64_t pos = binaryCacheAlign(sizeof(SnapshotHeader));
+    header.recordsPos = pos;
+    pos = binaryCacheAlign(pos + d->numRecords * sizeof(RecordData));
+    header.nodesPos = pos;
+    pos = binaryCacheAlign(pos + d->nodes.size() * sizeof(NodeData));
+    header.leavesPos = pos;
+    pos = binaryCacheAlign(pos + d->leaves.size() * sizeof(LeafData));
+    header.membersPos = pos;
+    pos = binaryCacheAlign(pos + d->members.size() * sizeof(MemberData));
+    header.navStationsPos = pos;
+    pos = binaryCacheAlign(pos + d->navStations.size() * sizeof(StationData));
+    header.commStationsPos = pos;
+    pos = binaryCacheAlign(pos + d->commStations.size() * sizeof(StationData));
+    header.airwayEdgesPos = pos;
+    pos = binaryCacheAlign(pos + d->airwayEdges.size() * sizeof(EdgeData));
+    header.sourcesPos = pos;
+    pos = binaryCacheAlign(pos + sources.size() * sizeof(SourceData));
+    header.identsPos = pos;
+    pos = binaryCacheAlign(pos + d->idents.size() * sizeof(IdentData));
+    header.stringDataPos = pos;
+    header.fileSize = pos + d->stringData.size();
+
+    BinaryCacheWriter& w = *d->out;
+    w.padTo(header.nodesPos);
+    w.write(d->nodes.data(), d->nodes.size() * sizeof(NodeData));
+    w.padTo(header.leavesPos);
+    w.write(d->leaves.data(), d->leaves.size() * sizeof(LeafData));
+    w.padTo(header.membersPos);
+    w.write(d->members.data(), d->members.size() * sizeof(MemberData));
+    w.padTo(header.navStationsPos);
+    w.write(d->navStations.data(), d->navStations.size() * sizeof(StationData));
+    w.padTo(header.commStationsPos);
+    w.write(d->commStations.data(), d->commStations.size() * sizeof(StationData));
+    w.padTo(header.airwayEdgesPos);
+    w.write(d->airwayEdges.data(), d->airwayEdges.size() * sizeof(EdgeData));
+    w.padTo(header.sourcesPos);
+    w.write(sources.data(), sources.size() * sizeof(SourceData));
+    w.padTo(header.identsPos);
+    w.write(d->idents.data(), d->idents.size() * sizeof(IdentData));
+    w.padTo(header.stringDataPos);
+    w.write(d->stringData.data(), d->stringData.size());
+
+    w.stream().seekp(0);
+    w.write(&header, sizeof(header));
+
+    const bool ok = w.commit();
+    d->out.reset();
+    if (!ok) {
+        return false;
+    }
+
+    SG_LOG(SG_NAVCACHE, SG_INFO, "NavCache: wrote snapshot with " << header.numRecords
+           << " records to " << d->path);
+    return true;
+}
+
+} // of namespace flightgear
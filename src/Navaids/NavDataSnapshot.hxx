@@ -0,0 +1,96 @@
+/*
+ * SPDX-FileName: NavDataSnapshot.hxx
+ * SPDX-FileComment: memory mapped, read-only snapshot of the navdata cache
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <simgear/misc/sg_path.hxx>
+
+#include <Navaids/FrequencyTable.hxx>
+#include <Navaids/NavDataCache.hxx>
+#include <Navaids/PositionedHotSet.hxx>
+
+class SGMMapFile;
+
+namespace flightgear {
+
+/**
+ * A flat export of a built NavDataCache: the positioned records with the
+ * columns of their type tables, the octree, the leaf members, the
+ * frequency tables, the airway edges and an ident index, as sorted arrays
+ * of fixed-size records plus a string table. The file is mapped into
+ * memory and used in place.
+ *
+ * The snapshot records the schema version and the dat files it was built
+ * from, with their size, modification time and hash, and is only opened
+ * if the same files are given: unchanged files are recognised by their
+ * modification time, others (for instance in another installation) by
+ * their hash. A cache built from the same files assigns the same guids,
+ * so the snapshot can stand in for its persistent part.
+ */
+class NavDataSnapshot
+{
+public:
+    ~NavDataSnapshot();
+
+    /// nullptr if the file is missing, damaged, or built from other sources
+    static std::unique_ptr<NavDataSnapshot> open(const SGPath& path, const PathList& sources);
+
+    bool findRecord(PositionedID guid, PositionedRecord& r) const;
+
+    /// false if the leaf has no members in the snapshot
+    bool leafChildren(int64_t leafId, TypedPositionedVec& children) const;
+
+    /// the child mask of an octree node, or -1 if it isn't in the snapshot
+    int branchChildren(int64_t nodeId) const;
+
+    /// add the navaids, or comm stations, to table and finish it
+    void fillFrequencyTable(bool comm, FrequencyTable& table) const;
+
+    AirwayNetworkEdgeVec airwayNetworkEdges(int network) const;
+
+    /// guids with the ident, or starting with it, ignoring case
+    PositionedIDVec findByIdent(const std::string& ident, bool exact,
+                                int minType, int maxType) const;
+
+    size_t recordCount() const;
+
+    /**
+     * Streams a snapshot to disk. Records must be added in ascending guid
+     * order and leaf members grouped by leaf; everything but the records
+     * is kept in memory until finish().
+     */
+    class Writer
+    {
+    public:
+        Writer(const SGPath& path, const PathList& sources);
+        ~Writer();
+
+        bool begin();
+        void addRecord(const PositionedRecord& r);
+        void addOctreeNode(int64_t nodeId, int children);
+        void addLeafMember(int64_t leafId, PositionedID guid, FGPositioned::Type ty);
+        void addStation(bool comm, const FrequencyTable::Station& s);
+        void addAirwayEdge(int network, const AirwayNetworkEdge& e);
+        bool finish();
+
+    private:
+        class WriterPrivate;
+        std::unique_ptr<WriterPrivate> d;
+    };
+
+private:
+    NavDataSnapshot();
+
+    class NavDataSnapshotPrivate;
+    std::unique_ptr<NavDataSnapshotPrivate> d;
+};
+
+} // of namespace flightgear
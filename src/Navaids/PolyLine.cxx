@@ -25,7 +25,9 @@
 
 #include "PolyLine.hxx"
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 
 #include <simgear/math/sg_geodesy.hxx>
 #include <simgear/structure/exception.hxx>
@@ -34,9 +36,68 @@
 
 using namespace flightgear;
 
-PolyLine::PolyLine(Type aTy, const SGGeodVec& aPoints) :
+namespace {
+
+// tolerance of simplified level 1; each further level is four times coarser
+const double LEVEL1_TOLERANCE_M = 250.0;
+
+// a displayed range spans at least this many tolerances, which keeps the
+// simplification below a pixel or so
+const double RANGE_PER_TOLERANCE = 500.0;
+
+double distSqrToSegment(const SGVec3d& aPt, const SGVec3d& aStart, const SGVec3d& aEnd)
+{
+    const SGVec3d seg = aEnd - aStart;
+    const double lenSqr = dot(seg, seg);
+    if (lenSqr <= 0.0) {
+        return distSqr(aPt, aStart); // closed rings start and end together
+    }
+
+    const double t = SGMiscd::clip(dot(aPt - aStart, seg) / lenSqr, 0.0, 1.0);
+    return distSqr(aPt, aStart + t * seg);
+}
+
+/**
+ * Douglas-Peucker: mark the points to keep, so none of those dropped is
+ * further than aToleranceM from the line through the kept ones
+ */
+void simplifyPoints(const std::vector<SGVec3d>& aCarts, double aToleranceM, std::vector<bool>& aKeep)
+{
+    aKeep.assign(aCarts.size(), false);
+    aKeep.front() = aKeep.back() = true;
+
+    const double toleranceSqr = aToleranceM * aToleranceM;
+    std::vector<std::pair<size_t, size_t>> spans;
+    spans.push_back(std::make_pair(0, aCarts.size() - 1));
+
+    while (!spans.empty()) {
+        const size_t first = spans.back().first, last = spans.back().second;
+        spans.pop_back();
+
+        double maxDistSqr = 0.0;
+        size_t furthest = first;
+        for (size_t i = first + 1; i < last; ++i) {
+            const double d = distSqrToSegment(aCarts[i], aCarts[first], aCarts[last]);
+            if (d > maxDistSqr) {
+                maxDistSqr = d;
+                furthest = i;
+            }
+        }
+
+        if (maxDistSqr > toleranceSqr) {
+            aKeep[furthest] = true;
+            spans.push_back(std::make_pair(first, furthest));
+            spans.push_back(std::make_pair(furthest, last));
+        }
+    }
+}
+
+} // of anonymous namespace
+
+PolyLine::PolyLine(Type aTy, const SGGeodVec& aPoints, const SGBoxd& aCartBox) :
     m_type(aTy),
-    m_data(aPoints)
+    m_data(aPoints),
+    m_box(aCartBox)
 {
     assert(!aPoints.empty());
 }
@@ -68,6 +129,7 @@ PolyLineList PolyLine::createChunked(Type aTy, const SGGeodVec& aRawPoints)
 
     SGVec3d chunkStartCart = SGVec3d::fromGeod(aRawPoints.front());
     SGGeodVec chunk;
+    std::vector<SGVec3d> chunkCarts;
     SGGeodVec::const_iterator it = aRawPoints.begin();
 
     while (it != aRawPoints.end()) {
@@ -77,19 +139,22 @@ PolyLineList PolyLine::createChunked(Type aTy, const SGGeodVec& aRawPoints)
     // distance check, but also ensure we generate actual valid line segments.
         if ((chunk.size() >= 2) && (d2 > maxDistanceSquaredM)) {
             chunk.push_back(*it); // close the segment
-            result.push_back(new PolyLine(aTy, chunk));
+            chunkCarts.push_back(ptCart);
+            result.push_back(createFromCarts(aTy, chunk, chunkCarts));
             chunkStartCart = ptCart;
             chunk.clear();
+            chunkCarts.clear();
         }
 
         chunk.push_back(*it++); // add to open chunk
+        chunkCarts.push_back(ptCart);
     }
 
     // if we have a single trailing point, we already added it as the last
     // point of the previous chunk, so we're ok. Otherwise, create the
     // final chunk's polyline
     if (chunk.size() > 1) {
-        result.push_back(new PolyLine(aTy, chunk));
+        result.push_back(createFromCarts(aTy, chunk, chunkCarts));
     }
 
     return result;
@@ -97,7 +162,106 @@ PolyLineList PolyLine::createChunked(Type aTy, const SGGeodVec& aRawPoints)
 
 PolyLineRef PolyLine::create(PolyLine::Type aTy, const SGGeodVec &aRawPoints)
 {
-    return new PolyLine(aTy, aRawPoints);
+    std::vector<SGVec3d> carts;
+    carts.reserve(aRawPoints.size());
+    for (const auto& g : aRawPoints) {
+        carts.push_back(SGVec3d::fromGeod(g));
+    }
+
+    return createFromCarts(aTy, aRawPoints, carts);
+}
+
+PolyLineRef PolyLine::createFromCarts(Type aTy, const SGGeodVec& aPoints,
+                                      const std::vector<SGVec3d>& aCarts)
+{
+    SGBoxd box;
+    for (const auto& c : aCarts) {
+        box.expandBy(c);
+    }
+
+    PolyLineRef line = new PolyLine(aTy, aPoints, box);
+    line->simplify(aCarts);
+    return line;
+}
+
+PolyLineRef PolyLine::createWithLevels(Type aTy, const std::vector<SGGeodVec>& aLevels,
+                                       const SGBoxd& aCartBox)
+{
+    assert(aLevels.size() == (NUM_SIMPLIFIED_LEVELS + 1));
+    PolyLineRef line = new PolyLine(aTy, aLevels.front(), aCartBox);
+    size_t previousSize = aLevels.front().size();
+    for (unsigned int level = 1; level <= NUM_SIMPLIFIED_LEVELS; ++level) {
+        const SGGeodVec& points = aLevels[level];
+        if (points.empty() || (points.size() == previousSize)) {
+            line->m_simplified.push_back(PolyLineRef());
+            continue;
+        }
+
+        line->m_simplified.push_back(new PolyLine(aTy, points, aCartBox));
+        previousSize = points.size();
+    }
+
+    return line;
+}
+
+void PolyLine::simplify(const std::vector<SGVec3d>& aCarts)
+{
+    assert(aCarts.size() == m_data.size());
+    m_simplified.clear();
+
+    std::vector<bool> keep;
+    size_t previousSize = m_data.size();
+    for (unsigned int level = 1; level <= NUM_SIMPLIFIED_LEVELS; ++level) {
+        simplifyPoints(aCarts, simplifiedToleranceM(level), keep);
+        const size_t numKept = std::count(keep.begin(), keep.end(), true);
+        if (numKept == previousSize) {
+            // the previous level stands in, see simplified()
+            m_simplified.push_back(PolyLineRef());
+            continue;
+        }
+
+        SGGeodVec points;
+        points.reserve(numKept);
+        for (size_t i = 0; i < keep.size(); ++i) {
+            if (keep[i]) {
+                points.push_back(m_data[i]);
+            }
+        }
+
+        m_simplified.push_back(new PolyLine(m_type, points, m_box));
+        previousSize = numKept;
+    }
+}
+
+PolyLineRef PolyLine::simplified(unsigned int aLevel) const
+{
+    for (size_t level = std::min<size_t>(aLevel, m_simplified.size()); level > 0; --level) {
+        if (m_simplified[level - 1]) {
+            return m_simplified[level - 1];
+        }
+    }
+
+    return const_cast<PolyLine*>(this);
+}
+
+double PolyLine::simplifiedToleranceM(unsigned int aLevel)
+{
+    if (aLevel == 0) {
+        return 0.0;
+    }
+
+    return LEVEL1_TOLERANCE_M * std::pow(4.0, static_cast<double>(aLevel - 1));
+}
+
+unsigned int PolyLine::levelForRange(double aRangeNm)
+{
+    const double visibleM = (aRangeNm * SG_NM_TO_METER) / RANGE_PER_TOLERANCE;
+    unsigned int level = 0;
+    while ((level < NUM_SIMPLIFIED_LEVELS) && (simplifiedToleranceM(level + 1) <= visibleM)) {
+        ++level;
+    }
+
+    return level;
 }
 
 void PolyLine::bulkAddToSpatialIndex(PolyLineList::const_iterator begin,
@@ -115,18 +279,6 @@ void PolyLine::addToSpatialIndex() const
     node->addPolyLine(const_cast<PolyLine*>(this));
 }
 
-SGBoxd PolyLine::cartesianBox() const
-{
-    SGBoxd result;
-    SGGeodVec::const_iterator it;
-    for (it = m_data.begin(); it != m_data.end(); ++it) {
-        SGVec3d cart = SGVec3d::fromGeod(*it);
-        result.expandBy(cart);
-    }
-
-    return result;
-}
-
 class SingleTypeFilter : public PolyLine::TypeFilter
 {
 public:
@@ -170,7 +322,13 @@ PolyLineList PolyLine::linesNearPos(const SGGeod& aPos, double aRangeNm, const T
         }
     } // of deque iteration
 
+    // the index holds the full lines, wide ranges get simplified ones
+    const unsigned int level = levelForRange(aRangeNm);
     PolyLineList result;
-    result.insert(result.end(), resultSet.begin(), resultSet.end());
+    result.reserve(resultSet.size());
+    for (const auto& ref : resultSet) {
+        result.push_back(ref->simplified(level));
+    }
+
     return result;
 }
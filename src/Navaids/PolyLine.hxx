@@ -79,6 +79,24 @@ public:
     
     const SGGeodVec& points() const
     { return m_data; }
+
+    /// number of simplified versions kept besides the line itself
+    static constexpr unsigned int NUM_SIMPLIFIED_LEVELS = 3;
+
+    /**
+     * the line simplified (Douglas-Peucker) so no point of it is further
+     * than simplifiedToleranceM(aLevel) from the result. Level 0 is the
+     * line itself; simplified lines have no simplified levels of their own.
+     */
+    PolyLineRef simplified(unsigned int aLevel) const;
+
+    static double simplifiedToleranceM(unsigned int aLevel);
+
+    /**
+     * the coarsest level whose simplification isn't visible when showing
+     * aRangeNm around a point
+     */
+    static unsigned int levelForRange(double aRangeNm);
     
     /**
      * create poly line objects from raw input points and a type.
@@ -90,12 +108,21 @@ public:
     
     static PolyLineRef create(Type aTy, const SGGeodVec& aRawPoints);
 
+    /**
+     * create a line whose simplified levels and bounding box are already
+     * known, as stored in a cache. aLevels[0] is the line itself, and
+     * is followed by NUM_SIMPLIFIED_LEVELS simplified versions.
+     */
+    static PolyLineRef createWithLevels(Type aTy, const std::vector<SGGeodVec>& aLevels,
+                                        const SGBoxd& aCartBox);
+
     static void bulkAddToSpatialIndex(PolyLineList::const_iterator begin,
                                       PolyLineList::const_iterator end);
 
     /**
      * retrieve all the lines within a range of a search point.
-     * lines are returned if any point is near the search location.
+     * lines are returned if any point is near the search location, at the
+     * simplified level suiting the range.
      */
     static PolyLineList linesNearPos(const SGGeod& aPos, double aRangeNm, Type aTy);
     
@@ -107,16 +134,27 @@ public:
     
     static PolyLineList linesNearPos(const SGGeod& aPos, double aRangeNm, const TypeFilter& aFilter);
 
-    SGBoxd cartesianBox() const;
+    SGBoxd cartesianBox() const
+    { return m_box; }
 
     void addToSpatialIndex() const;
 
 private:
     
-    PolyLine(Type aTy, const SGGeodVec& aPoints);
-    
+    PolyLine(Type aTy, const SGGeodVec& aPoints, const SGBoxd& aCartBox);
+
+    /// create and simplify a line whose points are already in cartesian form
+    static PolyLineRef createFromCarts(Type aTy, const SGGeodVec& aPoints,
+                                       const std::vector<SGVec3d>& aCarts);
+
+    /// build the simplified levels, from the cartesian form of the points
+    void simplify(const std::vector<SGVec3d>& aCarts);
+
     Type m_type;
     SGGeodVec m_data;
+    SGBoxd m_box;
+    /// levels 1 to NUM_SIMPLIFIED_LEVELS, null where a level removed nothing
+    PolyLineList m_simplified;
 
 };
     
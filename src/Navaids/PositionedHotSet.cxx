@@ -0,0 +1,123 @@
+/*
+ * SPDX-FileName: PositionedHotSet.cxx
+ * SPDX-FileComment: in-memory store of prefetched octree leaves
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#include "PositionedHotSet.hxx"
+
+namespace {
+
+size_t recordBytes(const flightgear::PositionedRecord& r)
+{
+    return sizeof(r) + r.ident.capacity() + r.name.capacity() + r.sceneryPath.capacity();
+}
+
+} // of anonymous namespace
+
+namespace flightgear {
+
+PositionedHotSet::PositionedHotSet(size_t budgetBytes) : _budget(budgetBytes)
+{
+}
+
+void PositionedHotSet::setBudget(size_t budgetBytes)
+{
+    _budget = budgetBytes;
+    while ((_bytes > _budget) && (_lru.size() > 1)) {
+        evict(_lru.back());
+    }
+}
+
+void PositionedHotSet::insertLeaf(int64_t leafId, PositionedRecordVec&& records)
+{
+    if (_leaves.count(leafId)) {
+        evict(leafId);
+    }
+
+    _lru.push_front(leafId);
+    Leaf& leaf = _leaves[leafId];
+    leaf.records = std::move(records);
+    leaf.lru = _lru.begin();
+    for (size_t i = 0; i < leaf.records.size(); ++i) {
+        leaf.bytes += recordBytes(leaf.records[i]);
+        // items of an airport can also be in a leaf of their own, the
+        // newest copy wins
+        _index[leaf.records[i].guid] = IndexEntry{leafId, i};
+    }
+    _bytes += leaf.bytes;
+
+    // always keep the leaf just inserted
+    while ((_bytes > _budget) && (_lru.size() > 1)) {
+        evict(_lru.back());
+    }
+}
+
+bool PositionedHotSet::hasLeaf(int64_t leafId) const
+{
+    return _leaves.count(leafId) > 0;
+}
+
+bool PositionedHotSet::leafChildren(int64_t leafId, TypedPositionedVec& children)
+{
+    auto it = _leaves.find(leafId);
+    if (it == _leaves.end()) {
+        return false;
+    }
+
+    touch(it->second);
+    for (const auto& r : it->second.records) {
+        if (r.octreeNode == leafId) {
+            children.push_back(TypedPositioned(r.type, r.guid));
+        }
+    }
+    return true;
+}
+
+const PositionedRecord* PositionedHotSet::find(PositionedID guid)
+{
+    auto it = _index.find(guid);
+    if (it == _index.end()) {
+        return nullptr;
+    }
+
+    Leaf& leaf = _leaves[it->second.leaf];
+    touch(leaf);
+    return &leaf.records[it->second.record];
+}
+
+void PositionedHotSet::clear()
+{
+    _leaves.clear();
+    _index.clear();
+    _lru.clear();
+    _bytes = 0;
+}
+
+void PositionedHotSet::touch(Leaf& leaf)
+{
+    _lru.splice(_lru.begin(), _lru, leaf.lru);
+}
+
+void PositionedHotSet::evict(int64_t leafId)
+{
+    auto it = _leaves.find(leafId);
+    if (it == _leaves.end()) {
+        return;
+    }
+
+    for (const auto& r : it->second.records) {
+        auto ix = _index.find(r.guid);
+        if ((ix != _index.end()) && (ix->second.leaf == leafId)) {
+            _index.erase(ix);
+        }
+    }
+
+    _bytes -= it->second.bytes;
+    _lru.erase(it->second.lru);
+    _leaves.erase(it);
+}
+
+} // of namespace flightgear
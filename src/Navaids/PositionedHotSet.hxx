@@ -0,0 +1,128 @@
+/*
+ * SPDX-FileName: PositionedHotSet.hxx
+ * SPDX-FileComment: in-memory store of prefetched octree leaves
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <simgear/math/SGMath.hxx>
+
+#include <Navaids/NavDataCache.hxx>
+#include <Navaids/positioned.hxx>
+
+namespace flightgear {
+
+/**
+ * The columns of a positioned row and of the table for its type, enough to
+ * create the FGPositioned without going back to the database. Only the
+ * fields of the type's table are set.
+ */
+struct PositionedRecord {
+    PositionedID guid = 0;
+    FGPositioned::Type type = FGPositioned::INVALID;
+    std::string ident;
+    std::string name;
+    PositionedID airport = 0;
+    SGGeod pos;
+    int64_t octreeNode = 0;
+
+    // airport
+    std::string sceneryPath;
+    bool hasMetar = false;
+
+    // runway, helipad, taxiway
+    double heading = 0.0;
+    double length = 0.0;
+    double width = 0.0;
+    double displacedThreshold = 0.0;
+    double stopway = 0.0;
+    int surface = 0;
+    PositionedID reciprocal = 0;
+    PositionedID ils = 0;
+
+    // navaid and comm station
+    int freq = 0;
+    int rangeNm = 0;
+    double multiuse = 0.0;
+    PositionedID runway = 0;
+    PositionedID colocated = 0;
+};
+
+typedef std::vector<PositionedRecord> PositionedRecordVec;
+
+/**
+ * Octree leaves loaded by the NavDataCache prefetcher: the records of the
+ * leaf members, plus the runways, comm stations and other items of the
+ * airports in the leaf. NavDataCache answers getOctreeLeafChildren and
+ * cache misses of loadById from here before querying the database, so
+ * spatial searches in a prefetched area don't touch SQLite.
+ *
+ * The store holds records, not FGPositioned instances, so evicting a leaf
+ * never drops an object someone is still using. Leaves are evicted least
+ * recently used first once the estimated size exceeds the budget.
+ */
+class PositionedHotSet
+{
+public:
+    explicit PositionedHotSet(size_t budgetBytes = 32 * 1024 * 1024);
+
+    void setBudget(size_t budgetBytes);
+
+    /// replace or add a leaf, and evict leaves above the budget
+    void insertLeaf(int64_t leafId, PositionedRecordVec&& records);
+
+    bool hasLeaf(int64_t leafId) const;
+
+    /**
+     * the members of a stored leaf, that is the records whose octree node
+     * it is
+     * @return false if the leaf isn't stored
+     */
+    bool leafChildren(int64_t leafId, TypedPositionedVec& children);
+
+    /// the record of guid, or nullptr; valid until the next insertion
+    const PositionedRecord* find(PositionedID guid);
+
+    void clear();
+
+    size_t leafCount() const
+    { return _leaves.size(); }
+
+    size_t recordCount() const
+    { return _index.size(); }
+
+    size_t bytes() const
+    { return _bytes; }
+
+private:
+    typedef std::list<int64_t> LruList;
+
+    struct Leaf {
+        PositionedRecordVec records;
+        LruList::iterator lru;
+        size_t bytes = 0;
+    };
+
+    struct IndexEntry {
+        int64_t leaf;
+        size_t record;
+    };
+
+    void touch(Leaf& leaf);
+    void evict(int64_t leafId);
+
+    std::unordered_map<int64_t, Leaf> _leaves;
+    std::unordered_map<PositionedID, IndexEntry> _index;
+    LruList _lru; ///< most recently used first
+    size_t _bytes = 0;
+    size_t _budget;
+};
+
+} // of namespace flightgear
@@ -19,6 +19,7 @@
 #include <simgear/timing/timestamp.hxx>
 
 #include "PolyLine.hxx"
+#include "SpatialQueryCache.hxx"
 
 namespace flightgear
 {
@@ -129,10 +130,19 @@ void Leaf::visit(const SGVec3d& aPos, double aCutoff,
                      aResults.begin() + previousResultsSize, aResults.end());
 }
 
+void Leaf::findLeavesWithinRange(const SGVec3d& aPos, double aCutoff,
+                                 std::vector<Leaf*>& aLeaves)
+{
+    if (distToNearest(aPos) <= aCutoff) {
+        aLeaves.push_back(this);
+    }
+}
+
 void Leaf::insertChild(FGPositioned::Type ty, PositionedID id)
 {
   assert(_childrenLoaded);
   children.insert(children.end(), TypedPositioned(ty, id));
+  SpatialQueryCache::instance()->clear();
 }
 
 void Leaf::removeChild(PositionedID id)
@@ -146,6 +156,7 @@ void Leaf::removeChild(PositionedID id)
 
     if (it != children.end()) {
         children.erase(it);
+        SpatialQueryCache::instance()->clear();
     }
 }
 
@@ -214,6 +225,21 @@ void Branch::visitForLines(const SGVec3d& aPos, double aCutoff,
     } // of child iteration
 }
 
+void Branch::findLeavesWithinRange(const SGVec3d& aPos, double aCutoff,
+                                   std::vector<Leaf*>& aLeaves)
+{
+    if (distToNearest(aPos) > aCutoff) {
+        return;
+    }
+
+    loadChildren();
+    for (unsigned int i=0; i<8; ++i) {
+        if (_children[i]) {
+            _children[i]->findLeavesWithinRange(aPos, aCutoff, aLeaves);
+        }
+    }
+}
+
 static bool boxContainsBox(const SGBoxd& a, const SGBoxd& b)
 {
     const SGVec3d aMin(a.getMin()),
@@ -328,9 +354,18 @@ int Branch::childMask() const
   return result;
 }
 
+static void prefetchAround(const SGVec3d& aPos)
+{
+    NavDataCache* cache = NavDataCache::instance();
+    if (cache) {
+        cache->prefetchAround(aPos);
+    }
+}
+
 bool findNearestN(const SGVec3d& aPos, unsigned int aN, double aCutoffM, FGPositioned::Filter* aFilter, FGPositionedList& aResults, int aCutoffMsec)
 {
   aResults.clear();
+  prefetchAround(aPos);
   FindNearestPQueue pq;
   FindNearestResults results;
   pq.push(Ordered<Node*>(globalPersistentOctree(), 0));
@@ -370,9 +405,25 @@ bool findNearestN(const SGVec3d& aPos, unsigned int aN, double aCutoffM, FGPosit
   return !pq.empty();
 }
 
-bool findAllWithinRange(const SGVec3d& aPos, double aRangeM, FGPositioned::Filter* aFilter, FGPositionedList& aResults, int aCutoffMsec)
+static bool boxWithinSphere(const SGBoxd& aBox, const SGVec3d& aCentre, double aRadius)
+{
+    // the corner furthest from the centre decides
+    double d2 = 0.0;
+    for (int i=0; i<3; ++i) {
+        const double d = std::max(fabs(aCentre[i] - aBox.getMin()[i]),
+                                  fabs(aBox.getMax()[i] - aCentre[i]));
+        d2 += d * d;
+    }
+
+    return d2 <= (aRadius * aRadius);
+}
+
+static bool findAllWithinRangeImpl(const SGVec3d& aPos, double aRangeM,
+                                   const SGVec3d* aKnownPos, double aKnownRangeM,
+                                   FGPositioned::Filter* aFilter, FGPositionedList& aResults, int aCutoffMsec)
 {
   aResults.clear();
+  prefetchAround(aPos);
   FindNearestPQueue pq;
   FindNearestResults results;
   pq.push(Ordered<Node*>(globalPersistentOctree(), 0));
@@ -386,6 +437,10 @@ bool findAllWithinRange(const SGVec3d& aPos, double aRangeM, FGPositioned::Filte
     Node* nd = pq.top().get();
     pq.pop();
 
+    if (aKnownPos && boxWithinSphere(nd->bbox(), *aKnownPos, aKnownRangeM)) {
+      continue;
+    }
+
     nd->visit(aPos, rng, aFilter, results, pq);
   } // of queue iteration
 
@@ -399,6 +454,18 @@ bool findAllWithinRange(const SGVec3d& aPos, double aRangeM, FGPositioned::Filte
   return !pq.empty();
 }
 
+bool findAllWithinRange(const SGVec3d& aPos, double aRangeM, FGPositioned::Filter* aFilter, FGPositionedList& aResults, int aCutoffMsec)
+{
+  return findAllWithinRangeImpl(aPos, aRangeM, nullptr, 0.0, aFilter, aResults, aCutoffMsec);
+}
+
+bool findAllWithinRangeOutside(const SGVec3d& aPos, double aRangeM,
+                               const SGVec3d& aKnownPos, double aKnownRangeM,
+                               FGPositioned::Filter* aFilter, FGPositionedList& aResults, int aCutoffMsec)
+{
+  return findAllWithinRangeImpl(aPos, aRangeM, &aKnownPos, aKnownRangeM, aFilter, aResults, aCutoffMsec);
+}
+
 } // of namespace Octree
 
 } // of namespace flightgear
@@ -146,6 +146,13 @@ namespace Octree
 
     virtual Node* findNodeForBox(const SGBoxd& box) const;
 
+    /**
+     * collect the leaves below this node within aCutoff of aPos. Only
+     * creates nodes, the members of the leaves are not loaded.
+     */
+    virtual void findLeavesWithinRange(const SGVec3d& aPos, double aCutoff,
+                                       std::vector<Leaf*>& aLeaves) = 0;
+
     virtual ~Node();
 
     void addPolyLine(const PolyLineRef&);
@@ -174,6 +181,12 @@ namespace Octree
           return const_cast<Leaf*>(this);
     }
 
+    virtual void findLeavesWithinRange(const SGVec3d& aPos, double aCutoff,
+                                       std::vector<Leaf*>& aLeaves);
+
+    bool childrenLoaded() const
+    { return _childrenLoaded; }
+
     void insertChild(FGPositioned::Type ty, PositionedID id);
     void removeChild(PositionedID id);
 
@@ -209,6 +222,9 @@ private:
 
     virtual Node* findNodeForBox(const SGBoxd& box) const;
 
+    virtual void findLeavesWithinRange(const SGVec3d& aPos, double aCutoff,
+                                       std::vector<Leaf*>& aLeaves);
+
   private:
     Node* childForPos(const SGVec3d& aCart) const;
     Node* childAtIndex(int childIndex) const;
@@ -231,6 +247,15 @@ private:
 
   bool findNearestN(const SGVec3d& aPos, unsigned int aN, double aCutoffM, FGPositioned::Filter* aFilter, FGPositionedList& aResults, int aCutoffMsec);
   bool findAllWithinRange(const SGVec3d& aPos, double aRangeM, FGPositioned::Filter* aFilter, FGPositionedList& aResults, int aCutoffMsec);
+
+  /**
+   * as findAllWithinRange, but nodes lying entirely within aKnownRangeM of
+   * aKnownPos are not visited, the caller has their items already. Nodes
+   * partly inside are visited, so items on either side can be returned.
+   */
+  bool findAllWithinRangeOutside(const SGVec3d& aPos, double aRangeM,
+                                 const SGVec3d& aKnownPos, double aKnownRangeM,
+                                 FGPositioned::Filter* aFilter, FGPositionedList& aResults, int aCutoffMsec);
 } // of namespace Octree
 
 
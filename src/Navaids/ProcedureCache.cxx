@@ -0,0 +1,530 @@
+/*
+ * SPDX-FileName: ProcedureCache.cxx
+ * SPDX-FileComment: background loading and binary cache of procedures files
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#include "ProcedureCache.hxx"
+#include "BinaryCacheFile.hxx"
+
+#include <unordered_map>
+#include <vector>
+
+#include <simgear/debug/logstream.hxx>
+#include <simgear/io/sg_file.hxx>
+#include <simgear/misc/sg_dir.hxx>
+#include <simgear/misc/strutils.hxx>
+#include <simgear/threads/SGThread.hxx>
+#include <simgear/xml/easyxml.hxx>
+
+#include <Airports/airport.hxx>
+#include <Airports/xmlloader.hxx>
+#include <Main/globals.hxx>
+
+namespace {
+
+const char CACHE_MAGIC[8] = {'F', 'G', 'P', 'R', 'O', 'C', 'D', 'B'};
+const uint32_t CACHE_VERSION = 2;
+
+struct CacheHeader
+{
+    flightgear::BinaryCacheHeader common;
+    uint32_t hashLen;
+    uint32_t sourceLen;
+    uint32_t numStrings;
+    uint32_t numAttrs;
+    uint32_t numEvents;
+};
+
+} // of anonymous namespace
+
+namespace flightgear {
+
+/**
+ * The elements, attributes and text of an XML file, in order. All names,
+ * values and text are interned in the string table.
+ */
+class ProcedureCache::Recording
+{
+public:
+    enum EventType : uint32_t {
+        START_ELEMENT,
+        END_ELEMENT,
+        DATA
+    };
+
+    struct Event {
+        uint32_t type;
+        uint32_t text;      ///< element name, or the text of DATA
+        uint32_t firstAttr; ///< index into attrs
+        uint32_t numAttrs;
+    };
+
+    void record(const SGPath& source);
+    void replay(XMLVisitor& visitor) const;
+
+    bool read(const SGPath& path, const std::string& sourceHash);
+    bool write(const SGPath& path, const std::string& sourceHash, const SGPath& source) const;
+
+    /// the source a cache file was written from, false if it's unusable
+    static bool readSource(const SGPath& path, std::string& source);
+
+    std::vector<std::string> strings;
+    std::vector<uint32_t> attrs; ///< name and value of each attribute
+    std::vector<Event> events;
+};
+
+void ProcedureCache::Recording::record(const SGPath& source)
+{
+    class Recorder : public XMLVisitor
+    {
+    public:
+        Recorder(Recording& recording) : _recording(recording)
+        {
+        }
+
+        void startElement(const char* name, const XMLAttributes& atts) override
+        {
+            flushText();
+            Event e{START_ELEMENT, intern(name),
+                    static_cast<uint32_t>(_recording.attrs.size()),
+                    static_cast<uint32_t>(atts.size())};
+            for (int i = 0; i < atts.size(); ++i) {
+                _recording.attrs.push_back(intern(atts.getName(i)));
+                _recording.attrs.push_back(intern(atts.getValue(i)));
+            }
+            _recording.events.push_back(e);
+        }
+
+        void endElement(const char* name) override
+        {
+            flushText();
+            _recording.events.push_back(Event{END_ELEMENT, intern(name), 0, 0});
+        }
+
+        void data(const char* s, int len) override
+        {
+            // expat hands text over in pieces
+            _text.append(s, len);
+        }
+
+        void endXML() override
+        {
+            flushText();
+        }
+
+    private:
+        uint32_t intern(const std::string& s)
+        {
+            auto it = _index.find(s);
+            if (it != _index.end()) {
+                return it->second;
+            }
+
+            const uint32_t i = static_cast<uint32_t>(_recording.strings.size());
+            _recording.strings.push_back(s);
+            _index.emplace(s, i);
+            return i;
+        }
+
+        void flushText()
+        {
+            if (!_text.empty()) {
+                _recording.events.push_back(Event{DATA, intern(_text), 0, 0});
+                _text.clear();
+            }
+        }
+
+        Recording& _recording;
+        std::unordered_map<std::string, uint32_t> _index;
+        std::string _text;
+    };
+
+    Recorder recorder(*this);
+    readXML(source, recorder);
+}
+
+void ProcedureCache::Recording::replay(XMLVisitor& visitor) const
+{
+    visitor.startXML();
+    for (const auto& e : events) {
+        const std::string& text = strings[e.text];
+        if (e.type == START_ELEMENT) {
+            XMLAttributesDefault atts;
+            for (uint32_t a = e.firstAttr; a < (e.firstAttr + 2 * e.numAttrs); a += 2) {
+                atts.addAttribute(strings[attrs[a]].c_str(), strings[attrs[a + 1]].c_str());
+            }
+            visitor.startElement(text.c_str(), atts);
+        } else if (e.type == END_ELEMENT) {
+            visitor.endElement(text.c_str());
+        } else {
+            visitor.data(text.data(), static_cast<int>(text.size()));
+        }
+    }
+    visitor.endXML();
+}
+
+bool ProcedureCache::Recording::read(const SGPath& path, const std::string& sourceHash)
+{
+    std::string data;
+    if (!readBinaryCacheFile(path, data)) {
+        return false;
+    }
+
+    BinaryCacheReader reader(data);
+    CacheHeader header;
+    std::string hash, source;
+    if (!reader.get(&header, sizeof(header)) ||
+        !header.common.matches(CACHE_MAGIC, CACHE_VERSION) ||
+        !reader.getString(hash, header.hashLen) ||
+        !reader.getString(source, header.sourceLen)) {
+        SG_LOG(SG_NAVAID, SG_WARN, "ignoring incompatible procedure cache " << path);
+        return false;
+    }
+
+    if (hash != sourceHash) {
+        SG_LOG(SG_NAVAID, SG_DEBUG, "procedure cache " << path << " is out of date");
+        return false;
+    }
+
+    // counts beyond the file size can only come from a damaged file
+    if ((header.numStrings > reader.size()) || (header.numAttrs > reader.size()) ||
+        (header.numEvents > reader.size())) {
+        return false;
+    }
+
+    strings.resize(header.numStrings);
+    for (auto& s : strings) {
+        uint32_t len = 0;
+        if (!reader.get(&len, sizeof(len)) || !reader.getString(s, len)) {
+            return false;
+        }
+    }
+
+    attrs.resize(header.numAttrs);
+    events.resize(header.numEvents);
+    if (!reader.get(attrs.data(), attrs.size() * sizeof(uint32_t)) ||
+        !reader.get(events.data(), events.size() * sizeof(Event))) {
+        return false;
+    }
+
+    for (auto a : attrs) {
+        if (a >= strings.size()) {
+            return false;
+        }
+    }
+
+    for (const auto& e : events) {
+        if ((e.type > DATA) || (e.text >= strings.size()) ||
+            (e.firstAttr > attrs.size()) || (e.numAttrs > ((attrs.size() - e.firstAttr) / 2))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool ProcedureCache::Recording::readSource(const SGPath& path, std::string& source)
+{
+    std::string data;
+    if (!readBinaryCacheFile(path, data)) {
+        return false;
+    }
+
+    BinaryCacheReader reader(data);
+    CacheHeader header;
+    std::string hash;
+    return reader.get(&header, sizeof(header)) &&
+           header.common.matches(CACHE_MAGIC, CACHE_VERSION) &&
+           reader.getString(hash, header.hashLen) &&
+           reader.getString(source, header.sourceLen);
+}
+
+bool ProcedureCache::Recording::write(const SGPath& path, const std::string& sourceHash,
+                                      const SGPath& source) const
+{
+    BinaryCacheWriter w(path);
+    if (!w.isOpen()) {
+        return false;
+    }
+
+    CacheHeader header;
+    header.common.init(CACHE_MAGIC, CACHE_VERSION);
+    const std::string sourcePath = source.realpath().utf8Str();
+    header.hashLen = static_cast<uint32_t>(sourceHash.size());
+    header.sourceLen = static_cast<uint32_t>(sourcePath.size());
+    header.numStrings = static_cast<uint32_t>(strings.size());
+    header.numAttrs = static_cast<uint32_t>(attrs.size());
+    header.numEvents = static_cast<uint32_t>(events.size());
+
+    w.write(&header, sizeof(header));
+    w.write(sourceHash.data(), sourceHash.size());
+    w.write(sourcePath.data(), sourcePath.size());
+    for (const auto& s : strings) {
+        const uint32_t len = static_cast<uint32_t>(s.size());
+        w.write(&len, sizeof(len));
+        w.write(s.data(), s.size());
+    }
+    w.write(attrs.data(), attrs.size() * sizeof(uint32_t));
+    w.write(events.data(), events.size() * sizeof(Event));
+    return w.commit();
+}
+
+class ProcedureCache::PrefetchThread : public SGThread
+{
+public:
+    PrefetchThread(ProcedureCache* cache) : _cache(cache)
+    {
+    }
+
+    void run() override
+    {
+        _cache->runPrefetch();
+    }
+
+private:
+    ProcedureCache* _cache;
+};
+
+ProcedureCache* ProcedureCache::instance()
+{
+    static ProcedureCache static_instance;
+    return &static_instance;
+}
+
+ProcedureCache::~ProcedureCache()
+{
+    {
+        std::lock_guard<std::mutex> g(_lock);
+        _queue.clear();
+        _pruneDir = SGPath();
+    }
+
+    if (_thread) {
+        _thread->join();
+    }
+}
+
+void ProcedureCache::prefetch(const FGAirport* apt)
+{
+    if (!apt || apt->proceduresLoaded()) {
+        return;
+    }
+
+    SGPath path;
+    if (XMLLoader::findAirportData(apt->ident(), "procedures", path)) {
+        prefetch(path);
+    }
+}
+
+void ProcedureCache::prefetch(const SGPath& source)
+{
+    const SGPath cachePath = cacheFile(source);
+    std::lock_guard<std::mutex> g(_lock);
+    auto it = _prefetched.find(source.utf8Str());
+    if (it != _prefetched.end()) {
+        it->second.discarded = false;
+        return; // pending, or done and not used yet
+    }
+
+    _prefetched[source.utf8Str()] = Prefetched();
+    _queue.emplace_back(source, cachePath);
+    if (!_pruneScheduled) {
+        _pruneScheduled = true;
+        _pruneDir = cachePath.dirPath();
+    }
+
+    if (!_threadRunning) {
+        // the last thread has nothing left to do, and doesn't lock again
+        if (_thread) {
+            _thread->join();
+        }
+
+        _thread.reset(new PrefetchThread(this));
+        _threadRunning = true;
+        _thread->start();
+    }
+}
+
+void ProcedureCache::discardPrefetch(const FGAirport* apt)
+{
+    if (!apt) {
+        return;
+    }
+
+    SGPath path;
+    if (XMLLoader::findAirportData(apt->ident(), "procedures", path)) {
+        discardPrefetch(path);
+    }
+}
+
+void ProcedureCache::discardPrefetch(const SGPath& source)
+{
+    std::lock_guard<std::mutex> g(_lock);
+    auto it = _prefetched.find(source.utf8Str());
+    if (it == _prefetched.end()) {
+        return;
+    }
+
+    if (it->second.done) {
+        _prefetched.erase(it);
+    } else {
+        it->second.discarded = true; // the worker thread drops it
+    }
+}
+
+size_t ProcedureCache::prefetchCount() const
+{
+    std::lock_guard<std::mutex> g(_lock);
+    return _prefetched.size();
+}
+
+void ProcedureCache::read(const SGPath& source, XMLVisitor& visitor)
+{
+    RecordingRef recording;
+    std::string hash;
+    std::exception_ptr error;
+    bool prefetched = false;
+    {
+        std::unique_lock<std::mutex> g(_lock);
+        auto it = _prefetched.find(source.utf8Str());
+        if (it != _prefetched.end()) {
+            // entries of a std::map stay put while others are added, and
+            // only this thread erases done ones
+            it->second.discarded = false;
+            _prefetchDone.wait(g, [it] { return it->second.done; });
+            recording = it->second.recording;
+            hash = it->second.hash;
+            error = it->second.error;
+            _prefetched.erase(it);
+            prefetched = true;
+        }
+    }
+
+    // the file may have been updated since it was prefetched
+    if (prefetched && !error && (hash.empty() || (SGFile(source).computeHash() != hash))) {
+        prefetched = false;
+    }
+
+    if (prefetched) {
+        ++_prefetchHits;
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    } else {
+        recording = load(source, cacheFile(source), hash);
+    }
+
+    recording->replay(visitor);
+}
+
+SGPath ProcedureCache::cacheFile(const SGPath& source) const
+{
+    // the same airport can come from several scenery paths (TerraSync,
+    // custom scenery), each copy gets a file of its own
+    const std::string path = source.realpath().utf8Str();
+    const std::string key = simgear::strutils::md5(path.data(), path.size()).substr(0, 8);
+    return globals->get_fg_home() / "ProcedureCache" / (source.file() + "_" + key + ".cache");
+}
+
+void ProcedureCache::prune()
+{
+    pruneDirectory(globals->get_fg_home() / "ProcedureCache");
+}
+
+void ProcedureCache::pruneDirectory(const SGPath& dir)
+{
+    if (!dir.isDir()) {
+        return;
+    }
+
+    // temporary files of writers in progress don't end in .cache
+    for (const auto& f : simgear::Dir(dir).children(simgear::Dir::TYPE_FILE)) {
+        if (!simgear::strutils::ends_with(f.file(), ".cache")) {
+            continue;
+        }
+
+        std::string source;
+        if (!Recording::readSource(f, source) || !SGPath::fromUtf8(source).exists()) {
+            SG_LOG(SG_NAVAID, SG_DEBUG, "removing procedure cache " << f);
+            SGPath(f).remove();
+        }
+    }
+}
+
+ProcedureCache::RecordingRef ProcedureCache::load(const SGPath& source, const SGPath& cachePath,
+                                                  std::string& hash)
+{
+    hash = SGFile(source).computeHash();
+    if (!hash.empty()) {
+        auto cached = std::make_shared<Recording>();
+        if (cached->read(cachePath, hash)) {
+            ++_cacheReads;
+            return cached;
+        }
+    }
+
+    auto recording = std::make_shared<Recording>();
+    recording->record(source);
+    ++_xmlReads;
+    if (!hash.empty()) {
+        recording->write(cachePath, hash, source);
+    }
+
+    return recording;
+}
+
+void ProcedureCache::runPrefetch()
+{
+    for (;;) {
+        std::pair<SGPath, SGPath> item;
+        SGPath pruneDir;
+        {
+            std::lock_guard<std::mutex> g(_lock);
+            if (_queue.empty() && _pruneDir.isNull()) {
+                _threadRunning = false;
+                return;
+            }
+
+            if (_queue.empty()) {
+                std::swap(pruneDir, _pruneDir);
+            } else {
+                item = _queue.front();
+                _queue.pop_front();
+            }
+        }
+
+        if (!pruneDir.isNull()) {
+            pruneDirectory(pruneDir);
+            continue;
+        }
+
+        RecordingRef recording;
+        std::string hash;
+        std::exception_ptr error;
+        try {
+            recording = load(item.first, item.second, hash);
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        {
+            std::lock_guard<std::mutex> g(_lock);
+            auto it = _prefetched.find(item.first.utf8Str());
+            if ((it != _prefetched.end()) && it->second.discarded) {
+                _prefetched.erase(it);
+            } else if (it != _prefetched.end()) {
+                Prefetched& p = it->second;
+                p.done = true;
+                p.recording = recording;
+                p.hash = hash;
+                p.error = error;
+            }
+        }
+        _prefetchDone.notify_all();
+    }
+}
+
+} // of namespace flightgear
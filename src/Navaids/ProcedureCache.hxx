@@ -0,0 +1,128 @@
+/*
+ * SPDX-FileName: ProcedureCache.hxx
+ * SPDX-FileComment: background loading and binary cache of procedures files
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <simgear/misc/sg_path.hxx>
+
+class FGAirport;
+class XMLVisitor;
+
+namespace flightgear {
+
+/**
+ * Reads the ICAO.procedures.xml files behind FGAirport's SIDs, STARs and
+ * approaches.
+ *
+ * Parsing the XML is the slow part, and doesn't need the airport, so it
+ * is done apart from building the procedures: a file is parsed into the
+ * sequence of its elements, attributes and text, which is replayed into
+ * a NavdataVisitor on the main thread. The sequence is stored in
+ * $FG_HOME/ProcedureCache along with the SHA-1 and the path of the file,
+ * and used instead of the XML while the hash matches. Cache files whose
+ * source is gone are pruned once per session.
+ *
+ * prefetch() reads the files of airports a flight plan is about to need
+ * on a worker thread; read() waits for a pending prefetch of the file
+ * rather than reading it twice, and checks the file didn't change since.
+ * Prefetches which aren't read are discarded when the flight plan ends.
+ *
+ * Except for the worker thread, use from the main thread only.
+ */
+class ProcedureCache
+{
+public:
+    static ProcedureCache* instance();
+
+    ~ProcedureCache();
+
+    /// start reading the procedures of an airport, unless they're loaded
+    void prefetch(const FGAirport* apt);
+    void prefetch(const SGPath& source);
+
+    /// drop a prefetch which won't be read, see FlightPlan::finish()
+    void discardPrefetch(const FGAirport* apt);
+    void discardPrefetch(const SGPath& source);
+
+    /**
+     * Replay a procedures file into a visitor, from a prefetch, the binary
+     * cache, or the XML. Throws as readXML() does if the file is invalid.
+     */
+    void read(const SGPath& source, XMLVisitor& visitor);
+
+    /// where the cached form of a procedures file is stored
+    SGPath cacheFile(const SGPath& source) const;
+
+    /**
+     * Remove the cache files whose source no longer exists, or which have
+     * an older layout. The worker thread does this once its first queue
+     * is done.
+     */
+    void prune();
+
+    /// files parsed from XML, on either thread
+    uint64_t xmlReads() const
+    { return _xmlReads; }
+
+    /// files read from the binary cache, on either thread
+    uint64_t cacheReads() const
+    { return _cacheReads; }
+
+    /// read() calls answered by a prefetch
+    uint64_t prefetchHits() const
+    { return _prefetchHits; }
+
+    /// prefetches pending or kept for read()
+    size_t prefetchCount() const;
+
+private:
+    ProcedureCache() = default;
+
+    class Recording;
+    class PrefetchThread;
+    typedef std::shared_ptr<const Recording> RecordingRef;
+
+    struct Prefetched {
+        bool done = false;
+        bool discarded = false; ///< drop the result once done
+        RecordingRef recording;
+        std::string hash; ///< of the source when it was read
+        std::exception_ptr error;
+    };
+
+    /// hash the source, and use the cache file or parse and write it
+    RecordingRef load(const SGPath& source, const SGPath& cachePath, std::string& hash);
+
+    static void pruneDirectory(const SGPath& dir);
+
+    /// worker thread body: load queued files until there are none left
+    void runPrefetch();
+
+    mutable std::mutex _lock;
+    std::condition_variable _prefetchDone;
+    std::deque<std::pair<SGPath, SGPath>> _queue; ///< source, cache file
+    std::map<std::string, Prefetched> _prefetched; ///< by source path
+    std::unique_ptr<PrefetchThread> _thread;
+    bool _threadRunning = false;
+    bool _pruneScheduled = false;
+    SGPath _pruneDir; ///< for the worker thread, once its queue is empty
+
+    std::atomic<uint64_t> _xmlReads{0};
+    std::atomic<uint64_t> _cacheReads{0};
+    std::atomic<uint64_t> _prefetchHits{0};
+};
+
+} // of namespace flightgear
@@ -24,12 +24,16 @@
 #endif
 
 #include "SHPParser.hxx"
+#include "BinaryCacheFile.hxx"
 
 #include <simgear/debug/logstream.hxx>
 #include <simgear/structure/exception.hxx>
 #include <simgear/misc/sg_path.hxx>
+#include <simgear/misc/strutils.hxx>
 #include <simgear/io/lowlevel.hxx>
 
+#include <Main/globals.hxx>
+
 // http://www.esri.com/library/whitepapers/pdfs/shapefile.pdf table 1
 const int SHP_FILE_MAGIC = 9994;
 const int SHP_FILE_VERSION = 1000;
@@ -41,6 +45,23 @@ const int SHP_POLYGON_TYPE = 5;
 namespace
 {
 
+const char CACHE_MAGIC[8] = {'F', 'G', 'P', 'O', 'L', 'Y', 'D', 'B'};
+const uint32_t CACHE_VERSION = 1;
+
+// followed by each line: its cartesian box as six doubles, then the
+// number of points and the lon/lat pairs of each level. A simplified
+// level with no points is the same as the level before it.
+struct CacheHeader
+{
+    flightgear::BinaryCacheHeader common;
+    int32_t type;
+    uint32_t closed;
+    int64_t sourceSize;
+    int64_t sourceModTime;
+    uint32_t numLevels;
+    uint32_t numLines;
+};
+
 void sgReadIntBE ( gzFile fd, int& var )
 {
     if ( gzread ( fd, &var, sizeof(int) ) != sizeof(int) ) {
@@ -83,6 +104,128 @@ void parseSHPPoints2D(gzFile fd, int numPoints, flightgear::SGGeodVec& aPoints)
     }
 }
 
+CacheHeader cacheHeaderFor(const SGPath& aPath, flightgear::PolyLine::Type aTy, bool aClosed)
+{
+    CacheHeader header;
+    header.common.init(CACHE_MAGIC, CACHE_VERSION);
+    header.type = aTy;
+    header.closed = aClosed;
+    header.sourceSize = aPath.sizeInBytes();
+    header.sourceModTime = aPath.modTime();
+    header.numLevels = flightgear::PolyLine::NUM_SIMPLIFIED_LEVELS + 1;
+    header.numLines = 0;
+    return header;
+}
+
+bool readCache(const SGPath& aCachePath, const CacheHeader& aExpected, flightgear::PolyLineList& aResult)
+{
+    using flightgear::PolyLine;
+
+    std::string data;
+    if (!flightgear::readBinaryCacheFile(aCachePath, data)) {
+        return false;
+    }
+
+    flightgear::BinaryCacheReader reader(data);
+    CacheHeader header;
+    if (!reader.get(&header, sizeof(header)) ||
+        !header.common.matches(CACHE_MAGIC, CACHE_VERSION) ||
+        (header.numLevels != aExpected.numLevels)) {
+        SG_LOG(SG_NAVAID, SG_WARN, "ignoring incompatible shape file cache " << aCachePath);
+        return false;
+    }
+
+    if ((header.type != aExpected.type) || (header.closed != aExpected.closed) ||
+        (header.sourceSize != aExpected.sourceSize) ||
+        (header.sourceModTime != aExpected.sourceModTime)) {
+        SG_LOG(SG_NAVAID, SG_DEBUG, "shape file cache " << aCachePath << " is out of date");
+        return false;
+    }
+
+    // counts beyond the file size can only come from a damaged file
+    if (header.numLines > data.size()) {
+        return false;
+    }
+
+    const auto ty = static_cast<PolyLine::Type>(header.type);
+    flightgear::PolyLineList lines;
+    lines.reserve(header.numLines);
+    std::vector<flightgear::SGGeodVec> levels(header.numLevels);
+    std::vector<double> lonLats;
+
+    for (uint32_t l = 0; l < header.numLines; ++l) {
+        double box[6];
+        if (!reader.get(box, sizeof(box))) {
+            return false;
+        }
+
+        for (auto& points : levels) {
+            uint32_t numPoints = 0;
+            if (!reader.get(&numPoints, sizeof(numPoints)) ||
+                (numPoints > (reader.remaining() / (2 * sizeof(double))))) {
+                return false;
+            }
+
+            lonLats.resize(numPoints * 2);
+            if (numPoints > 0) {
+                reader.get(lonLats.data(), lonLats.size() * sizeof(double));
+            }
+
+            points.clear();
+            points.reserve(numPoints);
+            for (uint32_t i = 0; i < numPoints; ++i) {
+                points.push_back(SGGeod::fromDeg(lonLats[i * 2], lonLats[(i * 2) + 1]));
+            }
+        }
+
+        if (levels.front().size() < 2) {
+            return false;
+        }
+
+        const SGBoxd cartBox(SGVec3d(box[0], box[1], box[2]), SGVec3d(box[3], box[4], box[5]));
+        lines.push_back(PolyLine::createWithLevels(ty, levels, cartBox));
+    }
+
+    aResult.insert(aResult.end(), lines.begin(), lines.end());
+    return true;
+}
+
+bool writeCache(const SGPath& aCachePath, CacheHeader aHeader, const flightgear::PolyLineList& aLines)
+{
+    flightgear::BinaryCacheWriter w(aCachePath);
+    if (!w.isOpen()) {
+        return false;
+    }
+
+    aHeader.numLines = static_cast<uint32_t>(aLines.size());
+    w.write(&aHeader, sizeof(aHeader));
+
+    std::vector<double> lonLats;
+    for (const auto& line : aLines) {
+        const SGBoxd cartBox = line->cartesianBox();
+        const double box[6] = {cartBox.getMin().x(), cartBox.getMin().y(), cartBox.getMin().z(),
+                               cartBox.getMax().x(), cartBox.getMax().y(), cartBox.getMax().z()};
+        w.write(box, sizeof(box));
+
+        for (uint32_t level = 0; level < aHeader.numLevels; ++level) {
+            const auto simplified = line->simplified(level);
+            lonLats.clear();
+            if ((level == 0) || (simplified.get() != line->simplified(level - 1).get())) {
+                for (const auto& g : simplified->points()) {
+                    lonLats.push_back(g.getLongitudeDeg());
+                    lonLats.push_back(g.getLatitudeDeg());
+                }
+            }
+
+            const uint32_t numPoints = static_cast<uint32_t>(lonLats.size() / 2);
+            w.write(&numPoints, sizeof(numPoints));
+            w.write(lonLats.data(), lonLats.size() * sizeof(double));
+        }
+    }
+
+    return w.commit();
+}
+
 } // anonymous namespace
 
 namespace flightgear
@@ -191,6 +334,31 @@ void SHPParser::parsePolyLines(const SGPath& aPath, PolyLine::Type aTy,
         gzclose(file);
         throw e; // rethrow
     }
+
+    gzclose(file);
+}
+
+void SHPParser::loadPolyLines(const SGPath& aPath, PolyLine::Type aTy,
+                              PolyLineList& aResult, bool aClosed)
+{
+    const SGPath cachePath = cacheFile(aPath);
+    const CacheHeader header = cacheHeaderFor(aPath, aTy, aClosed);
+    if (readCache(cachePath, header, aResult)) {
+        return;
+    }
+
+    PolyLineList lines;
+    parsePolyLines(aPath, aTy, lines, aClosed);
+    writeCache(cachePath, header, lines);
+    aResult.insert(aResult.end(), lines.begin(), lines.end());
+}
+
+SGPath SHPParser::cacheFile(const SGPath& aPath)
+{
+    // shape files in different scenery paths often share a name
+    const std::string path = aPath.realpath().utf8Str();
+    const std::string key = simgear::strutils::md5(path.data(), path.size()).substr(0, 8);
+    return globals->get_fg_home() / "PolyLineCache" / (aPath.file() + "_" + key + ".cache");
 }
 
 } // of namespace flightgear
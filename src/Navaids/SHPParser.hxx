@@ -39,6 +39,21 @@ public:
      * Throws sg_exceptions if parsing problems occur.
      */
     static void parsePolyLines(const SGPath&, PolyLine::Type aTy, PolyLineList& aResult, bool aClosed);
+
+    /**
+     * As parsePolyLines, but through a binary cache of the chunked and
+     * simplified lines, which is rebuilt when the size or modification
+     * time of the shape file changes.
+     *
+     * Doesn't touch the spatial index, so it can run on a worker thread;
+     * add the lines on the main thread with PolyLine::bulkAddToSpatialIndex.
+     */
+    static void loadPolyLines(const SGPath&, PolyLine::Type aTy, PolyLineList& aResult, bool aClosed);
+
+    /**
+     * where loadPolyLines() caches the lines of a shape file
+     */
+    static SGPath cacheFile(const SGPath&);
 };
 
 } // of namespace flightgear
@@ -0,0 +1,194 @@
+/*
+ * SPDX-FileName: SpatialQueryCache.cxx
+ * SPDX-FileComment: shared cache of spatial query results for FGPositioned
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#include "SpatialQueryCache.hxx"
+
+#include <algorithm>
+
+#include <Navaids/PositionedOctree.hxx>
+
+namespace {
+
+const size_t MAX_ENTRIES = 8;
+
+// entries are searched this much further than asked for, so a display
+// following a moving centre keeps hitting them for a while
+const double SEARCH_MARGIN = 0.25;
+
+/**
+ * the type range of a filter, without its pass(): the leaves select the
+ * types, the stored items are shared between filters
+ */
+class TypeRangeFilter : public FGPositioned::Filter
+{
+public:
+    TypeRangeFilter(FGPositioned::Type aMin, FGPositioned::Type aMax) : _min(aMin),
+                                                                      _max(aMax)
+    {
+    }
+
+    FGPositioned::Type minType() const override
+    { return _min; }
+
+    FGPositioned::Type maxType() const override
+    { return _max; }
+
+private:
+    const FGPositioned::Type _min, _max;
+};
+
+} // of anonymous namespace
+
+namespace flightgear {
+
+SpatialQueryCache* SpatialQueryCache::instance()
+{
+    static SpatialQueryCache static_instance;
+    return &static_instance;
+}
+
+bool SpatialQueryCache::findWithinRange(const SGVec3d& aPos, double aRangeM, FGPositioned::Filter* aFilter,
+                                        FGPositionedList& aResults, int aCutoffMsec)
+{
+    aResults.clear();
+    bool partial = false;
+    // the filter may well run queries of its own
+    const ItemsRef items = candidates(aPos, aRangeM, aFilter, partial, aCutoffMsec);
+
+    Octree::FindNearestResults ordered;
+    for (const auto& p : *items) {
+        const double d = dist(aPos, p->cart());
+        if ((d > aRangeM) || !aFilter->pass(p)) {
+            continue;
+        }
+
+        ordered.push_back(Octree::OrderedPositioned(p.get(), d));
+    }
+
+    std::sort(ordered.begin(), ordered.end());
+    aResults.reserve(ordered.size());
+    for (const auto& o : ordered) {
+        aResults.push_back(o.get());
+    }
+
+    return partial;
+}
+
+bool SpatialQueryCache::findNearestN(const SGVec3d& aPos, unsigned int aN, double aCutoffM, FGPositioned::Filter* aFilter,
+                                     FGPositionedList& aResults, int aCutoffMsec)
+{
+    // filling an entry would search the whole cutoff range, the octree
+    // search stops once it has found aN items
+    if (!findCovering(aFilter->minType(), aFilter->maxType(), aPos, aCutoffM)) {
+        return Octree::findNearestN(aPos, aN, aCutoffM, aFilter, aResults, aCutoffMsec);
+    }
+
+    const bool partial = findWithinRange(aPos, aCutoffM, aFilter, aResults, aCutoffMsec);
+    if (aResults.size() > aN) {
+        aResults.resize(aN);
+    }
+
+    return partial;
+}
+
+void SpatialQueryCache::clear()
+{
+    _entries.clear();
+}
+
+SpatialQueryCache::Entry* SpatialQueryCache::findCovering(FGPositioned::Type minType, FGPositioned::Type maxType,
+                                                          const SGVec3d& aPos, double aRangeM)
+{
+    for (auto& e : _entries) {
+        if ((e.minType == minType) && (e.maxType == maxType) &&
+            ((dist(aPos, e.centre) + aRangeM) <= e.rangeM)) {
+            return &e;
+        }
+    }
+
+    return nullptr;
+}
+
+SpatialQueryCache::ItemsRef SpatialQueryCache::candidates(const SGVec3d& aPos, double aRangeM,
+                                                          FGPositioned::Filter* aFilter,
+                                                          bool& aPartial, int aCutoffMsec)
+{
+    const auto minType = aFilter->minType(), maxType = aFilter->maxType();
+    ++_tick;
+
+    Entry* covering = findCovering(minType, maxType, aPos, aRangeM);
+    if (covering) {
+        ++_hits;
+        covering->lastUsed = _tick;
+        return covering->items;
+    }
+
+    ++_misses;
+    Entry* overlapping = nullptr;
+    for (auto& e : _entries) {
+        if ((e.minType == minType) && (e.maxType == maxType) &&
+            (dist(aPos, e.centre) < (e.rangeM + aRangeM))) {
+            overlapping = &e;
+            break;
+        }
+    }
+
+    const double searchRangeM = aRangeM * (1.0 + SEARCH_MARGIN);
+    TypeRangeFilter typeFilter(minType, maxType);
+    FGPositionedList found;
+    FGPositionedList items;
+
+    if (overlapping) {
+        aPartial = Octree::findAllWithinRangeOutside(aPos, searchRangeM,
+                                                     overlapping->centre, overlapping->rangeM,
+                                                     &typeFilter, found, aCutoffMsec);
+
+        // keep what is still in range, and add what the old entry didn't cover
+        for (const auto& p : *overlapping->items) {
+            if (dist(aPos, p->cart()) <= searchRangeM) {
+                items.push_back(p);
+            }
+        }
+
+        for (const auto& p : found) {
+            if (dist(overlapping->centre, p->cart()) > overlapping->rangeM) {
+                items.push_back(p);
+            }
+        }
+    } else {
+        aPartial = Octree::findAllWithinRange(aPos, searchRangeM, &typeFilter, found, aCutoffMsec);
+        items.swap(found);
+    }
+
+    auto result = std::make_shared<const FGPositionedList>(std::move(items));
+    if (aPartial) {
+        // an incomplete search can't answer later queries
+        return result;
+    }
+
+    Entry* entry = overlapping;
+    if (entry) {
+        ++_incrementalUpdates;
+    } else if (_entries.size() < MAX_ENTRIES) {
+        _entries.push_back(Entry());
+        entry = &_entries.back();
+    } else {
+        entry = &(*std::min_element(_entries.begin(), _entries.end(),
+                                    [](const Entry& a, const Entry& b) { return a.lastUsed < b.lastUsed; }));
+    }
+
+    entry->minType = minType;
+    entry->maxType = maxType;
+    entry->centre = aPos;
+    entry->rangeM = searchRangeM;
+    entry->items = result;
+    entry->lastUsed = _tick;
+    return result;
+}
+
+} // of namespace flightgear
@@ -0,0 +1,96 @@
+/*
+ * SPDX-FileName: SpatialQueryCache.hxx
+ * SPDX-FileComment: shared cache of spatial query results for FGPositioned
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <simgear/math/SGMath.hxx>
+
+#include <Navaids/positioned.hxx>
+
+namespace flightgear {
+
+/**
+ * Results of the range searches behind FGPositioned::findWithinRange and
+ * findClosestN, shared by everything querying the same area: the map
+ * widget, the ND, the GPS and the Canvas map layers all ask for nearly the
+ * same centre and range many times a second.
+ *
+ * An entry holds the items of a type range within a sphere, searched a
+ * little larger than asked for. Any query for the same types whose sphere
+ * lies inside an entry's is answered from it, applying the caller's filter
+ * and the exact range to the stored items. When the centre moves out of
+ * the entry, only the octree nodes not inside the old sphere are searched,
+ * and the items which left it are dropped.
+ *
+ * Entries are dropped whenever an item is added, removed or moved. Like
+ * the octree, this is only to be used from the main thread.
+ */
+class SpatialQueryCache
+{
+public:
+    static SpatialQueryCache* instance();
+
+    /**
+     * the items within aRangeM of aPos which pass aFilter, nearest first
+     * @return true if the search ran out of time, the results are partial
+     */
+    bool findWithinRange(const SGVec3d& aPos, double aRangeM, FGPositioned::Filter* aFilter,
+                         FGPositionedList& aResults, int aCutoffMsec);
+
+    /**
+     * the aN items nearest to aPos within aCutoffM, from an entry if one
+     * covers the query; never creates or extends entries.
+     * @return true if the search ran out of time, the results are partial
+     */
+    bool findNearestN(const SGVec3d& aPos, unsigned int aN, double aCutoffM, FGPositioned::Filter* aFilter,
+                      FGPositionedList& aResults, int aCutoffMsec);
+
+    void clear();
+
+    uint64_t hits() const
+    { return _hits; }
+
+    uint64_t misses() const
+    { return _misses; }
+
+    /// misses answered by extending an overlapping entry
+    uint64_t incrementalUpdates() const
+    { return _incrementalUpdates; }
+
+private:
+    typedef std::shared_ptr<const FGPositionedList> ItemsRef;
+
+    struct Entry {
+        FGPositioned::Type minType;
+        FGPositioned::Type maxType;
+        SGVec3d centre;
+        double rangeM;
+        ItemsRef items; ///< shared, so a query can outlive a clear()
+        uint64_t lastUsed;
+    };
+
+    Entry* findCovering(FGPositioned::Type minType, FGPositioned::Type maxType,
+                        const SGVec3d& aPos, double aRangeM);
+
+    /**
+     * the candidates for a query, from an entry or from a search. Results
+     * of a search which ran out of time aren't cached.
+     */
+    ItemsRef candidates(const SGVec3d& aPos, double aRangeM, FGPositioned::Filter* aFilter,
+                        bool& aPartial, int aCutoffMsec);
+
+    std::vector<Entry> _entries;
+    uint64_t _tick = 0;
+    uint64_t _hits = 0;
+    uint64_t _misses = 0;
+    uint64_t _incrementalUpdates = 0;
+};
+
+} // of namespace flightgear
@@ -23,7 +23,8 @@
 
 #include <tuple>
 #include <algorithm>
-#include <set>
+#include <limits>
+#include <unordered_map>
 
 #include <simgear/sg_inlines.h>
 #include <simgear/structure/exception.hxx>
@@ -37,7 +38,6 @@
 
 using std::make_pair;
 using std::string;
-using std::set;
 using std::vector;
 
 //#define DEBUG_AWY_SEARCH 1
@@ -50,46 +50,214 @@ typedef SGSharedPtr<FGPositioned> FGPositionedRef;
 
 //////////////////////////////////////////////////////////////////////////////
 
-class AStarOpenNode : public SGReferenced
+/**
+ * One airway network as a compressed sparse row adjacency graph. Nodes are
+ * numbered densely in the order they are first seen; the edges leaving
+ * node i are [firstEdge[i], firstEdge[i + 1]) in the edge arrays. Each
+ * edge in the cache is stored in both directions, as airwayEdgesFrom()
+ * returns them.
+ *
+ * The per-search arrays are kept here too, so a search only has to reset
+ * them instead of allocating.
+ */
+class AirwayGraph
 {
 public:
-  AStarOpenNode(FGPositionedRef aNode, double aLegDist, 
-    int aAirway,
-    FGPositionedRef aDest, AStarOpenNode* aPrev) :
-    node(aNode),
-    previous(aPrev),
-    airway(aAirway)
-  { 
-    distanceFromStart = aLegDist;
-    if (previous) {
-      distanceFromStart +=  previous->distanceFromStart;
+  void load(Airway::Level network);
+
+  /// dense index of a positioned, or -1 if it's not on the network
+  int indexOf(PositionedID id) const
+  {
+    auto it = _index.find(id);
+    return (it == _index.end()) ? -1 : it->second;
+  }
+
+  size_t size() const
+  { return ids.size(); }
+
+  std::vector<PositionedID> ids;
+  std::vector<SGVec3d> carts;
+  std::vector<unsigned int> firstEdge;
+  std::vector<unsigned int> edgeTarget;
+  std::vector<int> edgeAirway;
+  std::vector<double> edgeLengthM;
+
+  // search state, indexed by node
+  std::vector<double> distanceFromStart; // aka 'g(x)'
+  std::vector<int> previous;
+  std::vector<int> previousAirway;
+  std::vector<bool> closed;
+
+private:
+  std::unordered_map<PositionedID, int> _index;
+};
+
+void AirwayGraph::load(Airway::Level network)
+{
+  NavDataCache* cache = NavDataCache::instance();
+  const AirwayNetworkEdgeVec edges = cache->airwayNetworkEdges(network);
+
+  std::vector<SGGeod> geods;
+  auto addNode = [this, &geods](PositionedID id, const SGVec3d& cart) {
+    auto it = _index.find(id);
+    if (it != _index.end()) {
+      return it->second;
     }
-    
-		directDistanceToDestination = SGGeodesy::distanceM(node->geod(), aDest->geod());
+
+    const int i = static_cast<int>(ids.size());
+    _index.emplace(id, i);
+    ids.push_back(id);
+    carts.push_back(cart);
+    geods.push_back(SGGeod::fromCart(cart));
+    return i;
+  };
+
+  std::vector<std::pair<int, int>> ends;
+  std::vector<int> airways;
+  ends.reserve(edges.size());
+  airways.reserve(edges.size());
+  for (const auto& e : edges) {
+    SGVec3d fromCart = e.fromCart, toCart = e.toCart;
+    if (!e.haveCarts) {
+      FGPositionedRef from = cache->loadById(e.from), to = cache->loadById(e.to);
+      if (!from || !to) {
+        continue;
+      }
+      fromCart = from->cart();
+      toCart = to->cart();
+    }
+
+    ends.emplace_back(addNode(e.from, fromCart), addNode(e.to, toCart));
+    airways.push_back(e.airway);
   }
-  
-  virtual ~AStarOpenNode()
+
+  // count the degree of each node, then place the edges
+  firstEdge.assign(ids.size() + 1, 0);
+  for (const auto& e : ends) {
+    ++firstEdge[e.first + 1];
+    ++firstEdge[e.second + 1];
+  }
+  for (size_t i = 1; i < firstEdge.size(); ++i) {
+    firstEdge[i] += firstEdge[i - 1];
+  }
+
+  edgeTarget.resize(2 * ends.size());
+  edgeAirway.resize(2 * ends.size());
+  edgeLengthM.resize(2 * ends.size());
+  std::vector<unsigned int> fill(firstEdge.begin(), firstEdge.end() - 1);
+  for (size_t i = 0; i < ends.size(); ++i) {
+    const int a = ends[i].first, b = ends[i].second;
+    const double lengthM = SGGeodesy::distanceM(geods[a], geods[b]);
+    for (auto dir : {std::make_pair(a, b), std::make_pair(b, a)}) {
+      const unsigned int slot = fill[dir.first]++;
+      edgeTarget[slot] = dir.second;
+      edgeAirway[slot] = airways[i];
+      edgeLengthM[slot] = lengthM;
+    }
+  }
+
+  SG_LOG(SG_NAVAID, SG_DEBUG, "loaded airway network " << network << ": " << ids.size()
+         << " nodes, " << edgeTarget.size() << " edges");
+}
+
+/**
+ * Binary min-heap of open node indices keyed on f(x), with the position of
+ * each node in the heap, so that membership tests and decreasing a key
+ * don't need to search the heap.
+ */
+class OpenNodeHeap
+{
+public:
+  void reset(size_t nodeCount)
   {
+    _heap.clear();
+    _pos.assign(nodeCount, -1);
+  }
+
+  bool empty() const
+  { return _heap.empty(); }
+
+  bool contains(int node) const
+  { return _pos[node] >= 0; }
+
+  /// insert node, or move it up if it is already open
+  void push(int node, double cost)
+  {
+    int i = _pos[node];
+    if (i < 0) {
+      i = static_cast<int>(_heap.size());
+      _heap.emplace_back(cost, node);
+    } else {
+      _heap[i].first = cost;
+    }
+    siftUp(i);
+  }
+
+  int pop()
+  {
+    const int node = _heap.front().second;
+    _pos[node] = -1;
+    _heap.front() = _heap.back();
+    _heap.pop_back();
+    if (!_heap.empty()) {
+      _pos[_heap.front().second] = 0;
+      siftDown(0);
+    }
+    return node;
+  }
+
+private:
+  void place(int i, const std::pair<double, int>& entry)
+  {
+    _heap[i] = entry;
+    _pos[entry.second] = i;
+  }
+
+  void siftUp(int i)
+  {
+    const auto entry = _heap[i];
+    while (i > 0) {
+      const int parent = (i - 1) / 2;
+      if (_heap[parent].first <= entry.first) {
+        break;
+      }
+      place(i, _heap[parent]);
+      i = parent;
+    }
+    place(i, entry);
+  }
+
+  void siftDown(int i)
+  {
+    const auto entry = _heap[i];
+    const int count = static_cast<int>(_heap.size());
+    for (;;) {
+      int child = 2 * i + 1;
+      if (child >= count) {
+        break;
+      }
+      if ((child + 1 < count) && (_heap[child + 1].first < _heap[child].first)) {
+        ++child;
+      }
+      if (entry.first <= _heap[child].first) {
+        break;
+      }
+      place(i, _heap[child]);
+      i = child;
+    }
+    place(i, entry);
   }
-  
-  FGPositionedRef node;
-  SGSharedPtr<AStarOpenNode> previous;
-  int airway;
-  double distanceFromStart; // aka 'g(x)'
-  double directDistanceToDestination; // aka 'h(x)'
-  
-  /**
-	 * aka 'f(x)'
-	 */
-	double totalCost() const {
-		return distanceFromStart + directDistanceToDestination;
-	}
-};
 
-using AStarOpenNodeRef = SGSharedPtr<AStarOpenNode>;
+  std::vector<std::pair<double, int>> _heap;
+  std::vector<int> _pos;
+};
 
 ////////////////////////////////////////////////////////////////////////////
 
+Airway::Network::Network() = default;
+
+Airway::Network::~Network() = default;
+
 Airway::Network* Airway::lowLevel()
 {
   static Network* static_lowLevel = nullptr;
@@ -113,6 +281,15 @@ Airway::Network* Airway::highLevel()
   return static_highLevel;
 }
 
+void Airway::clearCache()
+{
+  static_airwaysCache.clear();
+  for (Network* net : {lowLevel(), highLevel()}) {
+    net->_graph.reset();
+    net->_inNetworkCache.clear();
+  }
+}
+
 Airway::Airway(const std::string& aIdent,
                const Level level,
                int dbId,
@@ -431,6 +608,7 @@ void Airway::Network::addEdge(int aWay, const SGGeod& aStartPos,
   }
   
   NavDataCache::instance()->insertEdge(_networkID, aWay, start->guid(), end->guid());
+  _graph.reset();
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -444,6 +622,10 @@ static double headingDiffDeg(double a, double b)
     
 bool Airway::Network::inNetwork(PositionedID posID) const
 {
+  if (_graph) {
+    return _graph->indexOf(posID) >= 0;
+  }
+
   NetworkMembershipDict::iterator it = _inNetworkCache.find(posID);
   if (it != _inNetworkCache.end()) {
     return it->second; // cached, easy
@@ -581,21 +763,29 @@ Airway::Network::findNodeByIdent(const std::string& ident, const SGGeod& near) c
 
 /////////////////////////////////////////////////////////////////////////////
 
-typedef vector<AStarOpenNodeRef> OpenNodeHeap;
+AirwayGraph& Airway::Network::graph() const
+{
+  if (!_graph) {
+    _graph.reset(new AirwayGraph);
+    _graph->load(_networkID);
+  }
+
+  return *_graph;
+}
 
-static void buildWaypoints(AStarOpenNodeRef aNode, WayptVec& aRoute)
+static void buildWaypoints(const AirwayGraph& aGraph, int aNode, WayptVec& aRoute)
 {
 // count the route length, and hence pre-size aRoute
   size_t count = 0;
-  AStarOpenNodeRef n = aNode;
-  for (; n != nullptr; ++count, n = n->previous) {;}
+  for (int n = aNode; n >= 0; ++count, n = aGraph.previous[n]) {;}
   aRoute.resize(count);
-  
+
 // run over the route, creating waypoints
-  for (n = aNode; n; n=n->previous) {
+  NavDataCache* cache = NavDataCache::instance();
+  for (int n = aNode; n >= 0; n = aGraph.previous[n]) {
       // get / create airway to be the owner for this waypoint
-      AirwayRef awy = Airway::loadByCacheId(n->airway);
-      auto wp = new NavaidWaypoint(n->node, awy);
+      AirwayRef awy = Airway::loadByCacheId(aGraph.previousAirway[n]);
+      auto wp = new NavaidWaypoint(cache->loadById(aGraph.ids[n]), awy);
       if (awy) {
           wp->setFlag(WPT_VIA);
       }
@@ -604,101 +794,79 @@ static void buildWaypoints(AStarOpenNodeRef aNode, WayptVec& aRoute)
   }
 }
 
-/**
- * Inefficent (linear) helper to find an open node in the heap
- */
-static AStarOpenNodeRef
-findInOpen(const OpenNodeHeap& aHeap, FGPositioned* aPos)
+bool Airway::Network::search2(FGPositionedRef aStart, FGPositionedRef aDest,
+  WayptVec& aRoute)
 {
-  for (unsigned int i=0; i<aHeap.size(); ++i) {
-    if (aHeap[i]->node == aPos) {
-      return aHeap[i];
-    }
+  AirwayGraph& g = graph();
+  const int start = g.indexOf(aStart->guid());
+  const int dest = g.indexOf(aDest->guid());
+
+  if (aStart == aDest) {
+    auto wp = new NavaidWaypoint(aStart, nullptr);
+    wp->setFlag(WPT_GENERATED);
+    aRoute.assign(1, WayptRef(wp));
+    return true;
   }
-  
-  return nullptr;
-}
 
-class HeapOrder
-{
-public:
-  bool operator()(AStarOpenNode* a, AStarOpenNode* b)
-  {
-    return a->totalCost() > b->totalCost();
+  if ((start < 0) || (dest < 0)) {
+    SG_LOG(SG_NAVAID, SG_INFO, "A* failed to find route: end point not on the airway network");
+    return false;
   }
-};
 
-bool Airway::Network::search2(FGPositionedRef aStart, FGPositionedRef aDest,
-  WayptVec& aRoute)
-{  
-  typedef set<PositionedID> ClosedNodeSet;
-  
+  // straight line distance, never more than the distance along the
+  // surface, so this is a consistent heuristic - aka 'h(x)'
+  const SGVec3d destCart = g.carts[dest];
+  auto directDistanceToDestination = [&g, &destCart](int node) {
+    return dist(g.carts[node], destCart);
+  };
+
+  const size_t n = g.size();
+  g.distanceFromStart.assign(n, std::numeric_limits<double>::max());
+  g.previous.assign(n, -1);
+  g.previousAirway.assign(n, 0);
+  g.closed.assign(n, false);
+
   OpenNodeHeap openNodes;
-  ClosedNodeSet closedNodes;
-  HeapOrder ordering;
-  
-  openNodes.push_back(new AStarOpenNode(aStart, 0.0, 0, aDest, nullptr));
-  
+  openNodes.reset(n);
+  g.distanceFromStart[start] = 0.0;
+  openNodes.push(start, directDistanceToDestination(start));
+
 // A* open node iteration
   while (!openNodes.empty()) {
-    std::pop_heap(openNodes.begin(), openNodes.end(), ordering);
-    AStarOpenNodeRef x = openNodes.back();
-    FGPositioned* xp = x->node;    
-    openNodes.pop_back();
-    closedNodes.insert(xp->guid());
-  
+    const int x = openNodes.pop();
+    g.closed[x] = true;
+
 #ifdef DEBUG_AWY_SEARCH
-    SG_LOG(SG_NAVAID, SG_INFO, "x:" << xp->ident() << ", f(x)=" << x->totalCost());
+    SG_LOG(SG_NAVAID, SG_INFO, "x:" << g.ids[x] << ", g(x)=" << g.distanceFromStart[x]);
 #endif
-    
-  // check if xp is the goal; if so we're done, since there cannot be an open
+
+  // check if x is the goal; if so we're done, since there cannot be an open
   // node with lower f(x) value.
-    if (xp == aDest) {
-      buildWaypoints(x, aRoute);
+    if (x == dest) {
+      buildWaypoints(g, x, aRoute);
       return true;
     }
-    
+
   // adjacent (neighbour) iteration
-    NavDataCache* cache = NavDataCache::instance();
-    for (auto other : cache->airwayEdgesFrom(_networkID, xp->guid())) {
-      if (closedNodes.count(other.second)) {
+    for (unsigned int e = g.firstEdge[x]; e < g.firstEdge[x + 1]; ++e) {
+      const int y = g.edgeTarget[e];
+      if (g.closed[y]) {
         continue; // closed, ignore
       }
 
-      FGPositioned* yp = cache->loadById(other.second);
-      double edgeDistanceM = SGGeodesy::distanceM(xp->geod(), yp->geod());
-      AStarOpenNodeRef y = findInOpen(openNodes, yp);
-      if (y) { // already open
-        double g = x->distanceFromStart + edgeDistanceM;
-        if (g > y->distanceFromStart) {
-          // worse path, ignore
-#ifdef DEBUG_AWY_SEARCH
-          SG_LOG(SG_NAVAID, SG_INFO, "\tabandoning " << yp->ident() <<
-           " path is worse: g(y)" << y->distanceFromStart << ", g'=" << g);
-#endif
-          continue;
-        }
-        
-      // we need to update y. Unfortunately this means rebuilding the heap,
-      // since y's score can change arbitrarily
-#ifdef DEBUG_AWY_SEARCH
-        SG_LOG(SG_NAVAID, SG_INFO, "\tfixing up previous for new path to " << yp->ident() << ", d =" << g);
-#endif
-        y->previous = x;
-        y->distanceFromStart = g;
-        y->airway = other.first;
-        std::make_heap(openNodes.begin(), openNodes.end(), ordering);
-      } else { // not open, insert a new node for y into the heap
-        y = new AStarOpenNode(yp, edgeDistanceM, other.first, aDest, x);
-#ifdef DEBUG_AWY_SEARCH
-        SG_LOG(SG_NAVAID, SG_INFO, "\ty=" << yp->ident() << ", f(y)=" << y->totalCost());
-#endif
-        openNodes.push_back(y);
-        std::push_heap(openNodes.begin(), openNodes.end(), ordering);
+      const double distance = g.distanceFromStart[x] + g.edgeLengthM[e];
+      if (openNodes.contains(y) && (distance > g.distanceFromStart[y])) {
+        // worse path, ignore
+        continue;
       }
+
+      g.distanceFromStart[y] = distance;
+      g.previous[y] = x;
+      g.previousAirway[y] = g.edgeAirway[e];
+      openNodes.push(y, distance + directDistanceToDestination(y));
     } // of neighbour iteration
   } // of open node iteration
-  
+
   SG_LOG(SG_NAVAID, SG_INFO, "A* failed to find route");
   return false;
 }
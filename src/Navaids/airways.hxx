@@ -21,6 +21,7 @@
 #define FG_AIRWAYS_HXX
 
 #include <map>
+#include <memory>
 #include <vector>
 
 #include <Navaids/route.hxx>
@@ -35,6 +36,7 @@ namespace flightgear {
 struct SearchContext;
 class AdjacentWaypoint;
 class InAirwayFilter;
+class AirwayGraph;
 class Airway;
 
 using AirwayRef = SGSharedPtr<Airway>;
@@ -102,7 +104,9 @@ public:
   public:
     friend class Airway;
     friend class InAirwayFilter;
-    
+
+    Network();
+    ~Network();
   
     /**
      * Principal routing algorithm. Attempts to find the best route beween
@@ -132,6 +136,12 @@ public:
                             bool exactTo, bool exactFrom);
       
     bool search2(FGPositionedRef aStart, FGPositionedRef aDest, WayptVec& aRoute);
+
+    /**
+     * the adjacency graph used by search2, loaded from the cache on first
+     * use and dropped when edges are added
+     */
+    AirwayGraph& graph() const;
   
     /**
      * Test if a positioned item is part of this airway network or not.
@@ -157,6 +167,8 @@ public:
      */
     typedef std::map<PositionedID, bool> NetworkMembershipDict;
     mutable NetworkMembershipDict _inNetworkCache;
+
+    mutable std::unique_ptr<AirwayGraph> _graph;
     
     Level _networkID;
   };
@@ -164,6 +176,12 @@ public:
 
   static Network* highLevel();
   static Network* lowLevel();
+
+  /**
+   * Forget the loaded airways and the networks' graphs, which hold cache
+   * row IDs. Called when the NavDataCache is rebuilt or closed.
+   */
+  static void clearCache();
   
 private:
   Airway(const std::string& aIdent, const Level level, int dbId, int aTop, int aBottom);
@@ -36,6 +36,7 @@
 
 #include <Navaids/navrecord.hxx>
 #include <Navaids/navdb.hxx>
+#include <Navaids/NavDataCache.hxx>
 #include <Airports/runways.hxx>
 #include <Airports/airport.hxx>
 #include <Airports/xmlloader.hxx>
@@ -236,13 +237,21 @@ void FGMobileNavRecord::updatePos()
   }
 
   if( _vehicle_node.valid() )
-    modifyPosition(SGGeod::fromDegFt(
+  {
+    const SGGeod pos = SGGeod::fromDegFt(
       _vehicle_node->getDoubleValue("position/longitude-deg"),
       _vehicle_node->getDoubleValue("position/latitude-deg"),
       _vehicle_node->getNameString() == "carrier"
       ? _initial_elevation_ft
       : _vehicle_node->getDoubleValue("position/altitude-ft")
-    ));
+    );
+    modifyPosition(pos);
+
+    // the radios find stations by frequency nearest first
+    auto cache = flightgear::NavDataCache::instance();
+    if( cache )
+      cache->updateFrequencyPosition(guid(), type(), SGVec3d::fromGeod(pos));
+  }
   else
     invalidatePosition();
 
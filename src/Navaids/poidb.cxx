@@ -6,7 +6,9 @@
 
 #include "config.h"
 
-#include <istream>              // std::ws
+#include <cctype>
+#include <cstdlib>
+#include <string>
 #include "poidb.hxx"
 
 #include <simgear/compiler.h>
@@ -34,7 +36,7 @@ mapPOITypeToFGPType(int aTy)
   case 1001: return FGPositioned::WAYPOINT;
 
   default:
-    throw sg_range_exception("Unknown POI type", "FGNavDataCache::readPOIFromStream");
+    throw sg_range_exception("Unknown POI type", "flightgear::readPOIFromLine");
   }
 }
 
@@ -43,33 +45,44 @@ namespace flightgear
 
     const int LINES_IN_POI_DAT = 769019;
 
-static PositionedID readPOIFromStream(std::istream& aStream, NavDataCache* cache,
-                                        FGPositioned::Type type = FGPositioned::INVALID)
+// parse one "type lat lon name" line, without going through stream
+// extraction for each field: poi.dat has three quarters of a million
+static PositionedID readPOIFromLine(const std::string& aLine, NavDataCache* cache,
+                                    FGPositioned::Type type = FGPositioned::INVALID)
 {
-    if (aStream.eof()) {
+    const char* p = aLine.c_str();
+    while (isspace(static_cast<unsigned char>(*p))) {
+        ++p;
+    }
+
+    if ((*p == '#') || (*p == 0)) {
         return 0;
     }
 
-    aStream >> std::ws;
-    if (aStream.peek() == '#') {
-        aStream >> skipeol;
+    // each field has to be there, otherwise the line is skipped rather than
+    // read as a point at 0,0
+    char* end;
+    const char* field = p;
+    const long rawType = strtol(field, &end, 10);
+    bool ok = (end != field);
+    field = end;
+    const double lat = strtod(field, &end);
+    ok = ok && (end != field);
+    field = end;
+    const double lon = strtod(field, &end);
+    ok = ok && (end != field);
+    if (!ok) {
+        SG_LOG(SG_NAVAID, SG_WARN, "poi.dat: skipping malformed line '" << aLine << "'");
         return 0;
     }
-    
-  int rawType;
-  aStream >> rawType;
-  double lat, lon;
-  std::string name;
-  aStream >> lat >> lon;
-  getline(aStream, name);
 
-  SGGeod pos(SGGeod::fromDeg(lon, lat));
-  name = simgear::strutils::strip(name);
+    const std::string name = simgear::strutils::strip(std::string(end));
+    SGGeod pos(SGGeod::fromDeg(lon, lat));
 
   // the type can be forced by our caller, but normally we use the value
   // supplied in the .dat file
   if (type == FGPositioned::INVALID) {
-    type = mapPOITypeToFGPType(rawType);
+    type = mapPOITypeToFGPType(static_cast<int>(rawType));
   }
   if (type == FGPositioned::INVALID) {
     return 0;
@@ -89,8 +102,9 @@ bool poiDBInit(const SGPath& path)
 
     unsigned int lineNumber = 0;
     NavDataCache* cache = NavDataCache::instance();
-    while (!in.eof()) {
-      readPOIFromStream(in, cache);
+    std::string line;
+    while (std::getline(in, line)) {
+      readPOIFromLine(line, cache);
 
         ++lineNumber;
         if ((lineNumber % 100) == 0) {
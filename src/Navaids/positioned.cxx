@@ -23,6 +23,7 @@
 #include <simgear/sg_inlines.h>
 
 #include "Navaids/PositionedOctree.hxx"
+#include "Navaids/SpatialQueryCache.hxx"
 
 using std::string;
 using namespace flightgear;
@@ -318,7 +319,7 @@ FGPositioned::findWithinRange(const SGGeod& aPos, double aRangeNm, Filter* aFilt
     }
     
   FGPositionedList result;
-  Octree::findAllWithinRange(SGVec3d::fromGeod(aPos), 
+  SpatialQueryCache::instance()->findWithinRange(SGVec3d::fromGeod(aPos),
     aRangeNm * SG_NM_TO_METER, aFilter, result, 0xffffff);
   return result;
 }
@@ -334,7 +335,7 @@ FGPositioned::findWithinRangePartial(const SGGeod& aPos, double aRangeNm, Filter
     
   int limitMsec = 32;
   FGPositionedList result;
-  aPartial = Octree::findAllWithinRange(SGVec3d::fromGeod(aPos),
+  aPartial = SpatialQueryCache::instance()->findWithinRange(SGVec3d::fromGeod(aPos),
                              aRangeNm * SG_NM_TO_METER, aFilter, result,
                                         limitMsec);
   return result;
@@ -385,7 +386,7 @@ FGPositioned::findClosestN(const SGGeod& aPos, unsigned int aN, double aCutoffNm
   
   FGPositionedList result;
   int limitMsec = 0xffff;
-  Octree::findNearestN(SGVec3d::fromGeod(aPos), aN, aCutoffNm * SG_NM_TO_METER, aFilter, result, limitMsec);
+  SpatialQueryCache::instance()->findNearestN(SGVec3d::fromGeod(aPos), aN, aCutoffNm * SG_NM_TO_METER, aFilter, result, limitMsec);
   return result;
 }
 
@@ -396,7 +397,7 @@ FGPositioned::findClosestNPartial(const SGGeod& aPos, unsigned int aN, double aC
     
     FGPositionedList result;
     int limitMsec = 32;
-    aPartial = Octree::findNearestN(SGVec3d::fromGeod(aPos), aN, aCutoffNm * SG_NM_TO_METER, aFilter, result,
+    aPartial = SpatialQueryCache::instance()->findNearestN(SGVec3d::fromGeod(aPos), aN, aCutoffNm * SG_NM_TO_METER, aFilter, result,
                         limitMsec);
     return result;
 }
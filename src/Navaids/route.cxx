@@ -42,6 +42,7 @@
 #include <Navaids/procedure.hxx>
 #include <Navaids/waypoint.hxx>
 #include <Navaids/LevelDXML.hxx>
+#include <Navaids/ProcedureCache.hxx>
 #include <Airports/airport.hxx>
 #include <Navaids/airways.hxx>
 #include <Environment/atmosphere.hxx> // for Mach conversions
@@ -759,7 +760,7 @@ void RouteBase::loadAirportProcedures(const SGPath& aPath, FGAirport* aApt)
   assert(aApt);
   try {
     NavdataVisitor visitor(aApt, aPath);
-      readXML(aPath, visitor);
+    ProcedureCache::instance()->read(aPath, visitor);
   } catch (sg_io_exception& ex) {
     SG_LOG(SG_NAVAID, SG_WARN, "failure parsing procedures: " << aPath <<
       "\n\t" << ex.getMessage() << "\n\tat:" << ex.getLocation().asString());
@@ -183,6 +183,15 @@ SGGeod turnCenterFromExit(const SGGeod& pt, double outHeadingDeg,
     return SGGeodesy::direct(pt, outHeadingDeg + p, turnRadiusM);
 }
 
+// exact comparison, the geometry is deterministic so unchanged inputs
+// give identical values
+static bool sameGeod(const SGGeod& a, const SGGeod& b)
+{
+    return (a.getLongitudeRad() == b.getLongitudeRad()) &&
+           (a.getLatitudeRad() == b.getLatitudeRad()) &&
+           (a.getElevationM() == b.getElevationM());
+}
+
 struct TurnInfo
 {
     SGGeod turnCenter;
@@ -625,6 +634,36 @@ public:
       return pointOnEntryTurnFromHeading(legCourseTrue + theta);
   }
   
+  /**
+   * a waypoint at a known position, whose geometry only depends on the
+   * waypoints before it; RoutePath::update() can restart from one of these
+   */
+  bool isFixedPoint() const
+  {
+    if (skipped || wpt->flag(WPT_DYNAMIC)) {
+      return false;
+    }
+
+    const std::string& ty(wpt->type());
+    return (ty != "discontinuity") && (ty != "vectors") && (ty != "via");
+  }
+
+  bool sameAs(const WayptData& other) const
+  {
+    return (wpt == other.wpt) && (hasEntry == other.hasEntry) &&
+           (posValid == other.posValid) && (legCourseValid == other.legCourseValid) &&
+           (skipped == other.skipped) && (flyOver == other.flyOver) &&
+           sameGeod(pos, other.pos) && sameGeod(turnEntryPos, other.turnEntryPos) &&
+           sameGeod(turnExitPos, other.turnExitPos) &&
+           sameGeod(turnEntryCenter, other.turnEntryCenter) &&
+           sameGeod(turnExitCenter, other.turnExitCenter) &&
+           (turnEntryAngle == other.turnEntryAngle) && (turnExitAngle == other.turnExitAngle) &&
+           (turnRadius == other.turnRadius) && (legCourseTrue == other.legCourseTrue) &&
+           (pathDistanceM == other.pathDistanceM) &&
+           (turnPathDistanceM == other.turnPathDistanceM) &&
+           (overflightCompensationAngle == other.overflightCompensationAngle);
+  }
+
   WayptRef wpt;
   bool hasEntry, posValid, legCourseValid, skipped;
   SGGeod pos, turnEntryPos, turnExitPos, turnEntryCenter, turnExitCenter;
@@ -644,11 +683,49 @@ class RoutePath::RoutePathPrivate
 {
 public:
     WayptDataVec waypoints;
+    /// each waypoint as the main pass found it, before its own turn was computed
+    WayptDataVec entryStates;
+    /// the data before an update, while it is running
+    WayptDataVec previousWaypoints, previousEntries;
 
     AircraftPerformance perf;
+    unsigned int perfSerial = 0;
+    /// FlightPlan::revision() when last brought up to date
+    unsigned int planRevision = 0;
     bool constrainLegCourses;
     double maxFlyByTurnAngleDeg = 90.0;
 
+    /// waypoints which have been through pass 0 and 1
+    unsigned int initialised = 0;
+    int recomputed = 0;
+    /// waypoints modified in place since the last update
+    WayptVec dirtyWaypoints;
+
+    /**
+     * run pass 0 and 1 on the waypoints up to index. Pass 1 looks at the
+     * position of the following waypoint, so pass 0 runs one ahead.
+     */
+    void initThrough(unsigned int index)
+    {
+        const auto count = waypoints.size();
+        for (; (initialised <= index) && (initialised < count); ++initialised) {
+            const unsigned int i = initialised;
+            WayptData* nextPtr = nullptr;
+            if ((i + 1) < count) {
+                waypoints[i + 1].initPass0();
+                nextPtr = &waypoints[i + 1];
+            }
+
+            if (i == 0) {
+                continue;
+            }
+
+            auto prev = previousValidWaypoint(i);
+            WayptData* prevPtr = (prev == waypoints.end()) ? nullptr : &(*prev);
+            waypoints[i].initPass1(prevPtr, nextPtr);
+        }
+    }
+
     void computeDynamicPosition(int index)
     {
         auto previous(previousValidWaypoint(index));
@@ -866,15 +943,26 @@ public:
     }
 }; // of RoutePathPrivate class
 
-RoutePath::RoutePath(const flightgear::FlightPlan* fp) :
-  d(new RoutePathPrivate)
+static WayptVec legWaypoints(const flightgear::FlightPlan* fp)
 {
+    WayptVec r;
     for (int l=0; l<fp->numLegs(); ++l) {
         WayptRef wpt = fp->legAtIndex(l)->waypoint();
         if (!wpt) {
             SG_LOG(SG_NAVAID, SG_DEV_ALERT, "Waypoint " << l << " of " << fp->numLegs() << "is NULL");
             break;
         }
+        r.push_back(wpt);
+    }
+    return r;
+}
+
+RoutePath::RoutePath(const flightgear::FlightPlan* fp) :
+  d(new RoutePathPrivate)
+{
+    d->perfSerial = AircraftPerformance::dataSerial();
+    d->planRevision = fp->revision();
+    for (const auto& wpt : legWaypoints(fp)) {
         d->waypoints.push_back(WayptData(wpt));
     }
 
@@ -900,21 +988,166 @@ RoutePath::~RoutePath()
 
 void RoutePath::commonInit()
 {
-  for (auto& w : d->waypoints) {
-    w.initPass0();
+  d->entryStates.clear();
+  d->initialised = 0;
+  if (!d->waypoints.empty()) {
+    d->waypoints.front().initPass0();
   }
-  
-  for (unsigned int i=1; i<d->waypoints.size(); ++i) {
-    WayptData* nextPtr = ((i + 1) < d->waypoints.size()) ? &d->waypoints[i+1] : nullptr;
-    auto prev = d->previousValidWaypoint(i);
-    WayptData* prevPtr = (prev == d->waypoints.end()) ? nullptr : &(*prev);
-    d->waypoints[i].initPass1(prevPtr, nextPtr);
+
+  computeFrom(0, -1);
+}
+
+bool RoutePath::update(const flightgear::FlightPlan* fp)
+{
+  // called every frame by the route manager, so check cheaply first
+  const unsigned int perfSerial = AircraftPerformance::dataSerial();
+  const bool constrain = fp->followLegTrackToFixes();
+  if ((fp->revision() == d->planRevision) && (perfSerial == d->perfSerial) &&
+      (constrain == d->constrainLegCourses) && d->dirtyWaypoints.empty()) {
+    d->recomputed = 0;
+    return false;
   }
+  d->planRevision = fp->revision();
 
-  for (unsigned int i=0; i<d->waypoints.size(); ++i) {
-      if (d->waypoints[i].skipped) {
-          continue;
-      }
+  const WayptVec wpts = legWaypoints(fp);
+  const int oldCount = static_cast<int>(d->waypoints.size());
+  const int newCount = static_cast<int>(wpts.size());
+  const int common = std::min(oldCount, newCount);
+
+  // waypoints are matched by identity: an edit replaces the Waypt
+  int prefix = 0;
+  while ((prefix < common) && (d->waypoints[prefix].wpt == wpts[prefix])) {
+    ++prefix;
+  }
+
+  int suffix = 0;
+  while ((suffix < (common - prefix)) &&
+         (d->waypoints[oldCount - 1 - suffix].wpt == wpts[newCount - 1 - suffix])) {
+    ++suffix;
+  }
+
+  // resolved only now, since edits in a batch can move them around
+  for (const auto& dirty : d->dirtyWaypoints) {
+    auto it = std::find(wpts.begin(), wpts.end(), dirty);
+    if (it == wpts.end()) {
+      continue; // deleted since
+    }
+
+    const int index = static_cast<int>(it - wpts.begin());
+    prefix = std::min(prefix, index);
+    suffix = std::min(suffix, newCount - 1 - index);
+  }
+  d->dirtyWaypoints.clear();
+
+  // the performance data, or the category it is derived from, can change
+  // without any leg changing; the whole path depends on it
+  bool perfChanged = false;
+  if (perfSerial != d->perfSerial) {
+    AircraftPerformance perf;
+    perfChanged = (perf != d->perf);
+    d->perf = perf;
+    d->perfSerial = perfSerial;
+  }
+
+  const bool fullRebuild = (constrain != d->constrainLegCourses) || perfChanged;
+  if (!fullRebuild && (prefix == oldCount) && (oldCount == newCount)) {
+    d->recomputed = 0;
+    return false;
+  }
+
+  // the last fixed point before the change, everything before it keeps
+  // its geometry
+  int restart = prefix - 1;
+  while ((restart > 0) && !d->waypoints[restart].isFixedPoint()) {
+    --restart;
+  }
+
+  d->previousWaypoints.swap(d->waypoints);
+  d->previousEntries.swap(d->entryStates);
+  d->waypoints.clear();
+  d->entryStates.clear();
+  d->constrainLegCourses = constrain;
+
+  if (fullRebuild || (restart <= 0)) {
+    for (const auto& wpt : wpts) {
+      d->waypoints.push_back(WayptData(wpt));
+    }
+    commonInit();
+  } else {
+    d->waypoints.assign(d->previousWaypoints.begin(), d->previousWaypoints.begin() + restart);
+    d->waypoints.push_back(d->previousEntries[restart]);
+    for (int i = restart + 1; i < newCount; ++i) {
+      d->waypoints.push_back(WayptData(wpts[i]));
+    }
+
+    d->entryStates.assign(d->previousEntries.begin(), d->previousEntries.begin() + restart);
+    d->initialised = restart + 1;
+    if (d->initialised < d->waypoints.size()) {
+      d->waypoints[d->initialised].initPass0();
+    }
+
+    computeFrom(restart, newCount - suffix);
+  }
+
+  d->previousWaypoints.clear();
+  d->previousEntries.clear();
+  return true;
+}
+
+void RoutePath::invalidate(const WayptRef& wpt)
+{
+  if (std::find(d->dirtyWaypoints.begin(), d->dirtyWaypoints.end(), wpt) == d->dirtyWaypoints.end()) {
+    d->dirtyWaypoints.push_back(wpt);
+  }
+}
+
+int RoutePath::recomputedCount() const
+{
+  return d->recomputed;
+}
+
+void RoutePath::computeFrom(unsigned int start, int reuseFrom)
+{
+  const int offset = static_cast<int>(d->previousWaypoints.size()) -
+                     static_cast<int>(d->waypoints.size());
+  d->recomputed = 0;
+
+  for (unsigned int i = start; i < d->waypoints.size(); ++i) {
+    d->initThrough(i);
+    WayptData& w(d->waypoints[i]);
+
+    if ((reuseFrom >= 0) && (static_cast<int>(i) >= reuseFrom) && w.isFixedPoint() &&
+        w.sameAs(d->previousEntries[i + offset])) {
+      // the rest of the route is as before, only the distance from the
+      // previous waypoint can differ
+      std::copy(d->previousWaypoints.begin() + i + offset, d->previousWaypoints.end(),
+                d->waypoints.begin() + i);
+      d->entryStates.insert(d->entryStates.end(),
+                            d->previousEntries.begin() + i + offset, d->previousEntries.end());
+      d->initialised = d->waypoints.size();
+      w.pathDistanceM = computeDistanceForIndex(i);
+      return;
+    }
+
+    d->entryStates.push_back(w);
+    ++d->recomputed;
+    computeIndex(i);
+  }
+}
+
+void RoutePath::computeIndex(unsigned int i)
+{
+    if (d->waypoints[i].skipped) {
+        return;
+    }
+
+    // pass 1 has to have seen everything up to the next valid waypoint
+    for (unsigned int j = i + 1; j < d->waypoints.size(); ++j) {
+        d->initThrough(j);
+        if (!d->waypoints[j].skipped && (d->waypoints[j].wpt->type() != "discontinuity")) {
+            break;
+        }
+    }
 
       double alt = 0.0; // FIXME
       double radiusM = d->perf.turnRadiusMForAltitude(alt);
@@ -947,7 +1180,6 @@ void RoutePath::commonInit()
     
     // now turn is computed, can resolve distances
     d->waypoints[i].pathDistanceM = computeDistanceForIndex(i);
-  }
 }
 
 SGGeodVec RoutePath::pathForIndex(int index) const
@@ -57,10 +57,35 @@ public:
   
   double distanceBetweenIndices(int from, int to) const;
 
+  /**
+   * Bring the path up to date with the legs of fp. Waypoints are matched
+   * to the ones seen before by identity; only the legs from the last fixed
+   * point before a change are recomputed, until the geometry is the same
+   * as before the change again. The aircraft performance is read again
+   * when /aircraft/performance changed, and the whole path recomputed if
+   * it differs. If neither the plan nor the performance data changed, this
+   * returns without looking at the legs.
+   * @return false if nothing changed
+   */
+  bool update(const flightgear::FlightPlan* fp);
+
+  /**
+   * recompute the leg of wpt on the next update(), for waypoints which
+   * were modified in place. The leg is looked up by the update, so it may
+   * move, or be deleted, in the meantime.
+   */
+  void invalidate(const flightgear::WayptRef& wpt);
+
+  /// legs recomputed by the last update(), or by construction
+  int recomputedCount() const;
+
 private:
   class RoutePathPrivate;
   
   void commonInit();
+
+  void computeFrom(unsigned int start, int reuseFrom);
+  void computeIndex(unsigned int index);
   
   double computeDistanceForIndex(int index) const;
 
@@ -540,6 +540,15 @@ FGScenery::get_cart_ground_intersection(const SGVec3d& pos, const SGVec3d& dir,
     return _terrain->get_cart_ground_intersection( pos, dir, nearestHit, butNotFrom );
 }
 
+bool
+FGScenery::get_cart_segment_intersection(const SGVec3d& start, const SGVec3d& end,
+                                         SGVec3d& nearestHit,
+                                         const simgear::BVHMaterial** material,
+                                         const osg::Node* butNotFrom)
+{
+    return _terrain->get_cart_segment_intersection( start, end, nearestHit, material, butNotFrom );
+}
+
 bool FGScenery::scenery_available(const SGGeod& position, double range_m)
 {
     return _terrain->scenery_available( position, range_m );
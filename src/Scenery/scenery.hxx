@@ -126,6 +126,15 @@ public:
                                       SGVec3d& nearestHit,
                                       const osg::Node* butNotFrom = 0);
 
+    /// Compute the intersection of the segment from start to end with the
+    /// terrain which is nearest to start. Cartesian wgs84 coordinates in
+    /// meters, like get_cart_ground_intersection. On success, true is
+    /// returned.
+    bool get_cart_segment_intersection(const SGVec3d& start, const SGVec3d& end,
+                                       SGVec3d& nearestHit,
+                                       const simgear::BVHMaterial** material,
+                                       const osg::Node* butNotFrom = 0);
+
     osg::Group *get_scene_graph () const { return scene_graph.get(); }
     osg::Group *get_terrain_branch () const { return terrain_branch.get(); }
     osg::Group *get_models_branch () const { return models_branch.get(); }
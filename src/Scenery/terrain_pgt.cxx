@@ -222,6 +222,28 @@ bool FGPgtTerrain::get_cart_ground_intersection(const SGVec3d& pos, const SGVec3
     return true;
 }
 
+bool FGPgtTerrain::get_cart_segment_intersection(const SGVec3d& start, const SGVec3d& end,
+                                                 SGVec3d& nearestHit,
+                                                 const simgear::BVHMaterial** material,
+                                                 const osg::Node* butNotFrom)
+{
+    // the same flat terrain get_elevation_m() reports
+    const double startAlt = SGGeod::fromCart(start).getElevationM();
+    const double endAlt = SGGeod::fromCart(end).getElevationM();
+    double terrainAlt;
+    if (!get_elevation_m(SGGeod::fromCart(start), terrainAlt, material, butNotFrom)) {
+        return false;
+    }
+
+    if ((startAlt < terrainAlt) || (endAlt > terrainAlt) || (startAlt <= endAlt)) {
+        return false;
+    }
+
+    const double t = (startAlt - terrainAlt) / (startAlt - endAlt);
+    nearestHit = start + t * (end - start);
+    return true;
+}
+
 bool FGPgtTerrain::scenery_available(const SGGeod& position, double range_m)
 {
     if( schedule_scenery(position, range_m, 0.0) )
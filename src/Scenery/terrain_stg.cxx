@@ -372,6 +372,28 @@ FGStgTerrain::get_cart_ground_intersection(const SGVec3d& pos, const SGVec3d& di
   return true;
 }
 
+bool
+FGStgTerrain::get_cart_segment_intersection(const SGVec3d& start, const SGVec3d& end,
+                                            SGVec3d& nearestHit,
+                                            const simgear::BVHMaterial** material,
+                                            const osg::Node* butNotFrom)
+{
+  if ( norm1(start) < 1 )
+    return false;
+
+  FGSceneryIntersect intersectVisitor(SGLineSegmentd(start, end), butNotFrom);
+  intersectVisitor.setTraversalMask(SG_NODEMASK_TERRAIN_BIT);
+  terrain_branch->accept(intersectVisitor);
+
+  if (!intersectVisitor.getHaveHit())
+      return false;
+
+  nearestHit = intersectVisitor.getLineSegment().getEnd();
+  if (material)
+      *material = intersectVisitor.getMaterial();
+  return true;
+}
+
 bool FGStgTerrain::scenery_available(const SGGeod& position, double range_m)
 {
   if( schedule_scenery(position, range_m, 0.0) )
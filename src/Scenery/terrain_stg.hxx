@@ -99,6 +99,15 @@ public:
     bool get_cart_ground_intersection(const SGVec3d& start, const SGVec3d& dir,
                                       SGVec3d& nearestHit,
                                       const osg::Node* butNotFrom = 0);
+
+    /// Compute the intersection of the segment from start to end with the
+    /// terrain which is nearest to start. Cartesian wgs84 coordinates in
+    /// meters, like get_cart_ground_intersection. On success, true is
+    /// returned.
+    bool get_cart_segment_intersection(const SGVec3d& start, const SGVec3d& end,
+                                       SGVec3d& nearestHit,
+                                       const simgear::BVHMaterial** material,
+                                       const osg::Node* butNotFrom = 0);
     
     /// Returns true if scenery is available for the given lat, lon position
     /// within a range of range_m.
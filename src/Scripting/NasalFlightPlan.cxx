@@ -1798,6 +1798,28 @@ static naRef f_flightplan_clearLegs(naContext c, naRef me, int argc, naRef* args
     return naNil();
 }
 
+static naRef f_flightplan_beginBatchEdit(naContext c, naRef me, int argc, naRef* args)
+{
+    FlightPlan* fp = flightplanGhost(me);
+    if (!fp) {
+        naRuntimeError(c, "flightplan.beginBatchEdit called on non-flightplan object");
+    }
+
+    fp->beginBatchEdit();
+    return naNil();
+}
+
+static naRef f_flightplan_commitBatchEdit(naContext c, naRef me, int argc, naRef* args)
+{
+    FlightPlan* fp = flightplanGhost(me);
+    if (!fp) {
+        naRuntimeError(c, "flightplan.commitBatchEdit called on non-flightplan object");
+    }
+
+    fp->commitBatchEdit();
+    return naNil();
+}
+
 static naRef f_flightplan_clearAll(naContext c, naRef me, int argc, naRef* args)
 {
     FlightPlan* fp = flightplanGhost(me);
@@ -2122,7 +2144,7 @@ static naRef f_leg_courseAndDistanceFrom(naContext c, naRef me, int argc, naRef*
     SGGeod pos;
     geodFromArgs(args, 0, argc, pos);
 
-    RoutePath path(leg->owner());
+    const RoutePath& path = leg->owner()->routePath();
     SGGeod    wpPos = path.positionForIndex(leg->index());
     double    courseDeg, az2, distanceM;
     SGGeodesy::inverse(pos, wpPos, courseDeg, az2, distanceM);
@@ -2140,7 +2162,7 @@ static naRef f_leg_path(naContext c, naRef me, int argc, naRef* args)
         naRuntimeError(c, "leg.setAltitude called on non-flightplan-leg object");
     }
 
-    RoutePath path(leg->owner());
+    const RoutePath& path = leg->owner()->routePath();
     SGGeodVec gv(path.pathForIndex(leg->index()));
 
     naRef result = naNewVector(c);
@@ -2357,6 +2379,8 @@ naRef initNasalFlightPlan(naRef globals, naContext c)
 
     hashset(c, flightplanPrototype, "clearWPType", naNewFunc(c, naNewCCode(c, f_flightplan_clearWPType)));
     hashset(c, flightplanPrototype, "clone", naNewFunc(c, naNewCCode(c, f_flightplan_clone)));
+    hashset(c, flightplanPrototype, "beginBatchEdit", naNewFunc(c, naNewCCode(c, f_flightplan_beginBatchEdit)));
+    hashset(c, flightplanPrototype, "commitBatchEdit", naNewFunc(c, naNewCCode(c, f_flightplan_commitBatchEdit)));
 
     hashset(c, flightplanPrototype, "pathGeod", naNewFunc(c, naNewCCode(c, f_flightplan_pathGeod)));
     // this is a clearer name than pathGeod
@@ -965,6 +965,34 @@ static naRef f_findAirportsByICAO(naContext c, naRef me, int argc, naRef* args)
   return r;
 }
 
+static naRef f_findAirportsByName(naContext c, naRef me, int argc, naRef* args)
+{
+  if ((argc < 1) || !naIsString(args[0])) {
+    naRuntimeError(c, "findAirportsByName expects string as arg 0");
+  }
+
+  int argOffset = 0;
+  std::string term(naStr_data(args[argOffset++]));
+  FGAirport::TypeRunwayFilter filter; // defaults to airports only
+  if ((argOffset < argc) && naIsString(args[argOffset])) {
+    filter.fromTypeString(naStr_data(args[argOffset++]));
+  }
+
+  size_t limit = 0;
+  if ((argOffset < argc) && naIsNum(args[argOffset])) {
+    limit = static_cast<size_t>(std::max(0.0, naNumValue(args[argOffset++]).num));
+  }
+
+  naRef r = naNewVector(c);
+
+  FGPositionedList apts = NavDataCache::instance()->searchNames(term, &filter, limit);
+  for (FGPositionedRef a : apts) {
+    naVec_append(r, ghostForAirport(c, fgpositioned_cast<FGAirport>(a)));
+  }
+
+  return r;
+}
+
 static naRef f_airport_tower(naContext c, naRef me, int argc, naRef* args)
 {
     FGAirport* apt = airportGhost(me);
@@ -1878,6 +1906,7 @@ static struct {
     {"airportinfo", f_airportinfo},
     {"findAirportsWithinRange", f_findAirportsWithinRange},
     {"findAirportsByICAO", f_findAirportsByICAO},
+    {"findAirportsByName", f_findAirportsByName},
     {"navinfo", f_navinfo},
     {"findNavaidsWithinRange", f_findNavaidsWithinRange},
     {"findNDBByFrequencyKHz", f_findNDBByFrequency},
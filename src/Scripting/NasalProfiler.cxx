@@ -0,0 +1,258 @@
+// NasalProfiler.cxx - instrumenting profiler for Nasal callbacks
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include "config.h"
+
+#include "NasalProfiler.hxx"
+
+#include <algorithm>
+#include <iomanip>
+#include <map>
+
+#include <simgear/debug/logstream.hxx>
+#include <simgear/io/iostreams/sgstream.hxx>
+
+namespace {
+
+const int MAX_PUBLISHED_ENTRIES = 20;
+
+std::string jsonEscape(const std::string& s)
+{
+    std::string result;
+    result.reserve(s.size());
+    for (char c : s) {
+        switch (c) {
+        case '"':  result += "\\\""; break;
+        case '\\': result += "\\\\"; break;
+        case '\n': result += "\\n"; break;
+        case '\t': result += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) >= 0x20)
+                result += c;
+        }
+    }
+    return result;
+}
+
+// strip the line number from a "file:line" source location
+std::string fileOfSource(const std::string& source)
+{
+    const auto colon = source.rfind(':');
+    if (colon == std::string::npos)
+        return source;
+    return source.substr(0, colon);
+}
+
+} // of anonymous namespace
+
+FGNasalProfiler::FGNasalProfiler() = default;
+
+FGNasalProfiler::~FGNasalProfiler() = default;
+
+void FGNasalProfiler::init(SGPropertyNode* root)
+{
+    _root = root;
+    _epoch.stamp();
+    _lastPublish.stamp();
+}
+
+void FGNasalProfiler::shutdown()
+{
+    _enabled = false;
+    _tracing = false;
+    reset();
+    _root.clear();
+}
+
+const char* FGNasalProfiler::categoryName(Category cat)
+{
+    switch (cat) {
+    case TIMER:     return "timer";
+    case SETTIMER:  return "settimer";
+    case LISTENER:  return "listener";
+    case COMMAND:   return "command";
+    case MODULE:    return "module";
+    default:
+        break;
+    }
+
+    return "unknown";
+}
+
+void FGNasalProfiler::update()
+{
+    if (!_root)
+        return;
+
+    const bool enabled = _root->getBoolValue("enabled");
+    if (enabled != _enabled) {
+        _enabled = enabled;
+        if (!_enabled) {
+            _tracing = false;
+        }
+    }
+
+    if (!_enabled)
+        return;
+
+    _tracing = _root->getBoolValue("trace");
+    if (_root->getBoolValue("reset")) {
+        reset();
+        _root->setBoolValue("reset", false);
+    }
+
+    if (_lastPublish.elapsedMSec() >= 1000) {
+        _lastPublish.stamp();
+        publish();
+    }
+}
+
+void FGNasalProfiler::reset()
+{
+    _trace.clear();
+    _entries.clear();
+    _epoch.stamp();
+    if (_root) {
+        _root->removeChildren("entry");
+        _root->removeChildren("file");
+    }
+}
+
+void FGNasalProfiler::record(Category cat, const std::string& name,
+                             const std::string& source,
+                             const SGTimeStamp& start, double durationUSec)
+{
+    std::string key = categoryName(cat);
+    key += ':';
+    key += name;
+
+    auto it = _entries.find(key);
+    if (it == _entries.end()) {
+        Entry e;
+        e.category = cat;
+        e.name = name;
+        e.source = source;
+        it = _entries.emplace(key, e).first;
+    }
+
+    Entry& e = it->second;
+    ++e.calls;
+    e.totalUSec += durationUSec;
+    e.maxUSec = std::max(e.maxUSec, durationUSec);
+
+    if (_tracing && (_trace.size() < _maxTraceEvents)) {
+        const double startUSec = (start - _epoch).toUSecs();
+        _trace.push_back({&e, startUSec, durationUSec});
+    }
+}
+
+void FGNasalProfiler::publish()
+{
+    std::vector<const Entry*> entries;
+    entries.reserve(_entries.size());
+
+    struct FileTotals {
+        unsigned long calls = 0;
+        double totalUSec = 0.0;
+        double maxUSec = 0.0;
+    };
+    std::map<std::string, FileTotals> files;
+
+    for (const auto& it : _entries) {
+        const Entry& e = it.second;
+        entries.push_back(&e);
+
+        if (!e.source.empty()) {
+            FileTotals& f = files[fileOfSource(e.source)];
+            f.calls += e.calls;
+            f.totalUSec += e.totalUSec;
+            f.maxUSec = std::max(f.maxUSec, e.maxUSec);
+        }
+    }
+
+    const int maxEntries = _root->getIntValue("max-entries", MAX_PUBLISHED_ENTRIES);
+    const size_t count = std::min(entries.size(), static_cast<size_t>(std::max(0, maxEntries)));
+    std::partial_sort(entries.begin(), entries.begin() + count, entries.end(),
+                      [](const Entry* a, const Entry* b) {
+                          return a->totalUSec > b->totalUSec;
+                      });
+
+    _root->removeChildren("entry");
+    for (size_t i = 0; i < count; ++i) {
+        const Entry* e = entries[i];
+        SGPropertyNode* n = _root->getChild("entry", i, true);
+        n->setStringValue("category", categoryName(e->category));
+        n->setStringValue("name", e->name);
+        n->setStringValue("source", e->source);
+        n->setLongValue("calls", e->calls);
+        n->setDoubleValue("total-ms", e->totalUSec * 0.001);
+        n->setDoubleValue("max-ms", e->maxUSec * 0.001);
+        n->setDoubleValue("mean-ms", e->totalUSec * 0.001 / e->calls);
+    }
+
+    std::vector<std::pair<std::string, FileTotals>> sortedFiles(files.begin(), files.end());
+    const size_t fileCount = std::min(sortedFiles.size(), static_cast<size_t>(std::max(0, maxEntries)));
+    std::partial_sort(sortedFiles.begin(), sortedFiles.begin() + fileCount, sortedFiles.end(),
+                      [](const std::pair<std::string, FileTotals>& a,
+                         const std::pair<std::string, FileTotals>& b) {
+                          return a.second.totalUSec > b.second.totalUSec;
+                      });
+
+    _root->removeChildren("file");
+    for (size_t i = 0; i < fileCount; ++i) {
+        SGPropertyNode* n = _root->getChild("file", i, true);
+        n->setStringValue("path", sortedFiles[i].first);
+        n->setLongValue("calls", sortedFiles[i].second.calls);
+        n->setDoubleValue("total-ms", sortedFiles[i].second.totalUSec * 0.001);
+        n->setDoubleValue("max-ms", sortedFiles[i].second.maxUSec * 0.001);
+    }
+
+    _root->setIntValue("trace-events", _trace.size());
+}
+
+bool FGNasalProfiler::writeTrace(const SGPath& path) const
+{
+    sg_ofstream f(path, std::ios::out | std::ios::trunc);
+    if (!f.is_open()) {
+        SG_LOG(SG_NASAL, SG_ALERT, "Nasal profiler: unable to write trace file " << path);
+        return false;
+    }
+
+    // Chrome trace-event format, complete ('X') events with microsecond
+    // timestamps. Everything runs on the main thread, so pid/tid are fixed.
+    f << std::fixed << std::setprecision(1);
+    f << "{\"traceEvents\":[\n";
+    bool first = true;
+    for (const auto& ev : _trace) {
+        if (!first)
+            f << ",\n";
+        first = false;
+
+        f << "{\"name\":\"" << jsonEscape(ev.entry->name) << "\","
+          << "\"cat\":\"" << categoryName(ev.entry->category) << "\","
+          << "\"ph\":\"X\",\"pid\":1,\"tid\":1,"
+          << "\"ts\":" << ev.startUSec << ","
+          << "\"dur\":" << ev.durationUSec;
+        if (!ev.entry->source.empty()) {
+            f << ",\"args\":{\"source\":\"" << jsonEscape(ev.entry->source) << "\"}";
+        }
+        f << "}";
+    }
+    f << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    SG_LOG(SG_NASAL, SG_INFO, "Nasal profiler: wrote " << _trace.size() << " events to " << path);
+    return true;
+}
@@ -0,0 +1,150 @@
+// NasalProfiler.hxx - instrumenting profiler for Nasal callbacks
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifndef NASAL_PROFILER_HXX
+#define NASAL_PROFILER_HXX
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <simgear/misc/sg_path.hxx>
+#include <simgear/props/props.hxx>
+#include <simgear/timing/timestamp.hxx>
+
+/**
+ * Accumulates the time spent in Nasal entry points (timers, listeners,
+ * command bindings and module loading), keyed by a descriptive name such
+ * as the "maketimer-[%p]-file:line" timer names.
+ *
+ * Controlled through /sim/nasal/profiler:
+ *   enabled    - collect cumulative/max times per entry
+ *   trace      - additionally record individual calls for a trace file
+ *   reset      - clear all collected data
+ *
+ * Once a second the most expensive entries are published below that
+ * node (entry[n]), together with the same data aggregated per source
+ * file (file[n]). The "nasal-profiler-write-trace" command writes the
+ * recorded calls in the Chrome trace-event JSON format, which can be
+ * loaded into chrome://tracing or Perfetto.
+ *
+ * When disabled, a Scope costs a single pointer test.
+ */
+class FGNasalProfiler
+{
+public:
+    enum Category {
+        TIMER = 0,      ///< persistent timer, maketimer()
+        SETTIMER,       ///< single-shot settimer() callback
+        LISTENER,
+        COMMAND,
+        MODULE,         ///< top-level code of a module being loaded
+        NUM_CATEGORIES
+    };
+
+    FGNasalProfiler();
+    ~FGNasalProfiler();
+
+    void init(SGPropertyNode* root);
+    void shutdown();
+
+    /// poll the control properties and publish results periodically
+    void update();
+
+    bool isEnabled() const
+    { return _enabled; }
+
+    /**
+     * @param name   unique name of the entry point
+     * @param source "file:line" of the Nasal code, used for the per-file
+     *               aggregation; may be empty
+     */
+    void record(Category cat, const std::string& name, const std::string& source,
+                const SGTimeStamp& start, double durationUSec);
+
+    bool writeTrace(const SGPath& path) const;
+
+    void reset();
+
+    static const char* categoryName(Category cat);
+
+    /**
+     * RAII helper measuring a single call. The strings must outlive the
+     * scope; they are only looked at when the profiler is enabled.
+     */
+    class Scope
+    {
+    public:
+        Scope(FGNasalProfiler* p, Category cat, const std::string& name,
+              const std::string& source) :
+            _profiler((p && p->isEnabled()) ? p : nullptr),
+            _category(cat),
+            _name(name),
+            _source(source)
+        {
+            if (_profiler)
+                _start.stamp();
+        }
+
+        ~Scope()
+        {
+            if (_profiler)
+                _profiler->record(_category, _name, _source, _start, _start.elapsedUSec());
+        }
+
+    private:
+        FGNasalProfiler* _profiler;
+        Category _category;
+        const std::string& _name;
+        const std::string& _source;
+        SGTimeStamp _start;
+    };
+
+private:
+    struct Entry
+    {
+        Category category;
+        std::string name;
+        std::string source;
+        unsigned long calls = 0;
+        double totalUSec = 0.0;
+        double maxUSec = 0.0;
+    };
+
+    struct TraceEvent
+    {
+        const Entry* entry;
+        double startUSec;
+        double durationUSec;
+    };
+
+    void publish();
+
+    SGPropertyNode_ptr _root;
+    bool _enabled = false;
+    bool _tracing = false;
+
+    SGTimeStamp _epoch;             ///< origin of trace timestamps
+    SGTimeStamp _lastPublish;
+
+    // keyed by category and name; entries are never removed until reset(),
+    // so TraceEvent can safely point to them
+    std::unordered_map<std::string, Entry> _entries;
+    std::vector<TraceEvent> _trace;
+    size_t _maxTraceEvents = 1000000;
+};
+
+#endif // NASAL_PROFILER_HXX
@@ -64,6 +64,7 @@
 #include "NasalHTTP.hxx"
 #include "NasalModelData.hxx"
 #include "NasalPositioned.hxx"
+#include "NasalProfiler.hxx"
 #include "NasalSGPath.hxx"
 #include "NasalString.hxx"
 #include "NasalSys.hxx"
@@ -134,6 +135,7 @@ public:
     char nm[256];
     if (c) {
         snprintf(nm, 128, "maketimer-[%p]-%s:%d", (void*)this, naStr_data(naGetSourceFile(c, 0)), naGetLine(c, 0));
+        _source = std::string(naStr_data(naGetSourceFile(c, 0))) + ":" + std::to_string(naGetLine(c, 0));
     }
     else {
         snprintf(nm, 128, "maketimer-%p", this);
@@ -206,6 +208,7 @@ public:
       // event manager).
       _isRunning = false;
 
+    FGNasalProfiler::Scope scope(_sys->profiler(), FGNasalProfiler::TIMER, _name, _source);
     naRef *args = nullptr;
     _sys->callMethod(_func, _self, 0, args, naNil() /* locals */);
   }
@@ -222,6 +225,7 @@ public:
   { return _name; }
 private:
   std::string _name;
+  std::string _source;
   FGNasalSys* _sys;
   naRef _func, _self;
   int _gcRoot, _gcSelf;
@@ -815,6 +819,8 @@ public:
         naRef args[1];
         args[0] = _sys->wrappedPropsNode(const_cast<SGPropertyNode*>(aNode));
 
+        static const std::string noSource;
+        FGNasalProfiler::Scope scope(_sys->profiler(), FGNasalProfiler::COMMAND, _name, noSource);
         _sys->callMethod(_func, naNil(), 1, args, naNil() /* locals */);
 
         return true;
@@ -1083,6 +1089,15 @@ void FGNasalSys::init()
     }
     int i;
 
+    _listenerStatsNode = fgGetNode("/sim/nasal/listener-stats", true);
+    _listenerStatsPublished.stamp();
+
+    _profiler.reset(new FGNasalProfiler);
+    _profiler->init(fgGetNode("/sim/nasal/profiler", true));
+    _profiler->update(); // pick up enabled state so module loading is covered
+    globals->get_commands()->addCommand("nasal-profiler-write-trace", this,
+                                        &FGNasalSys::commandWriteProfilerTrace);
+
     _context = naNewContext();
 
     // Start with globals.  Add it to itself as a recursive
@@ -1208,6 +1223,7 @@ void FGNasalSys::shutdown()
     shutdownNasalFlightPlan();
     shutdownNasalUnitTestInSim();
 
+    _pendingListeners.clear();
     for (auto l : _listener)
         delete l.second;
     _listener.clear();
@@ -1217,6 +1233,8 @@ void FGNasalSys::shutdown()
     }
     _commands.clear();
 
+    globals->get_commands()->removeCommand("nasal-profiler-write-trace");
+
     for(auto ml : _moduleListeners)
         delete ml;
     _moduleListeners.clear();
@@ -1251,6 +1269,11 @@ void FGNasalSys::shutdown()
         }
     }
 
+    // keep the profiler object until here: timers and listeners destroyed
+    // above may still reference it
+    _profiler->shutdown();
+    _profiler.reset();
+
     _inited = false;
 }
 
@@ -1274,9 +1297,22 @@ void FGNasalSys::update(double)
     if( NasalClipboard::getInstance() )
         NasalClipboard::getInstance()->update();
 
-    std::for_each(_dead_listener.begin(), _dead_listener.end(),
-                  []( FGNasalListener* l) { delete l; });
-    _dead_listener.clear();
+    dispatchPendingListeners();
+
+    if (!_dead_listener.empty()) {
+        // a listener can be queued again after removelistener() was called
+        // from within a callback; make sure we never dispatch a deleted one
+        _pendingListeners.erase(std::remove_if(_pendingListeners.begin(), _pendingListeners.end(),
+                                               [](FGNasalListener* l) { return l->_dead; }),
+                                _pendingListeners.end());
+
+        std::for_each(_dead_listener.begin(), _dead_listener.end(),
+                      []( FGNasalListener* l) { delete l; });
+        _dead_listener.clear();
+    }
+
+    updateListenerStats();
+    _profiler->update();
 
     if (!_loadList.empty())
     {
@@ -1577,7 +1613,11 @@ bool FGNasalSys::createModule(const char* moduleName, const char* fileName,
     hashset(locals, "__moduleFilePath", modFilePath);
 
     _cmdArg = (SGPropertyNode*)cmdarg;
-    callWithContext(ctx, code, argc, args, locals);
+    {
+        const std::string name(moduleName), source(fileName);
+        FGNasalProfiler::Scope scope(_profiler.get(), FGNasalProfiler::MODULE, name, source);
+        callWithContext(ctx, code, argc, args, locals);
+    }
     hashset(_globals, moduleName, locals);
 
     naFreeContext(ctx);
@@ -1793,6 +1833,8 @@ void FGNasalSys::setTimer(naContext c, int argc, naRef* args)
 
     // Generate and register a C++ timer handler
     NasalTimer* t = new NasalTimer(handler, this);
+    t->name = name;
+    t->source = name.substr(strlen("settimer-"));
     _nasalTimers.push_back(t);
     globals->get_event_mgr()->addEvent(name,
                                        [t](){ t->timerExpired(); },
@@ -1801,7 +1843,10 @@ void FGNasalSys::setTimer(naContext c, int argc, naRef* args)
 
 void FGNasalSys::handleTimer(NasalTimer* t)
 {
-    call(t->handler, 0, 0, naNil());
+    {
+        FGNasalProfiler::Scope scope(_profiler.get(), FGNasalProfiler::SETTIMER, t->name, t->source);
+        call(t->handler, 0, 0, naNil());
+    }
     auto it =  std::find(_nasalTimers.begin(), _nasalTimers.end(), t);
     assert(it != _nasalTimers.end());
     _nasalTimers.erase(it);
@@ -1850,9 +1895,11 @@ int FGNasalSys::_listenerId = 0;
 // called initially. If the fourth, optional argument is set to 0, then the
 // function is only called when the property node value actually changes.
 // Otherwise it's called independent of the value whenever the node is
-// written to (default). The setlistener() function returns a unique
-// id number, which is to be used as argument to the removelistener()
-// function.
+// written to (default). A value of 2 additionally reports child events,
+// and a value of 3 coalesces writes: the function is called at most once
+// per frame, from FGNasalSys::update(), and sees the latest value. The
+// setlistener() function returns a unique id number, which is to be used
+// as argument to the removelistener() function.
 naRef FGNasalSys::setListener(naContext c, int argc, naRef* args)
 {
     SGPropertyNode_ptr node;
@@ -1882,6 +1929,9 @@ naRef FGNasalSys::setListener(naContext c, int argc, naRef* args)
     int type = argc > 3 && naIsNum(args[3]) ? int(args[3].num) : 1; // trigger will always be triggered when the property is written
     FGNasalListener *nl = new FGNasalListener(node, code, this,
             gcSave(code), _listenerId, init, type);
+    nl->_source = std::string(naStr_data(naGetSourceFile(c, 0))) + ":" +
+                  std::to_string(naGetLine(c, 0));
+    nl->_profileName = "listener-" + std::to_string(_listenerId) + "-" + node->getPath();
 
     node->addChangeListener(nl, init != 0);
 
@@ -1906,6 +1956,115 @@ naRef FGNasalSys::removeListener(naContext c, int argc, naRef* args)
     return naNum(_listener.size());
 }
 
+// nasal-profiler-write-trace command: writes the calls recorded while
+// /sim/nasal/profiler/trace was set, as a Chrome trace-event JSON file.
+// The optional "path" argument defaults to $FG_HOME/Export/nasal-trace.json
+bool FGNasalSys::commandWriteProfilerTrace(const SGPropertyNode* arg, SGPropertyNode*)
+{
+    SGPath path = globals->get_fg_home() / "Export" / "nasal-trace.json";
+    if (arg->hasChild("path")) {
+        path = SGPath::fromUtf8(arg->getStringValue("path"));
+    }
+
+    const SGPath authorizedPath = SGPath(path).validate(true /* write */);
+    if (authorizedPath.isNull()) {
+        SG_LOG(SG_NASAL, SG_ALERT, "nasal-profiler-write-trace: path is not authorized for writing: " << path);
+        return false;
+    }
+
+    const SGPath dir = authorizedPath.dirPath();
+    if (!dir.exists()) {
+        simgear::Dir(dir).create(0777); // respect user's umask
+    }
+
+    return _profiler->writeTrace(authorizedPath);
+}
+
+void FGNasalSys::queueListener(FGNasalListener* l)
+{
+    _pendingListeners.push_back(l);
+}
+
+void FGNasalSys::dispatchPendingListeners()
+{
+    if (_pendingListeners.empty())
+        return;
+
+    // callbacks may write coalesced properties again; those are deferred
+    // to the next frame rather than being dispatched from this loop
+    std::vector<FGNasalListener*> pending;
+    pending.swap(_pendingListeners);
+    for (auto l : pending) {
+        l->_pending = false;
+        if (!l->_dead)
+            l->call(l->_node, naNum(0));
+    }
+}
+
+// Listener instrumentation: when /sim/nasal/listener-stats/enabled is set,
+// every callback invocation is timed, and once a second the most expensive
+// listeners (by cumulative time) are published below that node.
+void FGNasalSys::updateListenerStats()
+{
+    const bool enabled = _listenerStatsNode->getBoolValue("enabled");
+    if (!enabled) {
+        if (_listenerStatsEnabled) {
+            _listenerStatsNode->removeChildren("listener");
+            _listenerStatsEnabled = false;
+        }
+        _listenerCallCount = 0;
+        _listenerCoalescedCount = 0;
+        return;
+    }
+
+    _listenerStatsEnabled = true;
+    _listenerStatsNode->setIntValue("calls-per-frame", _listenerCallCount);
+    _listenerStatsNode->setIntValue("coalesced-per-frame", _listenerCoalescedCount);
+    _listenerStatsNode->setIntValue("pending", _pendingListeners.size());
+    _listenerCallCount = 0;
+    _listenerCoalescedCount = 0;
+
+    if (_listenerStatsNode->getBoolValue("reset")) {
+        for (auto& l : _listener) {
+            l.second->_callCount = 0;
+            l.second->_totalUSec = 0.0;
+            l.second->_maxUSec = 0.0;
+        }
+        _listenerStatsNode->setBoolValue("reset", false);
+    }
+
+    if (_listenerStatsPublished.elapsedMSec() < 1000)
+        return;
+    _listenerStatsPublished.stamp();
+
+    std::vector<FGNasalListener*> active;
+    for (auto& l : _listener) {
+        if (l.second->_callCount > 0)
+            active.push_back(l.second);
+    }
+
+    const size_t maxEntries = std::min(active.size(),
+        static_cast<size_t>(std::max(0, _listenerStatsNode->getIntValue("max-entries", 20))));
+    std::partial_sort(active.begin(), active.begin() + maxEntries, active.end(),
+                      [](const FGNasalListener* a, const FGNasalListener* b) {
+                          return a->_totalUSec > b->_totalUSec;
+                      });
+
+    _listenerStatsNode->removeChildren("listener");
+    for (size_t i = 0; i < maxEntries; ++i) {
+        const FGNasalListener* l = active[i];
+        SGPropertyNode* n = _listenerStatsNode->getChild("listener", i, true);
+        n->setIntValue("id", l->_id);
+        n->setStringValue("property", l->_node->getPath());
+        n->setStringValue("source", l->_source);
+        n->setIntValue("type", l->_type);
+        n->setLongValue("calls", l->_callCount);
+        n->setDoubleValue("total-ms", l->_totalUSec * 0.001);
+        n->setDoubleValue("max-ms", l->_maxUSec * 0.001);
+        n->setDoubleValue("mean-ms", l->_totalUSec * 0.001 / l->_callCount);
+    }
+}
+
 void FGNasalSys::registerToLoad(FGNasalModelData *data)
 {
   if( _loadList.empty() )
@@ -1976,8 +2135,12 @@ FGNasalListener::FGNasalListener(SGPropertyNode *node, naRef code,
     _type(type),
     _active(0),
     _dead(false),
+    _pending(false),
     _last_int(0L),
-    _last_float(0.0)
+    _last_float(0.0),
+    _callCount(0),
+    _totalUSec(0.0),
+    _maxUSec(0.0)
 {
     if(_type == 0 && !_init)
         changed(node);
@@ -1998,12 +2161,48 @@ void FGNasalListener::call(SGPropertyNode* which, naRef mode)
     arg[1] = _nas->propNodeGhost(_node);
     arg[2] = mode;                  // value changed, child added/removed
     arg[3] = naNum(_node != which); // child event?
-    _nas->call(_code, 4, arg, naNil());
+
+    ++_nas->_listenerCallCount;
+
+    // one measurement feeds both the listener stats and the profiler
+    FGNasalProfiler* profiler = _nas->profiler();
+    const bool profiling = profiler && profiler->isEnabled();
+    if (_nas->_listenerStatsEnabled || profiling) {
+        SGTimeStamp st;
+        st.stamp();
+        _nas->call(_code, 4, arg, naNil());
+        const double usec = st.elapsedUSec();
+        if (_nas->_listenerStatsEnabled) {
+            ++_callCount;
+            _totalUSec += usec;
+            _maxUSec = std::max(_maxUSec, usec);
+        }
+        if (profiling) {
+            profiler->record(FGNasalProfiler::LISTENER, _profileName, _source, st, usec);
+        }
+    } else {
+        _nas->call(_code, 4, arg, naNil());
+    }
     _active--;
 }
 
 void FGNasalListener::valueChanged(SGPropertyNode* node)
 {
+    if(_type == COALESCED) {
+        if(node != _node || _dead) return;
+        if(_init) {
+            // the initial call is made synchronously, as for other types
+            _init = 0;
+            call(node, naNum(0));
+        } else if(_pending) {
+            ++_nas->_listenerCoalescedCount;
+        } else {
+            _pending = true;
+            _nas->queueListener(this);
+        }
+        return;
+    }
+
     if(_type < 2 && node != _node) return;   // skip child events
     if(_type > 0 || changed(_node) || _init)
         call(node, naNum(0));
@@ -10,6 +10,7 @@
 #include <simgear/props/props.hxx>
 #include <simgear/structure/subsystem_mgr.hxx>
 #include <simgear/threads/SGQueue.hxx>
+#include <simgear/timing/timestamp.hxx>
 
 // Required only for MSVC
 #ifdef _MSC_VER
@@ -25,6 +26,7 @@ class SGCondition;
 class FGNasalModelData;
 class NasalCommand;
 class FGNasalModuleListener;
+class FGNasalProfiler;
 struct NasalTimer;  ///< timer created by settimer
 class TimerObj;     ///< persistent timer created by maketimer
 
@@ -165,6 +167,10 @@ public:
 
     bool reloadModuleFromFile(const std::string& moduleName);
 
+    /// the Nasal execution profiler, configured via /sim/nasal/profiler
+    FGNasalProfiler* profiler() const
+    { return _profiler.get(); }
+
 private:
     void initLogLevelConstants();
 
@@ -178,6 +184,8 @@ private:
                std::string& errors);
     naRef genPropsModule();
 
+    bool commandWriteProfilerTrace(const SGPropertyNode* arg, SGPropertyNode* root);
+
 
 private:
     //friend class FGNasalScript;
@@ -207,6 +215,8 @@ private:
 
     std::unique_ptr<simgear::BufferedLogCallback> _log;
 
+    std::unique_ptr<FGNasalProfiler> _profiler;
+
     typedef std::map<std::string, NasalCommand*> NasalCommandDict;
     NasalCommandDict _commands;
 
@@ -222,6 +232,21 @@ private:
 
     void handleTimer(NasalTimer* t);
 
+    // coalesced listeners (type 3) written since the last update(); they
+    // are dispatched once, with the latest value, from update()
+    std::vector<FGNasalListener*> _pendingListeners;
+
+    void queueListener(FGNasalListener* l);
+    void dispatchPendingListeners();
+    void updateListenerStats();
+
+    // listener instrumentation, see /sim/nasal/listener-stats
+    SGPropertyNode_ptr _listenerStatsNode;
+    bool _listenerStatsEnabled = false;
+    SGTimeStamp _listenerStatsPublished;
+    unsigned int _listenerCallCount = 0;
+    unsigned int _listenerCoalescedCount = 0;
+
     // track persistent timers. These are owned from the Nasal side, so we
     // only track a non-owning reference here.
     std::vector<TimerObj*> _persistentTimers;
@@ -28,6 +28,10 @@ int nasalStructEqual(naContext ctx, naRef a, naRef b);
 
 class FGNasalListener : public SGPropertyChangeListener {
 public:
+    /// listener type value for setlistener(): the callback is deferred and
+    /// invoked at most once per frame, from FGNasalSys::update()
+    static const int COALESCED = 3;
+
     FGNasalListener(SGPropertyNode* node, naRef code, FGNasalSys* nasal,
                     int key, int id, int init, int type);
     
@@ -50,9 +54,17 @@ private:
     int _type;
     unsigned int _active;
     bool _dead;
+    bool _pending;
     long _last_int;
     double _last_float;
     std::string _last_string;
+
+    // instrumentation, only updated while listener stats are enabled
+    std::string _source;            ///< file:line of the setlistener() call
+    std::string _profileName;       ///< entry name for FGNasalProfiler
+    unsigned long _callCount;
+    double _totalUSec;
+    double _maxUSec;
 };
 
 
@@ -86,6 +98,8 @@ struct NasalTimer
     ~NasalTimer();
     
     naRef handler;
+    std::string name;               ///< settimer-file:line
+    std::string source;             ///< file:line
     int gcKey = 0;
     FGNasalSys* nasal = nullptr;
 };
@@ -44,6 +44,7 @@
 
 #include <AIModel/AIAircraft.hxx>
 #include <AIModel/AIFlightPlan.hxx>
+#include <AIModel/AIFlightPlanQueue.hxx>
 #include <AIModel/AIManager.hxx>
 #include <Airports/airport.hxx>
 #include <Main/fg_props.hxx>
@@ -71,7 +72,8 @@ FGAISchedule::FGAISchedule()
       courseToDest(0),
       initialized(false),
       valid(false),
-      scheduleComplete(false)
+      scheduleComplete(false),
+      nextUpdate(0)
 {
 }
 
@@ -109,7 +111,8 @@ FGAISchedule::FGAISchedule(const string& model,
       courseToDest(0),
       initialized(false),
       valid(true),
-      scheduleComplete(false)
+      scheduleComplete(false),
+      nextUpdate(0)
 {
 }
 
@@ -139,6 +142,7 @@ FGAISchedule::FGAISchedule(const FGAISchedule& other) : modelPath{other.modelPat
     initialized = other.initialized;
     valid = other.valid;
     scheduleComplete = other.scheduleComplete;
+    nextUpdate = other.nextUpdate;
 }
 
 
@@ -235,6 +239,7 @@ bool FGAISchedule::update(time_t now, const SGVec3d& userCart)
         if (aiAircraft->getDie()) {
             aiAircraft = NULL;
         } else {
+            nextUpdate = now + TRAFFIC_AI_ACTIVE_RECHECK_SEC;
             return true; // in visual range, let the AIManager handle it
         }
     }
@@ -248,17 +253,21 @@ bool FGAISchedule::update(time_t now, const SGVec3d& userCart)
         // and detach it from the current list of aircraft.
         flight->update();
         flights.erase(flights.begin()); // pop_front(), effectively
+        nextUpdate = now;               // look at the next leg straight away
         return true;                    // processing complete
     }
 
     FGAirport* dep = flight->getDepartureAirport();
     FGAirport* arr = flight->getArrivalAirport();
     if (!dep || !arr) {
+        // nothing will change before this leg is over
+        nextUpdate = flight->getArrivalTime() + 1;
         return true; // processing complete
     }
 
     double speed = 450.0;
     int remainingWaitTime = 0;
+    bool enroute = false;
     if (dep != arr) {
         totalTimeEnroute = flight->getArrivalTime() - flight->getDepartureTime();
         if (flight->getDepartureTime() < now) {
@@ -277,6 +286,7 @@ bool FGAISchedule::update(time_t now, const SGVec3d& userCart)
             SGGeodesy::direct(dep->geod(), course, coveredDistance, position, az2);
 
             SG_LOG(SG_AI, SG_BULK, "Traffic Manager: " << flight->getCallSign() << " is in progress " << (x * 100) << "%");
+            enroute = true;
             speed = ((distanceM - coveredDistance) * SG_METER_TO_NM) / 3600.0;
         } else {
             // not departed yet
@@ -308,17 +318,34 @@ bool FGAISchedule::update(time_t now, const SGVec3d& userCart)
         SG_LOG(SG_AI, SG_BULK, "Traffic manager: " << registration << " is scheduled for a flight from " << dep->getId() << " to " << arr->getId() << ". Current distance to user: " << distanceToUser);
     }
     if (distanceToUser >= TRAFFIC_TO_AI_DIST_TO_START) {
-        return true; // out of visual range, for the moment.
+        // Out of visual range, for the moment. While waiting at the gate
+        // only the user can close the distance; once en route both can.
+        if (enroute) {
+            setNextUpdate(now, distanceToUser, TRAFFIC_MAX_AI_SPEED_KTS + TRAFFIC_MAX_USER_SPEED_KTS,
+                          flight->getArrivalTime() + 1);
+        } else {
+            setNextUpdate(now, distanceToUser, TRAFFIC_MAX_USER_SPEED_KTS,
+                          std::min(flight->getDepartureTime(), flight->getArrivalTime() + 1));
+        }
+        return true;
     }
 
     if (!createAIAircraft(flight, speed, deptime, remainingTimeEnroute)) {
         valid = false;
     }
+    nextUpdate = now + TRAFFIC_AI_ACTIVE_RECHECK_SEC;
 
 
     return true; // processing complete
 }
 
+void FGAISchedule::setNextUpdate(time_t now, double distanceNm, double closingSpeedKts, time_t nextEvent)
+{
+    const double marginNm = distanceNm - TRAFFIC_TO_AI_DIST_TO_START;
+    const time_t untilInRange = static_cast<time_t>(marginNm / closingSpeedKts * 3600.0);
+    nextUpdate = now + std::max<time_t>(1, std::min(untilInRange, nextEvent - now));
+}
+
 bool FGAISchedule::validModelPath(const std::string& modelPath)
 {
     return (resolveModelPath(modelPath) != SGPath());
@@ -365,23 +392,55 @@ bool FGAISchedule::createAIAircraft(FGScheduledFlight* flight, double speedKnots
     aiAircraft->setBank(0);
 
     courseToDest = SGGeodesy::courseDeg(position, arr->geod());
-    std::unique_ptr<FGAIFlightPlan> fp(new FGAIFlightPlan(aiAircraft,
-                                                          flightPlanName,
-                                                          courseToDest,
-                                                          deptime,
-                                                          remainingTime,
-                                                          dep,
-                                                          arr,
-                                                          true,
-                                                          radius,
-                                                          flight->getCruiseAlt() * 100,
-                                                          position.getLatitudeDeg(),
-                                                          position.getLongitudeDeg(),
-                                                          speedKnots, flightType, acType,
-                                                          airline));
+
+    // everything the plan depends on is copied now, the builder runs in a
+    // later frame
+    SGSharedPtr<FGAIAircraft> ac = aiAircraft;
+    const double course = courseToDest;
+    const double groundRadius = radius;
+    const double cruiseAltFt = flight->getCruiseAlt() * 100;
+    const SGGeod pos = position;
+    const string fltType = flightType;
+    const string type = acType;
+    const string company = airline;
+    auto builder = [=]() {
+        return std::unique_ptr<FGAIFlightPlan>(new FGAIFlightPlan(ac,
+                                                                  flightPlanName,
+                                                                  course,
+                                                                  deptime,
+                                                                  remainingTime,
+                                                                  dep,
+                                                                  arr,
+                                                                  true,
+                                                                  groundRadius,
+                                                                  cruiseAltFt,
+                                                                  pos.getLatitudeDeg(),
+                                                                  pos.getLongitudeDeg(),
+                                                                  speedKnots, fltType, type,
+                                                                  company));
+    };
+
+    const string callsign = flight->getCallSign();
+    auto aiManager = globals->get_subsystem<FGAIManager>();
+    FGAIFlightPlanQueue* queue = aiManager ? aiManager->getFlightPlanQueue() : nullptr;
+    if (!queue) {
+        attachAIAircraft(builder(), dep, arr, deptime, callsign);
+        return valid;
+    }
+
+    // the aircraft dies with us, which drops the job; so capturing this is safe
+    queue->push(aiAircraft, builder, [this, dep, arr, deptime, callsign](std::unique_ptr<FGAIFlightPlan> fp) {
+        attachAIAircraft(std::move(fp), dep, arr, deptime, callsign);
+    });
+    return true;
+}
+
+void FGAISchedule::attachAIAircraft(std::unique_ptr<FGAIFlightPlan> fp, FGAirport* dep, FGAirport* arr,
+                                    time_t deptime, const string& callsign)
+{
     if (fp->isValidPlan()) {
         // set this here so it's available inside attach, which calls AIBase::init
-        simgear::ErrorReportContext ec{"traffic-aircraft-callsign", flight->getCallSign()};
+        simgear::ErrorReportContext ec{"traffic-aircraft-callsign", callsign};
 
         aiAircraft->FGAIBase::setFlightPlan(std::move(fp));
         globals->get_subsystem<FGAIManager>()->attach(aiAircraft);
@@ -396,15 +455,14 @@ bool FGAISchedule::createAIAircraft(FGScheduledFlight* flight, double speedKnots
                 // arrival time not known here
             }
         }
-        return true;
     } else {
         aiAircraft = NULL;
+        valid = false;
         //hand back the flights that had already been scheduled
         while (!flights.empty()) {
             flights.front()->release();
             flights.erase(flights.begin());
         }
-        return false;
     }
 }
 
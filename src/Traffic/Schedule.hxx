@@ -28,11 +28,22 @@
 
 #pragma once
 
+#include <memory>
+
 constexpr double TRAFFIC_TO_AI_DIST_TO_START = 150.0;
 constexpr double TRAFFIC_TO_AI_DIST_TO_DIE = 200.0;
 
+// Upper bounds used to decide how long a distant schedule can be left alone
+// before it could possibly come within TRAFFIC_TO_AI_DIST_TO_START of the user.
+constexpr double TRAFFIC_MAX_AI_SPEED_KTS = 650.0;
+constexpr double TRAFFIC_MAX_USER_SPEED_KTS = 1200.0;
+// re-check interval while the AIManager owns our aircraft
+constexpr time_t TRAFFIC_AI_ACTIVE_RECHECK_SEC = 30;
+
 // forward decls
 class FGAIAircraft;
+class FGAIFlightPlan;
+class FGAirport;
 class FGScheduledFlight;
 
 typedef std::vector<FGScheduledFlight*> FGScheduledFlightVec;
@@ -66,16 +77,31 @@ private:
     bool initialized;
     bool valid;
     bool scheduleComplete;
+    time_t nextUpdate;
+
+    /**
+     * Compute when update() needs to look at us again, given the distance
+     * (nm) to the user and the time of the next scheduled state change.
+     */
+    void setNextUpdate(time_t now, double distanceNm, double closingSpeedKts, time_t nextEvent);
 
     bool scheduleFlights(time_t now);
     int groundTimeFromRadius();
 
     /**
    * Transition this schedule from distant mode to AI mode;
-   * create the AIAircraft (and flight plan) and register with the AIManager
+   * create the AIAircraft and queue its flight plan with the AIManager,
+   * which registers the aircraft once the plan is ready
    */
     bool createAIAircraft(FGScheduledFlight* flight, double speedKnots, time_t deptime, time_t remainingTime);
 
+    /**
+   * Second half of createAIAircraft, once the flight plan was built.
+   * On failure, the aircraft is dropped and the schedule becomes invalid.
+   */
+    void attachAIAircraft(std::unique_ptr<FGAIFlightPlan> fp, FGAirport* dep, FGAirport* arr,
+                          time_t deptime, const std::string& callsign);
+
     // the aiAircraft associated with us
     SGSharedPtr<FGAIAircraft> aiAircraft;
 
@@ -103,6 +129,15 @@ public:
     bool update(time_t now, const SGVec3d& userCart);
     bool init();
 
+    /**
+     * Earliest time at which calling update() may change anything: the next
+     * departure/arrival of the current leg, or the earliest time at which
+     * the aircraft could come within range of a user flying at no more than
+     * TRAFFIC_MAX_USER_SPEED_KTS. Valid after update() returned true.
+     */
+    time_t getNextUpdateTime() const { return nextUpdate; }
+    bool isValid() const { return valid; }
+
     double getSpeed();
     //void setClosestDistanceToUser();
     bool next(); // forces the schedule to move on to the next flight.
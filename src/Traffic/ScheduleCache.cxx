@@ -0,0 +1,395 @@
+/******************************************************************************
+ * ScheduleCache.cxx
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ *
+ **************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+
+#include <simgear/debug/logstream.hxx>
+#include <simgear/io/sg_mmap.hxx>
+#include <simgear/misc/sg_dir.hxx>
+
+#include <Main/globals.hxx>
+#include <Navaids/BinaryCacheFile.hxx>
+
+#include "ScheduleCache.hxx"
+
+using flightgear::binaryCacheAlign;
+using flightgear::binaryCacheSectionFits;
+
+namespace {
+
+const char CACHE_MAGIC[8] = {'F', 'G', 'T', 'R', 'A', 'F', 'F', 'C'};
+const uint32_t CACHE_VERSION = 1;
+
+// All sections start on an 8-byte boundary, so the records can be used
+// in place from the mapped file.
+struct CacheHeader
+{
+    flightgear::BinaryCacheHeader common;
+    uint32_t numStrings;
+    uint32_t numSources;
+    uint32_t numAircraft;
+    uint32_t numFlights;
+    uint64_t stringOffsetsPos;  ///< uint64_t[numStrings + 1], relative to stringDataPos
+    uint64_t stringDataPos;
+    uint64_t sourcesPos;
+    uint64_t aircraftPos;
+    uint64_t flightsPos;
+    uint64_t fileSize;
+};
+
+struct SourceRecord
+{
+    int64_t modTime;
+    uint64_t size;
+    uint32_t path;
+    uint32_t included;
+};
+
+struct AircraftRecord
+{
+    double radius;
+    double offset;
+    uint32_t model, livery, homePort, registration, requiredAircraft,
+        acType, airline, perfClass, flightType;
+    uint32_t heavy;
+};
+
+struct FlightRecord
+{
+    uint32_t callsign, fltRules, departurePort, arrivalPort,
+        departureTime, arrivalTime, repeat, requiredAircraft;
+    int32_t cruiseAlt;
+    uint32_t padding;
+};
+
+} // of anonymous namespace
+
+class TrafficScheduleCache::Writer
+{
+public:
+    uint32_t intern(const std::string& s)
+    {
+        auto it = stringIds.find(s);
+        if (it != stringIds.end()) {
+            return it->second;
+        }
+
+        const uint32_t id = static_cast<uint32_t>(stringOffsets.size());
+        stringOffsets.push_back(stringData.size());
+        stringData.append(s);
+        stringIds.emplace(s, id);
+        return id;
+    }
+
+    std::unordered_map<std::string, uint32_t> stringIds;
+    std::vector<uint64_t> stringOffsets;
+    std::string stringData;
+
+    std::vector<SourceRecord> sources;
+    std::vector<AircraftRecord> aircraft;
+    std::vector<FlightRecord> flights;
+};
+
+TrafficScheduleCache::TrafficScheduleCache(const SGPath& cacheFile) :
+    _path(cacheFile)
+{
+}
+
+TrafficScheduleCache::~TrafficScheduleCache() = default;
+
+SGPath TrafficScheduleCache::defaultPath()
+{
+    return globals->get_fg_home() / "ai" / "traffic-schedules.cache";
+}
+
+PathList TrafficScheduleCache::findTrafficFiles(const PathList& trafficDirs)
+{
+    // must match the traversal order of ScheduleParseThread::parseTrafficDir
+    PathList result;
+    for (const auto& dir : trafficDirs) {
+        simgear::Dir trafficDir(dir);
+        for (const auto& sub : trafficDir.children(simgear::Dir::TYPE_DIR | simgear::Dir::NO_DOT_OR_DOTDOT)) {
+            simgear::Dir d2(sub);
+            for (const auto& xml : d2.children(simgear::Dir::TYPE_FILE, ".xml")) {
+                result.push_back(xml);
+            }
+        }
+    }
+    return result;
+}
+
+void TrafficScheduleCache::addSource(const SGPath& path, bool included)
+{
+    if (!_writer) {
+        _writer.reset(new Writer);
+    }
+
+    SourceRecord r;
+    r.modTime = path.modTime();
+    r.size = path.sizeInBytes();
+    r.path = _writer->intern(path.utf8Str());
+    r.included = included ? 1 : 0;
+    _writer->sources.push_back(r);
+}
+
+void TrafficScheduleCache::addAircraft(const TrafficCacheAircraft& ac)
+{
+    if (!_writer) {
+        _writer.reset(new Writer);
+    }
+
+    AircraftRecord r;
+    r.radius = ac.radius;
+    r.offset = ac.offset;
+    r.model = _writer->intern(ac.model);
+    r.livery = _writer->intern(ac.livery);
+    r.homePort = _writer->intern(ac.homePort);
+    r.registration = _writer->intern(ac.registration);
+    r.requiredAircraft = _writer->intern(ac.requiredAircraft);
+    r.acType = _writer->intern(ac.acType);
+    r.airline = _writer->intern(ac.airline);
+    r.perfClass = _writer->intern(ac.perfClass);
+    r.flightType = _writer->intern(ac.flightType);
+    r.heavy = ac.heavy ? 1 : 0;
+    _writer->aircraft.push_back(r);
+}
+
+void TrafficScheduleCache::addFlight(const TrafficCacheFlight& flight)
+{
+    if (!_writer) {
+        _writer.reset(new Writer);
+    }
+
+    FlightRecord r;
+    r.callsign = _writer->intern(flight.callsign);
+    r.fltRules = _writer->intern(flight.fltRules);
+    r.departurePort = _writer->intern(flight.departurePort);
+    r.arrivalPort = _writer->intern(flight.arrivalPort);
+    r.departureTime = _writer->intern(flight.departureTime);
+    r.arrivalTime = _writer->intern(flight.arrivalTime);
+    r.repeat = _writer->intern(flight.repeat);
+    r.requiredAircraft = _writer->intern(flight.requiredAircraft);
+    r.cruiseAlt = flight.cruiseAlt;
+    r.padding = 0;
+    _writer->flights.push_back(r);
+}
+
+bool TrafficScheduleCache::write()
+{
+    if (!_writer) {
+        return false;
+    }
+
+    Writer& w = *_writer;
+    w.stringOffsets.push_back(w.stringData.size()); // end of the last string
+
+    CacheHeader header;
+    memset(&header, 0, sizeof(header));
+    header.common.init(CACHE_MAGIC, CACHE_VERSION);
+    header.numStrings = static_cast<uint32_t>(w.stringOffsets.size() - 1);
+    header.numSources = static_cast<uint32_t>(w.sources.size());
+    header.numAircraft = static_cast<uint32_t>(w.aircraft.size());
+    header.numFlights = static_cast<uint32_t>(w.flights.size());
+
+    uint64_t pos = binaryCacheAlign(sizeof(CacheHeader));
+    header.stringOffsetsPos = pos;
+    pos = binaryCacheAlign(pos + w.stringOffsets.size() * sizeof(uint64_t));
+    header.sourcesPos = pos;
+    pos = binaryCacheAlign(pos + w.sources.size() * sizeof(SourceRecord));
+    header.aircraftPos = pos;
+    pos = binaryCacheAlign(pos + w.aircraft.size() * sizeof(AircraftRecord));
+    header.flightsPos = pos;
+    pos = binaryCacheAlign(pos + w.flights.size() * sizeof(FlightRecord));
+    header.stringDataPos = pos;
+    header.fileSize = pos + w.stringData.size();
+
+    flightgear::BinaryCacheWriter f(_path);
+    if (!f.isOpen()) {
+        return false;
+    }
+
+    f.write(&header, sizeof(header));
+    f.padTo(header.stringOffsetsPos);
+    f.write(w.stringOffsets.data(), w.stringOffsets.size() * sizeof(uint64_t));
+    f.padTo(header.sourcesPos);
+    f.write(w.sources.data(), w.sources.size() * sizeof(SourceRecord));
+    f.padTo(header.aircraftPos);
+    f.write(w.aircraft.data(), w.aircraft.size() * sizeof(AircraftRecord));
+    f.padTo(header.flightsPos);
+    f.write(w.flights.data(), w.flights.size() * sizeof(FlightRecord));
+    f.padTo(header.stringDataPos);
+    f.write(w.stringData.data(), w.stringData.size());
+    if (!f.commit()) {
+        return false;
+    }
+
+    SG_LOG(SG_AI, SG_INFO, "Traffic schedule cache: wrote " << header.numAircraft << " aircraft and "
+           << header.numFlights << " flights to " << _path);
+    _writer.reset();
+    return true;
+}
+
+bool TrafficScheduleCache::load(const PathList& trafficFiles,
+                                const AircraftCallback& aircraftCb,
+                                const FlightCallback& flightCb) const
+{
+    if (!_path.exists()) {
+        return false;
+    }
+
+    SGMMapFile mmap(_path);
+    if (!mmap.open(SG_IO_IN)) {
+        return false;
+    }
+
+    const char* base = mmap.get();
+    const uint64_t length = mmap.get_size();
+    if (!base || (length < sizeof(CacheHeader))) {
+        return false;
+    }
+
+    const CacheHeader* header = reinterpret_cast<const CacheHeader*>(base);
+    if (!header->common.matches(CACHE_MAGIC, CACHE_VERSION) ||
+        (header->fileSize != length))
+    {
+        SG_LOG(SG_AI, SG_INFO, "Traffic schedule cache: ignoring incompatible cache file " << _path);
+        return false;
+    }
+
+    // validate section bounds before touching any record
+    if (!binaryCacheSectionFits(length, header->stringOffsetsPos, uint64_t(header->numStrings) + 1, sizeof(uint64_t)) ||
+        !binaryCacheSectionFits(length, header->sourcesPos, header->numSources, sizeof(SourceRecord)) ||
+        !binaryCacheSectionFits(length, header->aircraftPos, header->numAircraft, sizeof(AircraftRecord)) ||
+        !binaryCacheSectionFits(length, header->flightsPos, header->numFlights, sizeof(FlightRecord)) ||
+        (header->stringDataPos > length))
+    {
+        SG_LOG(SG_AI, SG_WARN, "Traffic schedule cache: damaged cache file " << _path);
+        return false;
+    }
+
+    const uint64_t* stringOffsets = reinterpret_cast<const uint64_t*>(base + header->stringOffsetsPos);
+    const char* stringData = base + header->stringDataPos;
+    const uint64_t stringDataLength = length - header->stringDataPos;
+    const uint32_t numStrings = header->numStrings;
+
+    bool stringsValid = true;
+    auto str = [&](uint32_t id) -> std::string_view {
+        if ((id >= numStrings) || (stringOffsets[id] > stringOffsets[id + 1]) ||
+            (stringOffsets[id + 1] > stringDataLength))
+        {
+            stringsValid = false;
+            return std::string_view();
+        }
+        return std::string_view(stringData + stringOffsets[id], stringOffsets[id + 1] - stringOffsets[id]);
+    };
+
+    // up-to-date check: same traffic files, in the same order, unmodified;
+    // included files must be unmodified too
+    const SourceRecord* sources = reinterpret_cast<const SourceRecord*>(base + header->sourcesPos);
+    size_t fileIndex = 0;
+    for (uint32_t i = 0; i < header->numSources; ++i) {
+        const SourceRecord& src = sources[i];
+        const SGPath path = SGPath::fromUtf8(std::string(str(src.path)));
+        if (!src.included) {
+            if ((fileIndex >= trafficFiles.size()) ||
+                (trafficFiles[fileIndex].utf8Str() != path.utf8Str()))
+            {
+                SG_LOG(SG_AI, SG_INFO, "Traffic schedule cache: set of traffic files changed");
+                return false;
+            }
+            ++fileIndex;
+        }
+
+        if (!path.exists() || (path.modTime() != src.modTime) ||
+            (static_cast<uint64_t>(path.sizeInBytes()) != src.size))
+        {
+            SG_LOG(SG_AI, SG_INFO, "Traffic schedule cache: " << path << " was modified");
+            return false;
+        }
+    }
+
+    if (!stringsValid || (fileIndex != trafficFiles.size())) {
+        SG_LOG(SG_AI, SG_INFO, "Traffic schedule cache: set of traffic files changed");
+        return false;
+    }
+
+    // resolve everything first, so a damaged string table is detected
+    // before any record was handed out
+    std::vector<TrafficCacheAircraft> aircraft;
+    aircraft.reserve(header->numAircraft);
+    const AircraftRecord* acRecords = reinterpret_cast<const AircraftRecord*>(base + header->aircraftPos);
+    for (uint32_t i = 0; i < header->numAircraft; ++i) {
+        const AircraftRecord& r = acRecords[i];
+        TrafficCacheAircraft ac;
+        ac.model = str(r.model);
+        ac.livery = str(r.livery);
+        ac.homePort = str(r.homePort);
+        ac.registration = str(r.registration);
+        ac.requiredAircraft = str(r.requiredAircraft);
+        ac.acType = str(r.acType);
+        ac.airline = str(r.airline);
+        ac.perfClass = str(r.perfClass);
+        ac.flightType = str(r.flightType);
+        ac.heavy = (r.heavy != 0);
+        ac.radius = r.radius;
+        ac.offset = r.offset;
+        aircraft.push_back(std::move(ac));
+    }
+
+    std::vector<TrafficCacheFlight> flights;
+    flights.reserve(header->numFlights);
+    const FlightRecord* fltRecords = reinterpret_cast<const FlightRecord*>(base + header->flightsPos);
+    for (uint32_t i = 0; i < header->numFlights; ++i) {
+        const FlightRecord& r = fltRecords[i];
+        TrafficCacheFlight flt;
+        flt.callsign = str(r.callsign);
+        flt.fltRules = str(r.fltRules);
+        flt.departurePort = str(r.departurePort);
+        flt.arrivalPort = str(r.arrivalPort);
+        flt.departureTime = str(r.departureTime);
+        flt.arrivalTime = str(r.arrivalTime);
+        flt.repeat = str(r.repeat);
+        flt.requiredAircraft = str(r.requiredAircraft);
+        flt.cruiseAlt = r.cruiseAlt;
+        flights.push_back(std::move(flt));
+    }
+
+    if (!stringsValid) {
+        SG_LOG(SG_AI, SG_WARN, "Traffic schedule cache: damaged cache file " << _path);
+        return false;
+    }
+
+    for (const auto& ac : aircraft) {
+        aircraftCb(ac);
+    }
+
+    for (const auto& flt : flights) {
+        flightCb(flt);
+    }
+
+    return true;
+}
@@ -0,0 +1,109 @@
+/* -*- Mode: C++ -*- *****************************************************
+ * ScheduleCache.hxx
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ *
+ **************************************************************************/
+
+/**************************************************************************
+ * Binary cache of the parsed traffic schedules.
+ *
+ * Parsing all traffic XML files is slow with the full traffic packs, so
+ * the parsed aircraft and flight records are stored in $FG_HOME in a flat
+ * layout (header, string table, fixed-size records) which is mapped into
+ * memory on the next start. The cache remembers the modification time and
+ * size of every file that contributed to it, including files pulled in via
+ * "include", and is discarded as soon as any of them changes.
+ *
+ * Only the raw records are cached: model path validation, the
+ * traffic proportion and time-of-week processing depend on the current
+ * installation and time, so they are still performed when loading.
+ **************************************************************************/
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <simgear/misc/sg_path.hxx>
+
+struct TrafficCacheAircraft
+{
+    std::string model;
+    std::string livery;
+    std::string homePort;
+    std::string registration;
+    std::string requiredAircraft;
+    std::string acType;
+    std::string airline;
+    std::string perfClass;
+    std::string flightType;
+    bool heavy = false;
+    double radius = 0.0;
+    double offset = 0.0;
+};
+
+struct TrafficCacheFlight
+{
+    std::string callsign;
+    std::string fltRules;
+    std::string departurePort;
+    std::string arrivalPort;
+    std::string departureTime;
+    std::string arrivalTime;
+    std::string repeat;
+    std::string requiredAircraft;
+    int cruiseAlt = 0;
+};
+
+class TrafficScheduleCache
+{
+public:
+    explicit TrafficScheduleCache(const SGPath& cacheFile);
+    ~TrafficScheduleCache();
+
+    /// $FG_HOME/ai/traffic-schedules.cache
+    static SGPath defaultPath();
+
+    /// all traffic files (<dir>/<subdir>/*.xml), in parse order
+    static PathList findTrafficFiles(const PathList& trafficDirs);
+
+    typedef std::function<void(const TrafficCacheAircraft&)> AircraftCallback;
+    typedef std::function<void(const TrafficCacheFlight&)> FlightCallback;
+
+    /**
+     * Load the cache if it is up to date with respect to @a trafficFiles,
+     * passing every record to the callbacks, in the order they were
+     * originally parsed. Returns false (without invoking any callback) if
+     * the cache is missing, damaged or stale.
+     */
+    bool load(const PathList& trafficFiles,
+              const AircraftCallback& aircraftCb,
+              const FlightCallback& flightCb) const;
+
+    // writing: record everything during a full parse, then write()
+    void addSource(const SGPath& path, bool included);
+    void addAircraft(const TrafficCacheAircraft& ac);
+    void addFlight(const TrafficCacheFlight& flight);
+    bool write();
+
+private:
+    class Writer;
+    SGPath _path;
+    std::unique_ptr<Writer> _writer;
+};
@@ -0,0 +1,134 @@
+/******************************************************************************
+ * ScheduleQueue.cxx
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ *
+ **************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "ScheduleQueue.hxx"
+
+#include <simgear/timing/timestamp.hxx>
+
+void TrafficScheduleQueue::reset(const ScheduleVector& schedules, time_t now)
+{
+    clear();
+
+    std::vector<Entry> entries;
+    entries.reserve(schedules.size());
+    for (size_t rank = 0; rank < schedules.size(); ++rank) {
+        Slot& slot = _slots[schedules[rank]];
+        slot.rank = rank;
+        if (schedules[rank]->isValid()) {
+            slot.queued = true;
+            ++_queuedCount;
+            entries.push_back({now, rank, slot.serial, schedules[rank]});
+        }
+    }
+
+    _heap = decltype(_heap)(std::greater<Entry>(), std::move(entries));
+}
+
+void TrafficScheduleQueue::clear()
+{
+    _heap = decltype(_heap)();
+    _slots.clear();
+    _queuedCount = 0;
+}
+
+void TrafficScheduleQueue::push(FGAISchedule* schedule, time_t due)
+{
+    auto it = _slots.find(schedule);
+    if (it == _slots.end()) {
+        // not seen by reset(), rank it behind all the others
+        it = _slots.emplace(schedule, Slot{_slots.size(), 0, false}).first;
+    }
+
+    Slot& slot = it->second;
+    if (slot.queued) {
+        ++slot.serial; // supersedes the queued entry
+    } else {
+        slot.queued = true;
+        ++_queuedCount;
+    }
+
+    _heap.push({due, slot.rank, slot.serial, schedule});
+}
+
+void TrafficScheduleQueue::skipStale()
+{
+    while (!_heap.empty()) {
+        const Entry& top = _heap.top();
+        const Slot& slot = _slots[top.schedule];
+        if (slot.queued && (slot.serial == top.serial)) {
+            return;
+        }
+        _heap.pop();
+    }
+}
+
+FGAISchedule* TrafficScheduleQueue::popDue(time_t now)
+{
+    skipStale();
+    if (_heap.empty() || (_heap.top().due > now)) {
+        return nullptr;
+    }
+
+    FGAISchedule* schedule = _heap.top().schedule;
+    _heap.pop();
+
+    Slot& slot = _slots[schedule];
+    slot.queued = false;
+    ++slot.serial;
+    --_queuedCount;
+    return schedule;
+}
+
+int TrafficScheduleQueue::processDue(time_t now, double budgetMsec,
+                                     const std::function<bool(FGAISchedule*)>& update)
+{
+    SGTimeStamp st;
+    st.stamp();
+
+    int processed = 0;
+    while (FGAISchedule* schedule = popDue(now)) {
+        ++processed;
+        if (!update(schedule)) {
+            // processing was preempted, continue with it next frame
+            push(schedule, now);
+            break;
+        }
+
+        if (schedule->isValid()) {
+            push(schedule, schedule->getNextUpdateTime());
+        }
+
+        if (st.elapsedMSec() > budgetMsec) {
+            break;
+        }
+    }
+
+    return processed;
+}
+
+bool TrafficScheduleQueue::hasDue(time_t now)
+{
+    skipStale();
+    return !_heap.empty() && (_heap.top().due <= now);
+}
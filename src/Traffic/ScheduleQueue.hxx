@@ -0,0 +1,108 @@
+/* -*- Mode: C++ -*- *****************************************************
+ * ScheduleQueue.hxx
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ *
+ **************************************************************************/
+
+/**************************************************************************
+ * Activation queue of the traffic manager.
+ *
+ * Schedules are ordered by the time at which they next need attention (see
+ * FGAISchedule::getNextUpdateTime), ties broken by score rank. Each frame
+ * only the entries which are due are processed, so the cost per frame
+ * does not depend on the total number of schedules.
+ *
+ * A schedule is queued at most once: pushing it again replaces the earlier
+ * entry, which is left in the heap and skipped when it surfaces.
+ **************************************************************************/
+
+#pragma once
+
+#include <ctime>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+#include "Schedule.hxx"
+
+class TrafficScheduleQueue
+{
+public:
+    /**
+     * Queue every valid schedule as due at now. Their order in the vector
+     * is their rank, used to order schedules due at the same time.
+     */
+    void reset(const ScheduleVector& schedules, time_t now);
+
+    void clear();
+
+    /**
+     * Queue a schedule to be processed at due, replacing any entry for it
+     * which is already queued.
+     */
+    void push(FGAISchedule* schedule, time_t due);
+
+    /**
+     * Remove and return the earliest schedule due by now, or nullptr if
+     * none is due.
+     */
+    FGAISchedule* popDue(time_t now);
+
+    /**
+     * Run update on each schedule due by now, earliest first, requeueing
+     * it at its next update time while it stays valid. Stops when nothing
+     * more is due, when budgetMsec has been spent, or when update returns
+     * false, in which case the schedule is due again straight away.
+     * Returns the number of schedules processed.
+     */
+    int processDue(time_t now, double budgetMsec, const std::function<bool(FGAISchedule*)>& update);
+
+    bool hasDue(time_t now);
+
+    /// number of schedules queued
+    size_t size() const
+    { return _queuedCount; }
+
+private:
+    struct Entry
+    {
+        time_t due;
+        size_t rank;
+        unsigned int serial;
+        FGAISchedule* schedule;
+
+        bool operator>(const Entry& other) const
+        {
+            return (due > other.due) || ((due == other.due) && (rank > other.rank));
+        }
+    };
+
+    struct Slot
+    {
+        size_t rank = 0;
+        unsigned int serial = 0;
+        bool queued = false;
+    };
+
+    /// drop superseded entries from the top of the heap
+    void skipStale();
+
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> _heap;
+    std::unordered_map<const FGAISchedule*, Slot> _slots;
+    size_t _queuedCount = 0;
+};
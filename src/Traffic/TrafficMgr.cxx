@@ -53,6 +53,7 @@
 #include <algorithm>
 
 #include <simgear/compiler.h>
+#include <simgear/constants.h>
 #include <simgear/debug/ErrorReportingCallback.hxx>
 #include <simgear/io/iostreams/sgstream.hxx>
 #include <simgear/misc/sg_dir.hxx>
@@ -62,6 +63,7 @@
 #include <simgear/structure/subsystem_mgr.hxx>
 #include <simgear/threads/SGThread.hxx>
 #include <simgear/timing/sg_time.hxx>
+#include <simgear/timing/timestamp.hxx>
 
 #include <simgear/xml/easyxml.hxx>
 #include <simgear/scene/tsync/terrasync.hxx>
@@ -77,6 +79,7 @@
 #include <Main/fg_props.hxx>
 #include <Main/sentryIntegration.hxx>
 
+#include "ScheduleCache.hxx"
 #include "TrafficMgr.hxx"
 
 using std::sort;
@@ -85,6 +88,10 @@ using std::endl;
 using std::string;
 using std::vector;
 
+// a jump of the user position larger than this between two updates is
+// treated as a relocation, invalidating all computed wake-up times
+static const double TRAFFIC_RELOCATION_DIST_NM = 20.0;
+
 /**
  * Thread encapsulating parsing the traffic schedules.
  */
@@ -123,6 +130,11 @@ public:
     _trafficDirPaths = dirs;
   }
 
+  void setUseCache(bool useCache)
+  {
+    _useCache = useCache;
+  }
+
   bool isFinished() const
   {
     std::lock_guard<std::mutex> g(_lock);
@@ -131,6 +143,27 @@ public:
 
   void run() override
   {
+      if (_useCache) {
+          SGTimeStamp st;
+          st.stamp();
+
+          const PathList files = TrafficScheduleCache::findTrafficFiles(_trafficDirPaths);
+          TrafficScheduleCache cache(TrafficScheduleCache::defaultPath());
+          const bool loaded = cache.load(files,
+              [this](const TrafficCacheAircraft& ac) { addAircraft(ac); },
+              [this](const TrafficCacheFlight& flt) { addFlight(flt); });
+
+          if (loaded) {
+              SG_LOG(SG_AI, SG_INFO, "loading traffic schedules from cache took:" << st.elapsedMSec() << "msec");
+              std::lock_guard<std::mutex> g(_lock);
+              _isFinished = true;
+              return;
+          }
+
+          // record everything we parse, to write a fresh cache at the end
+          _cacheWriter.reset(new TrafficScheduleCache(TrafficScheduleCache::defaultPath()));
+      }
+
       for (const auto& p : _trafficDirPaths) {
           parseTrafficDir(p);
           if (_cancelThread) {
@@ -138,6 +171,11 @@ public:
           }
       }
 
+      if (_cacheWriter) {
+          _cacheWriter->write();
+          _cacheWriter.reset();
+      }
+
     std::lock_guard<std::mutex> g(_lock);
     _isFinished = true;
   }
@@ -168,6 +206,9 @@ public:
             SGPath path = globals->get_fg_root();
             path.append("/Traffic/");
             path.append(attval);
+            if (_cacheWriter) {
+                _cacheWriter->addSource(path, true);
+            }
             readXML(path, *this);
         }
         elementValueStack.push_back("");
@@ -249,34 +290,22 @@ public:
                 snprintf(buffer, 16, "%d", acCounter);
                 requiredAircraft = buffer;
             }
-            SG_LOG(SG_AI, SG_BULK, "Adding flight: " << callsign << " "
-                   << fltrules << " "
-                   << departurePort << " "
-                   << arrivalPort << " "
-                   << cruiseAlt << " "
-                   << departureTime << " "
-                   << arrivalTime << " " << repeat << " " << requiredAircraft);
-            // For database maintenance purposes, it may be convenient to
-            //
-            if (fgGetBool("/sim/traffic-manager/dumpdata") == true) {
-                SG_LOG(SG_AI, SG_ALERT, "Traffic Dump FLIGHT," << callsign << ","
-                       << fltrules << ","
-                       << departurePort << ","
-                       << arrivalPort << ","
-                       << cruiseAlt << ","
-                       << departureTime << ","
-                       << arrivalTime << "," << repeat << "," << requiredAircraft);
+
+            TrafficCacheFlight flt;
+            flt.callsign = callsign;
+            flt.fltRules = fltrules;
+            flt.departurePort = departurePort;
+            flt.arrivalPort = arrivalPort;
+            flt.cruiseAlt = cruiseAlt;
+            flt.departureTime = departureTime;
+            flt.arrivalTime = arrivalTime;
+            flt.repeat = repeat;
+            flt.requiredAircraft = requiredAircraft;
+            if (_cacheWriter) {
+                _cacheWriter->addFlight(flt);
             }
 
-            _trafficManager->flights[requiredAircraft].push_back(new FGScheduledFlight(callsign,
-                                                                      fltrules,
-                                                                      departurePort,
-                                                                      arrivalPort,
-                                                                      cruiseAlt,
-                                                                      departureTime,
-                                                                      arrivalTime,
-                                                                      repeat,
-                                                                      requiredAircraft));
+            addFlight(flt);
             requiredAircraft = "";
         } else if (!strcmp(name, "aircraft")) {
             endAircraft();
@@ -313,63 +342,125 @@ public:
 private:
     void endAircraft()
     {
-        string isHeavy = heavy ? "true" : "false";
+        // The implicit aircraft id pairs this aircraft with the preceding
+        // flights lacking a <required-aircraft>. It is consumed even if the
+        // aircraft is rejected below, so those flights are never attributed
+        // to the next aircraft, and the ids don't depend on the random
+        // proportion filter (which matters for the schedule cache).
+        if (requiredAircraft == "") {
+            char buffer[16];
+            snprintf(buffer, 16, "%d", acCounter);
+            requiredAircraft = buffer;
+        }
+        if (homePort == "") {
+            homePort = departurePort;
+        }
+
+        TrafficCacheAircraft ac;
+        ac.model = mdl;
+        ac.livery = livery;
+        ac.homePort = homePort;
+        ac.registration = registration;
+        ac.requiredAircraft = requiredAircraft;
+        ac.acType = acType;
+        ac.airline = airline;
+        ac.perfClass = m_class;
+        ac.flightType = flighttype;
+        ac.heavy = heavy;
+        ac.radius = radius;
+        ac.offset = offset;
+        if (_cacheWriter) {
+            _cacheWriter->addAircraft(ac);
+        }
 
-        if (missingModels.find(mdl) != missingModels.end()) {
+        addAircraft(ac);
+
+        acCounter++;
+        requiredAircraft = "";
+        homePort = "";
+        score = 0;
+    }
+
+    /**
+     * Create the schedule for a parsed (or cached) aircraft, unless its
+     * model is missing or it is dropped by the traffic proportion.
+     */
+    void addAircraft(const TrafficCacheAircraft& ac)
+    {
+        if (missingModels.find(ac.model) != missingModels.end()) {
             // don't stat() or warn again
-            requiredAircraft = homePort = "";
             return;
         }
 
-        if (!FGAISchedule::validModelPath(mdl)) {
-            missingModels.insert(mdl);
-            simgear::reportFailure(simgear::LoadFailure::NotFound, simgear::ErrorCode::AITrafficSchedule, "Missing traffic model path:" + mdl, _currentFile);
-            requiredAircraft = homePort = "";
-            return;
+        if (validModels.find(ac.model) == validModels.end()) {
+            if (!FGAISchedule::validModelPath(ac.model)) {
+                missingModels.insert(ac.model);
+                simgear::reportFailure(simgear::LoadFailure::NotFound, simgear::ErrorCode::AITrafficSchedule, "Missing traffic model path:" + ac.model, _currentFile);
+                return;
+            }
+            validModels.insert(ac.model);
         }
 
         int proportion =
         (int) (fgGetDouble("/sim/traffic-manager/proportion") * 100);
         int randval = rand() & 100;
         if (randval > proportion) {
-            requiredAircraft = homePort = "";
             return;
         }
 
         if (fgGetBool("/sim/traffic-manager/dumpdata") == true) {
-            SG_LOG(SG_AI, SG_ALERT, "Traffic Dump AC," << homePort << "," << registration << "," << requiredAircraft
-                   << "," << acType << "," << livery << ","
-                   << airline << ","  << m_class << "," << offset << "," << radius << "," << flighttype << "," << isHeavy << "," << mdl);
-        }
-
-        if (requiredAircraft == "") {
-            char buffer[16];
-            snprintf(buffer, 16, "%d", acCounter);
-            requiredAircraft = buffer;
-        }
-        if (homePort == "") {
-            homePort = departurePort;
+            string isHeavy = ac.heavy ? "true" : "false";
+            SG_LOG(SG_AI, SG_ALERT, "Traffic Dump AC," << ac.homePort << "," << ac.registration << "," << ac.requiredAircraft
+                   << "," << ac.acType << "," << ac.livery << ","
+                   << ac.airline << ","  << ac.perfClass << "," << ac.offset << "," << ac.radius << "," << ac.flightType << "," << isHeavy << "," << ac.model);
         }
 
         // caution, modifying the scheduled aircraft structure from the
         // 'wrong' thread. This is safe because FGTrafficManager won't touch
         // the structure while we exist.
-        _trafficManager->scheduledAircraft.push_back(new FGAISchedule(mdl,
-                                                     livery,
-                                                     homePort,
-                                                     registration,
-                                                     requiredAircraft,
-                                                     heavy,
-                                                     acType,
-                                                     airline,
-                                                     m_class,
-                                                     flighttype,
-                                                     radius, offset));
+        _trafficManager->scheduledAircraft.push_back(new FGAISchedule(ac.model,
+                                                     ac.livery,
+                                                     ac.homePort,
+                                                     ac.registration,
+                                                     ac.requiredAircraft,
+                                                     ac.heavy,
+                                                     ac.acType,
+                                                     ac.airline,
+                                                     ac.perfClass,
+                                                     ac.flightType,
+                                                     ac.radius, ac.offset));
+    }
 
-        acCounter++;
-        requiredAircraft = "";
-        homePort = "";
-        score = 0;
+    void addFlight(const TrafficCacheFlight& flt)
+    {
+        SG_LOG(SG_AI, SG_BULK, "Adding flight: " << flt.callsign << " "
+               << flt.fltRules << " "
+               << flt.departurePort << " "
+               << flt.arrivalPort << " "
+               << flt.cruiseAlt << " "
+               << flt.departureTime << " "
+               << flt.arrivalTime << " " << flt.repeat << " " << flt.requiredAircraft);
+        // For database maintenance purposes, it may be convenient to
+        //
+        if (fgGetBool("/sim/traffic-manager/dumpdata") == true) {
+            SG_LOG(SG_AI, SG_ALERT, "Traffic Dump FLIGHT," << flt.callsign << ","
+                   << flt.fltRules << ","
+                   << flt.departurePort << ","
+                   << flt.arrivalPort << ","
+                   << flt.cruiseAlt << ","
+                   << flt.departureTime << ","
+                   << flt.arrivalTime << "," << flt.repeat << "," << flt.requiredAircraft);
+        }
+
+        _trafficManager->flights[flt.requiredAircraft].push_back(new FGScheduledFlight(flt.callsign,
+                                                                  flt.fltRules,
+                                                                  flt.departurePort,
+                                                                  flt.arrivalPort,
+                                                                  flt.cruiseAlt,
+                                                                  flt.departureTime,
+                                                                  flt.arrivalTime,
+                                                                  flt.repeat,
+                                                                  flt.requiredAircraft));
     }
 
     void parseTrafficDir(const SGPath& path)
@@ -388,6 +479,9 @@ private:
             simgear::PathList trafficFiles = d2.children(simgear::Dir::TYPE_FILE, ".xml");
             for (const auto& xml : trafficFiles) {
                 _currentFile = xml;
+                if (_cacheWriter) {
+                    _cacheWriter->addSource(xml, false);
+                }
                 try {
                     readXML(xml, *this);
                     if (_cancelThread) {
@@ -409,6 +503,8 @@ private:
   bool _cancelThread;
   simgear::PathList _trafficDirPaths;
   SGPath _currentFile;
+  bool _useCache = false;
+  std::unique_ptr<TrafficScheduleCache> _cacheWriter;
 
   // parser state
 
@@ -416,6 +512,7 @@ private:
   // record model paths which are missing, to avoid duplicate
   // warnings when parsing traffic schedules.
   std::set<std::string> missingModels;
+  std::set<std::string> validModels;
 
   std::string mdl, livery, registration, callsign, fltrules,
       port, timeString, departurePort, departureTime, arrivalPort, arrivalTime,
@@ -435,12 +532,17 @@ FGTrafficManager::FGTrafficManager() :
   doingInit(false),
   trafficSyncRequested(false),
   waitingMetarTime(0.0),
+  lastUpdateTime(0),
   enabled("/sim/traffic-manager/enabled"),
   aiEnabled("/sim/ai/enabled"),
   realWxEnabled("/environment/realwx/enabled"),
   metarValid("/environment/metar/valid"),
   active("/sim/traffic-manager/active"),
-  aiDataUpdateNow("/sim/terrasync/ai-data-update-now")
+  aiDataUpdateNow("/sim/terrasync/ai-data-update-now"),
+  updateBudgetMsec("/sim/traffic-manager/update-budget-ms"),
+  queuedSchedules("/sim/traffic-manager/schedules-queued"),
+  processedSchedules("/sim/traffic-manager/schedules-processed"),
+  scheduleBacklog("/sim/traffic-manager/schedules-backlog")
 {
 }
 
@@ -505,6 +607,7 @@ void FGTrafficManager::shutdown()
         cachefile.close();
     }
     scheduledAircraft.clear();
+    activationQueue.clear();
 
     for (auto flight : flights) {
         for (auto scheduled : flight.second)
@@ -512,7 +615,6 @@ void FGTrafficManager::shutdown()
     }
     flights.clear();
 
-    currAircraft = scheduledAircraft.begin();
     doingInit = false;
     inited = false;
     trafficSyncRequested = false;
@@ -581,6 +683,7 @@ void FGTrafficManager::init()
 
         scheduleParser.reset(new ScheduleParseThread(this));
         scheduleParser->setTrafficDirs(dirs);
+        scheduleParser->setUseCache(fgGetBool("/sim/traffic-manager/use-schedule-cache", true));
         scheduleParser->start();
     } else {
         fgSetBool("/sim/traffic-manager/heuristics", false);
@@ -623,8 +726,7 @@ void FGTrafficManager::finishInit()
     }
 
     sort(scheduledAircraft.begin(), scheduledAircraft.end(), FGAISchedule::compareSchedules);
-    currAircraft = scheduledAircraft.begin();
-    currAircraftClosest = scheduledAircraft.begin();
+    rebuildActivationQueue(globals->get_time_params()->get_cur_time());
 
     doingInit = false;
     inited = true;
@@ -674,17 +776,45 @@ void FGTrafficManager::loadHeuristics()
       }
     }
 
-  for(currAircraft = scheduledAircraft.begin(); currAircraft != scheduledAircraft.end(); ++currAircraft) {
-        const string& registration = (*currAircraft)->getRegistration();
+    for (auto schedule : scheduledAircraft) {
+        const string& registration = schedule->getRegistration();
         HeuristicMapIterator itr = heurMap.find(registration);
         if (itr != heurMap.end()) {
-            (*currAircraft)->setrunCount(itr->second.runCount);
-            (*currAircraft)->setHits(itr->second.hits);
-            (*currAircraft)->setLastUsed(itr->second.lastRun);
+            schedule->setrunCount(itr->second.runCount);
+            schedule->setHits(itr->second.hits);
+            schedule->setLastUsed(itr->second.lastRun);
         }
     }
 }
 
+/**
+ * (Re-)queue every valid schedule as due now, in score order. Used after
+ * parsing, and whenever the wake-up times computed by the schedules can no
+ * longer be trusted (user relocated, sim time moved backwards).
+ */
+void FGTrafficManager::rebuildActivationQueue(time_t now)
+{
+    activationQueue.reset(scheduledAircraft, now);
+    lastUpdateTime = now;
+    lastUserCart = globals->get_aircraft_position_cart();
+}
+
+void FGTrafficManager::requeueSchedule(FGAISchedule* schedule)
+{
+    // after shutdown the schedule may be gone already, so don't touch it
+    if (!inited || !schedule->isValid()) {
+        return;
+    }
+
+    activationQueue.push(schedule, globals->get_time_params()->get_cur_time());
+}
+    }
+
+    activationQueue = ActivationQueue(std::greater<QueuedSchedule>(), std::move(entries));
+    lastUpdateTime = now;
+    lastUserCart = globals->get_aircraft_position_cart();
+}
+
 bool FGTrafficManager::metarReady(double dt)
 {
     // wait for valid METAR (when realWX is enabled only), since we need
@@ -755,18 +885,29 @@ void FGTrafficManager::update(double dt)
     }
 
     SGVec3d userCart = globals->get_aircraft_position_cart();
-
-    if (currAircraft == scheduledAircraft.end()) {
-        currAircraft = scheduledAircraft.begin();
-    }
-
     time_t now = globals->get_time_params()->get_cur_time();
 
-    //cerr << "Processing << " << (*currAircraft)->getRegistration() << " with score " << (*currAircraft)->getScore() << endl;
-    if ((*currAircraft)->update(now, userCart)) {
-        // schedule is done - process another aircraft in next iteration
-        ++currAircraft;
+    // The wake-up times assume the user moves continuously at bounded speed
+    // and that time runs forward; start over if either is violated.
+    const double movedNm = dist(userCart, lastUserCart) * SG_METER_TO_NM;
+    if ((now < lastUpdateTime) || (movedNm > TRAFFIC_RELOCATION_DIST_NM)) {
+        SG_LOG(SG_AI, SG_DEBUG, "Traffic Manager: user relocated or time reset, re-evaluating all schedules");
+        rebuildActivationQueue(now);
     }
+    lastUpdateTime = now;
+    lastUserCart = userCart;
+
+    // Process every schedule which is due, within a time budget so that a
+    // large batch (e.g. after init or relocation) is spread over frames.
+    const double budgetMsec = (updateBudgetMsec > 0.0) ? static_cast<double>(updateBudgetMsec) : 2.0;
+    const int processed = activationQueue.processDue(now, budgetMsec, [now, &userCart](FGAISchedule* schedule) {
+        //cerr << "Processing << " << schedule->getRegistration() << " with score " << schedule->getScore() << endl;
+        return schedule->update(now, userCart);
+    });
+
+    queuedSchedules = static_cast<int>(activationQueue.size());
+    processedSchedules = processed;
+    scheduleBacklog = activationQueue.hasDue(now);
 }
 
 void FGTrafficManager::readTimeTableFromFile(SGPath infileName)
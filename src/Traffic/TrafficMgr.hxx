@@ -48,12 +48,14 @@
 #include <set>
 #include <memory>
 
+#include <simgear/math/SGMath.hxx>
 #include <simgear/structure/subsystem_mgr.hxx>
 #include <simgear/props/propertyObject.hxx>
 #include <simgear/misc/sg_path.hxx>
 
 #include "SchedFlight.hxx"
 #include "Schedule.hxx"
+#include "ScheduleQueue.hxx"
 
 
 class Heuristic
@@ -85,7 +87,12 @@ private:
     std::string waitingMetarStation;
 
     ScheduleVector scheduledAircraft;
-    ScheduleVectorIterator currAircraft, currAircraftClosest;
+
+    TrafficScheduleQueue activationQueue;
+    SGVec3d lastUserCart;
+    time_t lastUpdateTime;
+
+    void rebuildActivationQueue(time_t now);
 
     FGScheduledFlightMap flights;
 
@@ -93,6 +100,9 @@ private:
     void Tokenize(const std::string& str, std::vector<std::string>& tokens, const std::string& delimiters = " ");
 
     simgear::PropertyObject<bool> enabled, aiEnabled, realWxEnabled, metarValid, active, aiDataUpdateNow;
+    simgear::PropertyObject<double> updateBudgetMsec;
+    simgear::PropertyObject<int> queuedSchedules, processedSchedules;
+    simgear::PropertyObject<bool> scheduleBacklog;
 
     void loadHeuristics();
 
@@ -121,6 +131,12 @@ public:
     // Subsystem identification.
     static const char* staticSubsystemClassId() { return "traffic-manager"; }
 
+    /**
+     * Look at a schedule again in the next update, e.g. because its AI
+     * aircraft was removed, instead of waiting for its next update time.
+     */
+    void requeueSchedule(FGAISchedule* schedule);
+
     FGScheduledFlightVecIterator getFirstFlight(const std::string &ref) { return flights[ref].begin(); }
     FGScheduledFlightVecIterator getLastFlight(const std::string &ref) { return flights[ref].end(); }
 };
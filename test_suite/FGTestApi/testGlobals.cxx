@@ -464,6 +464,12 @@ bool geodsApproximatelyEqual(const SGGeod& a, const SGGeod& b)
     return SGGeodesy::distanceM(a, b) < 50.0;
 }
 
+void writeDamagedCacheFile(const SGPath& path, const std::string& magic)
+{
+    sg_ofstream f(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    f << magic << "\x01";
+}
+
 
 namespace tearDown {
 
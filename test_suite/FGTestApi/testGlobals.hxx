@@ -13,6 +13,8 @@ SPDX-License-Identifier: GPL-2.0-or-later
 #include <simgear/props/propsfwd.hxx>
 #include <simgear/structure/SGSharedPtr.hxx>
 
+class SGPath;
+
 namespace flightgear
 {
     class FlightPlan;
@@ -73,6 +75,12 @@ bool executeNasal(const std::string& code);
 
 bool geodsApproximatelyEqual(const SGGeod& a, const SGGeod& b);
 
+/**
+ * Replace a binary cache file with one which starts with the given magic
+ * but ends inside the header, as left by an interrupted write.
+ */
+void writeDamagedCacheFile(const SGPath& path, const std::string& magic);
+
 namespace tearDown {
 
 void shutdownTestGlobals();
@@ -0,0 +1,390 @@
+/*
+ * This file is part of the program FlightGear.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "test_traffic_scaling.hxx"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+
+#include <simgear/compiler.h>
+
+#if defined(__GLIBC__) && ((__GLIBC__ > 2) || (__GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+#define HAVE_MALLINFO2 1
+#endif
+
+#if !defined(SG_WINDOWS)
+#include <sys/resource.h>
+#endif
+
+#include "test_suite/FGTestApi/NavDataCache.hxx"
+#include "test_suite/FGTestApi/testGlobals.hxx"
+
+#include <simgear/io/iostreams/sgstream.hxx>
+#include <simgear/misc/sg_dir.hxx>
+#include <simgear/misc/strutils.hxx>
+#include <simgear/timing/sg_time.hxx>
+#include <simgear/timing/timestamp.hxx>
+
+#include <AIModel/AIManager.hxx>
+#include <AIModel/performancedb.hxx>
+#include <ATC/atc_mgr.hxx>
+#include <Airports/airport.hxx>
+#include <Airports/airportdynamicsmanager.hxx>
+#include <Main/fg_props.hxx>
+#include <Main/globals.hxx>
+#include <Traffic/TrafficMgr.hxx>
+
+namespace {
+
+const int TICK_HZ = 30;
+const int MINUTES_PER_WEEK = 7 * 24 * 60;
+const int TURNAROUND_MINUTES = 60;
+
+const char* AIRPORTS[] = {"EDDF", "EGPH", "YSSY"};
+const int NUM_AIRPORTS = 3;
+
+// rough block times between the airports above, in minutes
+const int BLOCK_MINUTES[NUM_AIRPORTS][NUM_AIRPORTS] = {
+    {0, 110, 1320},
+    {110, 0, 1380},
+    {1320, 1380, 0}};
+
+std::string timeOfWeek(int minutes)
+{
+    minutes %= MINUTES_PER_WEEK;
+    char buf[16];
+    ::snprintf(buf, sizeof(buf), "%d/%02d:%02d:00", minutes / (24 * 60),
+               (minutes / 60) % 24, minutes % 60);
+    return buf;
+}
+
+std::vector<int> benchmarkScales()
+{
+    std::vector<int> scales;
+    const char* env = ::getenv("FG_TRAFFIC_BENCHMARK_SCALES");
+    for (const auto& s : simgear::strutils::split(env ? env : "1,2,4", ",")) {
+        const int n = ::atoi(s.c_str());
+        if (n > 0) {
+            scales.push_back(n);
+        }
+    }
+    return scales;
+}
+
+double benchmarkSimTime()
+{
+    const char* env = ::getenv("FG_TRAFFIC_BENCHMARK_SIM_TIME");
+    const double t = env ? ::atof(env) : 0.0;
+    return (t > 0.0) ? t : 60.0;
+}
+
+long heapInUseKb()
+{
+#if defined(HAVE_MALLINFO2)
+    return static_cast<long>(mallinfo2().uordblks / 1024);
+#else
+    return -1;
+#endif
+}
+
+// note this is the peak of the whole process, so it only ever grows
+long peakRssKb()
+{
+#if defined(SG_WINDOWS)
+    return -1;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return -1;
+    }
+#if defined(SG_MAC)
+    return usage.ru_maxrss / 1024; // bytes on macOS
+#else
+    return usage.ru_maxrss;
+#endif
+#endif
+}
+
+double percentileMs(const std::vector<double>& sortedUSec, double p)
+{
+    if (sortedUSec.empty()) {
+        return 0.0;
+    }
+    const size_t index = std::min(sortedUSec.size() - 1,
+                                  static_cast<size_t>(p * sortedUSec.size()));
+    return sortedUSec[index] * 0.001;
+}
+
+} // of anonymous namespace
+
+/////////////////////////////////////////////////////////////////////////////
+
+// Set up function for each test.
+void TrafficScalingTests::setUp()
+{
+    // every scale runs in its own set of test globals, see runScale()
+}
+
+// Clean up after each test.
+void TrafficScalingTests::tearDown()
+{
+}
+
+SGPath TrafficScalingTests::writeSchedule(int flights)
+{
+    const SGPath dataDir = globals->get_fg_home() / "traffic_benchmark";
+    const SGPath scheduleDir = dataDir / "AI" / "Traffic" / "S";
+    simgear::Dir(scheduleDir).create(0755);
+
+    sg_ofstream f(scheduleDir / "SYN.xml", std::ios::out | std::ios::trunc);
+    f << "<?xml version=\"1.0\"?>\n<trafficlist>\n";
+
+    // every aircraft flies one round trip per week, departure times are
+    // spread over the week deterministically so runs are comparable
+    const int aircraft = std::max(1, flights / 2);
+    for (int i = 0; i < aircraft; ++i) {
+        const int home = i % NUM_AIRPORTS;
+        const int dest = (home + 1 + (i / NUM_AIRPORTS) % 2) % NUM_AIRPORTS;
+        const int block = BLOCK_MINUTES[home][dest];
+        const int cruiseAlt = (block > 300) ? 350 : 240;
+        const std::string id = "SYN_" + std::to_string(i);
+
+        f << "  <aircraft>\n"
+          << "    <model>Aircraft/BN-2/BN-2-Hebridean.xml</model>\n"
+          << "    <livery>SYN</livery>\n"
+          << "    <airline>SYN</airline>\n"
+          << "    <home-port>" << AIRPORTS[home] << "</home-port>\n"
+          << "    <required-aircraft>" << id << "</required-aircraft>\n"
+          << "    <actype>BN2</actype>\n"
+          << "    <offset>0</offset>\n"
+          << "    <radius>8</radius>\n"
+          << "    <flighttype>gate</flighttype>\n"
+          << "    <performance-class>turboprop_transport</performance-class>\n"
+          << "    <registration>SYN-" << i << "</registration>\n"
+          << "    <heavy>false</heavy>\n"
+          << "  </aircraft>\n";
+
+        const int departure = (i * 7919) % MINUTES_PER_WEEK;
+        const int legs[2][3] = {
+            {home, dest, departure},
+            {dest, home, departure + block + TURNAROUND_MINUTES}};
+        for (int leg = 0; leg < 2; ++leg) {
+            f << "  <flight>\n"
+              << "    <callsign>SYN" << (2 * i + leg) << "</callsign>\n"
+              << "    <required-aircraft>" << id << "</required-aircraft>\n"
+              << "    <fltrules>IFR</fltrules>\n"
+              << "    <departure>\n"
+              << "      <port>" << AIRPORTS[legs[leg][0]] << "</port>\n"
+              << "      <time>" << timeOfWeek(legs[leg][2]) << "</time>\n"
+              << "    </departure>\n"
+              << "    <cruise-alt>" << cruiseAlt << "</cruise-alt>\n"
+              << "    <arrival>\n"
+              << "      <port>" << AIRPORTS[legs[leg][1]] << "</port>\n"
+              << "      <time>" << timeOfWeek(legs[leg][2] + block) << "</time>\n"
+              << "    </arrival>\n"
+              << "    <repeat>WEEK</repeat>\n"
+              << "  </flight>\n";
+        }
+    }
+
+    f << "</trafficlist>\n";
+    return dataDir;
+}
+
+TrafficScalingTests::ScaleResult TrafficScalingTests::runScale(int flights, double simTime)
+{
+    ScaleResult result;
+    result.flights = flights;
+
+    FGTestApi::setUp::initTestGlobals("TrafficScaling");
+    FGTestApi::setUp::initNavDataCache();
+    globals->set_fg_root(SGPath::fromUtf8(FG_TEST_SUITE_DATA));
+
+    FGAirport::clearAirportsCache();
+    for (const char* ident : AIRPORTS) {
+        FGAirportRef apt = FGAirport::getByIdent(ident);
+        apt->testSuiteInjectGroundnetXML(SGPath::fromUtf8(FG_TEST_SUITE_DATA) / (std::string(ident) + ".groundnet.xml"));
+    }
+
+    // only the synthetic schedule is loaded: the traffic manager drops the
+    // AI/Traffic directory of FG_ROOT when another one is present
+    globals->append_data_path(writeSchedule(flights), false);
+
+    fgSetBool("/sim/ai/enabled", true);
+    fgSetBool("/sim/traffic-manager/enabled", true);
+    fgSetBool("/sim/traffic-manager/heuristics", false);
+    fgSetBool("/sim/traffic-manager/use-schedule-cache", false);
+    fgSetBool("/sim/traffic-manager/dumpdata", false);
+    fgSetDouble("/sim/traffic-manager/proportion", 1.0);
+    fgSetBool("/sim/terrasync/ai-data-update-now", false);
+    fgSetBool("/environment/realwx/enabled", false);
+    fgSetBool("/environment/metar/valid", false);
+    fgSetBool("/sim/signals/fdm-initialized", true);
+
+    FGTestApi::setPositionAndStabilise(FGAirport::getByIdent("EGPH")->geod());
+
+    auto mgr = globals->get_subsystem_mgr();
+    mgr->add<PerformanceDB>();
+    auto atc = mgr->add<FGATCManager>();
+    auto aiManager = mgr->add<FGAIManager>();
+    auto dynamics = mgr->add<flightgear::AirportDynamicsManager>();
+    auto tmgr = mgr->add<FGTrafficManager>();
+
+    mgr->bind();
+    mgr->init();
+    mgr->postinit();
+
+    const long heapBefore = heapInUseKb();
+
+    // parsing happens on a thread; wait for the first scheduling pass
+    SGTimeStamp initStart;
+    initStart.stamp();
+    for (int i = 0; (i < 600) && (fgGetInt("/sim/traffic-manager/schedules-queued") == 0); ++i) {
+        FGTestApi::runForTime(1.0);
+    }
+    result.initMs = initStart.elapsedMSec();
+    result.scheduled = fgGetInt("/sim/traffic-manager/schedules-queued");
+
+    struct Timed {
+        const char* name;
+        SGSubsystem* subsystem;
+        std::vector<double> usec;
+    };
+    std::vector<Timed> timed = {
+        {"traffic-manager", tmgr, {}},
+        {"ai-model", aiManager, {}},
+        {"ATC", atc, {}},
+        {"airport-dynamics", dynamics, {}}};
+
+    // same as FGTestApi::runForTime(), but timing each subsystem
+    const double tickDuration = 1.0 / TICK_HZ;
+    const int ticks = static_cast<int>(simTime * TICK_HZ);
+    for (auto& t : timed) {
+        t.usec.reserve(ticks);
+    }
+
+    const long startTime = globals->get_time_params()->get_cur_time();
+    for (int tick = 0; tick < ticks; ++tick) {
+        globals->inc_sim_time_sec(tickDuration);
+        globals->get_time_params()->update(globals->get_view_position(), startTime, tick * tickDuration);
+
+        for (auto& t : timed) {
+            SGTimeStamp st;
+            st.stamp();
+            t.subsystem->update(tickDuration);
+            t.usec.push_back(st.elapsedUSec());
+        }
+    }
+
+    for (auto& t : timed) {
+        std::sort(t.usec.begin(), t.usec.end());
+
+        SubsystemResult r;
+        r.name = t.name;
+        r.p50Ms = percentileMs(t.usec, 0.50);
+        r.p90Ms = percentileMs(t.usec, 0.90);
+        r.p99Ms = percentileMs(t.usec, 0.99);
+        r.maxMs = t.usec.empty() ? 0.0 : t.usec.back() * 0.001;
+        r.meanMs = t.usec.empty() ? 0.0 : std::accumulate(t.usec.begin(), t.usec.end(), 0.0) * 0.001 / t.usec.size();
+        result.subsystems.push_back(r);
+    }
+
+    result.aiModels = fgGetInt("/ai/models/count");
+    const long heapAfter = heapInUseKb();
+    if ((heapBefore >= 0) && (heapAfter >= 0)) {
+        result.heapGrowthKb = heapAfter - heapBefore;
+    }
+    result.peakRssKb = peakRssKb();
+
+    FGTestApi::tearDown::shutdownTestGlobals();
+    return result;
+}
+
+void TrafficScalingTests::report(const std::vector<ScaleResult>& results)
+{
+    std::cout << "\nTraffic scaling, " << benchmarkSimTime() << " s simulated at "
+              << TICK_HZ << " Hz (times in ms)\n";
+    std::cout << std::fixed << std::setprecision(3);
+    for (const auto& r : results) {
+        std::cout << "\n" << r.flights << " flights: init " << r.initMs
+                  << ", schedules " << r.scheduled
+                  << ", AI models " << r.aiModels
+                  << ", heap growth " << r.heapGrowthKb << " kB"
+                  << ", peak RSS " << r.peakRssKb << " kB\n";
+        std::cout << std::setw(20) << std::left << "  subsystem" << std::right
+                  << std::setw(10) << "p50" << std::setw(10) << "p90"
+                  << std::setw(10) << "p99" << std::setw(10) << "max"
+                  << std::setw(10) << "mean" << "\n";
+        for (const auto& s : r.subsystems) {
+            std::cout << "  " << std::setw(18) << std::left << s.name << std::right
+                      << std::setw(10) << s.p50Ms << std::setw(10) << s.p90Ms
+                      << std::setw(10) << s.p99Ms << std::setw(10) << s.maxMs
+                      << std::setw(10) << s.meanMs << "\n";
+        }
+    }
+    std::cout << std::endl;
+
+    const char* csv = ::getenv("FG_TRAFFIC_BENCHMARK_CSV");
+    if (!csv) {
+        return;
+    }
+
+    const SGPath csvPath = SGPath::fromUtf8(csv);
+    const bool writeHeader = !csvPath.exists();
+    sg_ofstream f(csvPath, std::ios::out | std::ios::app);
+    if (writeHeader) {
+        f << "flights,subsystem,p50_ms,p90_ms,p99_ms,max_ms,mean_ms,init_ms,schedules,ai_models,heap_growth_kb,peak_rss_kb\n";
+    }
+    for (const auto& r : results) {
+        for (const auto& s : r.subsystems) {
+            f << r.flights << "," << s.name << "," << s.p50Ms << "," << s.p90Ms << ","
+              << s.p99Ms << "," << s.maxMs << "," << s.meanMs << "," << r.initMs << ","
+              << r.scheduled << "," << r.aiModels << "," << r.heapGrowthKb << ","
+              << r.peakRssKb << "\n";
+        }
+    }
+}
+
+void TrafficScalingTests::testScaling()
+{
+    // registered with the system tests, but far too slow for every run
+    if (!::getenv("FG_TRAFFIC_BENCHMARK")) {
+        std::cerr << "TrafficScalingTests: set FG_TRAFFIC_BENCHMARK=1 to run the benchmark" << std::endl;
+        return;
+    }
+
+    const double simTime = benchmarkSimTime();
+
+    std::vector<ScaleResult> results;
+    for (int thousands : benchmarkScales()) {
+        results.push_back(runScale(thousands * 1000, simTime));
+    }
+
+    report(results);
+
+    CPPUNIT_ASSERT(!results.empty());
+    for (const auto& r : results) {
+        CPPUNIT_ASSERT(r.scheduled > 0);
+    }
+}
@@ -0,0 +1,89 @@
+/*
+ * This file is part of the program FlightGear.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <string>
+#include <vector>
+
+#include <simgear/misc/sg_path.hxx>
+
+
+/**
+ * Scaling benchmark for the AI traffic subsystems.
+ *
+ * For each requested scale a synthetic schedule of that many thousand
+ * flights between EDDF, EGPH and YSSY (using the test_data groundnets) is
+ * written, loaded through FGTrafficManager and run headless for a fixed
+ * amount of simulation time. For every subsystem the update() time of
+ * each frame is recorded and reported as percentiles, together with the
+ * heap growth and peak RSS.
+ *
+ * Only runs when FG_TRAFFIC_BENCHMARK is set, otherwise the test returns
+ * at once; use the "traffic_benchmark" target, or set it and run
+ * "fgfs_test_suite -s TrafficScalingTests". Tunable through the
+ * environment:
+ *   FG_TRAFFIC_BENCHMARK_SCALES    thousands of flights, e.g. "1,2,5"
+ *   FG_TRAFFIC_BENCHMARK_SIM_TIME  simulated seconds per scale
+ *   FG_TRAFFIC_BENCHMARK_CSV       also append the results to this file
+ */
+class TrafficScalingTests : public CppUnit::TestFixture
+{
+    // Set up the test suite.
+    CPPUNIT_TEST_SUITE(TrafficScalingTests);
+    CPPUNIT_TEST(testScaling);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    // Set up function for each test.
+    void setUp();
+
+    // Clean up after each test.
+    void tearDown();
+
+    // The tests.
+    void testScaling();
+
+private:
+    struct SubsystemResult
+    {
+        std::string name;
+        double p50Ms = 0.0;
+        double p90Ms = 0.0;
+        double p99Ms = 0.0;
+        double maxMs = 0.0;
+        double meanMs = 0.0;
+    };
+
+    struct ScaleResult
+    {
+        int flights = 0;
+        double initMs = 0.0;
+        int scheduled = 0;          ///< schedules in the activation queue
+        int aiModels = 0;
+        long heapGrowthKb = -1;     ///< -1 where the C library can't tell
+        long peakRssKb = -1;
+        std::vector<SubsystemResult> subsystems;
+    };
+
+    SGPath writeSchedule(int flights);
+    ScaleResult runScale(int flights, double simTime);
+    void report(const std::vector<ScaleResult>& results);
+};
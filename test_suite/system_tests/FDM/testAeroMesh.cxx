@@ -221,3 +221,54 @@ void AeroMeshTests::testFrameTransformations()
         CPPUNIT_ASSERT_DOUBLES_EQUAL(accessor.read_FDM_AIWake_AircraftMesh_collPt(mesh)[i][2], p(3), 1e-7);
     }
 }
+
+
+void AeroMeshTests::testInducedVelocity()
+{
+    double b = 10.0;
+    double c = 2.0;
+    double vel = 100.;
+    double weight = 50.;
+
+    auto accessor = FGTestApi::PrivateAccessor::FDM::Accessor();
+
+    WakeMesh_ptr mesh = new WakeMesh(b, c, "testMesh");
+    mesh->computeAoA(vel, rho, weight);
+
+    // a second mesh of the same geometry gets the same circulations
+    WakeMesh_ptr other = new WakeMesh(b, c, "otherMesh");
+    other->computeAoA(vel, rho, weight);
+
+    int N = accessor.read_FDM_AIWake_WakeMesh_nelm(mesh);
+    double **gamma = accessor.read_FDM_AIWake_WakeMesh_Gamma(mesh);
+    for (int i=1; i<=N; ++i)
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(gamma[i][1],
+                                     accessor.read_FDM_AIWake_WakeMesh_Gamma(other)[i][1], 1e-12);
+
+    auto reference = [&](const SGVec3d& at) {
+        SGVec3d v(0., 0., 0.);
+        for (int i=0; i<N; ++i)
+            v += gamma[i+1][1] * accessor.read_FDM_AIWake_WakeMesh_elements(mesh)[i]->getInducedVelocity(at);
+        return v;
+    };
+
+    // near field: same as the sum over the elements
+    const SGVec3d near[] = {SGVec3d(-20., 3., 1.), SGVec3d(5., -4., -2.),
+                            SGVec3d(-0.5, 0., 0.3), SGVec3d(-300., 6., 0.)};
+    for (const auto& at : near) {
+        SGVec3d v = mesh->getInducedVelocityAt(at);
+        SGVec3d ref = reference(at);
+        for (int j=0; j<3; ++j)
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(ref[j], v[j], 1e-9);
+    }
+
+    // far field: the equivalent horseshoe vortex is close enough
+    const SGVec3d far[] = {SGVec3d(-100., 60., 0.), SGVec3d(-500., 0., -70.),
+                           SGVec3d(80., 30., 10.)};
+    for (const auto& at : far) {
+        SGVec3d v = mesh->getInducedVelocityAt(at);
+        SGVec3d ref = reference(at);
+        CPPUNIT_ASSERT(norm(v - ref) < 0.02*norm(ref));
+    }
+}
+
@@ -34,6 +34,7 @@ class AeroMeshTests : public CppUnit::TestFixture
     CPPUNIT_TEST(testFourierLiftingLine);
     CPPUNIT_TEST(testFrameTransformations);
     CPPUNIT_TEST(testLiftComputation);
+    CPPUNIT_TEST(testInducedVelocity);
     CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -47,6 +48,7 @@ public:
     void testFourierLiftingLine();
     void testFrameTransformations();
     void testLiftComputation();
+    void testInducedVelocity();
 };
 
 #endif  // _FG_AERO_MESH_SYSTEM_TESTS_HXX
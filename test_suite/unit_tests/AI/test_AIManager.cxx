@@ -21,6 +21,8 @@
 
 #include <cstring>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "test_suite/FGTestApi/NavDataCache.hxx"
 #include "test_suite/FGTestApi/TestDataLogger.hxx"
@@ -28,8 +30,13 @@
 #include "test_suite/FGTestApi/testGlobals.hxx"
 
 #include <AIModel/AIAircraft.hxx>
+#include <AIModel/AICollisionTree.hxx>
+#include <AIModel/AIElevationCache.hxx>
 #include <AIModel/AIFlightPlan.hxx>
+#include <AIModel/AIFlightPlanQueue.hxx>
 #include <AIModel/AIManager.hxx>
+#include <AIModel/AIModelLoader.hxx>
+#include <AIModel/performancedata.hxx>
 
 #include <Airports/airport.hxx>
 #include <Main/fg_props.hxx>
@@ -129,3 +136,354 @@ void AIManagerTests::testAircraftWaypoints()
     std::unique_ptr<FGAIFlightPlan> aiFP(new FGAIFlightPlan);
     ai->setFlightPlan(std::move(aiFP));    
 }
+
+void AIManagerTests::testElevationCache()
+{
+    int queries = 0;
+    bool haveScenery = false;
+    FGAIElevationCache cache([&](const SGGeod& pos, double& elev, const simgear::BVHMaterial** mat) {
+        ++queries;
+        if (!haveScenery) {
+            return false;
+        }
+        // a slope rising to the east
+        elev = 100.0 + (pos.getLongitudeDeg() + 2.5) * 1000.0;
+        if (mat) {
+            *mat = nullptr;
+        }
+        return true;
+    });
+
+    const SGGeod probe = SGGeod::fromDegM(-2.50001, 51.40001, 3000);
+    double elev = 0.0;
+
+    // no scenery yet: the failure is remembered and retried in a batch
+    CPPUNIT_ASSERT(!cache.getElevationM(probe, elev, nullptr));
+    CPPUNIT_ASSERT_EQUAL(1, queries);
+    CPPUNIT_ASSERT(!cache.getElevationM(probe, elev, nullptr));
+    CPPUNIT_ASSERT_EQUAL(1, queries);
+
+    haveScenery = true;
+    cache.update(5.0);
+    CPPUNIT_ASSERT(!cache.getElevationM(probe, elev, nullptr));
+    cache.update(0.1);
+    CPPUNIT_ASSERT_EQUAL(2, queries);
+    CPPUNIT_ASSERT(cache.getElevationM(probe, elev, nullptr));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(100.0, elev, 1.0);
+
+    // a second object close by shares the cell
+    const SGGeod nearby = SGGeod::fromDegM(-2.500009, 51.400011, 20000);
+    for (int i = 0; i < 10; ++i) {
+        CPPUNIT_ASSERT(cache.getElevationM(nearby, elev, nullptr));
+        cache.update(0.1);
+    }
+    CPPUNIT_ASSERT_EQUAL(2, queries);
+    CPPUNIT_ASSERT_EQUAL(size_t{1}, cache.size());
+    CPPUNIT_ASSERT(cache.hitRate() > 0.8);
+
+    // a probe starting below the cached ground isn't answered from the cache
+    CPPUNIT_ASSERT(cache.getElevationM(SGGeod::fromDegM(-2.50001, 51.40001, 50), elev, nullptr));
+    CPPUNIT_ASSERT_EQUAL(3, queries);
+
+    // a cell far away is resolved immediately
+    CPPUNIT_ASSERT(cache.getElevationM(SGGeod::fromDegM(-2.4, 51.4, 3000), elev, nullptr));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(200.0, elev, 1.0);
+    CPPUNIT_ASSERT_EQUAL(4, queries);
+    CPPUNIT_ASSERT_EQUAL(size_t{2}, cache.size());
+
+    // unused cells expire
+    cache.update(200.0);
+    CPPUNIT_ASSERT_EQUAL(size_t{0}, cache.size());
+}
+
+void AIManagerTests::testCollisionTree()
+{
+    auto aim = globals->get_subsystem<FGAIManager>();
+    auto eggd = FGAirport::findByIdent("EGGD");
+    FGTestApi::setPositionAndStabilise(eggd->geod());
+
+    // a row of targets, 2km apart, heading north
+    std::vector<FGAIBasePtr> targets;
+    for (int i = 0; i < 10; ++i) {
+        SGPropertyNode_ptr def(new SGPropertyNode);
+        def->setStringValue("type", "aircraft");
+        def->setStringValue("callsign", "TGT" + std::to_string(i));
+        def->setDoubleValue("heading", 0.0);
+        const SGGeod p = SGGeodesy::direct(eggd->geod(), 90.0, 2000.0 * i);
+        def->setDoubleValue("latitude", p.getLatitudeDeg());
+        def->setDoubleValue("longitude", p.getLongitudeDeg());
+        def->setDoubleValue("altitude", 6000.0);
+        def->setDoubleValue("speed", 0.0);
+
+        auto ai = aim->addObject(def);
+        CPPUNIT_ASSERT(ai);
+        ai->setCollisionLength(100);
+        ai->setCollisionHeight(50);
+        targets.push_back(ai);
+    }
+
+    FGAICollisionTree tree;
+    tree.build(aim->get_ai_list());
+    CPPUNIT_ASSERT(tree.size() >= 10);
+
+    const FGAIBasePtr target = targets[5];
+    const SGGeod targetPos = target->getGeodPos();
+
+    // a fast projectile crossing the target within one frame
+    const SGGeod from = SGGeodesy::direct(targetPos, 180.0, 400.0);
+    const SGGeod to = SGGeodesy::direct(targetPos, 0.0, 400.0);
+    double t = -1.0;
+    const FGAIBase* hit = tree.intersect(SGVec3d::fromGeod(from), SGVec3d::fromGeod(to), 0.0, t);
+    CPPUNIT_ASSERT(hit == target.get());
+    // entering the 100ft sphere, a bit before the middle of the segment
+    CPPUNIT_ASSERT(t > 0.4);
+    CPPUNIT_ASSERT(t < 0.5);
+
+    // passing well above it
+    SGGeod above = from;
+    above.setElevationFt(targetPos.getElevationFt() + 200);
+    SGGeod aboveEnd = to;
+    aboveEnd.setElevationFt(targetPos.getElevationFt() + 200);
+    CPPUNIT_ASSERT(!tree.intersect(SGVec3d::fromGeod(above), SGVec3d::fromGeod(aboveEnd), 0.0, t));
+
+    // ... unless the fuse range covers the distance
+    CPPUNIT_ASSERT(tree.intersect(SGVec3d::fromGeod(above), SGVec3d::fromGeod(aboveEnd), 200.0, t) == target.get());
+}
+
+void AIManagerTests::testPerformanceTables()
+{
+    SGPropertyNode_ptr def(new SGPropertyNode);
+    def->setDoubleValue("climb-rate-fpm", 3000.0);
+    def->setDoubleValue("descent-rate-fpm", 2000.0);
+    def->setDoubleValue("climb-speed-kts", 300.0);
+    def->setDoubleValue("descent-speed-kts", 280.0);
+    def->setDoubleValue("cruise-speed-kts", 450.0);
+    def->setDoubleValue("ceiling-ft", 40000.0);
+
+    PerformanceData perf;
+    perf.initFromProps(def);
+
+    // climb rate falls off towards the ceiling, and stays there
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(3000.0, perf.climbRateAt(0.0), 0.1);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(2250.0, perf.climbRateAt(20000.0), 0.1);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1500.0, perf.climbRateAt(40000.0), 0.1);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1500.0, perf.climbRateAt(60000.0), 0.1);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(3000.0, perf.climbRateAt(-500.0), 0.1);
+
+    // interpolated between samples
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(3000.0 * (1.0 - 0.5 * 12345.0 / 40000.0), perf.climbRateAt(12345.0), 0.1);
+
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(2000.0, perf.descentRateAt(30000.0), 0.1);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1200.0, perf.descentRateAt(0.0), 0.1);
+
+    // speed limit below 10000ft
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(250.0, perf.climbSpeedAt(5000.0), 0.1);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(300.0, perf.climbSpeedAt(15000.0), 0.1);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(250.0, perf.descentSpeedAt(8000.0), 0.1);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(280.0, perf.descentSpeedAt(20000.0), 0.1);
+
+    // descending from FL300 to FL200 at 2000fpm and 280kts takes 5 minutes
+    const double d = perf.descentDistanceM(30000.0) - perf.descentDistanceM(20000.0);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(280.0 * SG_NM_TO_METER * 5.0 / 60.0, d, 100.0);
+    CPPUNIT_ASSERT(perf.descentDistanceM(10000.0) > 0.0);
+
+    // same turns as the flight plan estimate for the default bank angle
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.1911 * 250.0 * 250.0, perf.turnRadius(250.0), 1.0);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.1911 * 700.0 * 700.0, perf.turnRadius(700.0), 1.0);
+}
+
+void AIManagerTests::testFlightPlanQueue()
+{
+    auto aim = globals->get_subsystem<FGAIManager>();
+    FGAIFlightPlanQueue* queue = aim->getFlightPlanQueue();
+    CPPUNIT_ASSERT(queue);
+
+    // one job per frame
+    fgSetDouble("/sim/ai/flightplan-queue/budget-ms", 0.0);
+
+    std::vector<SGSharedPtr<FGAIAircraft>> aircraft;
+    int built = 0;
+    int attached = 0;
+    for (int i = 0; i < 3; ++i) {
+        aircraft.push_back(new FGAIAircraft);
+        queue->push(aircraft.back(), [&built]() {
+                ++built;
+                return std::unique_ptr<FGAIFlightPlan>(new FGAIFlightPlan);
+            },
+            [&attached](std::unique_ptr<FGAIFlightPlan> fp) {
+                CPPUNIT_ASSERT(fp);
+                ++attached;
+            });
+    }
+
+    CPPUNIT_ASSERT_EQUAL(size_t{3}, queue->size());
+    CPPUNIT_ASSERT_EQUAL(0, built);
+
+    aim->update(0.1);
+    CPPUNIT_ASSERT_EQUAL(1, built);
+    CPPUNIT_ASSERT_EQUAL(1, attached);
+    CPPUNIT_ASSERT_EQUAL(2, fgGetInt("/sim/ai/flightplan-queue/depth"));
+
+    // an aircraft which died while waiting is skipped
+    aircraft[1]->setDie(true);
+    aim->update(0.1);
+    CPPUNIT_ASSERT_EQUAL(2, built);
+    CPPUNIT_ASSERT_EQUAL(0, fgGetInt("/sim/ai/flightplan-queue/depth"));
+    CPPUNIT_ASSERT_EQUAL(2L, fgGetLong("/sim/ai/flightplan-queue/built"));
+    CPPUNIT_ASSERT_EQUAL(1L, fgGetLong("/sim/ai/flightplan-queue/dropped"));
+    CPPUNIT_ASSERT(fgGetDouble("/sim/ai/flightplan-queue/max-latency-ms") >= 0.0);
+
+    // jobs dropped on shutdown mark their aircraft dead, so their schedules
+    // don't wait for them forever
+    SGSharedPtr<FGAIAircraft> waiting = new FGAIAircraft;
+    queue->push(waiting, [&built]() {
+            ++built;
+            return std::unique_ptr<FGAIFlightPlan>(new FGAIFlightPlan);
+        },
+        [&attached](std::unique_ptr<FGAIFlightPlan>) { ++attached; });
+    queue->clear();
+    CPPUNIT_ASSERT_EQUAL(size_t{0}, queue->size());
+    CPPUNIT_ASSERT(waiting->getDie());
+    CPPUNIT_ASSERT_EQUAL(2, built);
+    CPPUNIT_ASSERT_EQUAL(2, attached);
+}
+
+void AIManagerTests::testUpdateLOD()
+{
+    auto aim = globals->get_subsystem<FGAIManager>();
+    auto eggd = FGAirport::findByIdent("EGGD");
+    FGTestApi::setPositionAndStabilise(eggd->geod());
+
+    // off by default
+    CPPUNIT_ASSERT(!fgGetBool("/sim/ai/update-lod/enabled"));
+    fgSetBool("/sim/ai/update-lod/enabled", true);
+    fgSetDouble("/sim/ai/update-lod/near-range-nm", 10.0);
+    fgSetDouble("/sim/ai/update-lod/far-range-nm", 40.0);
+    fgSetDouble("/sim/ai/update-lod/hysteresis-nm", 1.0);
+    fgSetDouble("/sim/ai/update-lod/far-interval-sec", 1.0);
+
+    auto addStatic = [aim, eggd](double rangeNm) {
+        SGPropertyNode_ptr def(new SGPropertyNode);
+        def->setStringValue("type", "static");
+        const SGGeod p = SGGeodesy::direct(eggd->geod(), 45.0, rangeNm * SG_NM_TO_METER);
+        def->setDoubleValue("latitude", p.getLatitudeDeg());
+        def->setDoubleValue("longitude", p.getLongitudeDeg());
+        def->setDoubleValue("altitude", 1000.0);
+        auto ai = aim->addObject(def);
+        ai->setCollisionLength(100);
+        return ai;
+    };
+
+    auto nearObject = addStatic(2.0);
+    auto farObject = addStatic(100.0);
+
+    // the far object needs two frames to move down to the far tier
+    for (int i = 0; i < 3; ++i) {
+        aim->update(0.1);
+    }
+    CPPUNIT_ASSERT_EQUAL(0, nearObject->simLOD().tier); // near
+    CPPUNIT_ASSERT_EQUAL(2, farObject->simLOD().tier);  // far
+    CPPUNIT_ASSERT_EQUAL(1, fgGetInt("/sim/ai/update-lod/near-count"));
+    CPPUNIT_ASSERT_EQUAL(1, fgGetInt("/sim/ai/update-lod/far-count"));
+
+    // the far object only runs once the interval has accumulated
+    const long skipped = fgGetLong("/sim/ai/update-lod/skipped");
+    for (int i = 0; i < 10; ++i) {
+        aim->update(0.1);
+    }
+    CPPUNIT_ASSERT(fgGetLong("/sim/ai/update-lod/skipped") - skipped >= 8);
+    CPPUNIT_ASSERT(farObject->simLOD().pendingDt < 1.0);
+
+    // disabled, everything is updated every frame again
+    fgSetBool("/sim/ai/update-lod/enabled", false);
+    aim->update(0.1);
+    CPPUNIT_ASSERT_EQUAL(2, fgGetInt("/sim/ai/update-lod/exempt-count"));
+    CPPUNIT_ASSERT_EQUAL(0.0, farObject->simLOD().pendingDt);
+}
+
+void AIManagerTests::testModelLoader()
+{
+    auto aim = globals->get_subsystem<FGAIManager>();
+    FGAIModelLoader* loader = aim->getModelLoader();
+    CPPUNIT_ASSERT(loader);
+
+    auto eggd = FGAirport::findByIdent("EGGD");
+    FGTestApi::setPositionAndStabilise(eggd->geod());
+    fgSetDouble("/sim/current-view/viewer-lat-deg", eggd->geod().getLatitudeDeg());
+    fgSetDouble("/sim/current-view/viewer-lon-deg", eggd->geod().getLongitudeDeg());
+    fgSetDouble("/sim/current-view/viewer-elev-ft", 1000.0);
+    fgSetInt("/sim/ai/model-loader/max-concurrent", 1);
+    fgSetDouble("/sim/ai/model-loader/timeout-sec", 1.0);
+    // a distance LOD, so which objects are in range doesn't depend on the view
+    fgSetBool("/sim/rendering/static-lod/aimp-range-mode-distance", true);
+    fgSetDouble("/sim/rendering/static-lod/aimp-detailed", 3000.0);
+    fgSetDouble("/sim/rendering/static-lod/aimp-bare", 10000.0);
+
+    // all of these end up with the same (fallback) model
+    auto addStatic = [aim, eggd](double rangeNm) {
+        SGPropertyNode_ptr def(new SGPropertyNode);
+        def->setStringValue("type", "static");
+        const SGGeod p = SGGeodesy::direct(eggd->geod(), 90.0, rangeNm * SG_NM_TO_METER);
+        def->setDoubleValue("latitude", p.getLatitudeDeg());
+        def->setDoubleValue("longitude", p.getLongitudeDeg());
+        def->setDoubleValue("altitude", 1000.0);
+        return aim->addObject(def);
+    };
+
+    auto farObject = addStatic(30.0);
+    auto nearObject = addStatic(1.0);
+    auto midObject = addStatic(10.0);
+    CPPUNIT_ASSERT_EQUAL(size_t{3}, loader->pending());
+    CPPUNIT_ASSERT_EQUAL(size_t{1}, loader->cachedPaths());
+
+    // the nearest one is the prototype and takes the slot, the copies are
+    // attached along with it
+    aim->update(0.1);
+    CPPUNIT_ASSERT(!loader->isPending(nearObject.get()));
+    CPPUNIT_ASSERT(!loader->isPending(midObject.get()));
+    CPPUNIT_ASSERT(!loader->isPending(farObject.get()));
+    CPPUNIT_ASSERT_EQUAL(size_t{1}, loader->loading());
+
+    // nothing gets loaded without a pager; the slot is freed after the timeout
+    const long timeouts = fgGetLong("/sim/ai/model-loader/timeouts");
+    for (int i = 0; i < 12; ++i) {
+        aim->update(0.1);
+    }
+    CPPUNIT_ASSERT_EQUAL(size_t{0}, loader->loading());
+    CPPUNIT_ASSERT_EQUAL(timeouts + 1, fgGetLong("/sim/ai/model-loader/timeouts"));
+
+    // removed objects drop their reference, the last one the whole entry
+    farObject->setDie(true);
+    aim->update(0.1);
+    CPPUNIT_ASSERT(!loader->isPending(farObject.get()));
+    CPPUNIT_ASSERT_EQUAL(size_t{1}, loader->cachedPaths());
+
+    nearObject->setDie(true);
+    midObject->setDie(true);
+    aim->update(0.1);
+    CPPUNIT_ASSERT_EQUAL(size_t{0}, loader->cachedPaths());
+    CPPUNIT_ASSERT_EQUAL(size_t{0}, loader->loading());
+
+    // a prototype beyond its LOD range will never be loaded by the pager,
+    // so it gives up its slot at once
+    auto distantObject = addStatic(40.0);
+    aim->update(0.1);
+    CPPUNIT_ASSERT(!loader->isPending(distantObject.get()));
+    aim->update(0.1);
+    CPPUNIT_ASSERT_EQUAL(size_t{0}, loader->loading());
+    CPPUNIT_ASSERT_EQUAL(timeouts + 1, fgGetLong("/sim/ai/model-loader/timeouts"));
+
+    // queueing again with the same path is ignored, another path replaces
+    // the earlier request
+    loader->enqueue(distantObject.get(), "Models/Other.ac");
+    CPPUNIT_ASSERT_EQUAL(size_t{1}, loader->cachedPaths());
+    CPPUNIT_ASSERT_EQUAL(1, loader->users("Models/Other.ac"));
+    CPPUNIT_ASSERT(loader->isPending(distantObject.get()));
+    loader->enqueue(distantObject.get(), "Models/Other.ac");
+    CPPUNIT_ASSERT_EQUAL(size_t{1}, loader->pending());
+    CPPUNIT_ASSERT_EQUAL(1, loader->users("Models/Other.ac"));
+
+    distantObject->setDie(true);
+    aim->update(0.1);
+    CPPUNIT_ASSERT_EQUAL(size_t{0}, loader->cachedPaths());
+}
@@ -35,6 +35,12 @@ class AIManagerTests : public CppUnit::TestFixture
     CPPUNIT_TEST_SUITE(AIManagerTests);
     CPPUNIT_TEST(testBasic);
     CPPUNIT_TEST(testAircraftWaypoints);
+    CPPUNIT_TEST(testElevationCache);
+    CPPUNIT_TEST(testCollisionTree);
+    CPPUNIT_TEST(testPerformanceTables);
+    CPPUNIT_TEST(testFlightPlanQueue);
+    CPPUNIT_TEST(testUpdateLOD);
+    CPPUNIT_TEST(testModelLoader);
 
     CPPUNIT_TEST_SUITE_END();
 
@@ -49,4 +55,10 @@ public:
     // The tests.
     void testBasic();
     void testAircraftWaypoints();
+    void testElevationCache();
+    void testCollisionTree();
+    void testPerformanceTables();
+    void testFlightPlanQueue();
+    void testUpdateLOD();
+    void testModelLoader();
 };
@@ -29,8 +29,14 @@
 #include "test_suite/FGTestApi/testGlobals.hxx"
 
 #include <Airports/airport.hxx>
+#include <Traffic/ScheduleCache.hxx>
+#include <Traffic/ScheduleQueue.hxx>
 #include <Traffic/TrafficMgr.hxx>
 
+#include <simgear/io/iostreams/sgstream.hxx>
+#include <simgear/misc/sg_dir.hxx>
+#include <simgear/timing/timestamp.hxx>
+
 #include <Main/fg_props.hxx>
 #include <Main/globals.hxx>
 
@@ -150,3 +156,161 @@ void TrafficMgrTests::testTrafficManager()
     }
    CPPUNIT_ASSERT_EQUAL(25, counter);
 }
+
+void TrafficMgrTests::testScheduleCache()
+{
+    const SGPath trafficDir = globals->get_fg_home() / "test_schedule_cache" / "Traffic";
+    const SGPath subDir = trafficDir / "T";
+    simgear::Dir(subDir).create(0755);
+
+    const SGPath trafficFile = subDir / "TST.xml";
+    {
+        sg_ofstream f(trafficFile, std::ios::out | std::ios::trunc);
+        f << "<?xml version=\"1.0\"?>\n<trafficlist/>\n";
+    }
+
+    const SGPath cachePath = globals->get_fg_home() / "test_schedule_cache" / "traffic.cache";
+    PathList files = TrafficScheduleCache::findTrafficFiles({trafficDir});
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), files.size());
+
+    {
+        TrafficScheduleCache writer(cachePath);
+        writer.addSource(trafficFile, false);
+
+        TrafficCacheAircraft ac;
+        ac.model = "Aircraft/737/Models/737.xml";
+        ac.homePort = "EGPH";
+        ac.registration = "G-ABCD";
+        ac.requiredAircraft = "TST_BN_1";
+        ac.heavy = true;
+        ac.radius = 18.0;
+        writer.addAircraft(ac);
+
+        TrafficCacheFlight flt;
+        flt.callsign = "TST123";
+        flt.fltRules = "IFR";
+        flt.departurePort = "EGPH";
+        flt.arrivalPort = "EGPF";
+        flt.departureTime = "0/07:00:00";
+        flt.arrivalTime = "0/08:00:00";
+        flt.repeat = "WEEK";
+        flt.requiredAircraft = "TST_BN_1";
+        flt.cruiseAlt = 240;
+        writer.addFlight(flt);
+        writer.addFlight(flt);
+
+        CPPUNIT_ASSERT(writer.write());
+    }
+
+    std::vector<TrafficCacheAircraft> aircraft;
+    std::vector<TrafficCacheFlight> flights;
+    TrafficScheduleCache reader(cachePath);
+    bool ok = reader.load(files,
+        [&aircraft](const TrafficCacheAircraft& ac) { aircraft.push_back(ac); },
+        [&flights](const TrafficCacheFlight& flt) { flights.push_back(flt); });
+
+    CPPUNIT_ASSERT(ok);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), aircraft.size());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), flights.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("G-ABCD"), aircraft.front().registration);
+    CPPUNIT_ASSERT(aircraft.front().heavy);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(18.0, aircraft.front().radius, 1e-9);
+    CPPUNIT_ASSERT_EQUAL(std::string("EGPF"), flights.back().arrivalPort);
+    CPPUNIT_ASSERT_EQUAL(240, flights.back().cruiseAlt);
+
+    // an additional traffic file invalidates the cache
+    const SGPath extraFile = subDir / "TST2.xml";
+    {
+        sg_ofstream f(extraFile, std::ios::out | std::ios::trunc);
+        f << "<?xml version=\"1.0\"?>\n<trafficlist/>\n";
+    }
+
+    files = TrafficScheduleCache::findTrafficFiles({trafficDir});
+    aircraft.clear();
+    ok = reader.load(files,
+        [&aircraft](const TrafficCacheAircraft& ac) { aircraft.push_back(ac); },
+        [](const TrafficCacheFlight&) {});
+    CPPUNIT_ASSERT(!ok);
+    CPPUNIT_ASSERT(aircraft.empty());
+}
+
+void TrafficMgrTests::testScheduleQueue()
+{
+    auto makeSchedule = [](const std::string& reg) {
+        return std::make_unique<FGAISchedule>("Aircraft/737/Models/737.xml", "", "EGPH", reg, "TST_BN_1",
+                                              false, "737", "TST", "jet_transport", "gate", 18.0, 0.0);
+    };
+
+    auto a = makeSchedule("G-AAAA");
+    auto b = makeSchedule("G-BBBB");
+    auto c = makeSchedule("G-CCCC");
+    const ScheduleVector schedules{a.get(), b.get(), c.get()};
+
+    // all due at once: in rank order
+    TrafficScheduleQueue queue;
+    queue.reset(schedules, 100);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), queue.size());
+    CPPUNIT_ASSERT_EQUAL(a.get(), queue.popDue(100));
+    CPPUNIT_ASSERT_EQUAL(b.get(), queue.popDue(100));
+    CPPUNIT_ASSERT_EQUAL(c.get(), queue.popDue(100));
+    CPPUNIT_ASSERT(!queue.popDue(100));
+
+    // otherwise in due-time order, and nothing before it is due
+    queue.push(a.get(), 300);
+    queue.push(b.get(), 200);
+    queue.push(c.get(), 250);
+    CPPUNIT_ASSERT(!queue.hasDue(150));
+    CPPUNIT_ASSERT(!queue.popDue(150));
+    CPPUNIT_ASSERT_EQUAL(b.get(), queue.popDue(260));
+    CPPUNIT_ASSERT_EQUAL(c.get(), queue.popDue(260));
+    CPPUNIT_ASSERT(!queue.popDue(260));
+    CPPUNIT_ASSERT_EQUAL(a.get(), queue.popDue(300));
+
+    // pushing again replaces the queued entry, earlier or later
+    queue.push(a.get(), 500);
+    queue.push(a.get(), 400);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), queue.size());
+    CPPUNIT_ASSERT_EQUAL(a.get(), queue.popDue(450));
+    CPPUNIT_ASSERT(!queue.popDue(600));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), queue.size());
+
+    queue.push(b.get(), 400);
+    queue.push(b.get(), 900);
+    CPPUNIT_ASSERT(!queue.popDue(600));
+    CPPUNIT_ASSERT_EQUAL(b.get(), queue.popDue(900));
+
+    // a relocation requeues everything as due now
+    queue.push(a.get(), 2000);
+    queue.push(c.get(), 3000);
+    queue.reset(schedules, 1000);
+    CPPUNIT_ASSERT(queue.hasDue(1000));
+    CPPUNIT_ASSERT_EQUAL(a.get(), queue.popDue(1000));
+    CPPUNIT_ASSERT_EQUAL(b.get(), queue.popDue(1000));
+    CPPUNIT_ASSERT_EQUAL(c.get(), queue.popDue(1000));
+    CPPUNIT_ASSERT(!queue.popDue(5000));
+
+    // the budget stops processing after the first slow update
+    queue.reset(schedules, 100);
+    std::vector<FGAISchedule*> processed;
+    int count = queue.processDue(100, 1.0, [&processed](FGAISchedule* schedule) {
+        processed.push_back(schedule);
+        SGTimeStamp::sleepForMSec(5);
+        return true;
+    });
+    CPPUNIT_ASSERT_EQUAL(1, count);
+    CPPUNIT_ASSERT_EQUAL(a.get(), processed.front());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), queue.size());
+
+    // a preempted schedule stops processing too, and stays due; the one
+    // processed above was requeued at its next update time, which for a
+    // schedule that was never updated is the epoch
+    processed.clear();
+    count = queue.processDue(100, 1000.0, [&processed](FGAISchedule* schedule) {
+        processed.push_back(schedule);
+        return false;
+    });
+    CPPUNIT_ASSERT_EQUAL(1, count);
+    CPPUNIT_ASSERT_EQUAL(a.get(), processed.front());
+    CPPUNIT_ASSERT(queue.hasDue(100));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), queue.size());
+}
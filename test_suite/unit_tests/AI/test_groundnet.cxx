@@ -36,11 +36,14 @@
 #include <AIModel/performancedb.hxx>
 #include <Airports/airport.hxx>
 #include <Airports/airportdynamicsmanager.hxx>
+#include <Airports/dynamics.hxx>
 #include <Airports/groundnetwork.hxx>
 #include <Airports/parking.hxx>
 #include <Traffic/TrafficMgr.hxx>
 
+#include <ATC/GroundNetworkMesh.hxx>
 #include <ATC/atc_mgr.hxx>
+#include <ATC/trafficcontrol.hxx>
 
 #include <Main/fg_props.hxx>
 #include <Main/globals.hxx>
@@ -120,3 +123,79 @@ void GroundnetTests::testFind()
     CPPUNIT_ASSERT(pushForwardSegment);
     CPPUNIT_ASSERT_EQUAL(1027, pushForwardSegment->getEnd()->getIndex());
 }
+
+/**
+ * The spatial grid used for ATC proximity checks must return every record
+ * within the requested range, and leave out the far away ones.
+ */
+
+void GroundnetTests::testTrafficGrid()
+{
+    FGAirportRef egph = FGAirport::getByIdent("EGPH");
+    const SGGeod center = egph->geod();
+
+    TrafficVector traffic;
+    for (int i = 0; i < 36; ++i) {
+        // a ring of aircraft 100m around the centre, and one 5km away
+        SGGeod pos = SGGeodesy::direct(center, i * 10.0, 100.0);
+        FGTrafficRecord rec;
+        rec.setId(i + 1);
+        rec.setRadius(20.0);
+        rec.setPositionAndHeading(pos.getLatitudeDeg(), pos.getLongitudeDeg(), 0.0, 0.0, 0.0);
+        traffic.push_back(rec);
+    }
+    SGGeod far = SGGeodesy::direct(center, 45.0, 5000.0);
+    FGTrafficRecord farRec;
+    farRec.setId(100);
+    farRec.setRadius(40.0);
+    farRec.setPositionAndHeading(far.getLatitudeDeg(), far.getLongitudeDeg(), 0.0, 0.0, 0.0);
+    traffic.push_back(farRec);
+
+    FGTrafficGrid grid;
+    grid.update(traffic, 1.0);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(40.0, grid.getMaxRadius(), 1e-9);
+
+    std::vector<TrafficVectorIterator> nearby;
+    grid.query(center, 150.0, nearby);
+    int ring = 0;
+    for (auto it : nearby) {
+        CPPUNIT_ASSERT(it->getId() != 100);
+        ring++;
+    }
+    CPPUNIT_ASSERT_EQUAL(36, ring);
+
+    nearby.clear();
+    grid.query(far, 50.0, nearby);
+    CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(nearby.size()));
+    CPPUNIT_ASSERT_EQUAL(100, nearby.front()->getId());
+}
+
+/**
+ * The debug view mesh belongs to the airport: the startup and the ground
+ * controller render into the same one instead of building a copy each.
+ */
+
+void GroundnetTests::testGroundNetworkMesh()
+{
+    FGAirportRef egph = FGAirport::getByIdent("EGPH");
+    FGAirportDynamicsRef dynamics = egph->getDynamics();
+    CPPUNIT_ASSERT(dynamics);
+    CPPUNIT_ASSERT(!dynamics->getGroundNetworkMesh(false));
+
+    dynamics->getStartupController()->render(true);
+    FGGroundNetworkMesh* mesh = dynamics->getGroundNetworkMesh(false);
+    CPPUNIT_ASSERT(mesh);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(egph->groundNetwork()->getNumSegments()), mesh->size());
+
+    dynamics->getGroundController()->render(true);
+    CPPUNIT_ASSERT(mesh == dynamics->getGroundNetworkMesh(false));
+    CPPUNIT_ASSERT(mesh == dynamics->getGroundNetworkMesh());
+
+    // hiding must not build anything for an airport which never rendered
+    FGAirportRef ybbn = FGAirport::getByIdent("YBBN");
+    ybbn->getDynamics()->getGroundController()->render(false);
+    CPPUNIT_ASSERT(!ybbn->getDynamics()->getGroundNetworkMesh(false));
+
+    dynamics->getGroundController()->render(false);
+    CPPUNIT_ASSERT(mesh == dynamics->getGroundNetworkMesh(false));
+}
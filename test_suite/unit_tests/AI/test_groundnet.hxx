@@ -35,6 +35,8 @@ class GroundnetTests : public CppUnit::TestFixture
     CPPUNIT_TEST_SUITE(GroundnetTests);
     CPPUNIT_TEST(testShortestRoute);
     CPPUNIT_TEST(testFind);
+    CPPUNIT_TEST(testTrafficGrid);
+    CPPUNIT_TEST(testGroundNetworkMesh);
     
     CPPUNIT_TEST_SUITE_END();
 
@@ -49,4 +51,6 @@ public:
     // The tests.
     void testShortestRoute();
     void testFind();
+    void testTrafficGrid();
+    void testGroundNetworkMesh();
 };
@@ -259,3 +259,42 @@ void SubmodelsTests::testInitialState()
     CPPUNIT_ASSERT_DOUBLES_EQUAL(sin((pitch + pitch_offset) * SG_DEGREES_TO_RADIANS) * speed,
                                  sm->_getVS_fps(), 0.1);
 }
+
+void SubmodelsTests::testLightweight()
+{
+    auto props = globals->get_props();
+    auto sm_node = props->getNode("ai/submodels/submodel[3]");
+    std::string name = sm_node->getStringValue("name");
+    auto particles = props->getNode("sim/submodels/particles");
+
+    auto bikf = FGAirport::findByIdent("BIKF");
+    auto pilot = SGSharedPtr<FGTestApi::TestPilot>(new FGTestApi::TestPilot);
+    FGTestApi::setPosition(bikf->geod());
+    pilot->resetAtPosition(bikf->geod());
+    pilot->setSpeedKts(0);
+    pilot->setCourseTrue(0.0);
+    pilot->setTargetAltitudeFtMSL(0);
+    FGTestApi::runForTime(1);
+
+    // rounds go into the pool, not into the AI list
+    sm_node->setBoolValue("trigger", true);
+    FGTestApi::runForTime(1.05);
+    sm_node->setBoolValue("trigger", false);
+    CPPUNIT_ASSERT_EQUAL(0, countAIModels(name));
+    const int active = particles->getIntValue("active");
+    CPPUNIT_ASSERT(active >= 9 && active <= 11);
+    CPPUNIT_ASSERT_EQUAL(active, particles->getIntValue("spawned"));
+
+    // and expire like ballistic objects
+    FGTestApi::runForTime(3);
+    CPPUNIT_ASSERT_EQUAL(0, particles->getIntValue("active"));
+    CPPUNIT_ASSERT_EQUAL(0, particles->getIntValue("promoted"));
+
+    // with a full pool they are released as FGAIBallistic again
+    particles->setIntValue("max-count", 0);
+    sm_node->setBoolValue("trigger", true);
+    FGTestApi::runForTime(0.35);
+    sm_node->setBoolValue("trigger", false);
+    CPPUNIT_ASSERT(countAIModels(name) >= 3);
+    CPPUNIT_ASSERT_EQUAL(0, particles->getIntValue("active"));
+}
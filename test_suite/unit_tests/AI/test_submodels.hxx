@@ -35,6 +35,7 @@ class SubmodelsTests : public CppUnit::TestFixture
     CPPUNIT_TEST(testLoadXML);
     CPPUNIT_TEST(testRelease);
     CPPUNIT_TEST(testInitialState);
+    CPPUNIT_TEST(testLightweight);
 
     CPPUNIT_TEST_SUITE_END();
 
@@ -50,6 +51,7 @@ public:
     void testLoadXML();
     void testRelease();
     void testInitialState();
+    void testLightweight();
 
 private:
     FGAIBase* findAIModel(std::string &name);
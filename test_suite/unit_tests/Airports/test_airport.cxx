@@ -24,11 +24,14 @@
 #include <iostream>
 #include <cstring>
 #include <memory>
+#include <sstream>
 
 #include "test_suite/FGTestApi/NavDataCache.hxx"
 #include "test_suite/FGTestApi/TestDataLogger.hxx"
 #include "test_suite/FGTestApi/testGlobals.hxx"
 
+#include <simgear/io/iostreams/sgstream.hxx>
+#include <simgear/io/iostreams/zlibstream.hxx>
 #include <simgear/math/sg_geodesy.hxx>
 #include <simgear/math/SGGeod.hxx>
 #include <AIModel/AIAircraft.hxx>
@@ -38,6 +41,7 @@
 
 #include <Airports/airport.hxx>
 #include <Airports/airportdynamicsmanager.hxx>
+#include <Airports/apt_loader.hxx>
 #include <Airports/runways.hxx>
 #include <Traffic/TrafficMgr.hxx>
 #include <Time/TimeManager.hxx>
@@ -82,3 +86,81 @@ void AirportTests::testAirport()
     CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Distance between the runway start and point on centerline should be runway length", length, calculated, 1);
 
 }
+
+/**
+ * @brief Read the pavements of an airport from its offset in an apt.dat
+ *
+ */
+void AirportTests::testAirportDetail()
+{
+    const std::string header = "I\n1100 Version\n";
+    const std::string airport = "1 21 1 0 XTST Test Field\n"
+                                "100 45.00 1 0 0.25 1 2 1 09 51.0 -1.0 0 0 3 0 0 0 27 51.0 -0.99 0 0 3 0 0 0\n"
+                                "110 1 0.25 0.00 Apron\n"
+                                "111 51.001 -1.001\n"
+                                "111 51.001 -1.002\n"
+                                "113 51.002 -1.002\n"
+                                "20 51.0 -1.0 0 0 2 {@Y}A\n"
+                                "120 Centreline\n"
+                                "111 51.001 -1.001 1\n"
+                                "115 51.002 -1.001\n"
+                                "130 Boundary\n"
+                                "111 51.003 -1.003\n"
+                                "113 51.004 -1.004\n";
+    const std::string next = "1 21 1 0 XTS2 Next Field\n"
+                             "110 1 0.25 0.00 Other\n"
+                             "111 52.001 -1.001\n"
+                             "113 52.002 -1.002\n"
+                             "99\n";
+
+    const SGPath aptDat = globals->get_fg_home() / "detail_apt.dat";
+    {
+        sg_ofstream f(aptDat, std::ios::out | std::ios::binary | std::ios::trunc);
+        f << header << airport << next;
+    }
+
+    flightgear::APTLoader loader;
+    flightgear::APTLoader::AirportDetail detail;
+    CPPUNIT_ASSERT(loader.readAirportDetail(aptDat, header.size(), 3, "XTST", detail));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Must stop at the next airport", size_t{1}, detail.pavements.size());
+    CPPUNIT_ASSERT_EQUAL(std::string{"Apron"}, detail.pavements.front()->ident());
+    CPPUNIT_ASSERT_EQUAL(size_t{1}, detail.lineFeatures.size());
+    CPPUNIT_ASSERT_EQUAL(size_t{1}, detail.boundary.size());
+
+    flightgear::APTLoader::AirportDetail nextDetail;
+    CPPUNIT_ASSERT(loader.readAirportDetail(aptDat, header.size() + airport.size(), 16, "XTS2", nextDetail));
+    CPPUNIT_ASSERT_EQUAL(size_t{1}, nextDetail.pavements.size());
+    CPPUNIT_ASSERT(nextDetail.boundary.empty());
+
+    // an offset which isn't the airport's is refused
+    flightgear::APTLoader::AirportDetail wrong;
+    CPPUNIT_ASSERT(!loader.readAirportDetail(aptDat, header.size(), 3, "XTS2", wrong));
+    CPPUNIT_ASSERT(wrong.pavements.empty());
+
+    // compressed files can't be seeked, their rows are kept by the scan
+    CPPUNIT_ASSERT(flightgear::APTLoader::canSeekAptDat(aptDat));
+    CPPUNIT_ASSERT(!flightgear::APTLoader::canSeekAptDat(SGPath("Airports/apt.dat.gz")));
+
+    const std::string rows = "110 1 0.25 0.00 Apron\n"
+                             "111 51.001 -1.001\n"
+                             "111 51.001 -1.002\n"
+                             "113 51.002 -1.002\n"
+                             "120 Centreline\n"
+                             "111 51.001 -1.001 1\n"
+                             "115 51.002 -1.001\n"
+                             "130 Boundary\n"
+                             "111 51.003 -1.003\n"
+                             "113 51.004 -1.004\n";
+    // which are stored deflated
+    std::istringstream plainRows(rows);
+    simgear::ZlibCompressorIStream compressor(plainRows);
+    std::ostringstream deflatedRows;
+    deflatedRows << compressor.rdbuf();
+
+    flightgear::APTLoader::AirportDetail fromRows;
+    loader.parseAirportDetail(deflatedRows.str(), aptDat, 5, fromRows);
+    CPPUNIT_ASSERT_EQUAL(size_t{1}, fromRows.pavements.size());
+    CPPUNIT_ASSERT_EQUAL(std::string{"Apron"}, fromRows.pavements.front()->ident());
+    CPPUNIT_ASSERT_EQUAL(size_t{1}, fromRows.lineFeatures.size());
+    CPPUNIT_ASSERT_EQUAL(size_t{1}, fromRows.boundary.size());
+}
@@ -34,6 +34,7 @@ class AirportTests : public CppUnit::TestFixture
     // Set up the test suite.
     CPPUNIT_TEST_SUITE(AirportTests);
     CPPUNIT_TEST(testAirport);
+    CPPUNIT_TEST(testAirportDetail);
     CPPUNIT_TEST_SUITE_END();
 
 
@@ -46,4 +47,5 @@ public:
 
     // The tests.
     void testAirport();
+    void testAirportDetail();
 };
@@ -17,6 +17,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "test_binaryCacheFile.hxx"
 #include "test_flightplan.hxx"
 #include "test_navaids2.hxx"
 #include "test_aircraftPerformance.hxx"
@@ -29,3 +30,4 @@ CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(FPNasalTests, "Unit tests");
 CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(NavaidsTests, "Unit tests");
 CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(AircraftPerformanceTests, "Unit tests");
 CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(RouteManagerTests, "Unit tests");
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(BinaryCacheFileTests, "Unit tests");
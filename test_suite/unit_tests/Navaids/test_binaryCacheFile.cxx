@@ -0,0 +1,170 @@
+/*
+ * SPDX-FileName: test_binaryCacheFile.cxx
+ * SPDX-FileComment: unit tests for the framing shared by the binary caches
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#include "test_binaryCacheFile.hxx"
+
+#include <simgear/misc/sg_dir.hxx>
+
+#include "test_suite/FGTestApi/testGlobals.hxx"
+
+#include <Main/globals.hxx>
+#include <Navaids/BinaryCacheFile.hxx>
+
+using namespace flightgear;
+
+namespace {
+
+const char TEST_MAGIC[8] = {'F', 'G', 'T', 'E', 'S', 'T', 'D', 'B'};
+const uint32_t TEST_VERSION = 3;
+
+SGPath testDir()
+{
+    return globals->get_fg_home() / "BinaryCacheTest";
+}
+
+size_t numFiles()
+{
+    simgear::Dir dir(testDir());
+    return dir.exists() ? dir.children(simgear::Dir::TYPE_FILE).size() : 0;
+}
+
+} // of anonymous namespace
+
+// Set up function for each test.
+void BinaryCacheFileTests::setUp()
+{
+    FGTestApi::setUp::initTestGlobals("binary-cache-file");
+    simgear::Dir dir(testDir());
+    if (dir.exists()) {
+        dir.remove(true);
+    }
+}
+
+
+// Clean up after each test.
+void BinaryCacheFileTests::tearDown()
+{
+    FGTestApi::tearDown::shutdownTestGlobals();
+}
+
+
+void BinaryCacheFileTests::testRoundTrip()
+{
+    const SGPath path = testDir() / "test.cache";
+
+    BinaryCacheHeader header;
+    header.init(TEST_MAGIC, TEST_VERSION);
+    const uint32_t value = 42;
+    const uint64_t valuePos = binaryCacheAlign(sizeof(header) + 1);
+    {
+        BinaryCacheWriter w(path);
+        CPPUNIT_ASSERT(w.isOpen());
+        w.write(&header, sizeof(header));
+        w.padTo(valuePos);
+        w.write(&value, sizeof(value));
+        CPPUNIT_ASSERT(w.commit());
+    }
+
+    // only the cache file itself is left
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), numFiles());
+
+    std::string data;
+    CPPUNIT_ASSERT(readBinaryCacheFile(path, data));
+    CPPUNIT_ASSERT_EQUAL(valuePos + sizeof(value), static_cast<uint64_t>(data.size()));
+
+    BinaryCacheReader reader(data);
+    BinaryCacheHeader readHeader;
+    CPPUNIT_ASSERT(reader.get(&readHeader, sizeof(readHeader)));
+    CPPUNIT_ASSERT(readHeader.matches(TEST_MAGIC, TEST_VERSION));
+    CPPUNIT_ASSERT(!readHeader.matches(TEST_MAGIC, TEST_VERSION + 1));
+
+    std::string padding;
+    CPPUNIT_ASSERT(reader.getString(padding, valuePos - sizeof(header)));
+    uint32_t readValue = 0;
+    CPPUNIT_ASSERT(reader.get(&readValue, sizeof(readValue)));
+    CPPUNIT_ASSERT_EQUAL(value, readValue);
+
+    // reads never run past the end of the data
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), reader.remaining());
+    CPPUNIT_ASSERT(!reader.get(&readValue, 1));
+    CPPUNIT_ASSERT(!reader.getString(padding, 1));
+
+    CPPUNIT_ASSERT(binaryCacheSectionFits(64, 16, 6, 8));
+    CPPUNIT_ASSERT(!binaryCacheSectionFits(64, 16, 7, 8));
+    CPPUNIT_ASSERT(!binaryCacheSectionFits(64, 12, 1, 4));
+    CPPUNIT_ASSERT(!binaryCacheSectionFits(64, 72, 0, 8));
+
+    CPPUNIT_ASSERT(!readBinaryCacheFile(testDir() / "missing.cache", data));
+}
+
+void BinaryCacheFileTests::testUncommitted()
+{
+    const SGPath path = testDir() / "test.cache";
+    {
+        BinaryCacheWriter w(path);
+        CPPUNIT_ASSERT(w.isOpen());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), numFiles());
+    }
+
+    // nothing is left behind by a writer which never commits
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), numFiles());
+    CPPUNIT_ASSERT(!path.exists());
+}
+
+void BinaryCacheFileTests::testConcurrentWriters()
+{
+    const SGPath path = testDir() / "test.cache";
+    const uint32_t first = 1, second = 2;
+
+    // two writers of the same cache, as from two instances sharing
+    // FG_HOME, never write into each other's temporary file
+    BinaryCacheWriter a(path);
+    BinaryCacheWriter b(path);
+    CPPUNIT_ASSERT(a.isOpen());
+    CPPUNIT_ASSERT(b.isOpen());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), numFiles());
+
+    a.write(&first, sizeof(first));
+    b.write(&second, sizeof(second));
+    b.write(&second, sizeof(second));
+    CPPUNIT_ASSERT(a.commit());
+
+    std::string data;
+    CPPUNIT_ASSERT(readBinaryCacheFile(path, data));
+    CPPUNIT_ASSERT_EQUAL(sizeof(first), data.size());
+
+    CPPUNIT_ASSERT(b.commit());
+    CPPUNIT_ASSERT(readBinaryCacheFile(path, data));
+    CPPUNIT_ASSERT_EQUAL(2 * sizeof(second), data.size());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), numFiles());
+}
+
+void BinaryCacheFileTests::testDamaged()
+{
+    const SGPath path = testDir() / "test.cache";
+    FGTestApi::writeDamagedCacheFile(path, std::string(TEST_MAGIC, sizeof(TEST_MAGIC)));
+
+    // the file starts right, but is too short for a header
+    std::string data;
+    CPPUNIT_ASSERT(readBinaryCacheFile(path, data));
+    CPPUNIT_ASSERT_EQUAL(0, data.compare(0, sizeof(TEST_MAGIC), TEST_MAGIC, sizeof(TEST_MAGIC)));
+
+    BinaryCacheReader reader(data);
+    BinaryCacheHeader header;
+    CPPUNIT_ASSERT(!reader.get(&header, sizeof(header)));
+
+    // a header of another kind of cache, or from another byte order
+    BinaryCacheHeader other;
+    other.init("FGOTHRDB", TEST_VERSION);
+    CPPUNIT_ASSERT(!other.matches(TEST_MAGIC, TEST_VERSION));
+
+    BinaryCacheHeader swapped;
+    swapped.init(TEST_MAGIC, TEST_VERSION);
+    swapped.endianMarker = 0x04030201;
+    CPPUNIT_ASSERT(!swapped.matches(TEST_MAGIC, TEST_VERSION));
+}
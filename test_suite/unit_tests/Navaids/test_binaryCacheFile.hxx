@@ -0,0 +1,35 @@
+/*
+ * SPDX-FileName: test_binaryCacheFile.hxx
+ * SPDX-FileComment: unit tests for the framing shared by the binary caches
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+
+class BinaryCacheFileTests : public CppUnit::TestFixture
+{
+    // Set up the test suite.
+    CPPUNIT_TEST_SUITE(BinaryCacheFileTests);
+    CPPUNIT_TEST(testRoundTrip);
+    CPPUNIT_TEST(testUncommitted);
+    CPPUNIT_TEST(testConcurrentWriters);
+    CPPUNIT_TEST(testDamaged);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    // Set up function for each test.
+    void setUp();
+
+    // Clean up after each test.
+    void tearDown();
+
+    // The tests.
+    void testRoundTrip();
+    void testUncommitted();
+    void testConcurrentWriters();
+    void testDamaged();
+};
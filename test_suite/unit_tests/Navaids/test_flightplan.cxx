@@ -33,10 +33,13 @@
 #include <simgear/structure/exception.hxx>
 #include <simgear/magvar/magvar.hxx>
 #include <simgear/timing/sg_time.hxx>
+#include <simgear/timing/timestamp.hxx>
 
 #include <Navaids/FlightPlan.hxx>
 #include <Navaids/routePath.hxx>
 #include <Navaids/NavDataCache.hxx>
+#include <Navaids/ProcedureCache.hxx>
+#include <Navaids/procedure.hxx>
 #include <Navaids/waypoint.hxx>
 #include <Navaids/navlist.hxx>
 #include <Navaids/navrecord.hxx>
@@ -44,6 +47,7 @@
 #include <Navaids/fix.hxx>
 
 #include <Airports/airport.hxx>
+#include <Main/fg_props.hxx>
 #include <Main/globals.hxx>
 
 using namespace std::string_literals;
@@ -556,6 +560,68 @@ void FlightplanTests::testAirwayNetworkRoute()
     CPPUNIT_ASSERT_EQUAL(static_cast<int>(route.size()), 18);
 }
 
+void FlightplanTests::testAirwayGraphSearch()
+{
+    // a small network far from any real airway: A-B-C on one airway, a
+    // longer A-D-C on another, and E-F on its own
+    SGPath awyDat = globals->get_fg_home() / "test_awy.dat";
+    {
+        sg_ofstream f(awyDat);
+        f << "I\n640 test airways\n";
+        f << "TEST_AWY_A -55.0 -130.0 TEST_AWY_B -55.0 -129.0 2 180 450 TAWY1\n";
+        f << "TEST_AWY_B -55.0 -129.0 TEST_AWY_C -55.0 -128.0 2 180 450 TAWY1\n";
+        f << "TEST_AWY_A -55.0 -130.0 TEST_AWY_D -56.0 -129.0 2 180 450 TAWY2\n";
+        f << "TEST_AWY_D -56.0 -129.0 TEST_AWY_C -55.0 -128.0 2 180 450 TAWY2\n";
+        f << "TEST_AWY_E -55.0 -120.0 TEST_AWY_F -55.0 -119.0 2 180 450 TAWY3\n";
+        f << "99\n";
+    }
+
+    {
+        // create a transaction, which we don't commit, to avoid making permanent DB changes
+        NavDataCache::Transaction txn(NavDataCache::instance());
+        Airway::loadAWYDat(awyDat);
+
+        auto node = [](const std::string& ident, double lat, double lon) -> WayptRef {
+            auto pos = FGPositioned::findClosestWithIdent(ident, SGGeod::fromDeg(lon, lat));
+            CPPUNIT_ASSERT(pos);
+            return new NavaidWaypoint(pos, nullptr);
+        };
+
+        auto wptA = node("TEST_AWY_A"s, -55.0, -130.0);
+        auto wptC = node("TEST_AWY_C"s, -55.0, -128.0);
+        auto wptF = node("TEST_AWY_F"s, -55.0, -119.0);
+
+        // the exact end points are not repeated in the route
+        auto highLevelNet = Airway::highLevel();
+        WayptVec route;
+        CPPUNIT_ASSERT(highLevelNet->route(wptA, wptC, route));
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), route.size());
+        CPPUNIT_ASSERT_EQUAL("TEST_AWY_B"s, route.front()->ident());
+        CPPUNIT_ASSERT_EQUAL("TAWY1"s, route.front()->owner()->ident());
+
+        route.clear();
+        CPPUNIT_ASSERT(!highLevelNet->route(wptA, wptF, route));
+
+        // and the search state doesn't leak into the next search
+        route.clear();
+        CPPUNIT_ASSERT(highLevelNet->route(wptC, wptA, route));
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), route.size());
+        CPPUNIT_ASSERT_EQUAL("TEST_AWY_B"s, route.front()->ident());
+
+        // keep the rolled back rows out of the loaded positioned cache
+        for (const auto& ident : {"TEST_AWY_A"s, "TEST_AWY_B"s, "TEST_AWY_C"s,
+                                  "TEST_AWY_D"s, "TEST_AWY_E"s, "TEST_AWY_F"s}) {
+            for (const auto& pos : FGPositioned::findAllWithIdent(ident)) {
+                FGPositioned::deleteWaypoint(pos);
+            }
+        }
+    }
+
+    // the test edges are rolled back, so drop the graph built from them
+    Airway::clearCache();
+    awyDat.remove();
+}
+
 void FlightplanTests::testParseICAORoute()
 {
     FGAirportRef kord = FGAirport::findByIdent("KORD"s);
@@ -1380,3 +1446,202 @@ void FlightplanTests::testRoute()
     CPPUNIT_ASSERT(!fp1->isActive());
 
 }
+
+static void checkRoutePathMatchesRebuild(FlightPlanRef fp)
+{
+    const RoutePath& cached = fp->routePath();
+    RoutePath rebuilt(fp);
+    for (int l = 0; l < fp->numLegs(); ++l) {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(rebuilt.trackForIndex(l), cached.trackForIndex(l), 1e-9);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(rebuilt.distanceForIndex(l), cached.distanceForIndex(l), 1e-6);
+
+        const SGGeod a = rebuilt.positionForIndex(l), b = cached.positionForIndex(l);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(a.getLatitudeDeg(), b.getLatitudeDeg(), 1e-9);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(a.getLongitudeDeg(), b.getLongitudeDeg(), 1e-9);
+    }
+}
+
+void FlightplanTests::testRoutePathIncremental()
+{
+    FlightPlanRef fp1 = makeTestFP("EGHI"s, "20"s, "EDDM"s, "08L"s,
+                                   "SFD LYD BNE CIV ELLX LUX SAA KRH WLD"s);
+
+    const int legCount = fp1->numLegs();
+    checkRoutePathMatchesRebuild(fp1);
+
+    // nothing changed, nothing to do
+    CPPUNIT_ASSERT_EQUAL(0, fp1->routePath().recomputedCount());
+    RoutePath copy(fp1->routePath());
+    CPPUNIT_ASSERT(!copy.update(fp1));
+
+    // inserting recomputes the legs around the new waypoint only
+    fp1->insertWayptAtIndex(new BasicWaypt(SGGeod::fromDeg(4.8, 50.2), "TEST1"s, fp1.get()), 5);
+    CPPUNIT_ASSERT_EQUAL(legCount + 1, fp1->numLegs());
+    const int afterInsert = fp1->routePath().recomputedCount();
+    CPPUNIT_ASSERT(afterInsert > 0);
+    CPPUNIT_ASSERT(afterInsert < fp1->numLegs());
+    checkRoutePathMatchesRebuild(fp1);
+    CPPUNIT_ASSERT(copy.update(fp1));
+    CPPUNIT_ASSERT(!copy.update(fp1));
+
+    fp1->deleteIndex(3);
+    CPPUNIT_ASSERT(fp1->routePath().recomputedCount() < fp1->numLegs());
+    checkRoutePathMatchesRebuild(fp1);
+
+    // replacing the first waypoint recomputes from the start
+    fp1->deleteIndex(0);
+    checkRoutePathMatchesRebuild(fp1);
+
+    // a batch defers the delegates, and leg data, to the commit
+    auto ourDelegate = TestFPDelegateFactory::delegateForPlan(fp1);
+    CPPUNIT_ASSERT(ourDelegate);
+    ourDelegate->sawWaypointsChange = false;
+
+    const double distanceBefore = fp1->totalDistanceNm();
+    fp1->beginBatchEdit();
+    fp1->insertWayptAtIndex(new BasicWaypt(SGGeod::fromDeg(1.5, 51.2), "TEST2"s, fp1.get()), 2);
+    fp1->insertWayptAtIndex(new BasicWaypt(SGGeod::fromDeg(8.0, 49.6), "TEST3"s, fp1.get()), 8);
+    CPPUNIT_ASSERT(!ourDelegate->sawWaypointsChange);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(distanceBefore, fp1->totalDistanceNm(), 1e-9);
+
+    fp1->commitBatchEdit();
+    CPPUNIT_ASSERT(ourDelegate->sawWaypointsChange);
+    CPPUNIT_ASSERT(fp1->totalDistanceNm() > distanceBefore);
+    checkRoutePathMatchesRebuild(fp1);
+
+    // unbalanced commits are ignored
+    fp1->commitBatchEdit();
+
+    // a waypoint edited in place after inserts in the same batch is found
+    // where it is now, even past the end of the route before the batch
+    fp1->beginBatchEdit();
+    fp1->insertWayptAtIndex(new BasicWaypt(SGGeod::fromDeg(0.5, 51.0), "TEST4"s, fp1.get()), 1);
+    fp1->insertWayptAtIndex(new BasicWaypt(SGGeod::fromDeg(0.9, 51.1), "TEST5"s, fp1.get()), 2);
+    auto editedLeg = fp1->legAtIndex(fp1->numLegs() - 2);
+    editedLeg->waypoint()->setFlag(WPT_OVERFLIGHT);
+    editedLeg->markWaypointDirty();
+    fp1->commitBatchEdit();
+    checkRoutePathMatchesRebuild(fp1);
+
+    // and edited in place on its own, only its neighbourhood is recomputed
+    editedLeg = fp1->legAtIndex(4);
+    editedLeg->waypoint()->setFlag(WPT_OVERFLIGHT);
+    editedLeg->markWaypointDirty();
+    CPPUNIT_ASSERT(fp1->routePath().recomputedCount() > 0);
+    CPPUNIT_ASSERT(fp1->routePath().recomputedCount() < fp1->numLegs());
+    checkRoutePathMatchesRebuild(fp1);
+
+    // other performance data changes every leg
+    const std::string category = fgGetString("/aircraft/performance/icao-category");
+    fgSetString("/aircraft/performance/icao-category", "A");
+    CPPUNIT_ASSERT_EQUAL(fp1->numLegs(), fp1->routePath().recomputedCount());
+    checkRoutePathMatchesRebuild(fp1);
+
+    fgSetString("/aircraft/performance/icao-category", "E");
+    CPPUNIT_ASSERT_EQUAL(fp1->numLegs(), fp1->routePath().recomputedCount());
+    checkRoutePathMatchesRebuild(fp1);
+    CPPUNIT_ASSERT_EQUAL(0, fp1->routePath().recomputedCount());
+
+    fgSetString("/aircraft/performance/icao-category", category);
+}
+
+void FlightplanTests::testProcedureCache()
+{
+    auto cache = flightgear::ProcedureCache::instance();
+    const SGPath source = SGPath::fromUtf8(FG_TEST_SUITE_DATA) / "EDTY.procedures.xml";
+    SGPath cachePath = cache->cacheFile(source);
+    cachePath.remove();
+
+    // copies of the file in other scenery paths have cache files of their own
+    const SGPath sceneryCopy = globals->get_fg_home() / "Airports" / "E" / "D" / "T" / "EDTY.procedures.xml";
+    CPPUNIT_ASSERT(cache->cacheFile(sceneryCopy).utf8Str() != cachePath.utf8Str());
+
+    auto edty = FGAirport::findByIdent("EDTY"s);
+    const uint64_t xmlReads = cache->xmlReads();
+    edty->testSuiteInjectProceduresXML(source);
+    CPPUNIT_ASSERT_EQUAL(xmlReads + 1, cache->xmlReads());
+    CPPUNIT_ASSERT(cachePath.exists());
+
+    const unsigned int numApproaches = edty->numApproaches();
+    auto ils28 = edty->findApproachWithIdent("ILS28"s);
+    CPPUNIT_ASSERT(ils28);
+    const size_t primarySize = ils28->primary().size();
+    const size_t missedSize = ils28->missed().size();
+
+    // the same procedures from the binary cache
+    const uint64_t cacheReads = cache->cacheReads();
+    edty->testSuiteInjectProceduresXML(source);
+    CPPUNIT_ASSERT_EQUAL(cacheReads + 1, cache->cacheReads());
+    CPPUNIT_ASSERT_EQUAL(numApproaches, edty->numApproaches());
+    ils28 = edty->findApproachWithIdent("ILS28"s);
+    CPPUNIT_ASSERT(ils28);
+    CPPUNIT_ASSERT_EQUAL(primarySize, ils28->primary().size());
+    CPPUNIT_ASSERT_EQUAL(missedSize, ils28->missed().size());
+    CPPUNIT_ASSERT_EQUAL("28"s, ils28->runway()->ident());
+
+    // and from a prefetch
+    const uint64_t prefetchHits = cache->prefetchHits();
+    cache->prefetch(source);
+    edty->testSuiteInjectProceduresXML(source);
+    CPPUNIT_ASSERT_EQUAL(prefetchHits + 1, cache->prefetchHits());
+    CPPUNIT_ASSERT_EQUAL(numApproaches, edty->numApproaches());
+
+    // a cache written from other contents of the file is parsed again
+    SGPath copy = globals->get_fg_home() / "EDTY.procedures.xml";
+    {
+        sg_ifstream in(source);
+        sg_ofstream out(copy, std::ios::out | std::ios::trunc);
+        out << in.rdbuf();
+    }
+    edty->testSuiteInjectProceduresXML(copy);
+    {
+        sg_ofstream out(copy, std::ios::out | std::ios::app);
+        out << "<!-- edited -->\n";
+    }
+
+    const uint64_t xmlReadsBefore = cache->xmlReads();
+    edty->testSuiteInjectProceduresXML(copy);
+    CPPUNIT_ASSERT_EQUAL(xmlReadsBefore + 1, cache->xmlReads());
+    CPPUNIT_ASSERT_EQUAL(numApproaches, edty->numApproaches());
+
+    // the prefetch thread counts a file once it has read it
+    auto waitForLoads = [cache](uint64_t loads) {
+        for (int i = 0; (i < 5000) && ((cache->xmlReads() + cache->cacheReads()) < loads); ++i) {
+            SGTimeStamp::sleepForMSec(1);
+        }
+    };
+
+    // as is a prefetch of a file which changed before it was used
+    const uint64_t prefetchHitsBefore = cache->prefetchHits();
+    const uint64_t loads = cache->xmlReads() + cache->cacheReads();
+    cache->prefetch(copy);
+    waitForLoads(loads + 1);
+    {
+        sg_ofstream out(copy, std::ios::out | std::ios::app);
+        out << "<!-- edited again -->\n";
+    }
+    edty->testSuiteInjectProceduresXML(copy);
+    CPPUNIT_ASSERT_EQUAL(prefetchHitsBefore, cache->prefetchHits());
+    CPPUNIT_ASSERT_EQUAL(xmlReadsBefore + 2, cache->xmlReads());
+
+    // a discarded prefetch isn't used
+    const size_t prefetchCount = cache->prefetchCount();
+    cache->prefetch(source);
+    cache->discardPrefetch(source);
+    for (int i = 0; (i < 5000) && (cache->prefetchCount() > prefetchCount); ++i) {
+        SGTimeStamp::sleepForMSec(1);
+    }
+    CPPUNIT_ASSERT_EQUAL(prefetchCount, cache->prefetchCount());
+    edty->testSuiteInjectProceduresXML(source);
+    CPPUNIT_ASSERT_EQUAL(prefetchHitsBefore, cache->prefetchHits());
+
+    // cache files of removed sources are pruned
+    const SGPath copyCache = cache->cacheFile(copy);
+    CPPUNIT_ASSERT(copyCache.exists());
+    cache->prune();
+    CPPUNIT_ASSERT(copyCache.exists());
+    copy.remove();
+    cache->prune();
+    CPPUNIT_ASSERT(!copyCache.exists());
+    CPPUNIT_ASSERT(cachePath.exists());
+}
@@ -37,6 +37,7 @@ class FlightplanTests : public CppUnit::TestFixture
     CPPUNIT_TEST(testRoutePathTrivialFlightPlan);
     CPPUNIT_TEST(testBasicAirways);
     CPPUNIT_TEST(testAirwayNetworkRoute);
+    CPPUNIT_TEST(testAirwayGraphSearch);
     CPPUNIT_TEST(testBug1814);
     CPPUNIT_TEST(testRoutPathWpt0Midflight);
     CPPUNIT_TEST(testRoutePathVec);
@@ -60,6 +61,8 @@ class FlightplanTests : public CppUnit::TestFixture
     CPPUNIT_TEST(loadFGFPAsRoute);
     CPPUNIT_TEST(testLoadSaveBetweenRestriction);
     CPPUNIT_TEST(testRestrictionUnits);
+    CPPUNIT_TEST(testRoutePathIncremental);
+    CPPUNIT_TEST(testProcedureCache);
 
     //  CPPUNIT_TEST(testParseICAORoute);
     // CPPUNIT_TEST(testParseICANLowLevelRoute);
@@ -79,6 +82,7 @@ public:
     void testRoutePathTrivialFlightPlan();
     void testBasicAirways();
     void testAirwayNetworkRoute();
+    void testAirwayGraphSearch();
     void testParseICAORoute();
     void testParseICANLowLevelRoute();
     void testBug1814();
@@ -104,6 +108,8 @@ public:
     void loadFGFPAsRoute();
     void testLoadSaveBetweenRestriction();
     void testRestrictionUnits();
+    void testRoutePathIncremental();
+    void testProcedureCache();
 };
 
 #endif  // FG_FLIGHTPLAN_UNIT_TESTS_HXX
@@ -1,11 +1,27 @@
 #include "test_navaids2.hxx"
 
+#include <algorithm>
+#include <cstring>
+
+#include <simgear/io/iostreams/sgstream.hxx>
+#include <simgear/misc/sg_dir.hxx>
+#include <simgear/timing/timestamp.hxx>
+
 #include "test_suite/FGTestApi/testGlobals.hxx"
 #include "test_suite/FGTestApi/NavDataCache.hxx"
 
+#include <Main/globals.hxx>
+
 #include <Airports/airport.hxx>
 
+#include <Navaids/FrequencyTable.hxx>
 #include <Navaids/NavDataCache.hxx>
+#include <Navaids/NavDataSnapshot.hxx>
+#include <Navaids/PositionedHotSet.hxx>
+#include <Navaids/PolyLine.hxx>
+#include <Navaids/PositionedOctree.hxx>
+#include <Navaids/SHPParser.hxx>
+#include <Navaids/SpatialQueryCache.hxx>
 #include <Navaids/navrecord.hxx>
 #include <Navaids/navlist.hxx>
 
@@ -146,3 +162,514 @@ void NavaidsTests::testTemporaryWaypoint()
     closest = FGPositioned::findClosestN(vhhh->geod(), 1, 50.0, &filt);
     CPPUNIT_ASSERT_EQUAL(closest.size(), static_cast<size_t>(0));
 }
+
+void NavaidsTests::testNameSearch()
+{
+    auto cache = flightgear::NavDataCache::instance();
+
+    // words of the name, in any case
+    FGAirport::AirportFilter aptFilter;
+    auto apts = cache->searchNames("manchester", &aptFilter);
+    CPPUNIT_ASSERT(!apts.empty());
+    CPPUNIT_ASSERT(std::any_of(apts.begin(), apts.end(),
+                               [](const FGPositionedRef& p) { return p->ident() == "EGCC"; }));
+
+    // an exact ident is ranked first, ident prefixes before names
+    apts = cache->searchNames("EGCC", &aptFilter);
+    CPPUNIT_ASSERT(!apts.empty());
+    CPPUNIT_ASSERT_EQUAL(std::string{"EGCC"}, apts.front()->ident());
+
+    apts = cache->searchNames("EGC", &aptFilter, 5);
+    CPPUNIT_ASSERT(!apts.empty());
+    CPPUNIT_ASSERT(apts.size() <= 5);
+    CPPUNIT_ASSERT_EQUAL(std::string{"EGC"}, apts.front()->ident().substr(0, 3));
+
+    // every word has to match the start of a word
+    FGPositioned::TypeFilter vorFilter(FGPositioned::VOR);
+    auto vors = cache->searchNames("tre vor", &vorFilter);
+    CPPUNIT_ASSERT(std::any_of(vors.begin(), vors.end(),
+                               [](const FGPositionedRef& p) { return p->ident() == "TNT"; }));
+    vors = cache->searchNames("rent vor", &vorFilter);
+    CPPUNIT_ASSERT(std::none_of(vors.begin(), vors.end(),
+                                [](const FGPositionedRef& p) { return p->ident() == "TNT"; }));
+
+    // nothing to search for
+    CPPUNIT_ASSERT(cache->searchNames("--", &aptFilter).empty());
+
+    // the PLIB list uses the same index
+    char** list = cache->searchAirportNamesAndIdents("Manchester");
+    bool foundEGCC = false;
+    for (char** entry = list; *entry; ++entry) {
+        foundEGCC |= (strstr(*entry, "(EGCC)") != nullptr);
+        free(*entry);
+    }
+    free(list);
+    CPPUNIT_ASSERT(foundEGCC);
+
+    // removing a waypoint removes its words, even if its rowid is reused
+    flightgear::NavDataCache::Transaction txn(cache);
+    FGPositioned::TypeFilter fixFilter(FGPositioned::FIX);
+    const SGGeod pos = SGGeod::fromDeg(-2.0, 53.0);
+    auto fix = FGPositioned::createWaypoint(FGPositioned::FIX, "TEST_NW1", pos, false, "Quokka Point");
+    CPPUNIT_ASSERT_EQUAL(size_t{1}, cache->searchNames("quokka", &fixFilter).size());
+
+    CPPUNIT_ASSERT(FGPositioned::deleteWaypoint(fix));
+    CPPUNIT_ASSERT(cache->searchNames("quokka", &fixFilter).empty());
+
+    auto other = FGPositioned::createWaypoint(FGPositioned::FIX, "TEST_NW2", pos, false, "Wombat Point");
+    CPPUNIT_ASSERT(cache->searchNames("quokka", &fixFilter).empty());
+    CPPUNIT_ASSERT_EQUAL(size_t{1}, cache->searchNames("wombat", &fixFilter).size());
+    CPPUNIT_ASSERT(FGPositioned::deleteWaypoint(other));
+}
+
+
+void NavaidsTests::testFrequencyTable()
+{
+    using flightgear::FrequencyTable;
+
+    const SGVec3d origin = SGVec3d::fromGeod(SGGeod::fromDeg(0.0, 0.0));
+    const SGVec3d near = SGVec3d::fromGeod(SGGeod::fromDeg(0.5, 0.0));
+    const SGVec3d far = SGVec3d::fromGeod(SGGeod::fromDeg(5.0, 0.0));
+
+    FrequencyTable table;
+    CPPUNIT_ASSERT(!table.isBuilt());
+    table.add({11570, 1, FGPositioned::VOR, far});
+    table.add({11000, 2, FGPositioned::ILS, origin});
+    table.add({11570, 3, FGPositioned::DME, near});
+    table.add({11570, 4, FGPositioned::VOR, near});
+    table.finish();
+    CPPUNIT_ASSERT(table.isBuilt());
+    CPPUNIT_ASSERT_EQUAL(size_t{4}, table.size());
+
+    // nearest first, and only the requested types
+    auto ids = table.findByFreq(11570, FGPositioned::VOR, FGPositioned::VOR, origin);
+    CPPUNIT_ASSERT_EQUAL(size_t{2}, ids.size());
+    CPPUNIT_ASSERT_EQUAL(PositionedID{4}, ids.front());
+    CPPUNIT_ASSERT_EQUAL(PositionedID{1}, ids.back());
+
+    ids = table.findByFreq(11570, FGPositioned::VOR, FGPositioned::VOR, origin, 100000.0);
+    CPPUNIT_ASSERT_EQUAL(size_t{1}, ids.size());
+
+    // without a position, in the order they were added
+    ids = table.findByFreq(11570, FGPositioned::NDB, FGPositioned::GS);
+    CPPUNIT_ASSERT_EQUAL(size_t{3}, ids.size());
+    CPPUNIT_ASSERT_EQUAL(PositionedID{1}, ids.front());
+    CPPUNIT_ASSERT(table.findByFreq(10800, FGPositioned::NDB, FGPositioned::GS).empty());
+
+    // moved stations
+    table.updatePosition(1, origin);
+    ids = table.findByFreq(11570, FGPositioned::VOR, FGPositioned::VOR, origin);
+    CPPUNIT_ASSERT_EQUAL(PositionedID{1}, ids.front());
+    table.updatePosition(99, far); // not in the table
+    CPPUNIT_ASSERT_EQUAL(size_t{4}, table.size());
+
+    table.clear();
+    CPPUNIT_ASSERT(!table.isBuilt());
+
+    // the cache answers the radios from its tables
+    SGGeod egccPos = SGGeod::fromDeg(-2.27, 53.35);
+    FGNavRecordRef tnt = FGNavList::findByFreq(115.7, egccPos);
+    CPPUNIT_ASSERT(tnt);
+    CPPUNIT_ASSERT_EQUAL(std::string{"TNT"}, tnt->ident());
+    CPPUNIT_ASSERT(!FGNavList::findAllByFreq(115.7, egccPos).empty());
+}
+
+
+void NavaidsTests::testPrefetch()
+{
+    using flightgear::PositionedHotSet;
+    using flightgear::PositionedRecord;
+    using flightgear::PositionedRecordVec;
+
+    auto makeLeaf = [](PositionedID first, int64_t leaf) {
+        PositionedRecordVec records;
+        for (PositionedID id = first; id < first + 10; ++id) {
+            PositionedRecord r;
+            r.guid = id;
+            r.type = FGPositioned::FIX;
+            r.ident = "FIX" + std::to_string(id);
+            r.octreeNode = leaf;
+            records.push_back(r);
+        }
+        // an item of an airport in the leaf, but not a member of it
+        PositionedRecord rwy;
+        rwy.guid = first + 10;
+        rwy.type = FGPositioned::RUNWAY;
+        rwy.octreeNode = leaf + 1000;
+        records.push_back(rwy);
+        return records;
+    };
+
+    PositionedHotSet hotSet;
+    hotSet.insertLeaf(1, makeLeaf(100, 1));
+    hotSet.insertLeaf(2, makeLeaf(200, 2));
+    CPPUNIT_ASSERT_EQUAL(size_t{2}, hotSet.leafCount());
+    CPPUNIT_ASSERT_EQUAL(size_t{22}, hotSet.recordCount());
+
+    flightgear::TypedPositionedVec children;
+    CPPUNIT_ASSERT(hotSet.leafChildren(1, children));
+    CPPUNIT_ASSERT_EQUAL(size_t{10}, children.size());
+    CPPUNIT_ASSERT(hotSet.find(110));
+    CPPUNIT_ASSERT_EQUAL(std::string{"FIX205"}, hotSet.find(205)->ident);
+
+    // leaf 1 was used last, so leaf 2 goes first
+    const size_t leafBytes = hotSet.bytes() / 2;
+    hotSet.find(105);
+    hotSet.setBudget(leafBytes + leafBytes / 2);
+    CPPUNIT_ASSERT(hotSet.hasLeaf(1));
+    CPPUNIT_ASSERT(!hotSet.hasLeaf(2));
+    CPPUNIT_ASSERT(!hotSet.find(205));
+
+    hotSet.insertLeaf(3, makeLeaf(300, 3));
+    CPPUNIT_ASSERT(hotSet.hasLeaf(3));
+    CPPUNIT_ASSERT(!hotSet.hasLeaf(1));
+    CPPUNIT_ASSERT(hotSet.bytes() <= leafBytes + leafBytes / 2);
+
+    hotSet.clear();
+    CPPUNIT_ASSERT_EQUAL(size_t{0}, hotSet.recordCount());
+
+    // spatial searches around EGCC queue the leaves near it
+    auto cache = flightgear::NavDataCache::instance();
+    const SGGeod egccPos = SGGeod::fromDeg(-2.27, 53.35);
+    FGPositioned::TypeFilter vorFilter(FGPositioned::VOR);
+    auto before = FGPositioned::findWithinRange(egccPos, 20.0, &vorFilter);
+
+    for (int i = 0; (i < 1000) && (cache->pendingPrefetchLeaves() > 0); ++i) {
+        SGTimeStamp::sleepForMSec(10);
+    }
+    CPPUNIT_ASSERT_EQUAL(size_t{0}, cache->pendingPrefetchLeaves());
+    CPPUNIT_ASSERT(cache->prefetchedLeaves() > 0);
+
+    // and the results are the same either way
+    auto after = FGPositioned::findWithinRange(egccPos, 20.0, &vorFilter);
+    CPPUNIT_ASSERT_EQUAL(before.size(), after.size());
+    CPPUNIT_ASSERT(!after.empty());
+
+    // the VOR search only created the VORs; the fixes of the same leaves
+    // aren't cached yet, and are created from the prefetched records
+    const unsigned int hits = cache->prefetchHits();
+    FGPositioned::TypeFilter fixFilter(FGPositioned::FIX);
+    auto fixes = FGPositioned::findWithinRange(egccPos, 20.0, &fixFilter);
+    CPPUNIT_ASSERT(!fixes.empty());
+    CPPUNIT_ASSERT(cache->prefetchHits() > hits);
+
+    FGAirportRef egcc = FGAirport::findByIdent("EGCC");
+    CPPUNIT_ASSERT(egcc);
+    CPPUNIT_ASSERT(egcc->numRunways() > 0);
+}
+
+
+void NavaidsTests::testSnapshot()
+{
+    auto cache = flightgear::NavDataCache::instance();
+    const SGPath path = globals->get_fg_home() / "navdata.snapshot";
+    CPPUNIT_ASSERT(cache->writeSnapshot(path));
+    CPPUNIT_ASSERT(path.exists());
+
+    CPPUNIT_ASSERT(!cache->hasSnapshot());
+
+    const SGGeod egccPos = SGGeod::fromDeg(-2.27, 53.35);
+    FGPositioned::TypeFilter vorFilter(FGPositioned::VOR);
+    auto before = FGPositioned::findWithinRange(egccPos, 50.0, &vorFilter);
+
+    CPPUNIT_ASSERT(cache->openSnapshot(path));
+    CPPUNIT_ASSERT(cache->hasSnapshot());
+
+    // the same answers as from the database
+    auto after = FGPositioned::findWithinRange(egccPos, 50.0, &vorFilter);
+    CPPUNIT_ASSERT_EQUAL(before.size(), after.size());
+
+    FGNavRecordRef tnt = FGNavList::findByFreq(115.7, egccPos);
+    CPPUNIT_ASSERT(tnt);
+    CPPUNIT_ASSERT_EQUAL(std::string{"TNT"}, tnt->ident());
+    CPPUNIT_ASSERT_EQUAL(std::string{"TRENT VOR-DME"}, tnt->name());
+
+    // airports, their runways and comm stations are created from the snapshot
+    FGAirportRef egkk = FGAirport::findByIdent("EGKK");
+    CPPUNIT_ASSERT(egkk);
+    CPPUNIT_ASSERT(egkk->hasRunwayWithIdent("08R"));
+    CPPUNIT_ASSERT(!egkk->commStations().empty());
+
+    // searches by ident use the snapshot's index, ignoring case
+    auto tnts = cache->findAllWithIdent("tnt", &vorFilter, true);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), tnts.size());
+    CPPUNIT_ASSERT(tnts.front() == tnt);
+
+    FGAirport::AirportFilter airports;
+    auto egs = cache->findAllWithIdent("EGK", &airports, false);
+    CPPUNIT_ASSERT(std::find(egs.begin(), egs.end(), egkk) != egs.end());
+    for (const auto& p : egs) {
+        CPPUNIT_ASSERT_EQUAL(0, p->ident().compare(0, 3, "EGK"));
+    }
+
+    CPPUNIT_ASSERT(cache->findClosestWithIdent("EGKK", egccPos, &airports) == egkk);
+
+    // temporary items are not in the snapshot, but are still found
+    auto wpt = FGPositioned::createWaypoint(FGPositioned::WAYPOINT, "TEST_WP_SNP",
+                                            SGGeod::fromDeg(-2.0, 53.0), true);
+    FGPositioned::TypeFilter wpFilter(FGPositioned::WAYPOINT);
+    CPPUNIT_ASSERT(cache->findClosestWithIdent("TEST_WP_SNP", egccPos, &wpFilter) == wpt);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), cache->findAllWithIdent("TEST_WP_SNP", &wpFilter, true).size());
+    CPPUNIT_ASSERT(cache->hasSnapshot());
+    FGPositioned::deleteWaypoint(wpt);
+}
+
+void NavaidsTests::testSnapshotSources()
+{
+    using flightgear::NavDataSnapshot;
+    const SGPath source = globals->get_fg_home() / "snapshot_source.dat";
+    auto writeSource = [&source](const std::string& contents) {
+        sg_ofstream f(source, std::ios::out | std::ios::binary | std::ios::trunc);
+        f << contents;
+    };
+
+    writeSource("1000 Version\n");
+    const SGPath path = globals->get_fg_home() / "sources.snapshot";
+    NavDataSnapshot::Writer writer(path, {source});
+    CPPUNIT_ASSERT(writer.begin());
+    CPPUNIT_ASSERT(writer.finish());
+
+    // checked against the files alone, no cache involved
+    CPPUNIT_ASSERT(NavDataSnapshot::open(path, {source}));
+    CPPUNIT_ASSERT(!NavDataSnapshot::open(path, {}));
+
+    // the same contents elsewhere are recognised by their hash
+    const SGPath copy = globals->get_fg_home() / "snapshot_source_copy.dat";
+    {
+        sg_ofstream f(copy, std::ios::out | std::ios::binary | std::ios::trunc);
+        f << "1000 Version\n";
+    }
+    CPPUNIT_ASSERT(NavDataSnapshot::open(path, {copy}));
+
+    // other contents of the same size are not
+    writeSource("1100 Version\n");
+    CPPUNIT_ASSERT(!NavDataSnapshot::open(path, {source}));
+
+    copy.remove();
+    source.remove();
+}
+
+void NavaidsTests::testSpatialQueryCache()
+{
+    using flightgear::SpatialQueryCache;
+    auto cache = SpatialQueryCache::instance();
+    cache->clear();
+
+    auto sameAsOctree = [](const SGGeod& pos, double rangeM, FGPositioned::Filter* filt,
+                           const FGPositionedList& cached) {
+        FGPositionedList direct;
+        flightgear::Octree::findAllWithinRange(SGVec3d::fromGeod(pos), rangeM, filt, direct, 0xffffff);
+        CPPUNIT_ASSERT_EQUAL(direct.size(), cached.size());
+        for (const auto& p : direct) {
+            CPPUNIT_ASSERT(std::find(cached.begin(), cached.end(), p) != cached.end());
+        }
+    };
+
+    const SGGeod egkkPos = SGGeod::fromDeg(-0.19, 51.15);
+    const double rangeM = 40.0 * SG_NM_TO_METER;
+    FGAirport::AirportFilter airports;
+
+    auto first = FGPositioned::findWithinRange(egkkPos, rangeM / SG_NM_TO_METER, &airports);
+    CPPUNIT_ASSERT(!first.empty());
+    sameAsOctree(egkkPos, rangeM, &airports, first);
+
+    // the same query again, and a small move, are answered from the entry
+    const uint64_t hits = cache->hits();
+    auto second = FGPositioned::findWithinRange(egkkPos, rangeM / SG_NM_TO_METER, &airports);
+    CPPUNIT_ASSERT(first == second);
+    CPPUNIT_ASSERT_EQUAL(hits + 1, cache->hits());
+
+    const SGGeod nearby = SGGeodesy::direct(egkkPos, 90.0, 2.0 * SG_NM_TO_METER);
+    auto moved = FGPositioned::findWithinRange(nearby, rangeM / SG_NM_TO_METER, &airports);
+    CPPUNIT_ASSERT_EQUAL(hits + 2, cache->hits());
+    sameAsOctree(nearby, rangeM, &airports, moved);
+
+    // further away, the entry is extended rather than searched again
+    const uint64_t updates = cache->incrementalUpdates();
+    const SGGeod further = SGGeodesy::direct(egkkPos, 90.0, 30.0 * SG_NM_TO_METER);
+    auto extended = FGPositioned::findWithinRange(further, rangeM / SG_NM_TO_METER, &airports);
+    CPPUNIT_ASSERT_EQUAL(updates + 1, cache->incrementalUpdates());
+    sameAsOctree(further, rangeM, &airports, extended);
+
+    // nearest first, as before
+    for (size_t i = 1; i < extended.size(); ++i) {
+        CPPUNIT_ASSERT(dist(extended[i - 1]->cart(), SGVec3d::fromGeod(further)) <=
+                       dist(extended[i]->cart(), SGVec3d::fromGeod(further)));
+    }
+
+    // nearest-N queries use an entry which covers them, but never fill one
+    const uint64_t nearHits = cache->hits();
+    auto nearest = FGPositioned::findClosestN(further, 3, 0.5 * rangeM / SG_NM_TO_METER, &airports);
+    CPPUNIT_ASSERT_EQUAL(nearHits + 1, cache->hits());
+    for (size_t i = 0; i < nearest.size(); ++i) {
+        CPPUNIT_ASSERT(nearest[i] == extended[i]);
+    }
+
+    const uint64_t misses = cache->misses();
+    auto faraway = FGPositioned::findClosestN(SGGeod::fromDeg(114.0, 22.3), 64, 200.0, &airports);
+    CPPUNIT_ASSERT(!faraway.empty());
+    CPPUNIT_ASSERT_EQUAL(misses, cache->misses());
+
+    // new items drop the entries
+    FGPositioned::TypeFilter wpFilter(FGPositioned::WAYPOINT);
+    auto before = FGPositioned::findWithinRange(egkkPos, 50.0, &wpFilter);
+    auto wpt = FGPositioned::createWaypoint(FGPositioned::WAYPOINT, "TEST_WP_SQC",
+                                            SGGeodesy::direct(egkkPos, 0.0, 1000.0), true);
+    auto after = FGPositioned::findWithinRange(egkkPos, 50.0, &wpFilter);
+    CPPUNIT_ASSERT_EQUAL(before.size() + 1, after.size());
+    CPPUNIT_ASSERT(std::find(after.begin(), after.end(), wpt) != after.end());
+}
+
+namespace {
+
+void writeIntBE(std::ostream& os, int32_t v)
+{
+    const uint32_t u = static_cast<uint32_t>(v);
+    const char bytes[4] = {char(u >> 24), char(u >> 16), char(u >> 8), char(u)};
+    os.write(bytes, 4);
+}
+
+void writeIntLE(std::ostream& os, int32_t v)
+{
+    const uint32_t u = static_cast<uint32_t>(v);
+    const char bytes[4] = {char(u), char(u >> 8), char(u >> 16), char(u >> 24)};
+    os.write(bytes, 4);
+}
+
+void writeDoubleLE(std::ostream& os, double d)
+{
+    uint64_t u;
+    memcpy(&u, &d, sizeof(u));
+    for (int i = 0; i < 8; ++i) {
+        const char b = char(u >> (i * 8));
+        os.write(&b, 1);
+    }
+}
+
+// a shape file holding a single PolyLine record of one part
+void writePolyLineShapeFile(const SGPath& path, const flightgear::SGGeodVec& points)
+{
+    const int32_t numPoints = static_cast<int32_t>(points.size());
+    const int32_t contentBytes = 4 + 32 + 4 + 4 + 4 + (16 * numPoints);
+
+    sg_ofstream f(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    writeIntBE(f, 9994);
+    for (int i = 0; i < 5; ++i) {
+        writeIntBE(f, 0);
+    }
+    writeIntBE(f, (100 + 8 + contentBytes) / 2);
+    writeIntLE(f, 1000);
+    writeIntLE(f, 3);
+    for (int i = 0; i < 8; ++i) {
+        writeDoubleLE(f, 0.0);
+    }
+
+    writeIntBE(f, 1);
+    writeIntBE(f, contentBytes / 2);
+    writeIntLE(f, 3);
+    for (int i = 0; i < 4; ++i) {
+        writeDoubleLE(f, 0.0);
+    }
+    writeIntLE(f, 1);
+    writeIntLE(f, numPoints);
+    writeIntLE(f, 0);
+    for (const auto& g : points) {
+        writeDoubleLE(f, g.getLongitudeDeg());
+        writeDoubleLE(f, g.getLatitudeDeg());
+    }
+}
+
+} // of anonymous namespace
+
+void NavaidsTests::testPolyLineCache()
+{
+    using flightgear::PolyLine;
+    using flightgear::PolyLineList;
+    using flightgear::SHPParser;
+
+    // two degrees of river, wiggling by about 50m either side
+    flightgear::SGGeodVec raw;
+    for (int i = 0; i <= 400; ++i) {
+        const double wiggle = (i % 2) ? 0.00045 : -0.00045;
+        raw.push_back(SGGeod::fromDeg(10.0 + (i * 0.005), 45.0 + wiggle));
+    }
+
+    PolyLineList chunked = PolyLine::createChunked(PolyLine::RIVER, raw);
+    CPPUNIT_ASSERT(chunked.size() > 1);
+    for (const auto& line : chunked) {
+        CPPUNIT_ASSERT(line->simplified(0).get() == line.get());
+        auto level1 = line->simplified(1);
+        CPPUNIT_ASSERT(level1->numPoints() < line->numPoints());
+        CPPUNIT_ASSERT(level1->numPoints() >= 2);
+
+        // simplified lines keep their ends
+        const SGGeod lastPt = line->point(line->numPoints() - 1);
+        const SGGeod lastSimplified = level1->point(level1->numPoints() - 1);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(line->point(0).getLongitudeDeg(), level1->point(0).getLongitudeDeg(), 1e-9);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(lastPt.getLongitudeDeg(), lastSimplified.getLongitudeDeg(), 1e-9);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(0u, PolyLine::levelForRange(10.0));
+    CPPUNIT_ASSERT_EQUAL(PolyLine::NUM_SIMPLIFIED_LEVELS, PolyLine::levelForRange(5000.0));
+
+    // the first load parses and writes the cache, the second reads it
+    const SGPath shp = globals->get_fg_home() / "test_river.shp";
+    writePolyLineShapeFile(shp, raw);
+    SGPath cache = SHPParser::cacheFile(shp);
+    cache.remove();
+
+    // a file of the same name elsewhere gets its own cache
+    const SGPath otherShp = globals->get_fg_home() / "other" / "test_river.shp";
+    simgear::Dir(otherShp.dirPath()).create(0755);
+    writePolyLineShapeFile(otherShp, raw);
+    CPPUNIT_ASSERT(SHPParser::cacheFile(otherShp).utf8Str() != cache.utf8Str());
+
+    PolyLineList parsed;
+    SHPParser::loadPolyLines(shp, PolyLine::RIVER, parsed, false);
+    CPPUNIT_ASSERT_EQUAL(chunked.size(), parsed.size());
+    CPPUNIT_ASSERT(cache.exists());
+
+    PolyLineList cached;
+    SHPParser::loadPolyLines(shp, PolyLine::RIVER, cached, false);
+    CPPUNIT_ASSERT_EQUAL(parsed.size(), cached.size());
+    for (size_t i = 0; i < parsed.size(); ++i) {
+        CPPUNIT_ASSERT_EQUAL(PolyLine::RIVER, cached[i]->type());
+        for (unsigned int level = 0; level <= PolyLine::NUM_SIMPLIFIED_LEVELS; ++level) {
+            auto a = parsed[i]->simplified(level), b = cached[i]->simplified(level);
+            CPPUNIT_ASSERT_EQUAL(a->numPoints(), b->numPoints());
+            for (unsigned int p = 0; p < a->numPoints(); ++p) {
+                CPPUNIT_ASSERT_DOUBLES_EQUAL(a->point(p).getLongitudeDeg(), b->point(p).getLongitudeDeg(), 1e-9);
+                CPPUNIT_ASSERT_DOUBLES_EQUAL(a->point(p).getLatitudeDeg(), b->point(p).getLatitudeDeg(), 1e-9);
+            }
+        }
+
+        const SGBoxd pb = parsed[i]->cartesianBox(), cb = cached[i]->cartesianBox();
+        CPPUNIT_ASSERT(pb.getMin() == cb.getMin());
+        CPPUNIT_ASSERT(pb.getMax() == cb.getMax());
+    }
+
+    // the cache only answers for the line type it was written with
+    PolyLineList coastlines;
+    SHPParser::loadPolyLines(shp, PolyLine::COASTLINE, coastlines, false);
+    CPPUNIT_ASSERT_EQUAL(parsed.size(), coastlines.size());
+    CPPUNIT_ASSERT_EQUAL(PolyLine::COASTLINE, coastlines.front()->type());
+
+    // queries over a wide range get the simplified lines
+    PolyLine::bulkAddToSpatialIndex(cached.begin(), cached.end());
+    const SGGeod middle = SGGeod::fromDeg(11.0, 45.0);
+    size_t closePoints = 0, widePoints = 0;
+    for (const auto& line : PolyLine::linesNearPos(middle, 5.0, PolyLine::RIVER)) {
+        CPPUNIT_ASSERT(std::find(cached.begin(), cached.end(), line) != cached.end());
+        closePoints += line->numPoints();
+    }
+
+    auto wide = PolyLine::linesNearPos(middle, 500.0, PolyLine::RIVER);
+    CPPUNIT_ASSERT(!wide.empty());
+    for (const auto& line : wide) {
+        CPPUNIT_ASSERT(std::find(cached.begin(), cached.end(), line) == cached.end());
+        widePoints += line->numPoints();
+    }
+
+    CPPUNIT_ASSERT(closePoints > 0);
+    CPPUNIT_ASSERT(widePoints < raw.size());
+}
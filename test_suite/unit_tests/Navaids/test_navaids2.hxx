@@ -34,6 +34,13 @@ class NavaidsTests : public CppUnit::TestFixture
     CPPUNIT_TEST(testBasic);
     CPPUNIT_TEST(testCustomWaypoint);
     CPPUNIT_TEST(testTemporaryWaypoint);
+    CPPUNIT_TEST(testNameSearch);
+    CPPUNIT_TEST(testFrequencyTable);
+    CPPUNIT_TEST(testPrefetch);
+    CPPUNIT_TEST(testSnapshot);
+    CPPUNIT_TEST(testSnapshotSources);
+    CPPUNIT_TEST(testSpatialQueryCache);
+    CPPUNIT_TEST(testPolyLineCache);
     CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -47,6 +54,13 @@ public:
     void testBasic();
     void testCustomWaypoint();
     void testTemporaryWaypoint();
+    void testNameSearch();
+    void testFrequencyTable();
+    void testPrefetch();
+    void testSnapshot();
+    void testSnapshotSources();
+    void testSpatialQueryCache();
+    void testPolyLineCache();
 };
 
 #endif  // _FG_NAVAIDS_UNIT_TESTS_HXX
@@ -23,6 +23,7 @@
 #include "test_suite/FGTestApi/testGlobals.hxx"
 #include "test_suite/FGTestApi/NavDataCache.hxx"
 
+#include <simgear/io/iostreams/sgstream.hxx>
 #include <simgear/structure/commands.hxx>
 
 #include <Main/fg_props.hxx>
@@ -31,6 +32,7 @@
 
 #include <Airports/airport.hxx>
 
+#include <Scripting/NasalProfiler.hxx>
 #include <Scripting/NasalSys.hxx>
 
 #include <Main/FGInterpolator.hxx>
@@ -370,3 +372,87 @@ void NasalSysTests::testNullishChain()
     auto errors = nasalSys->getAndClearErrorList();
     CPPUNIT_ASSERT_EQUAL(errors.size(), static_cast<size_t>(0));
 }
+
+void NasalSysTests::testCoalescedListener()
+{
+    auto nasalSys = globals->get_subsystem<FGNasalSys>();
+    nasalSys->getAndClearErrorList();
+
+    fgSetBool("/sim/nasal/listener-stats/enabled", true);
+    fgSetInt("/foo/coalesced", 0);
+    bool ok = FGTestApi::executeNasal(R"(
+        _setlistener('/foo/coalesced', func(n) {
+            setprop('/foo/coalesced-calls', getprop('/foo/coalesced-calls') + 1);
+            setprop('/foo/coalesced-seen', n.getValue());
+        }, 0, 3);
+
+        setprop('/foo/coalesced-calls', 0);
+        for (var i = 1; i <= 5; i += 1) {
+            setprop('/foo/coalesced', i);
+        }
+
+        # nothing is dispatched until the next Nasal update
+        unitTest.assert_equal(getprop('/foo/coalesced-calls'), 0);
+    )");
+    CPPUNIT_ASSERT(ok);
+
+    nasalSys->update(0.0);
+    CPPUNIT_ASSERT_EQUAL(1, fgGetInt("/foo/coalesced-calls"));
+    CPPUNIT_ASSERT_EQUAL(5, fgGetInt("/foo/coalesced-seen"));
+    CPPUNIT_ASSERT_EQUAL(4, fgGetInt("/sim/nasal/listener-stats/coalesced-per-frame"));
+
+    // no writes, no further calls
+    nasalSys->update(0.0);
+    CPPUNIT_ASSERT_EQUAL(1, fgGetInt("/foo/coalesced-calls"));
+
+    fgSetInt("/foo/coalesced", 6);
+    nasalSys->update(0.0);
+    CPPUNIT_ASSERT_EQUAL(2, fgGetInt("/foo/coalesced-calls"));
+    CPPUNIT_ASSERT_EQUAL(6, fgGetInt("/foo/coalesced-seen"));
+    CPPUNIT_ASSERT(checkNoNasalErrors());
+}
+
+void NasalSysTests::testProfilerTrace()
+{
+    auto nasalSys = globals->get_subsystem<FGNasalSys>();
+    nasalSys->getAndClearErrorList();
+
+    fgSetBool("/sim/nasal/profiler/enabled", true);
+    fgSetBool("/sim/nasal/profiler/trace", true);
+    // the listener stats share the profiler's timing of each call
+    fgSetBool("/sim/nasal/listener-stats/enabled", true);
+    nasalSys->update(0.0);
+    CPPUNIT_ASSERT(nasalSys->profiler()->isEnabled());
+
+    bool ok = FGTestApi::executeNasal(R"(
+        _setlistener('/foo/profiled', func {
+            var sum = 0;
+            for (var i = 0; i < 100; i += 1) { sum += i; }
+        });
+
+        for (var i = 0; i < 10; i += 1) {
+            setprop('/foo/profiled', i);
+        }
+    )");
+    CPPUNIT_ASSERT(ok);
+
+    const SGPath tracePath = globals->get_fg_home() / "test_nasal_trace.json";
+    CPPUNIT_ASSERT(nasalSys->profiler()->writeTrace(tracePath));
+
+    sg_ifstream f(tracePath);
+    const std::string trace((std::istreambuf_iterator<char>(f)),
+                            std::istreambuf_iterator<char>());
+    CPPUNIT_ASSERT(trace.find("\"traceEvents\"") != std::string::npos);
+    CPPUNIT_ASSERT(trace.find("listener-") != std::string::npos);
+    CPPUNIT_ASSERT(trace.find("/foo/profiled") != std::string::npos);
+    CPPUNIT_ASSERT(trace.find("\"ph\":\"X\"") != std::string::npos);
+
+    nasalSys->update(0.0);
+    CPPUNIT_ASSERT_EQUAL(10, fgGetInt("/sim/nasal/listener-stats/calls-per-frame"));
+
+    // disabling stops recording
+    fgSetBool("/sim/nasal/profiler/enabled", false);
+    nasalSys->update(0.0);
+    CPPUNIT_ASSERT(!nasalSys->profiler()->isEnabled());
+    CPPUNIT_ASSERT(checkNoNasalErrors());
+}
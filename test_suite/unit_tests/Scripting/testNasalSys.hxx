@@ -41,6 +41,8 @@ class NasalSysTests : public CppUnit::TestFixture
     CPPUNIT_TEST(testNullAccess);
     CPPUNIT_TEST(testNullishChain);
     CPPUNIT_TEST(testFindComm);
+    CPPUNIT_TEST(testCoalescedListener);
+    CPPUNIT_TEST(testProfilerTrace);
     CPPUNIT_TEST_SUITE_END();
 
     bool checkNoNasalErrors();
@@ -63,6 +65,8 @@ public:
     void testNullAccess();
     void testNullishChain();
     void testFindComm();
+    void testCoalescedListener();
+    void testProfilerTrace();
 };
 
 #endif  // _FG_NASALSYS_UNIT_TESTS_HXX